@@ -0,0 +1,135 @@
+#include "iceberg/avro/file_reader.hh"
+
+#include <avro/Exception.hh>
+
+#include <algorithm>
+#include <utility>
+
+namespace iceberg {
+namespace avro {
+
+namespace {
+
+// Convert an exception thrown by avro-cpp, reporting the error of the stream if a read
+// failed
+Status ToStatus(const std::exception& e, const std::shared_ptr<const Status>& read_status,
+                const char* what) {
+  if (!read_status->ok()) {
+    return *read_status;
+  }
+  return Status::Invalid(what, e.what());
+}
+
+}  // namespace
+
+AvroInputStream::AvroInputStream(std::shared_ptr<io::InputStream> stream,
+                                 int64_t buffer_size)
+    : stream_(std::move(stream)),
+      buffer_(static_cast<size_t>(buffer_size)),
+      status_(std::make_shared<Status>()) {}
+
+void AvroInputStream::Fail(Status status) {
+  *status_ = std::move(status);
+  throw ::avro::Exception(status_->ToString());
+}
+
+bool AvroInputStream::next(const uint8_t** data, size_t* len) {
+  if (pos_ == size_) {
+    auto n = stream_->Read(static_cast<int64_t>(buffer_.size()), buffer_.data());
+    if (!n.ok()) {
+      Fail(n.status());
+    }
+    pos_ = 0;
+    size_ = static_cast<size_t>(*n);
+    if (size_ == 0) {
+      return false;
+    }
+  }
+  *data = buffer_.data() + pos_;
+  *len = size_ - pos_;
+  byte_count_ += size_ - pos_;
+  pos_ = size_;
+  return true;
+}
+
+void AvroInputStream::backup(size_t len) {
+  pos_ -= len;
+  byte_count_ -= len;
+}
+
+void AvroInputStream::skip(size_t len) {
+  const size_t buffered = std::min(len, size_ - pos_);
+  pos_ += buffered;
+  byte_count_ += buffered;
+  len -= buffered;
+  if (len > 0) {
+    Status status = stream_->Advance(static_cast<int64_t>(len));
+    if (!status.ok()) {
+      Fail(std::move(status));
+    }
+    byte_count_ += len;
+  }
+}
+
+FileReader::FileReader(std::shared_ptr<io::InputStream> stream,
+                       std::shared_ptr<const Status> read_status,
+                       std::unique_ptr<::avro::DataFileReaderBase> base)
+    : stream_(std::move(stream)),
+      read_status_(std::move(read_status)),
+      base_(std::move(base)),
+      schema_(base_->dataSchema()) {}
+
+FileReader::~FileReader() = default;
+
+Result<std::unique_ptr<FileReader>> FileReader::Open(
+    std::shared_ptr<io::InputStream> stream, int64_t buffer_size) {
+  auto input = std::make_unique<AvroInputStream>(stream, buffer_size);
+  auto read_status = input->status();
+  try {
+    auto base = std::make_unique<::avro::DataFileReaderBase>(std::move(input));
+    // Without a reader schema, objects are decoded with the writer's
+    base->init();
+    return std::unique_ptr<FileReader>(
+        new FileReader(std::move(stream), std::move(read_status), std::move(base)));
+  } catch (const std::exception& e) {
+    return ToStatus(e, read_status, "Invalid Avro data file: ");
+  }
+}
+
+Result<std::unique_ptr<FileReader>> FileReader::Open(
+    const std::shared_ptr<io::InputFile>& file, int64_t buffer_size) {
+  ICEBERG_ASSIGN_OR_RAISE(auto stream, file->newStream());
+  return Open(std::move(stream), buffer_size);
+}
+
+std::optional<std::string> FileReader::metadata(const std::string& key) const {
+  auto value = base_->getMetadata(key);
+  if (!value) {
+    return std::nullopt;
+  }
+  return std::string(*value);
+}
+
+Result<int64_t> FileReader::ReadBlock(const DecodeFn& decode) {
+  try {
+    if (!base_->hasMore()) {
+      return 0;
+    }
+    // The objects of a block share the position of the sync marker before it
+    const int64_t block = base_->previousSync();
+    int64_t num_objects = 0;
+    do {
+      base_->decr();
+      ICEBERG_RETURN_NOT_OK(decode(&base_->decoder()));
+      ++num_objects;
+    } while (base_->hasMore() && base_->previousSync() == block);
+    return num_objects;
+  } catch (const std::exception& e) {
+    return ToStatus(e, read_status_, "Invalid Avro data: ");
+  }
+}
+
+Status FileReader::Close() { return stream_->Close(); }
+
+}  // namespace avro
+}  // namespace iceberg
@@ -0,0 +1,305 @@
+#include "iceberg/avro/projection.hh"
+
+#include <avro/NodeImpl.hh>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace iceberg {
+namespace avro {
+
+namespace {
+
+// Named types may refer to themselves; deeper schemas are not considered zero-width
+constexpr int kMaxZeroWidthDepth = 32;
+
+bool IsZeroWidth(const ::avro::NodePtr& schema, int depth) {
+  if (depth > kMaxZeroWidthDepth) {
+    return false;
+  }
+  if (schema->type() == ::avro::AVRO_SYMBOLIC) {
+    return IsZeroWidth(::avro::resolveSymbol(schema), depth + 1);
+  }
+  const ::avro::Node* node = schema.get();
+  switch (node->type()) {
+    case ::avro::AVRO_NULL:
+      return true;
+    case ::avro::AVRO_FIXED:
+      return node->fixedSize() == 0;
+    case ::avro::AVRO_RECORD:
+      for (size_t i = 0; i < node->leaves(); ++i) {
+        if (!IsZeroWidth(node->leafAt(i), depth + 1)) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+Status ReadUnionIndex(::avro::Decoder* decoder, size_t num_branches, size_t* out) {
+  *out = decoder->decodeUnionIndex();
+  if (*out >= num_branches) {
+    return Status::Invalid("Avro union index out of range: ", *out);
+  }
+  return Status::OK();
+}
+
+void AppendLong(int64_t value, std::string* out) {
+  uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ (value < 0 ? ~0ULL : 0);
+  do {
+    uint8_t byte = zigzag & 0x7F;
+    zigzag >>= 7;
+    if (zigzag != 0) {
+      byte |= 0x80;
+    }
+    out->push_back(static_cast<char>(byte));
+  } while (zigzag != 0);
+}
+
+template <typename T>
+void AppendRaw(T value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}  // namespace
+
+::avro::NodePtr Resolve(const ::avro::NodePtr& schema) {
+  return schema->type() == ::avro::AVRO_SYMBOLIC ? ::avro::resolveSymbol(schema)
+                                                  : schema;
+}
+
+std::optional<int32_t> FieldId(const ::avro::NodePtr& record, size_t index) {
+  if (index >= record->customAttributes()) {
+    return std::nullopt;
+  }
+  const auto value = record->customAttributesAt(index).getAttribute("field-id");
+  if (!value) {
+    return std::nullopt;
+  }
+  const std::string& text = *value;
+  char* end = nullptr;
+  const long long id = std::strtoll(text.c_str(), &end, 10);
+  if (text.empty() || end != text.c_str() + text.size() || id < INT32_MIN ||
+      id > INT32_MAX) {
+    return std::nullopt;
+  }
+  return static_cast<int32_t>(id);
+}
+
+UnwrappedSchema UnwrapOptional(const ::avro::NodePtr& schema) {
+  const ::avro::NodePtr node = Resolve(schema);
+  if (node->type() == ::avro::AVRO_UNION && node->leaves() == 2) {
+    for (int i = 0; i < 2; ++i) {
+      const ::avro::NodePtr other = Resolve(node->leafAt(1 - i));
+      if (node->leafAt(i)->type() == ::avro::AVRO_NULL &&
+          other->type() != ::avro::AVRO_NULL) {
+        return UnwrappedSchema{other, i};
+      }
+    }
+  }
+  return UnwrappedSchema{node, -1};
+}
+
+bool IsZeroWidth(const ::avro::NodePtr& schema) { return IsZeroWidth(schema, 0); }
+
+Status ReadPresence(::avro::Decoder* decoder, const UnwrappedSchema& schema,
+                    bool* present) {
+  if (schema.null_index < 0) {
+    *present = true;
+    return Status::OK();
+  }
+  size_t index;
+  ICEBERG_RETURN_NOT_OK(ReadUnionIndex(decoder, 2, &index));
+  *present = static_cast<int>(index) != schema.null_index;
+  return Status::OK();
+}
+
+Status ReadOptionalLong(::avro::Decoder* decoder, const UnwrappedSchema& schema,
+                        bool* present, int64_t* out) {
+  ICEBERG_RETURN_NOT_OK(ReadPresence(decoder, schema, present));
+  if (!*present) {
+    return Status::OK();
+  }
+  switch (schema.node->type()) {
+    case ::avro::AVRO_BOOL:
+      *out = decoder->decodeBool();
+      break;
+    case ::avro::AVRO_INT:
+      *out = decoder->decodeInt();
+      break;
+    default:
+      *out = decoder->decodeLong();
+  }
+  return Status::OK();
+}
+
+Status ReadOptionalBytes(::avro::Decoder* decoder, const UnwrappedSchema& schema,
+                         bool* present, std::string* out) {
+  ICEBERG_RETURN_NOT_OK(ReadPresence(decoder, schema, present));
+  if (!*present) {
+    return Status::OK();
+  }
+  if (schema.node->type() == ::avro::AVRO_FIXED) {
+    std::vector<uint8_t> fixed;
+    decoder->decodeFixed(schema.node->fixedSize(), fixed);
+    out->assign(fixed.begin(), fixed.end());
+    return Status::OK();
+  }
+  // Bytes share the binary encoding of strings
+  decoder->decodeString(*out);
+  return Status::OK();
+}
+
+Status Skip(::avro::Decoder* decoder, const ::avro::NodePtr& schema) {
+  if (schema->type() == ::avro::AVRO_SYMBOLIC) {
+    return Skip(decoder, ::avro::resolveSymbol(schema));
+  }
+  const ::avro::Node* node = schema.get();
+  switch (node->type()) {
+    case ::avro::AVRO_NULL:
+      decoder->decodeNull();
+      return Status::OK();
+    case ::avro::AVRO_BOOL:
+      decoder->decodeBool();
+      return Status::OK();
+    case ::avro::AVRO_INT:
+    case ::avro::AVRO_LONG:
+      decoder->decodeLong();
+      return Status::OK();
+    case ::avro::AVRO_FLOAT:
+      decoder->decodeFloat();
+      return Status::OK();
+    case ::avro::AVRO_DOUBLE:
+      decoder->decodeDouble();
+      return Status::OK();
+    case ::avro::AVRO_BYTES:
+      decoder->skipBytes();
+      return Status::OK();
+    case ::avro::AVRO_STRING:
+      decoder->skipString();
+      return Status::OK();
+    case ::avro::AVRO_FIXED:
+      decoder->skipFixed(node->fixedSize());
+      return Status::OK();
+    case ::avro::AVRO_ENUM:
+      decoder->decodeEnum();
+      return Status::OK();
+    case ::avro::AVRO_RECORD:
+      for (size_t i = 0; i < node->leaves(); ++i) {
+        ICEBERG_RETURN_NOT_OK(Skip(decoder, node->leafAt(i)));
+      }
+      return Status::OK();
+    case ::avro::AVRO_ARRAY: {
+      // skipArray() skips the blocks written with byte sizes and returns the count of
+      // the next block to walk, 0 after the last one
+      const ::avro::NodePtr& items = node->leafAt(0);
+      const bool zero_width = IsZeroWidth(items);
+      for (size_t n = decoder->skipArray(); n != 0; n = decoder->skipArray()) {
+        for (size_t i = 0; i < n && !zero_width; ++i) {
+          ICEBERG_RETURN_NOT_OK(Skip(decoder, items));
+        }
+      }
+      return Status::OK();
+    }
+    case ::avro::AVRO_MAP: {
+      // Every key takes at least a byte, which bounds the count of a corrupt block
+      const ::avro::NodePtr& values = node->leafAt(1);
+      for (size_t n = decoder->skipMap(); n != 0; n = decoder->skipMap()) {
+        for (size_t i = 0; i < n; ++i) {
+          decoder->skipString();
+          ICEBERG_RETURN_NOT_OK(Skip(decoder, values));
+        }
+      }
+      return Status::OK();
+    }
+    case ::avro::AVRO_UNION: {
+      size_t index;
+      ICEBERG_RETURN_NOT_OK(ReadUnionIndex(decoder, node->leaves(), &index));
+      return Skip(decoder, node->leafAt(index));
+    }
+    default:
+      return Status::Invalid("Unexpected Avro type ", ::avro::toString(node->type()));
+  }
+}
+
+Status CopyValue(::avro::Decoder* decoder, const ::avro::NodePtr& schema,
+                 std::string* out) {
+  if (schema->type() == ::avro::AVRO_SYMBOLIC) {
+    return CopyValue(decoder, ::avro::resolveSymbol(schema), out);
+  }
+  const ::avro::Node* node = schema.get();
+  switch (node->type()) {
+    case ::avro::AVRO_NULL:
+      decoder->decodeNull();
+      return Status::OK();
+    case ::avro::AVRO_BOOL:
+      out->push_back(decoder->decodeBool() ? 1 : 0);
+      return Status::OK();
+    case ::avro::AVRO_INT:
+    case ::avro::AVRO_LONG:
+      AppendLong(decoder->decodeLong(), out);
+      return Status::OK();
+    case ::avro::AVRO_ENUM:
+      AppendLong(static_cast<int64_t>(decoder->decodeEnum()), out);
+      return Status::OK();
+    // Avro encodes floating point values in little-endian order, as laid out in memory
+    case ::avro::AVRO_FLOAT:
+      AppendRaw(decoder->decodeFloat(), out);
+      return Status::OK();
+    case ::avro::AVRO_DOUBLE:
+      AppendRaw(decoder->decodeDouble(), out);
+      return Status::OK();
+    case ::avro::AVRO_BYTES:
+    case ::avro::AVRO_STRING: {
+      std::string value;
+      decoder->decodeString(value);
+      AppendLong(static_cast<int64_t>(value.size()), out);
+      out->append(value);
+      return Status::OK();
+    }
+    case ::avro::AVRO_FIXED: {
+      std::vector<uint8_t> value;
+      decoder->decodeFixed(node->fixedSize(), value);
+      out->append(value.begin(), value.end());
+      return Status::OK();
+    }
+    case ::avro::AVRO_RECORD:
+      for (size_t i = 0; i < node->leaves(); ++i) {
+        ICEBERG_RETURN_NOT_OK(CopyValue(decoder, node->leafAt(i), out));
+      }
+      return Status::OK();
+    case ::avro::AVRO_ARRAY:
+    case ::avro::AVRO_MAP: {
+      const bool is_map = node->type() == ::avro::AVRO_MAP;
+      const ::avro::NodePtr& items = node->leafAt(is_map ? 1 : 0);
+      const bool zero_width = !is_map && IsZeroWidth(items);
+      for (size_t n = is_map ? decoder->mapStart() : decoder->arrayStart(); n != 0;
+           n = is_map ? decoder->mapNext() : decoder->arrayNext()) {
+        AppendLong(static_cast<int64_t>(n), out);
+        for (size_t i = 0; i < n && !zero_width; ++i) {
+          if (is_map) {
+            ICEBERG_RETURN_NOT_OK(CopyValue(decoder, node->leafAt(0), out));
+          }
+          ICEBERG_RETURN_NOT_OK(CopyValue(decoder, items, out));
+        }
+      }
+      AppendLong(0, out);
+      return Status::OK();
+    }
+    case ::avro::AVRO_UNION: {
+      size_t index;
+      ICEBERG_RETURN_NOT_OK(ReadUnionIndex(decoder, node->leaves(), &index));
+      AppendLong(static_cast<int64_t>(index), out);
+      return CopyValue(decoder, node->leafAt(index), out);
+    }
+    default:
+      return Status::Invalid("Unexpected Avro type ", ::avro::toString(node->type()));
+  }
+}
+
+}  // namespace avro
+}  // namespace iceberg
@@ -0,0 +1,105 @@
+#include "iceberg/buffer.hh"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace iceberg {
+
+namespace {
+
+constexpr size_t kBufferAlignment = 64;
+
+// Zero-size allocations still get a valid, non-null address
+alignas(kBufferAlignment) uint8_t zero_size_area[1];
+
+/// \brief A mutable buffer owning memory allocated by AllocateBuffer
+class OwnedBuffer : public MutableBuffer {
+ public:
+  OwnedBuffer(uint8_t* data, int64_t size) : MutableBuffer(data, size) {}
+
+  ~OwnedBuffer() override {
+    if (size_ > 0) {
+      std::free(const_cast<uint8_t*>(data_));
+    }
+  }
+};
+
+/// \brief A buffer releasing its memory through a user-provided deallocator
+class DeallocatingBuffer : public Buffer {
+ public:
+  DeallocatingBuffer(const uint8_t* data, int64_t size, Deallocator deallocator)
+      : Buffer(data, size), deallocator_(std::move(deallocator)) {}
+
+  ~DeallocatingBuffer() override {
+    if (deallocator_) {
+      deallocator_(data_, size_);
+    }
+  }
+
+ private:
+  Deallocator deallocator_;
+};
+
+/// \brief A buffer owning a std::string
+class StringBuffer : public Buffer {
+ public:
+  explicit StringBuffer(std::string data)
+      : Buffer(nullptr, 0), data_string_(std::move(data)) {
+    data_ = reinterpret_cast<const uint8_t*>(data_string_.data());
+    size_ = static_cast<int64_t>(data_string_.size());
+  }
+
+ private:
+  std::string data_string_;
+};
+
+}  // namespace
+
+bool Buffer::Equals(const Buffer& other) const {
+  return size_ == other.size_ &&
+         (data_ == other.data_ || size_ == 0 ||
+          std::memcmp(data_, other.data_, static_cast<size_t>(size_)) == 0);
+}
+
+std::shared_ptr<Buffer> Buffer::FromOwnedMemory(const uint8_t* data, int64_t size,
+                                                Deallocator deallocator) {
+  return std::make_shared<DeallocatingBuffer>(data, size, std::move(deallocator));
+}
+
+std::shared_ptr<Buffer> Buffer::FromString(std::string data) {
+  return std::make_shared<StringBuffer>(std::move(data));
+}
+
+Result<std::shared_ptr<Buffer>> Buffer::CopyOf(std::string_view data) {
+  ICEBERG_ASSIGN_OR_RAISE(auto buffer, AllocateBuffer(static_cast<int64_t>(data.size())));
+  if (!data.empty()) {
+    std::memcpy(buffer->mutable_data(), data.data(), data.size());
+  }
+  return buffer;
+}
+
+Result<std::shared_ptr<Buffer>> AllocateBuffer(int64_t size) {
+  if (size < 0) {
+    return Status::Invalid("Negative buffer size: ", size);
+  }
+  if (size == 0) {
+    return std::make_shared<OwnedBuffer>(zero_size_area, 0);
+  }
+  void* data = nullptr;
+  if (posix_memalign(&data, kBufferAlignment, static_cast<size_t>(size)) != 0) {
+    return Status::OutOfMemory("Failed to allocate buffer of ", size, " bytes");
+  }
+  return std::make_shared<OwnedBuffer>(reinterpret_cast<uint8_t*>(data), size);
+}
+
+Result<std::shared_ptr<Buffer>> SliceBufferSafe(std::shared_ptr<Buffer> buffer,
+                                                int64_t offset, int64_t length) {
+  if (offset < 0 || length < 0 || offset > buffer->size() ||
+      length > buffer->size() - offset) {
+    return Status::Invalid("Slice [", offset, ", ", offset + length,
+                           ") out of bounds of buffer of size ", buffer->size());
+  }
+  return SliceBuffer(std::move(buffer), offset, length);
+}
+
+}  // namespace iceberg
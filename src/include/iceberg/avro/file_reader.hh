@@ -0,0 +1,110 @@
+#pragma once
+
+#include <avro/DataFile.hh>
+#include <avro/Decoder.hh>
+#include <avro/Stream.hh>
+#include <avro/ValidSchema.hh>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace avro {
+
+/// \brief Adapts an io::InputStream to the input streams of avro-cpp, reading it in
+/// chunks of a fixed size.
+///
+/// avro-cpp expects its streams to throw on errors: a failed read throws
+/// ::avro::Exception and records the Status of the failure in status(), which may be
+/// kept after avro-cpp destroyed the stream.
+class ICEBERG_EXPORT AvroInputStream : public ::avro::InputStream {
+ public:
+  AvroInputStream(std::shared_ptr<io::InputStream> stream, int64_t buffer_size);
+
+  bool next(const uint8_t** data, size_t* len) override;
+
+  void backup(size_t len) override;
+
+  void skip(size_t len) override;
+
+  size_t byteCount() const override { return byte_count_; }
+
+  /// \brief The error of the read that failed, or OK
+  std::shared_ptr<const Status> status() const { return status_; }
+
+ private:
+  // Throw the error of a failed read, keeping its status
+  [[noreturn]] void Fail(Status status);
+
+  std::shared_ptr<io::InputStream> stream_;
+  std::vector<uint8_t> buffer_;
+  // The bytes [pos_, size_) of the buffer are read from the stream but not consumed
+  size_t pos_ = 0;
+  size_t size_ = 0;
+  size_t byte_count_ = 0;
+  std::shared_ptr<Status> status_;
+};
+
+/// \brief Reads an Avro object container file with avro-cpp's DataFileReaderBase, one
+/// block at a time.
+///
+/// The objects are left to the caller to decode with the binary decoder of the block,
+/// typically by a reader specialized for the file's schema that pulls the fields it
+/// needs and skips the others, see projection.hh. Exceptions of avro-cpp are returned as
+/// Status.
+class ICEBERG_EXPORT FileReader {
+ public:
+  static constexpr int64_t kDefaultBufferSize = 256 * 1024;
+
+  /// \brief Decodes one object of the file
+  using DecodeFn = std::function<Status(::avro::Decoder* decoder)>;
+
+  ~FileReader();
+
+  /// \brief Open a reader on a stream positioned at the start of an Avro file and read
+  /// the file header
+  static Result<std::unique_ptr<FileReader>> Open(
+      std::shared_ptr<io::InputStream> stream, int64_t buffer_size = kDefaultBufferSize);
+
+  static Result<std::unique_ptr<FileReader>> Open(
+      const std::shared_ptr<io::InputFile>& file,
+      int64_t buffer_size = kDefaultBufferSize);
+
+  /// \brief The writer's schema, from the "avro.schema" metadata
+  const ::avro::ValidSchema& schema() const { return schema_; }
+
+  /// \brief Return the value of a key of the file metadata, if present
+  std::optional<std::string> metadata(const std::string& key) const;
+
+  /// \brief Decode the objects of the next non-empty block, calling `decode` once per
+  /// object. Return the number of objects, 0 at the end of the file.
+  Result<int64_t> ReadBlock(const DecodeFn& decode);
+
+  Status Close();
+
+ private:
+  FileReader(std::shared_ptr<io::InputStream> stream,
+             std::shared_ptr<const Status> read_status,
+             std::unique_ptr<::avro::DataFileReaderBase> base);
+
+  std::shared_ptr<io::InputStream> stream_;
+  // The status of the reads of stream_, whose adapter base_ owns
+  std::shared_ptr<const Status> read_status_;
+  std::unique_ptr<::avro::DataFileReaderBase> base_;
+  ::avro::ValidSchema schema_;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(FileReader);
+};
+
+}  // namespace avro
+}  // namespace iceberg
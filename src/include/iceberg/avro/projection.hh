@@ -0,0 +1,83 @@
+#pragma once
+
+#include <avro/Decoder.hh>
+#include <avro/Node.hh>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "iceberg/status.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace avro {
+
+/// \defgroup avro-projection Decoding projections of Avro data
+///
+/// Helpers for readers specialized for a writer's schema, which walk the schema of
+/// avro-cpp once to plan what to decode, then pull the fields they need from
+/// ::avro::Decoder and skip the others without materializing them as generic datums.
+///
+/// Errors of the decoder, such as truncated data, are thrown as ::avro::Exception and
+/// reported by FileReader::ReadBlock; the helpers return the errors they detect
+/// themselves.
+///
+/// @{
+
+/// \brief Return the named type a symbolic node refers to, or the node itself
+ICEBERG_EXPORT ::avro::NodePtr Resolve(const ::avro::NodePtr& schema);
+
+/// \brief Return the Iceberg field id of a field of a record, from its "field-id"
+/// attribute
+ICEBERG_EXPORT std::optional<int32_t> FieldId(const ::avro::NodePtr& record,
+                                              size_t index);
+
+/// \brief A schema with an optional union unwrapped: the schema of the non-null values,
+/// resolved, and the index of the null branch, or -1 if the values are required
+struct ICEBERG_EXPORT UnwrappedSchema {
+  ::avro::NodePtr node;
+  int null_index = -1;
+};
+
+/// \brief Unwrap a union of null and one other type, as Iceberg writes optional fields,
+/// or return a required schema as is
+ICEBERG_EXPORT UnwrappedSchema UnwrapOptional(const ::avro::NodePtr& schema);
+
+/// \brief Return whether the values of a schema are encoded in no bytes, such as nulls
+/// and records of nulls
+ICEBERG_EXPORT bool IsZeroWidth(const ::avro::NodePtr& schema);
+
+/// \brief Read the union branch of a value of an optional schema, if any, and set
+/// `*present` to whether the value is not null
+ICEBERG_EXPORT Status ReadPresence(::avro::Decoder* decoder,
+                                   const UnwrappedSchema& schema, bool* present);
+
+/// \brief Read a BOOLEAN, INT or LONG value of an optional schema; `*out` is left
+/// unchanged if the value is null
+ICEBERG_EXPORT Status ReadOptionalLong(::avro::Decoder* decoder,
+                                       const UnwrappedSchema& schema, bool* present,
+                                       int64_t* out);
+
+/// \brief Read a BYTES, STRING or FIXED value of an optional schema into `*out`
+ICEBERG_EXPORT Status ReadOptionalBytes(::avro::Decoder* decoder,
+                                        const UnwrappedSchema& schema, bool* present,
+                                        std::string* out);
+
+/// \brief Skip a value of a schema without decoding it.
+///
+/// Strings, bytes and fixed values are skipped without being copied, and arrays and
+/// maps written with byte sizes are skipped whole. Arrays of zero-width items are
+/// skipped by their block headers alone, so a corrupt count cannot make the walk run
+/// without consuming data.
+ICEBERG_EXPORT Status Skip(::avro::Decoder* decoder, const ::avro::NodePtr& schema);
+
+/// \brief Decode a value of a schema and append its Avro binary encoding to `out`, e.g.
+/// to keep a value to decode later
+ICEBERG_EXPORT Status CopyValue(::avro::Decoder* decoder, const ::avro::NodePtr& schema,
+                                std::string* out);
+
+/// @}
+
+}  // namespace avro
+}  // namespace iceberg
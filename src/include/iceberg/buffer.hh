@@ -0,0 +1,130 @@
+// Adapted from Apache Arrow
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "iceberg/result.hh"
+#include "iceberg/util/logging.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+
+/// \brief Object containing a pointer to a contiguous piece of immutable memory with a
+/// particular size.
+///
+/// Buffers are shared through std::shared_ptr and flow through the read and write paths
+/// without copies: streams may hold on to the buffers they are given, and readers may
+/// return buffers aliasing caches or memory mappings. A buffer may be a slice of a parent
+/// buffer, in which case it keeps the parent alive and the memory is released only when
+/// the last slice goes away. Memory from elsewhere, such as an arrow::Buffer, is adopted
+/// with FromOwnedMemory or Wrap.
+class ICEBERG_EXPORT Buffer {
+ public:
+  /// \brief Function releasing memory adopted by FromOwnedMemory
+  using Deallocator = std::function<void(const uint8_t* data, int64_t size)>;
+
+  /// \brief Construct a buffer over memory owned by someone else
+  ///
+  /// The caller is responsible for keeping the memory alive for the lifetime of the
+  /// buffer.
+  Buffer(const uint8_t* data, int64_t size) : data_(data), size_(size) {}
+
+  /// \brief Construct a buffer viewing `size` bytes of `parent` from `offset`
+  Buffer(std::shared_ptr<Buffer> parent, int64_t offset, int64_t size)
+      : data_(parent->data() + offset), size_(size), parent_(std::move(parent)) {}
+
+  virtual ~Buffer() = default;
+
+  /// \brief Return a pointer to the buffer's data
+  const uint8_t* data() const { return data_; }
+
+  /// \brief Return a writable pointer to the buffer's data
+  ///
+  /// Only valid for mutable buffers, such as those returned by AllocateBuffer.
+  uint8_t* mutable_data() {
+    ICEBERG_CHECK(is_mutable_) << "Buffer is not mutable";
+    return const_cast<uint8_t*>(data_);
+  }
+
+  /// \brief Return whether the buffer's data may be written to
+  bool is_mutable() const { return is_mutable_; }
+
+  /// \brief Return the buffer's size in bytes
+  int64_t size() const { return size_; }
+
+  /// \brief Return the parent buffer, if this buffer is a slice
+  const std::shared_ptr<Buffer>& parent() const { return parent_; }
+
+  /// \brief View the buffer's contents as a string_view, without copying
+  std::string_view ToStringView() const {
+    return std::string_view(reinterpret_cast<const char*>(data_),
+                            static_cast<size_t>(size_));
+  }
+
+  /// \brief Copy the buffer's contents into a std::string
+  std::string ToString() const { return std::string(ToStringView()); }
+
+  /// \brief Return whether both buffers hold the same bytes
+  bool Equals(const Buffer& other) const;
+
+  /// \brief Adopt `size` bytes at `data`, calling `deallocator` once the buffer and all
+  /// of its slices are gone
+  static std::shared_ptr<Buffer> FromOwnedMemory(const uint8_t* data, int64_t size,
+                                                 Deallocator deallocator);
+
+  /// \brief Adopt the memory of `owner`, e.g. an arrow::Buffer, keeping it alive for as
+  /// long as the returned buffer or any of its slices is
+  template <typename Owner>
+  static std::shared_ptr<Buffer> Wrap(const uint8_t* data, int64_t size,
+                                      std::shared_ptr<Owner> owner) {
+    return FromOwnedMemory(data, size,
+                           [owner = std::move(owner)](const uint8_t*, int64_t) {});
+  }
+
+  /// \brief Create a buffer taking over the contents of `data`, without copying
+  static std::shared_ptr<Buffer> FromString(std::string data);
+
+  /// \brief Create a buffer holding a copy of `data`
+  static Result<std::shared_ptr<Buffer>> CopyOf(std::string_view data);
+
+ protected:
+  bool is_mutable_ = false;
+  const uint8_t* data_;
+  int64_t size_;
+  std::shared_ptr<Buffer> parent_;
+
+ private:
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(Buffer);
+};
+
+/// \brief A Buffer whose contents may be written to
+class ICEBERG_EXPORT MutableBuffer : public Buffer {
+ public:
+  MutableBuffer(uint8_t* data, int64_t size) : Buffer(data, size) { is_mutable_ = true; }
+};
+
+/// \brief Allocate a mutable buffer of `size` bytes, aligned to 64 bytes
+///
+/// The contents are left uninitialized.
+ICEBERG_EXPORT Result<std::shared_ptr<Buffer>> AllocateBuffer(int64_t size);
+
+/// \brief Construct a view on a buffer at the given offset and length, without bounds
+/// checking.
+///
+/// The returned buffer keeps `buffer` alive.
+static inline std::shared_ptr<Buffer> SliceBuffer(std::shared_ptr<Buffer> buffer,
+                                                  int64_t offset, int64_t length) {
+  return std::make_shared<Buffer>(std::move(buffer), offset, length);
+}
+
+/// \brief Like SliceBuffer, but return an Invalid status if the slice is out of bounds
+ICEBERG_EXPORT Result<std::shared_ptr<Buffer>> SliceBufferSafe(
+    std::shared_ptr<Buffer> buffer, int64_t offset, int64_t length);
+
+}  // namespace iceberg
@@ -0,0 +1,151 @@
+// Adapted from Apache Arrow
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "iceberg/buffer.hh"
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+/// \brief An InputStream decorator that reads from the raw stream in large chunks.
+///
+/// Small reads, such as a decoder pulling varints and block markers one at a time, are
+/// served from the buffer instead of costing one call on the raw stream each. Reads at
+/// least as large as the buffer bypass it. Skips beyond the buffered bytes are handed to
+/// the raw stream's Advance, which seeks on seekable streams.
+class ICEBERG_EXPORT BufferedInputStream : public InputStream {
+ public:
+  ~BufferedInputStream() override;
+
+  /// \brief Create a buffered stream reading from `raw`
+  ///
+  /// \param[in] buffer_size the size of the chunks read from the raw stream
+  /// \param[in] raw the raw stream, positioned where reading should start
+  static Result<std::shared_ptr<BufferedInputStream>> Create(
+      int64_t buffer_size, std::shared_ptr<InputStream> raw);
+
+  Status Close() override;
+
+  Result<int64_t> Tell() const override;
+
+  bool closed() const override;
+
+  using InputStream::Read;
+  Result<int64_t> Read(int64_t nbytes, void* out) override;
+
+  Status Advance(int64_t nbytes) override;
+
+  /// \brief Return a view of the next `nbytes` without consuming them
+  ///
+  /// The view is shorter only at the end of the stream. The buffer grows if `nbytes`
+  /// exceeds the buffer size. The view is invalidated by the next call on this stream.
+  Result<std::string_view> Peek(int64_t nbytes);
+
+  /// \brief Return the number of bytes read from the raw stream but not yet consumed
+  int64_t bytes_buffered() const { return bytes_buffered_; }
+
+  /// \brief Return the size of the chunks read from the raw stream
+  int64_t buffer_size() const { return buffer_size_; }
+
+  /// \brief Return the raw stream
+  const std::shared_ptr<InputStream>& raw() const { return raw_; }
+
+ private:
+  BufferedInputStream(int64_t buffer_size, std::shared_ptr<InputStream> raw,
+                      std::shared_ptr<Buffer> buffer, int64_t raw_pos);
+
+  // Move the unconsumed bytes to the front and read from the raw stream until at least
+  // `nbytes` are buffered or the raw stream is exhausted
+  Status FillBuffer(int64_t nbytes);
+
+  Status CheckClosed() const;
+
+  int64_t buffer_size_;
+  std::shared_ptr<InputStream> raw_;
+  std::shared_ptr<Buffer> buffer_;
+  // Offset of the first unconsumed byte in buffer_
+  int64_t buffer_pos_ = 0;
+  int64_t bytes_buffered_ = 0;
+  // Position of the raw stream, i.e. just past the buffered bytes
+  int64_t raw_pos_;
+  bool closed_ = false;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(BufferedInputStream);
+};
+
+/// \brief A PositionOutputStream decorator that coalesces small writes.
+///
+/// Writes are copied into a buffer that is handed to the raw stream once full; writes at
+/// least as large as the buffer go straight through. The position is tracked here, so
+/// Tell does not reach the raw stream. Flush pushes the buffer to the raw stream and
+/// flushes it; Sync additionally asks the raw stream for durability.
+///
+/// Callers must Close the stream explicitly to learn whether the buffered data was
+/// written: the destructor closes a stream left open, but only logs a failure.
+class ICEBERG_EXPORT BufferedOutputStream : public PositionOutputStream {
+ public:
+  ~BufferedOutputStream() override;
+
+  /// \brief Create a buffered stream writing to `raw`
+  ///
+  /// \param[in] buffer_size the size of the chunks written to the raw stream
+  /// \param[in] raw the raw stream, positioned where writing should start
+  static Result<std::shared_ptr<BufferedOutputStream>> Create(
+      int64_t buffer_size, std::shared_ptr<OutputStream> raw);
+
+  Status Close() override;
+
+  Result<int64_t> Tell() const override;
+
+  bool closed() const override;
+
+  Status Write(const void* data, int64_t nbytes) override;
+
+  /// \brief Write a buffer, passing it on to the raw stream without copying if it is at
+  /// least as large as the buffer
+  Status Write(const std::shared_ptr<Buffer>& data) override;
+
+  using Writable::Write;
+
+  Status Flush() override;
+
+  Status Sync() override;
+
+  /// \brief Return the number of bytes written but not yet handed to the raw stream
+  int64_t bytes_buffered() const { return bytes_buffered_; }
+
+  /// \brief Return the size of the chunks written to the raw stream
+  int64_t buffer_size() const { return buffer_->size(); }
+
+  /// \brief Return the raw stream
+  const std::shared_ptr<OutputStream>& raw() const { return raw_; }
+
+ private:
+  BufferedOutputStream(std::shared_ptr<OutputStream> raw, std::shared_ptr<Buffer> buffer,
+                       int64_t raw_pos);
+
+  Status FlushBuffer();
+
+  Status CheckClosed() const;
+
+  std::shared_ptr<OutputStream> raw_;
+  std::shared_ptr<Buffer> buffer_;
+  int64_t bytes_buffered_ = 0;
+  // Position of the raw stream, i.e. just before the buffered bytes
+  int64_t raw_pos_;
+  bool closed_ = false;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(BufferedOutputStream);
+};
+
+}  // namespace io
+}  // namespace iceberg
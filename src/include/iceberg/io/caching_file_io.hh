@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "iceberg/buffer.hh"
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+struct ICEBERG_EXPORT BlockCacheOptions {
+  /// Size of the cached blocks. Reads are rounded out to whole blocks.
+  int64_t block_size = 1024 * 1024;
+  /// Memory budget of the cache, in bytes, split evenly across shards.
+  int64_t capacity = 256 * 1024 * 1024;
+  /// Number of independently locked shards.
+  int num_shards = 16;
+};
+
+/// \brief A sharded LRU cache of fixed-size file blocks keyed by (location, block index).
+///
+/// Each shard has its own lock and LRU list, so concurrent readers of different blocks
+/// rarely contend. Blocks are immutable buffers; a block evicted while a reader still
+/// holds it stays alive until the reader drops it. Each shard also indexes its blocks by
+/// location, so that Erase touches only the blocks of the erased file.
+///
+/// Readers missing the same block concurrently share a single fetch: the first one
+/// claims it through Claim and completes it through Complete, the others wait on it.
+class ICEBERG_EXPORT BlockCache {
+ public:
+  struct Stats {
+    int64_t hits;
+    int64_t misses;
+    int64_t evictions;
+  };
+
+  /// \brief A fetch of a missing block, shared by the readers missing it concurrently
+  class ICEBERG_EXPORT PendingBlock {
+   public:
+    /// \brief Wait for the block, or the error its fetch failed with
+    Result<std::shared_ptr<Buffer>> Wait();
+
+   private:
+    friend class BlockCache;
+
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::optional<Result<std::shared_ptr<Buffer>>> result_;
+  };
+
+  /// \brief The outcome of Claim: the cached block, or the fetch to wait on or perform
+  struct Claimed {
+    std::shared_ptr<Buffer> block;
+    std::shared_ptr<PendingBlock> pending;
+    /// Whether the caller must fetch the block and pass it to Complete
+    bool owner = false;
+  };
+
+  explicit BlockCache(BlockCacheOptions options = {});
+  ~BlockCache();
+
+  /// \brief Return the cached block, or nullptr on a miss
+  std::shared_ptr<Buffer> Lookup(const std::string& location, int64_t block_index);
+
+  /// \brief Insert or replace a block, evicting least recently used blocks of its shard
+  /// to stay within the shard's budget
+  void Insert(const std::string& location, int64_t block_index,
+              std::shared_ptr<Buffer> block);
+
+  /// \brief Return the cached block; on a miss, join the fetch of the block in flight or
+  /// start a new one, which the caller then owns
+  Claimed Claim(const std::string& location, int64_t block_index);
+
+  /// \brief Complete an owned fetch, caching the block unless the file was erased in the
+  /// meantime, and wake the readers waiting on it
+  void Complete(const std::string& location, int64_t block_index,
+                const std::shared_ptr<PendingBlock>& pending,
+                Result<std::shared_ptr<Buffer>> block);
+
+  /// \brief Drop every block of a file, and detach the fetches of its blocks in flight
+  void Erase(const std::string& location);
+
+  /// \brief Return the number of bytes currently cached
+  int64_t size() const;
+
+  Stats stats() const;
+
+  const BlockCacheOptions& options() const { return options_; }
+
+ private:
+  struct Shard;
+  Shard& ShardFor(const std::string& location, int64_t block_index);
+
+  BlockCacheOptions options_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<int64_t> hits_{0};
+  std::atomic<int64_t> misses_{0};
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(BlockCache);
+};
+
+/// \brief A FileIO decorator serving reads through a BlockCache.
+///
+/// Streams of the returned input files fetch whole blocks from the wrapped FileIO on a
+/// miss, reading runs of consecutive missing blocks with a single ReadAt, and may be
+/// shared across threads through ReadAt. Concurrent misses of a block, from any stream,
+/// issue one read of it. Writing or deleting a file through this FileIO
+/// drops its cached blocks. Since Iceberg files are immutable, nothing else invalidates
+/// the cache.
+class ICEBERG_EXPORT CachingFileIO : public FileIO {
+ public:
+  CachingFileIO(std::shared_ptr<FileIO> base, std::shared_ptr<BlockCache> cache)
+      : base_(std::move(base)), cache_(std::move(cache)) {}
+  CachingFileIO(std::shared_ptr<FileIO> base, BlockCacheOptions options = {})
+      : CachingFileIO(std::move(base), std::make_shared<BlockCache>(options)) {}
+
+  std::string name() const override { return "caching"; }
+
+  bool Equals(const FileIO& other) const override;
+
+  using FileIO::newInputFile;
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path) override;
+
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path,
+                                                  int64_t length) override;
+
+  Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) override;
+
+  Status DeleteFile(const std::string& path) override;
+
+  Result<DeleteFilesResult> DeleteFiles(const std::vector<std::string>& paths,
+                                        const DeleteFilesOptions& options = {}) override;
+
+  Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {}) override;
+
+  Status CopyFile(const std::string& src, const std::string& dst) override;
+
+  const std::shared_ptr<FileIO>& base() const { return base_; }
+
+  const std::shared_ptr<BlockCache>& cache() const { return cache_; }
+
+ private:
+  std::shared_ptr<FileIO> base_;
+  std::shared_ptr<BlockCache> cache_;
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(CachingFileIO);
+};
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "iceberg/buffer.hh"
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+/// \brief Suffix of the sidecar file holding the checksums of a file
+constexpr char kChecksumFileSuffix[] = ".crc";
+
+/// \brief The CRC32C checksums of a file, as stored in its sidecar.
+struct ICEBERG_EXPORT FileChecksums {
+  /// Length of the file
+  int64_t length = 0;
+  /// Size of the checksummed blocks, the last one possibly shorter, or 0 for a single
+  /// checksum of the whole file
+  int64_t block_size = 0;
+  /// One checksum per block
+  std::vector<uint32_t> crcs;
+
+  int64_t num_blocks() const { return static_cast<int64_t>(crcs.size()); }
+
+  /// \brief Return the sidecar contents, guarded by a checksum of their own
+  std::string Serialize() const;
+
+  static Result<FileChecksums> Deserialize(std::string_view data);
+};
+
+/// \brief Compute the checksums of a whole buffer
+ICEBERG_EXPORT FileChecksums ComputeChecksums(const void* data, int64_t length,
+                                              int64_t block_size);
+
+/// \brief A PositionOutputStream computing the checksums of the data written through
+/// it to a base stream.
+///
+/// Close closes the base stream, then writes the checksums to the sidecar file, if
+/// any, replacing an earlier one.
+class ICEBERG_EXPORT ChecksummingOutputStream : public PositionOutputStream {
+ public:
+  /// \brief Create a stream checksumming blocks of `block_size` bytes, or the file as a
+  /// whole for 0
+  static Result<std::shared_ptr<ChecksummingOutputStream>> Create(
+      std::shared_ptr<PositionOutputStream> base, int64_t block_size,
+      std::shared_ptr<OutputFile> sidecar = nullptr);
+
+  Status Close() override;
+
+  Result<int64_t> Tell() const override;
+
+  bool closed() const override;
+
+  using PositionOutputStream::Write;
+  Status Write(const void* data, int64_t nbytes) override;
+
+  Status Flush() override;
+
+  Status Sync() override;
+
+  /// \brief Return the checksums of the data written so far, up to the last full block
+  /// until the stream is closed
+  const FileChecksums& checksums() const { return checksums_; }
+
+ private:
+  ChecksummingOutputStream(std::shared_ptr<PositionOutputStream> base,
+                           int64_t block_size, std::shared_ptr<OutputFile> sidecar);
+
+  Status WriteSidecar();
+
+  Status CheckClosed() const;
+
+  std::shared_ptr<PositionOutputStream> base_;
+  std::shared_ptr<OutputFile> sidecar_;
+  FileChecksums checksums_;
+  // Checksum of the partial block written so far
+  uint32_t block_crc_ = 0;
+  int64_t block_filled_ = 0;
+  bool closed_ = false;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(ChecksummingOutputStream);
+};
+
+/// \brief A SeekableInputStream verifying the data read from a base stream against its
+/// checksums, failing reads of corrupted data with an IOError.
+///
+/// With per-block checksums, every read is verified: reads cover whole blocks of the
+/// base stream, verified before their requested part is handed out. Sequential reads
+/// keep the current block, so small reads cost one block read and check per block.
+/// Concurrent ReadAt calls are safe.
+///
+/// With a single checksum of the whole file, only data read sequentially from the start
+/// is verified, once the end of the file is read. Positional reads are not verified.
+class ICEBERG_EXPORT VerifyingInputStream : public SeekableInputStream {
+ public:
+  static Result<std::shared_ptr<VerifyingInputStream>> Create(
+      std::shared_ptr<SeekableInputStream> base, FileChecksums checksums);
+
+  Status Close() override;
+
+  Result<int64_t> Tell() const override;
+
+  bool closed() const override;
+
+  Status Seek(int64_t position) override;
+
+  using SeekableInputStream::Read;
+  Result<int64_t> Read(int64_t nbytes, void* out) override;
+
+  using SeekableInputStream::ReadAt;
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override;
+
+  const FileChecksums& checksums() const { return checksums_; }
+
+ private:
+  VerifyingInputStream(std::shared_ptr<SeekableInputStream> base,
+                       FileChecksums checksums);
+
+  int64_t BlockLength(int64_t block) const;
+
+  // Read `block` whole into `out` and verify it
+  Status ReadBlock(int64_t block, uint8_t* out) const;
+
+  Result<int64_t> ReadWholeFile(int64_t nbytes, void* out);
+
+  Status CheckClosed() const;
+
+  std::shared_ptr<SeekableInputStream> base_;
+  const FileChecksums checksums_;
+  int64_t position_ = 0;
+  // The block last read sequentially, if any
+  int64_t current_block_ = -1;
+  std::shared_ptr<Buffer> current_;
+  // With a whole file checksum: the checksum of the data read sequentially from the
+  // start, up to verified_length_
+  uint32_t running_crc_ = 0;
+  int64_t verified_length_ = 0;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(VerifyingInputStream);
+};
+
+struct ICEBERG_EXPORT ChecksumOptions {
+  /// Size of the blocks of new files checksummed independently, or 0 to checksum new
+  /// files as a whole. Smaller blocks let random reads verify less data beyond what
+  /// they need, at 4 bytes of sidecar per block.
+  int64_t block_size = 64 * 1024;
+  /// Fail to open input streams of files without a sidecar instead of reading them
+  /// unverified.
+  bool require_checksums = false;
+};
+
+/// \brief A FileIO decorator keeping CRC32C checksums of the files written through it
+/// in sidecar files, and verifying the files read against them.
+///
+/// The sidecar of a file is stored next to it, with kChecksumFileSuffix appended to its
+/// location. Listings leave sidecars out; deleting or copying a file deletes or copies
+/// its sidecar too. An input stream also fails if the file's length differs from the
+/// one recorded, catching truncation.
+class ICEBERG_EXPORT ChecksumFileIO : public FileIO {
+ public:
+  ChecksumFileIO(std::shared_ptr<FileIO> base, ChecksumOptions options = {})
+      : base_(std::move(base)), options_(options) {}
+
+  std::string name() const override { return "checksum"; }
+
+  bool Equals(const FileIO& other) const override;
+
+  using FileIO::newInputFile;
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path) override;
+
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path,
+                                                  int64_t length) override;
+
+  Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) override;
+
+  Status DeleteFile(const std::string& path) override;
+
+  Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {}) override;
+
+  Status CopyFile(const std::string& src, const std::string& dst) override;
+
+  const std::shared_ptr<FileIO>& base() const { return base_; }
+
+  const ChecksumOptions& options() const { return options_; }
+
+ private:
+  std::shared_ptr<FileIO> base_;
+  const ChecksumOptions options_;
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(ChecksumFileIO);
+};
+
+}  // namespace io
+}  // namespace iceberg
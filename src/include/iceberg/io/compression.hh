@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "iceberg/buffer.hh"
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace internal {
+class Compressor;
+class Decompressor;
+}  // namespace internal
+
+/// \brief Compression of whole files, such as metadata files.
+enum class CompressionCodec : int8_t {
+  NONE = 0,
+  GZIP,
+  /// Only available when built with ICEBERG_WITH_ZSTD
+  ZSTD,
+};
+
+/// \brief The table property choosing the codec of new metadata files
+constexpr char kMetadataCompressionProperty[] = "write.metadata.compression-codec";
+
+/// \brief Parse a codec name as used by kMetadataCompressionProperty: "none", "gzip" or
+/// "zstd", in any case
+ICEBERG_EXPORT Result<CompressionCodec> CompressionCodecFromName(std::string_view name);
+
+ICEBERG_EXPORT const char* CompressionCodecName(CompressionCodec codec);
+
+/// \brief Return the codec of a file from its name, e.g. GZIP for "v3.gz.metadata.json"
+/// or "v3.metadata.json.gz"
+ICEBERG_EXPORT CompressionCodec CompressionCodecFromPath(std::string_view path);
+
+/// \brief Return the extension marking files of a codec, e.g. ".gz", or an empty string
+ICEBERG_EXPORT const char* CompressionCodecExtension(CompressionCodec codec);
+
+/// \brief Return whether this build can compress and decompress with `codec`
+ICEBERG_EXPORT bool IsCompressionCodecAvailable(CompressionCodec codec);
+
+struct ICEBERG_EXPORT CompressionOptions {
+  /// Codec-specific compression level; the codec's default if unset.
+  std::optional<int> level;
+  /// Size of the compressed chunks read from, respectively written to, the raw stream.
+  int64_t buffer_size = 64 * 1024;
+};
+
+/// \brief An InputStream decompressing the data of a raw stream as it is read.
+///
+/// Compressed data is pulled from the raw stream one chunk at a time, so a parser
+/// reading from this stream never holds more than a chunk of the compressed file and
+/// its own read buffer. Concatenated gzip members and zstd frames are read as a single
+/// stream.
+class ICEBERG_EXPORT DecompressingInputStream : public InputStream {
+ public:
+  ~DecompressingInputStream() override;
+
+  /// \brief Create a stream decompressing the data read from `raw`
+  static Result<std::shared_ptr<DecompressingInputStream>> Create(
+      CompressionCodec codec, std::shared_ptr<InputStream> raw,
+      const CompressionOptions& options = {});
+
+  Status Close() override;
+
+  /// \brief Return the number of decompressed bytes read
+  Result<int64_t> Tell() const override;
+
+  bool closed() const override;
+
+  using InputStream::Read;
+  Result<int64_t> Read(int64_t nbytes, void* out) override;
+
+  /// \brief Return the raw stream
+  const std::shared_ptr<InputStream>& raw() const { return raw_; }
+
+ private:
+  DecompressingInputStream(std::shared_ptr<InputStream> raw,
+                           std::unique_ptr<internal::Decompressor> decompressor,
+                           int64_t buffer_size);
+
+  // Read the next chunk from the raw stream once the current one is consumed
+  Status FillInput();
+
+  Status CheckClosed() const;
+
+  std::shared_ptr<InputStream> raw_;
+  std::unique_ptr<internal::Decompressor> decompressor_;
+  const int64_t buffer_size_;
+  std::shared_ptr<Buffer> input_;
+  int64_t input_pos_ = 0;
+  bool raw_eof_ = false;
+  int64_t position_ = 0;
+  bool closed_ = false;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(DecompressingInputStream);
+};
+
+/// \brief A PositionOutputStream compressing the data written to it into a raw stream.
+///
+/// Compressed data is written to the raw stream in chunks of the buffer size. Flush
+/// emits a sync point, so that everything written so far can be decompressed. Close
+/// ends the compressed stream and closes the raw stream.
+class ICEBERG_EXPORT CompressingOutputStream : public PositionOutputStream {
+ public:
+  ~CompressingOutputStream() override;
+
+  /// \brief Create a stream compressing into `raw`
+  static Result<std::shared_ptr<CompressingOutputStream>> Create(
+      CompressionCodec codec, std::shared_ptr<OutputStream> raw,
+      const CompressionOptions& options = {});
+
+  Status Close() override;
+
+  /// \brief Return the number of uncompressed bytes written
+  Result<int64_t> Tell() const override;
+
+  bool closed() const override;
+
+  using PositionOutputStream::Write;
+  Status Write(const void* data, int64_t nbytes) override;
+
+  Status Flush() override;
+
+  Status Sync() override;
+
+  /// \brief Return the raw stream
+  const std::shared_ptr<OutputStream>& raw() const { return raw_; }
+
+ private:
+  CompressingOutputStream(std::shared_ptr<OutputStream> raw,
+                          std::unique_ptr<internal::Compressor> compressor,
+                          std::shared_ptr<Buffer> output);
+
+  // Write the compressed bytes buffered so far to the raw stream
+  Status WriteOutput();
+
+  // Emit a sync point, or end the compressed stream, writing out all compressed bytes
+  Status DrainCompressor(bool end);
+
+  Status CheckClosed() const;
+
+  std::shared_ptr<OutputStream> raw_;
+  std::unique_ptr<internal::Compressor> compressor_;
+  std::shared_ptr<Buffer> output_;
+  int64_t output_size_ = 0;
+  int64_t position_ = 0;
+  bool closed_ = false;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(CompressingOutputStream);
+};
+
+/// \brief Open a stream over the decompressed contents of `file`, with the codec given
+/// by its path. Uncompressed files are read as they are.
+ICEBERG_EXPORT Result<std::shared_ptr<InputStream>> OpenDecompressedStream(
+    const std::shared_ptr<InputFile>& file, const CompressionOptions& options = {});
+
+/// \brief Wrap `raw` into a stream compressing with `codec`, or return it as it is for
+/// CompressionCodec::NONE
+ICEBERG_EXPORT Result<std::shared_ptr<PositionOutputStream>> MaybeCompress(
+    CompressionCodec codec, std::shared_ptr<PositionOutputStream> raw,
+    const CompressionOptions& options = {});
+
+}  // namespace io
+}  // namespace iceberg
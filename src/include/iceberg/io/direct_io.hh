@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "iceberg/buffer.hh"
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+/// \brief Options of the direct I/O streams.
+struct ICEBERG_EXPORT DirectIOOptions {
+  /// Alignment of file offsets, sizes and memory required by the device, typically its
+  /// logical block size. Must be a power of two.
+  int64_t alignment = 4096;
+  /// Size of the aligned buffers, a multiple of the alignment. Writes reach the file in
+  /// chunks of this size; reads of unaligned ranges go through such buffers.
+  int64_t buffer_size = 1024 * 1024;
+};
+
+/// \brief A PositionOutputStream writing to a file opened with O_DIRECT, bypassing the
+/// page cache.
+///
+/// Writes are collected in an aligned buffer from a shared pool and written out whenever
+/// a full buffer is ready. The unaligned tail of the file is written on Close, Sync and
+/// Flush with O_DIRECT cleared, since direct I/O cannot write partial blocks. If the
+/// file system rejects direct I/O, the stream falls back to regular writes.
+class ICEBERG_EXPORT DirectFileOutputStream : public PositionOutputStream {
+ public:
+  /// \brief Create a stream writing from the start of `fd`, which should have been
+  /// opened with O_DIRECT. The stream takes ownership of the descriptor.
+  static Result<std::shared_ptr<DirectFileOutputStream>> Create(
+      int fd, DirectIOOptions options = {});
+
+  ~DirectFileOutputStream() override;
+
+  Status Close() override;
+
+  Result<int64_t> Tell() const override;
+
+  using PositionOutputStream::Write;
+  Status Write(const void* data, int64_t nbytes) override;
+
+  /// \brief Write out the buffered bytes, the unaligned tail included
+  Status Flush() override;
+
+  Status Sync() override;
+
+  bool closed() const override;
+
+ private:
+  DirectFileOutputStream(int fd, DirectIOOptions options, std::shared_ptr<Buffer> buffer);
+
+  // Write the whole blocks of the buffer and move the remaining bytes to its front
+  Status WriteBlocks();
+
+  // Write the bytes of the buffer past the whole blocks without O_DIRECT, leaving
+  // them buffered so that the block is written again once complete
+  Status WriteTail();
+
+  Status PositionedWrite(const uint8_t* data, int64_t nbytes, int64_t position);
+
+  Status CheckClosed() const;
+
+  int fd_;
+  const DirectIOOptions options_;
+  std::shared_ptr<Buffer> buffer_;
+  int64_t buffered_ = 0;
+  // File offset of the start of the buffer, always aligned
+  int64_t buffer_offset_ = 0;
+  bool direct_ = true;
+  bool closed_ = false;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(DirectFileOutputStream);
+};
+
+/// \brief A SeekableInputStream reading a file opened with O_DIRECT, bypassing the page
+/// cache.
+///
+/// Aligned reads into aligned memory go straight to the file; other reads are widened
+/// to whole blocks through pooled aligned buffers. ReadAt is thread-safe.
+class ICEBERG_EXPORT DirectFileInputStream : public SeekableInputStream {
+ public:
+  /// \brief Create a stream over `fd`, which should have been opened with O_DIRECT. The
+  /// stream takes ownership of the descriptor.
+  explicit DirectFileInputStream(int fd, DirectIOOptions options = {})
+      : fd_(fd), options_(options) {}
+
+  ~DirectFileInputStream() override;
+
+  Status Close() override;
+
+  Result<int64_t> Tell() const override;
+
+  bool closed() const override;
+
+  Status Seek(int64_t position) override;
+
+  using SeekableInputStream::Read;
+  Result<int64_t> Read(int64_t nbytes, void* out) override;
+
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override;
+
+  /// \brief Read the enclosing blocks into an aligned buffer and return a slice of it
+  Result<std::shared_ptr<Buffer>> ReadAt(int64_t position, int64_t nbytes) override;
+
+ private:
+  // Read whole blocks starting at aligned `position` into aligned `out`
+  Result<int64_t> ReadBlocks(int64_t position, int64_t nbytes, uint8_t* out);
+
+  Status CheckClosed() const;
+
+  int fd_;
+  const DirectIOOptions options_;
+  int64_t position_ = 0;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(DirectFileInputStream);
+};
+
+namespace internal {
+
+/// \brief Return a mutable buffer of `size` bytes aligned to `alignment`, recycling the
+/// memory of released buffers of the same shape.
+ICEBERG_EXPORT Result<std::shared_ptr<Buffer>> AllocateAlignedBuffer(int64_t size,
+                                                                     int64_t alignment);
+
+/// \brief Return whether the direct I/O options are usable
+ICEBERG_EXPORT Status ValidateDirectIOOptions(const DirectIOOptions& options);
+
+/// \brief Open `path` with O_DIRECT if `*direct` and the file system supports it,
+/// otherwise normally, and set `*direct` to whether O_DIRECT was applied
+///
+/// \return the file descriptor, or -1 with errno set
+ICEBERG_EXPORT int OpenMaybeDirect(const std::string& path, int flags, bool* direct);
+
+/// \brief Make OpenMaybeDirect behave as on a file system without direct I/O support,
+/// for tests
+ICEBERG_EXPORT void SimulateDirectIOUnsupported(bool unsupported);
+
+}  // namespace internal
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "iceberg/buffer.hh"
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+/// \brief Which missed blocks a DiskCache stores.
+enum class CacheAdmission : int8_t {
+  /// Every block read on a miss.
+  ALL,
+  /// Blocks missed a second time while still remembered among the recent misses, so
+  /// that one-off scans do not flush the blocks read over and over.
+  SECOND_ACCESS,
+};
+
+/// \brief Which blocks a full DiskCache drops first.
+enum class CacheEviction : int8_t {
+  /// The least recently read.
+  LRU,
+  /// The least recently stored.
+  FIFO,
+};
+
+struct ICEBERG_EXPORT DiskCacheOptions {
+  /// Directory holding the cache, created if missing. Only one DiskCache at a time may
+  /// use a directory.
+  std::string directory;
+  /// Size of the cached blocks. Reads are rounded out to whole blocks.
+  int64_t block_size = 1024 * 1024;
+  /// Disk budget of the cached blocks, in bytes.
+  int64_t capacity = 16LL * 1024 * 1024 * 1024;
+  CacheAdmission admission = CacheAdmission::ALL;
+  /// Number of recent misses remembered by CacheAdmission::SECOND_ACCESS.
+  int64_t admission_window = 100000;
+  CacheEviction eviction = CacheEviction::LRU;
+  /// Verify the checksum of each block read from the cache, turning blocks torn by a
+  /// crash or corrupted on disk into misses.
+  bool verify_checksums = true;
+  /// Bound on the bytes of blocks queued by InsertAsync and not yet written; blocks
+  /// beyond it are not cached.
+  int64_t max_pending_bytes = 256 * 1024 * 1024;
+};
+
+/// \brief A cache of fixed-size file blocks, keyed by (location, block index), stored
+/// in a directory on a local disk and kept across process restarts.
+///
+/// Blocks live in slots of a preallocated data file. An index log records which block
+/// each slot holds, appended to as blocks are stored or erased and rewritten compactly
+/// when the cache is opened. Blocks are written before their index record, and the
+/// record carries the block's checksum, so a crash at any point loses at most the
+/// blocks being stored. Reopening a cache with another block size or capacity starts
+/// it over empty.
+///
+/// All methods are thread-safe; disk I/O happens outside of the cache's lock, and a
+/// slot being read is not reused until the read completes. Index records are appended
+/// under a lock of their own, and a slot dropped from the cache is only reused once the
+/// record of its erasure is synced.
+class ICEBERG_EXPORT DiskCache {
+ public:
+  struct Stats {
+    int64_t hits;
+    int64_t misses;
+    int64_t insertions;
+    /// Blocks not stored, by the admission policy or for lack of room
+    int64_t rejections;
+    int64_t evictions;
+    /// Blocks found corrupted on disk
+    int64_t corruptions;
+  };
+
+  /// \brief Open the cache in `options.directory`, with the blocks stored there before
+  static Result<std::shared_ptr<DiskCache>> Open(DiskCacheOptions options);
+
+  ~DiskCache();
+
+  /// \brief Return the cached block, or nullptr on a miss
+  Result<std::shared_ptr<Buffer>> Lookup(const std::string& location,
+                                         int64_t block_index);
+
+  /// \brief Store a block, subject to the admission policy, evicting another one if
+  /// the cache is full
+  Status Insert(const std::string& location, int64_t block_index, const Buffer& block);
+
+  /// \brief Store a block on the I/O thread pool, without waiting for it. The cache
+  /// waits for such pending blocks when destroyed.
+  void InsertAsync(const std::string& location, int64_t block_index,
+                   std::shared_ptr<Buffer> block);
+
+  /// \brief Wait until the blocks queued by InsertAsync are stored or dropped
+  void WaitForPendingInserts();
+
+  /// \brief Drop every block of a file
+  Status Erase(const std::string& location);
+
+  /// \brief Return the number of bytes of the cached blocks
+  int64_t size() const;
+
+  /// \brief Return the number of cached blocks
+  int64_t num_blocks() const;
+
+  Stats stats() const;
+
+  const DiskCacheOptions& options() const { return options_; }
+
+ private:
+  enum class SlotState : int8_t { FREE, PENDING, USED };
+
+  struct Slot {
+    SlotState state = SlotState::FREE;
+    std::string location;
+    int64_t block_index = 0;
+    int64_t size = 0;
+    uint32_t crc = 0;
+    // Lookups reading the slot, which keep it from being reused
+    int readers = 0;
+    // Whether the file of the block being stored in the slot was erased meanwhile
+    bool erased = false;
+    std::list<uint32_t>::iterator lru;
+  };
+
+  explicit DiskCache(DiskCacheOptions options);
+
+  // Load the index log, or start over if it is missing or of another configuration,
+  // then rewrite it compactly
+  Status Load();
+
+  Status Reset();
+
+  // Return an index with a record per cached block, oldest first
+  std::string EncodeIndexLocked() const;
+
+  // Replace the index log with `index`, holding `num_records` records. Needs
+  // index_mutex_.
+  Status RewriteIndexLocked(const std::string& index, int64_t num_records);
+
+  // Append `num_records` records to the index log, compacting it first if superseded
+  // records piled up, and sync them if `sync`. Needs index_mutex_, but not mutex_.
+  Status AppendIndexLocked(const std::string& records, int64_t num_records, bool sync);
+
+  Status AppendIndex(const std::string& records, int64_t num_records, bool sync);
+
+  void UseLocked(uint32_t slot, const std::string& location, int64_t block_index,
+                 int64_t size, uint32_t crc);
+
+  void FreeLocked(uint32_t slot);
+
+  // Drop the block in the slot, but keep the slot out of use until ReleaseLocked, once
+  // the erasure is recorded in the index
+  void RetireLocked(uint32_t slot);
+
+  void ReleaseLocked(uint32_t slot);
+
+  // Return a free slot, or a slot retired from an evicted block, setting `evicted`, or
+  // -1 if all slots are busy
+  int64_t TakeSlotLocked(bool* evicted);
+
+  // Release retired slots once their erase records are synced, or keep them out of use
+  // until the index is rewritten on the next open
+  Status ReleaseRetired(const std::vector<uint32_t>& slots);
+
+  bool AdmitLocked(const std::string& location, int64_t block_index);
+
+  void Unpin(uint32_t slot);
+
+  const DiskCacheOptions options_;
+  const int64_t num_slots_;
+  int lock_fd_ = -1;
+  int data_fd_ = -1;
+  int index_fd_ = -1;
+
+  // Serializes the writes to the index log; taken before mutex_ when both are held
+  std::mutex index_mutex_;
+  int64_t index_records_ = 0;
+
+  mutable std::mutex mutex_;
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> free_;
+  // Used slots, most recently used first
+  std::list<uint32_t> lru_;
+  // Location to block index to slot
+  std::unordered_map<std::string, std::unordered_map<int64_t, uint32_t>> files_;
+  // Recent misses, for CacheAdmission::SECOND_ACCESS
+  std::unordered_set<size_t> recent_misses_;
+  int64_t size_ = 0;
+  // Slots of the blocks being stored, by location, so that Erase can flag them and
+  // blocks read before it are not stored after it
+  std::unordered_map<std::string, std::unordered_set<uint32_t>> inserting_;
+  Stats stats_{};
+
+  std::mutex pending_mutex_;
+  std::condition_variable pending_cv_;
+  int64_t pending_bytes_ = 0;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(DiskCache);
+};
+
+/// \brief A FileIO decorator serving reads through a DiskCache, typically on a local
+/// SSD in front of remote or otherwise slow storage.
+///
+/// Streams fetch whole blocks from the wrapped FileIO on a miss, reading runs of
+/// consecutive missing blocks with a single ReadAt, and store them in the cache in the
+/// background. Writing or deleting a file through this FileIO drops its cached blocks.
+/// Since Iceberg files are immutable, nothing else invalidates the cache.
+class ICEBERG_EXPORT DiskCachingFileIO : public FileIO {
+ public:
+  DiskCachingFileIO(std::shared_ptr<FileIO> base, std::shared_ptr<DiskCache> cache)
+      : base_(std::move(base)), cache_(std::move(cache)) {}
+
+  std::string name() const override { return "disk-caching"; }
+
+  bool Equals(const FileIO& other) const override;
+
+  using FileIO::newInputFile;
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path) override;
+
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path,
+                                                  int64_t length) override;
+
+  Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) override;
+
+  Status DeleteFile(const std::string& path) override;
+
+  Result<DeleteFilesResult> DeleteFiles(const std::vector<std::string>& paths,
+                                        const DeleteFilesOptions& options = {}) override;
+
+  Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {}) override;
+
+  Status CopyFile(const std::string& src, const std::string& dst) override;
+
+  const std::shared_ptr<FileIO>& base() const { return base_; }
+
+  const std::shared_ptr<DiskCache>& cache() const { return cache_; }
+
+ private:
+  std::shared_ptr<FileIO> base_;
+  std::shared_ptr<DiskCache> cache_;
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(DiskCachingFileIO);
+};
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace internal {
+class StorageEmulator;
+}  // namespace internal
+
+/// \brief How the first-byte latency of each request is drawn.
+enum class LatencyDistribution : int8_t {
+  /// Always exactly `first_byte_latency`
+  FIXED,
+  /// Uniform between zero and twice `first_byte_latency`
+  UNIFORM,
+  /// Log-normal with median `first_byte_latency` and shape `latency_sigma`, giving the
+  /// long tail typical of object stores
+  LOG_NORMAL,
+};
+
+/// \brief Characteristics of the remote storage emulated by EmulatedFileIO.
+///
+/// Zero leaves the corresponding limit out.
+struct ICEBERG_EXPORT EmulatedStorageOptions {
+  /// Delay before the first byte of each data request, i.e. each ReadAt and the first
+  /// Read after opening or seeking a stream, and before an upload completes.
+  std::chrono::microseconds first_byte_latency{0};
+  LatencyDistribution latency_distribution = LatencyDistribution::FIXED;
+  double latency_sigma = 0.5;
+  /// Fixed cost of every request, including metadata requests such as getting the
+  /// length of a file, deleting it or listing a batch of files.
+  std::chrono::microseconds request_overhead{0};
+  /// Bytes per second read, respectively written, across all files of the FileIO.
+  int64_t read_bandwidth = 0;
+  int64_t write_bandwidth = 0;
+  /// Requests per second admitted across all files of the FileIO.
+  double max_requests_per_second = 0;
+  /// Seed of the latency distribution, so that runs can be repeated.
+  uint64_t seed = 42;
+};
+
+/// \brief Request and byte counts of an EmulatedFileIO.
+struct ICEBERG_EXPORT EmulatedStorageStats {
+  int64_t requests;
+  int64_t bytes_read;
+  int64_t bytes_written;
+  /// Most data requests ever paying their first-byte latency at once, which shows
+  /// whether concurrent reads overlapped their latencies
+  int64_t max_overlapping_requests;
+};
+
+/// \brief A FileIO decorator adding the latency, bandwidth and request-rate limits of a
+/// remote object store to a local FileIO.
+///
+/// It makes read coalescing, prefetching and caching measurable on a local disk. Each
+/// ReadAt is charged as one ranged GET request, so ReadAtAsync and ReadRanges overlap
+/// their latencies as they would against a real store.
+class ICEBERG_EXPORT EmulatedFileIO : public FileIO {
+ public:
+  EmulatedFileIO(std::shared_ptr<FileIO> base, EmulatedStorageOptions options);
+  ~EmulatedFileIO() override;
+
+  std::string name() const override { return "emulated"; }
+
+  bool Equals(const FileIO& other) const override;
+
+  using FileIO::newInputFile;
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path) override;
+
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path,
+                                                  int64_t length) override;
+
+  Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) override;
+
+  Status DeleteFile(const std::string& path) override;
+
+  Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {}) override;
+
+  /// \brief Copy within the base FileIO, charged as a single server-side copy request
+  Status CopyFile(const std::string& src, const std::string& dst) override;
+
+  EmulatedStorageStats stats() const;
+
+  const std::shared_ptr<FileIO>& base() const { return base_; }
+
+ private:
+  std::shared_ptr<FileIO> base_;
+  std::shared_ptr<internal::StorageEmulator> emulator_;
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(EmulatedFileIO);
+};
+
+}  // namespace io
+}  // namespace iceberg
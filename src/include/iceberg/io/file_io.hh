@@ -1,8 +1,13 @@
 #pragma once
 
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "iceberg/buffer.hh"
 #include "iceberg/result.hh"
 #include "iceberg/status.hh"
 #include "iceberg/util/compare.hh"
@@ -42,6 +47,75 @@ struct ICEBERG_EXPORT FileInfo : public util::EqualityComparable<FileInfo> {
   int64_t createdAtMillis_;
 };
 
+/// \brief A contiguous byte range of a file
+struct ICEBERG_EXPORT ReadRange : public util::EqualityComparable<ReadRange> {
+  ReadRange() = default;
+  ReadRange(int64_t offset, int64_t length) : offset(offset), length(length) {}
+
+  int64_t offset = 0;
+  int64_t length = 0;
+
+  bool Equals(const ReadRange& other) const {
+    return offset == other.offset && length == other.length;
+  }
+
+  /// \brief Return whether `other` lies entirely within this range
+  bool Contains(const ReadRange& other) const {
+    return offset <= other.offset && other.offset + other.length <= offset + length;
+  }
+};
+
+/// \brief Options for merging nearby ranges of a vectored read into fewer, larger reads
+struct ICEBERG_EXPORT CoalesceOptions {
+  /// Ranges separated by a hole of at most this many bytes are read together; the bytes
+  /// in the hole are read and discarded. Trade this off against the per-read cost of the
+  /// storage: a few KiB for local disks, much more for object stores.
+  int64_t hole_size_limit = 8192;
+  /// Stop merging once a read would grow beyond this many bytes. Overlapping ranges are
+  /// always merged.
+  int64_t range_size_limit = 32 * 1024 * 1024;
+};
+
+/// \brief Options for FileIO::ListPrefix.
+struct ICEBERG_EXPORT ListPrefixOptions {
+  /// Maximum number of directories or entries being listed at once.
+  int parallelism = 8;
+  /// Maximum number of files in one batch returned by FileInfoIterator::Next.
+  int64_t batch_size = 1000;
+};
+
+/// \brief A stream of FileInfo batches returned by FileIO::ListPrefix.
+///
+/// The listing may proceed in the background while batches are consumed; destroying the
+/// iterator stops it.
+class ICEBERG_EXPORT FileInfoIterator {
+ public:
+  virtual ~FileInfoIterator() = default;
+
+  /// \brief Return the next batch of files, in no particular order, or an empty batch
+  /// once the listing is exhausted.
+  virtual Result<std::vector<FileInfo>> Next() = 0;
+};
+
+/// \brief Options for FileIO::DeleteFiles.
+struct ICEBERG_EXPORT DeleteFilesOptions {
+  /// Maximum number of deletions in flight.
+  int parallelism = 16;
+  /// If set, called after each path is handled with the number of paths handled so far
+  /// and the total. Calls are serialized but may come from any thread.
+  std::function<void(int64_t completed, int64_t total)> progress;
+};
+
+/// \brief The outcome of FileIO::DeleteFiles.
+struct ICEBERG_EXPORT DeleteFilesResult {
+  /// Number of paths deleted successfully.
+  int64_t num_deleted = 0;
+  /// Paths that could not be deleted along with the reason, in input order.
+  std::vector<std::pair<std::string, Status>> failures;
+
+  bool ok() const { return failures.empty(); }
+};
+
 class ICEBERG_EXPORT FileInterface {
  public:
   virtual ~FileInterface() = 0;
@@ -80,13 +154,27 @@ class ICEBERG_EXPORT Writable {
   /// This method always processes the bytes in full. Depending on the semantics of the
   /// stream, the data may be written out immediately, held in buffer, or written
   /// asynchronously. In the case where the stream buffers the data, it will be copied. To
-  /// avoid potentially large copies, consider using a Write variant takes an owned
+  /// avoid potentially large copies, consider using the Write variant taking an owned
   /// Buffer.
   virtual Status Write(const void* data, int64_t nbytes) = 0;
 
+  /// \brief Write the given buffer to the stream
+  ///
+  /// The stream may keep a reference to the buffer instead of copying its contents. The
+  /// default implementation writes the bytes as the raw pointer variant does.
+  virtual Status Write(const std::shared_ptr<Buffer>& data);
+
   /// \brief Flush buffered bytes, if any
+  ///
+  /// Flushed bytes are handed to the underlying storage, e.g. the operating system for
+  /// local files, but are not necessarily durable; see Sync.
   virtual Status Flush();
 
+  /// \brief Flush buffered bytes and make everything written so far durable
+  ///
+  /// The default implementation only flushes.
+  virtual Status Sync();
+
   Status Write(std::string_view data);
 };
 
@@ -99,6 +187,13 @@ class ICEBERG_EXPORT Readable {
   /// Read at most `nbytes` from the current stream position into `out`.
   /// The number of bytes read is returned.
   virtual Result<int64_t> Read(int64_t nbytes, void* out) = 0;
+
+  /// \brief Read data from current stream position into a buffer.
+  ///
+  /// Read at most `nbytes` from the current stream position. Streams backed by memory
+  /// may return a buffer aliasing that memory; the default implementation allocates a
+  /// buffer and copies into it.
+  virtual Result<std::shared_ptr<Buffer>> Read(int64_t nbytes);
 };
 
 class ICEBERG_EXPORT OutputStream : virtual public FileInterface, public Writable {
@@ -111,7 +206,10 @@ class ICEBERG_EXPORT InputStream : virtual public FileInterface, public Readable
   virtual ~InputStream() = default;
 
   /// \brief Advance or skip stream indicated number of bytes
-  Status Advance(int64_t nbytes);
+  ///
+  /// The default implementation reads and discards the bytes through a small scratch
+  /// buffer; seekable streams seek instead.
+  virtual Status Advance(int64_t nbytes);
 
  protected:
   InputStream() = default;
@@ -124,6 +222,39 @@ class ICEBERG_EXPORT SeekableInputStream : public InputStream, public Seekable {
  public:
   virtual ~SeekableInputStream() = default;
 
+  /// \brief Skip bytes by seeking past them
+  Status Advance(int64_t nbytes) override;
+
+  /// \brief Read data from the given position, without moving the stream position.
+  ///
+  /// Read at most `nbytes` starting at `position` into `out`. The number of bytes read
+  /// is returned. Implementations should make this method safe to call from several
+  /// threads at once; the default implementation goes through Seek and Read and is not.
+  virtual Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out);
+
+  /// \brief Read data from the given position into a buffer, without moving the stream
+  /// position.
+  ///
+  /// As ReadAt, but return a buffer that may alias memory held by the stream.
+  virtual Result<std::shared_ptr<Buffer>> ReadAt(int64_t position, int64_t nbytes);
+
+  /// \brief Start reading data from the given position without waiting for it.
+  ///
+  /// The future resolves to the number of bytes read, as ReadAt would return. The stream
+  /// and `out` must stay alive until then. Several reads may be in flight at once. The
+  /// default implementation runs ReadAt on the I/O thread pool.
+  virtual std::future<Result<int64_t>> ReadAtAsync(int64_t position, int64_t nbytes,
+                                                   void* out);
+
+  /// \brief Read several byte ranges, returning one buffer per requested range.
+  ///
+  /// Nearby and overlapping ranges are coalesced according to `options` and the merged
+  /// reads are issued concurrently through ReadAtAsync; the returned buffers are slices
+  /// of the merged reads. A buffer is shorter than its range if the range extends past
+  /// the end of the file. The stream position is not moved.
+  virtual Result<std::vector<std::shared_ptr<Buffer>>> ReadRanges(
+      const std::vector<ReadRange>& ranges, const CoalesceOptions& options = {});
+
  protected:
   SeekableInputStream() = default;
 };
@@ -149,6 +280,10 @@ class ICEBERG_EXPORT InputFile {
   /// \brief Open a new SeekableInputStream for the underlying data file
   virtual Result<std::shared_ptr<io::SeekableInputStream>> newStream() = 0;
 
+  /// \brief Read several byte ranges of the file, see SeekableInputStream::ReadRanges
+  virtual Result<std::vector<std::shared_ptr<Buffer>>> ReadRanges(
+      const std::vector<ReadRange>& ranges, const CoalesceOptions& options = {});
+
   /// \brief Return fully-qualified location of the input file as a string
   const std::string& location() const { return location_; };
 
@@ -218,6 +353,12 @@ class ICEBERG_EXPORT FileIO : public std::enable_shared_from_this<FileIO>,
     return newInputFile(path);
   }
 
+  /// \brief Get an InputFile instance for a file described by a FileInfo, e.g. one
+  /// returned by a listing, so that its size need not be looked up again.
+  Result<std::shared_ptr<InputFile>> newInputFile(const FileInfo& info) {
+    return newInputFile(info.location(), info.size());
+  }
+
   /// \brief Get an OutputFile instance to write bytes to the file at the given path.
   virtual Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) = 0;
 
@@ -226,6 +367,28 @@ class ICEBERG_EXPORT FileIO : public std::enable_shared_from_this<FileIO>,
   Status DeleteFile(const InputFile& file) { return DeleteFile(file.location()); }
   Status DeleteFile(const OutputFile& file) { return DeleteFile(file.location()); }
 
+  /// \brief Delete many files, running up to `options.parallelism` deletions at once.
+  ///
+  /// A failure to delete one path does not stop the others; it is reported in the
+  /// result instead. Return an error status only for invalid options. The default
+  /// implementation calls DeleteFile for each path.
+  virtual Result<DeleteFilesResult> DeleteFiles(const std::vector<std::string>& paths,
+                                                const DeleteFilesOptions& options = {});
+
+  /// \brief List the files whose location starts with `prefix`, recursively.
+  ///
+  /// Only files are returned, not directories. The default implementation returns
+  /// NotImplemented.
+  virtual Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {});
+
+  /// \brief Copy the file at `src` to `dst`, which must not exist yet.
+  ///
+  /// Implementations should copy on the storage side where it can, without moving the
+  /// data through this process. The default implementation streams the contents from
+  /// newInputFile to newOutputFile and deletes `dst` if the copy fails.
+  virtual Status CopyFile(const std::string& src, const std::string& dst);
+
  protected:
   explicit FileIO() {}
 };
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+/// \brief Batches Sync requests from concurrent writers into group commits.
+///
+/// While one batch of streams is being synced, further Sync requests accumulate in the
+/// next batch. The first writer of a batch leads it: it optionally waits `max_delay` for
+/// more writers to join, then syncs every stream of the batch concurrently, each once no
+/// matter how many writers asked, and hands each writer the result for its stream. A
+/// burst of N writers thus costs about two sync latencies instead of N.
+class ICEBERG_EXPORT GroupCommitter {
+ public:
+  explicit GroupCommitter(
+      std::chrono::microseconds max_delay = std::chrono::microseconds::zero());
+  ~GroupCommitter();
+
+  /// \brief Make everything written to `stream` so far durable
+  ///
+  /// Block until a batch containing `stream` has been synced and return its result.
+  Status Sync(const std::shared_ptr<OutputStream>& stream);
+
+  /// \brief Return the number of batches synced so far
+  int64_t num_batches() const;
+
+ private:
+  struct Batch;
+
+  const std::chrono::microseconds max_delay_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  // The batch accepting new requests, if any
+  std::shared_ptr<Batch> pending_;
+  bool leader_active_ = false;
+  int64_t num_batches_ = 0;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(GroupCommitter);
+};
+
+}  // namespace io
+}  // namespace iceberg
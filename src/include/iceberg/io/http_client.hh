@@ -0,0 +1,120 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+struct ICEBERG_EXPORT HttpClientOptions {
+  std::string host;
+  int port = 80;
+  /// Maximum number of open connections, and so of requests in flight. Send blocks
+  /// while all of them are busy.
+  int max_connections = 32;
+  /// Timeout of connecting and of each send or receive on a connection.
+  int64_t timeout_millis = 30000;
+  /// Maximum size of a response body read into HttpResponse::body. Longer responses
+  /// fail, rather than exhaust memory on a malformed or hostile length.
+  int64_t max_body_bytes = 256 * 1024 * 1024;
+};
+
+struct ICEBERG_EXPORT HttpRequest {
+  std::string method;
+  /// Path and query string, already percent-encoded
+  std::string target;
+  /// Headers besides Host and Content-Length, which the client adds
+  std::vector<std::pair<std::string, std::string>> headers;
+  std::string_view body;
+  /// If set, the body of a successful response is read straight into this memory, up to
+  /// `body_capacity` bytes, instead of into HttpResponse::body.
+  void* body_out = nullptr;
+  int64_t body_capacity = 0;
+};
+
+struct ICEBERG_EXPORT HttpResponse {
+  int status = 0;
+  /// Headers, with lowercase names
+  std::vector<std::pair<std::string, std::string>> headers;
+  std::string body;
+  /// Number of body bytes, whether read into `body` or HttpRequest::body_out
+  int64_t body_size = 0;
+
+  /// \brief Return the value of a header by lowercase name, or nullptr if missing
+  const std::string* header(std::string_view name) const;
+};
+
+/// \brief Parse a length sent by a server, such as a Content-Length header in base 10
+/// or a chunk size in base 16, failing with IOError unless it is a non-negative number
+ICEBERG_EXPORT Result<int64_t> ParseHttpLength(std::string_view value, int base = 10);
+
+/// \brief A minimal HTTP/1.1 client over plain TCP, keeping a pool of connections to
+/// one server alive across requests.
+///
+/// Requests are sent one at a time per connection, without pipelining, so the number
+/// of connections bounds the requests in flight. A request failing on a connection
+/// reused from the pool before any byte of the response came back, typically because
+/// the server closed the idle connection, is retried once on a new connection.
+/// Responses may be sized by Content-Length, chunked, or end with the connection.
+/// TLS is not supported.
+///
+/// Send is thread-safe.
+class ICEBERG_EXPORT HttpClient {
+ public:
+  struct Stats {
+    int64_t requests;
+    int64_t connections_opened;
+  };
+
+  explicit HttpClient(HttpClientOptions options);
+  ~HttpClient();
+
+  /// \brief Send a request and wait for its response. Only failures to exchange the
+  /// request are errors; any HTTP status is returned as a response.
+  Result<HttpResponse> Send(const HttpRequest& request);
+
+  /// \brief Return the value of the Host header sent with each request
+  const std::string& host_header() const { return host_header_; }
+
+  Stats stats() const;
+
+  const HttpClientOptions& options() const { return options_; }
+
+ private:
+  struct Connection;
+
+  // Return an idle connection, or a new one if fewer than max_connections are open
+  Result<std::unique_ptr<Connection>> Acquire();
+
+  void Release(std::unique_ptr<Connection> connection, bool reusable);
+
+  Result<std::unique_ptr<Connection>> Connect();
+
+  Status Exchange(Connection* connection, const HttpRequest& request,
+                  HttpResponse* response, bool* received, bool* keep_alive);
+
+  const HttpClientOptions options_;
+  const std::string host_header_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::unique_ptr<Connection>> idle_;
+  int num_open_ = 0;
+  Stats stats_{};
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(HttpClient);
+};
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/ostreamable.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace internal {
+class MetricsRecorder;
+}  // namespace internal
+
+/// \brief The operations counted by InstrumentedFileIO.
+enum class IOOperation : int8_t {
+  /// Opening a stream for reading or writing
+  OPEN = 0,
+  /// Read, ReadAt and ReadAtAsync, counted once per call to the wrapped stream
+  READ,
+  SEEK,
+  WRITE,
+  /// Flush and Sync
+  FLUSH,
+  DELETE,
+  /// FileIO::CopyFile
+  COPY,
+};
+
+constexpr int kNumIOOperations = 7;
+
+ICEBERG_EXPORT const char* IOOperationName(IOOperation operation);
+
+/// \brief A histogram with power-of-two buckets.
+///
+/// Bucket 0 counts zeros and bucket i > 0 counts values in [2^(i-1), 2^i); the last
+/// bucket also counts every larger value.
+struct ICEBERG_EXPORT Log2Histogram {
+  static constexpr int kNumBuckets = 48;
+
+  std::array<int64_t, kNumBuckets> buckets{};
+
+  /// \brief Return the bucket counting `value`
+  static int BucketOf(int64_t value);
+
+  /// \brief Return the largest value counted by a bucket
+  static int64_t BucketUpperBound(int bucket);
+
+  /// \brief Return the number of values recorded
+  int64_t count() const;
+
+  /// \brief Return an upper bound of the `quantile` of the values, between 0 and 1, or 0
+  /// if the histogram is empty
+  int64_t Quantile(double quantile) const;
+};
+
+/// \brief Counters of one operation type.
+struct ICEBERG_EXPORT IOOperationMetrics {
+  /// Number of operations, failed ones included
+  int64_t count = 0;
+  int64_t errors = 0;
+  /// Bytes read or written
+  int64_t bytes = 0;
+  /// Bytes transferred per operation; only filled for reads and writes
+  Log2Histogram sizes;
+  /// Wall time per operation, in nanoseconds
+  Log2Histogram latency_nanos;
+};
+
+/// \brief A snapshot of the metrics of an InstrumentedFileIO.
+struct ICEBERG_EXPORT IOMetrics : public util::ToStringOstreamable<IOMetrics> {
+  std::array<IOOperationMetrics, kNumIOOperations> operations;
+
+  const IOOperationMetrics& operator[](IOOperation operation) const {
+    return operations[static_cast<int>(operation)];
+  }
+
+  /// \brief Return the distribution of read sizes
+  const Log2Histogram& read_sizes() const { return (*this)[IOOperation::READ].sizes; }
+
+  /// \brief Return one line per operation type with its counts and latency quantiles
+  std::string ToString() const;
+};
+
+struct ICEBERG_EXPORT InstrumentedFileIOOptions {
+  /// Path prefixes, such as table locations or the metadata and data directories of a
+  /// table, whose operations are also reported separately. Each operation is attributed
+  /// to the longest prefix of its path.
+  std::vector<std::string> prefixes;
+};
+
+/// \brief A FileIO decorator counting the operations issued on the files of a base
+/// FileIO, to find read amplification and small I/O in the readers.
+///
+/// Each operation type records a count, the bytes transferred and histograms of sizes
+/// and latencies. The counters are sharded so that threads mostly update their own
+/// cache lines, with relaxed atomic increments and no lock; snapshots sum the shards
+/// and are not atomic with respect to concurrent operations.
+///
+/// ReadRanges is forwarded to the base stream, which coalesces the ranges its own way,
+/// and counted as one read of the ranges' total size. A ReadAtAsync is issued on the
+/// base stream and recorded when its future completes, whether or not the caller waits
+/// for it.
+class ICEBERG_EXPORT InstrumentedFileIO : public FileIO {
+ public:
+  explicit InstrumentedFileIO(std::shared_ptr<FileIO> base,
+                              InstrumentedFileIOOptions options = {});
+  ~InstrumentedFileIO() override;
+
+  std::string name() const override { return "instrumented"; }
+
+  bool Equals(const FileIO& other) const override;
+
+  using FileIO::newInputFile;
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path) override;
+
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path,
+                                                  int64_t length) override;
+
+  Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) override;
+
+  Status DeleteFile(const std::string& path) override;
+
+  /// \brief Delete through the base FileIO, counting each path as one deletion and the
+  /// whole batch as one latency sample
+  Result<DeleteFilesResult> DeleteFiles(const std::vector<std::string>& paths,
+                                        const DeleteFilesOptions& options = {}) override;
+
+  Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {}) override;
+
+  /// \brief Copy within the base FileIO, counted as one copy operation
+  Status CopyFile(const std::string& src, const std::string& dst) override;
+
+  /// \brief Return the metrics of every operation
+  IOMetrics metrics() const;
+
+  /// \brief Return the metrics of the operations attributed to one of the configured
+  /// prefixes
+  Result<IOMetrics> metrics(const std::string& prefix) const;
+
+  /// \brief Return the configured prefixes
+  const std::vector<std::string>& prefixes() const { return options_.prefixes; }
+
+  const std::shared_ptr<FileIO>& base() const { return base_; }
+
+ private:
+  // Return the index of the longest configured prefix of `path`, or -1
+  int PrefixIndex(const std::string& path) const;
+
+  // Return the recorder of the longest configured prefix of `path`, or nullptr
+  std::shared_ptr<internal::MetricsRecorder> PrefixRecorder(
+      const std::string& path) const;
+
+  std::shared_ptr<FileIO> base_;
+  const InstrumentedFileIOOptions options_;
+  std::shared_ptr<internal::MetricsRecorder> total_;
+  // One per prefix, in the order of the options
+  std::vector<std::shared_ptr<internal::MetricsRecorder>> by_prefix_;
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(InstrumentedFileIO);
+};
+
+}  // namespace io
+}  // namespace iceberg
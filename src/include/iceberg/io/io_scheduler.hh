@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+/// \brief The classes of I/O requests arbitrated by an IOScheduler.
+enum class IOClass : int8_t {
+  /// Metadata, manifest list and manifest reads of query planning
+  METADATA = 0,
+  /// Data file reads of interactive scans
+  DATA_SCAN,
+  /// Speculative reads ahead of a consumer
+  PREFETCH,
+  /// Maintenance such as compaction, snapshot expiry and orphan file removal
+  BACKGROUND,
+};
+
+constexpr int kNumIOClasses = 4;
+
+ICEBERG_EXPORT const char* IOClassName(IOClass io_class);
+
+struct ICEBERG_EXPORT IOClassOptions {
+  /// Requests of classes with a higher priority are admitted first.
+  int priority;
+  /// Maximum number of requests of the class in flight at once.
+  int max_concurrency;
+};
+
+struct ICEBERG_EXPORT IOSchedulerOptions {
+  /// Maximum number of requests in flight at once, across all classes.
+  int max_concurrency = 32;
+  /// Indexed by IOClass. By default a saturating background workload leaves room for
+  /// the other classes, and speculative reads cannot crowd out the ones they serve.
+  std::array<IOClassOptions, kNumIOClasses> classes = {{
+      {/*priority=*/3, /*max_concurrency=*/32},
+      {/*priority=*/2, /*max_concurrency=*/24},
+      {/*priority=*/1, /*max_concurrency=*/8},
+      {/*priority=*/0, /*max_concurrency=*/8},
+  }};
+
+  IOClassOptions& operator[](IOClass io_class) {
+    return classes[static_cast<int>(io_class)];
+  }
+  const IOClassOptions& operator[](IOClass io_class) const {
+    return classes[static_cast<int>(io_class)];
+  }
+};
+
+/// \brief Counters of one class of an IOScheduler.
+struct ICEBERG_EXPORT IOClassStats {
+  /// Requests admitted so far
+  int64_t admitted;
+  int64_t in_flight;
+  int64_t queued;
+  /// Total time admitted requests spent queued, in nanoseconds
+  int64_t wait_nanos;
+};
+
+/// \brief Admits I/O requests by class, bounding the requests in flight overall and per
+/// class.
+///
+/// Whenever a slot frees up, it goes to the oldest queued request of the highest
+/// priority class that is below its own limit. Priorities are strict: a lower priority
+/// class only runs in the slots the higher ones cannot use, which the per-class limits
+/// keep available.
+///
+/// Admitted tasks run on threads of the scheduler's own, started as needed up to its
+/// overall limit, so an admitted task never waits behind others in a shared pool.
+/// Requests issued from within an admitted task run under that task's slot instead of
+/// queueing for another, which could otherwise never come.
+class ICEBERG_EXPORT IOScheduler : public std::enable_shared_from_this<IOScheduler> {
+ public:
+  /// \brief A slot held by a synchronous request, released on destruction
+  class ICEBERG_EXPORT Permit {
+   public:
+    Permit(Permit&& other) noexcept;
+    Permit& operator=(Permit&& other) noexcept;
+    ~Permit();
+
+    /// \brief Release the slot before destruction
+    void Release();
+
+   private:
+    friend class IOScheduler;
+    Permit(IOScheduler* scheduler, IOClass io_class)
+        : scheduler_(scheduler), io_class_(io_class) {}
+
+    IOScheduler* scheduler_;
+    IOClass io_class_;
+  };
+
+  static Result<std::shared_ptr<IOScheduler>> Make(IOSchedulerOptions options = {});
+
+  ~IOScheduler();
+
+  /// \brief Block until a request of `io_class` is admitted, unless called from a
+  /// task of this scheduler, which already holds a slot
+  Permit Acquire(IOClass io_class);
+
+  /// \brief Queue a task, run on a thread of the scheduler once admitted
+  void Spawn(IOClass io_class, std::function<void()> task);
+
+  /// \brief Queue a callable and return a future for its result
+  template <typename Function, typename R = std::invoke_result_t<Function>>
+  std::future<R> Submit(IOClass io_class, Function&& func) {
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<Function>(func));
+    std::future<R> future = task->get_future();
+    Spawn(io_class, [task]() { (*task)(); });
+    return future;
+  }
+
+  IOClassStats stats(IOClass io_class) const;
+
+  const IOSchedulerOptions& options() const { return options_; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Request {
+    // Called once admitted, outside of the lock
+    std::function<void()> start;
+    Clock::time_point enqueued;
+  };
+
+  class Workers;
+
+  explicit IOScheduler(IOSchedulerOptions options);
+
+  void Enqueue(IOClass io_class, std::function<void()> start);
+
+  void Release(IOClass io_class);
+
+  // Admit queued requests into the free slots and return their start callbacks
+  std::vector<std::function<void()>> DispatchLocked();
+
+  const IOSchedulerOptions options_;
+  // Classes by decreasing priority
+  std::array<int, kNumIOClasses> order_;
+
+  mutable std::mutex mutex_;
+  std::array<std::deque<Request>, kNumIOClasses> queues_;
+  std::array<int64_t, kNumIOClasses> in_flight_{};
+  std::array<int64_t, kNumIOClasses> admitted_{};
+  std::array<int64_t, kNumIOClasses> wait_nanos_{};
+  int64_t total_in_flight_ = 0;
+
+  // Shared with the threads, which may outlive the scheduler when a task drops the
+  // last reference to it
+  std::shared_ptr<Workers> workers_;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(IOScheduler);
+};
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <optional>
+
+#include "iceberg/result.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+namespace internal {
+
+/// \brief Number of submission queue entries of each per-thread ring
+constexpr unsigned kIoUringQueueDepth = 64;
+
+/// \brief Maximum number of rings, and so of completion threads, in the process. Threads
+/// submitting once this many rings exist do without io_uring.
+constexpr int kMaxIoUringRings = 32;
+
+/// \brief Return whether io_uring can be used by the calling thread
+ICEBERG_EXPORT bool IoUringAvailable();
+
+/// \brief Submit a positional read of `fd` on the calling thread's io_uring instance.
+///
+/// Every submitting thread owns a ring that only it submits to, so submission takes no
+/// lock; completions are reaped by a helper thread attached to the ring, which fulfills
+/// the returned future. Short reads, and reads the kernel refuses to take, are
+/// completed with pread(2).
+///
+/// Return std::nullopt if io_uring is unavailable or the ring already has as many reads
+/// in flight as its completion queue holds; callers should then fall back to a blocking
+/// read. `fd` and `out` must stay valid until the future is ready.
+ICEBERG_EXPORT std::optional<std::future<Result<int64_t>>> IoUringReadAt(
+    int fd, int64_t position, int64_t nbytes, void* out);
+
+}  // namespace internal
+}  // namespace io
+}  // namespace iceberg
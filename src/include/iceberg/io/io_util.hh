@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+namespace internal {
+
+/// \brief Read up to `nbytes` at `position` of `fd` with pread(2), retrying on EINTR and
+/// short reads. Return the number of bytes read, which is less than `nbytes` only at EOF.
+ICEBERG_EXPORT Result<int64_t> FileReadAt(int fd, int64_t position, int64_t nbytes,
+                                          void* out);
+
+/// \brief Read `input` to its end and write everything to `output`, in chunks of
+/// `chunk_size` bytes. Neither stream is closed.
+ICEBERG_EXPORT Status CopyStream(InputStream* input, OutputStream* output,
+                                 int64_t chunk_size = 1024 * 1024);
+
+/// \brief Merge read ranges that overlap or are separated by small holes.
+///
+/// Return sorted, disjoint ranges that together cover every non-empty input range, each
+/// input range lying entirely within one output range. Return Invalid for ranges with a
+/// negative offset or length.
+ICEBERG_EXPORT Result<std::vector<ReadRange>> CoalesceReadRanges(
+    std::vector<ReadRange> ranges, const CoalesceOptions& options);
+
+/// \brief Call `delete_one` for every path on up to `options.parallelism` threads,
+/// collecting per-path failures and reporting progress as FileIO::DeleteFiles does.
+///
+/// `delete_one` also receives the index of the calling worker, below the parallelism,
+/// so that implementations can keep per-worker state without locking.
+ICEBERG_EXPORT Result<DeleteFilesResult> RunDeleteFiles(
+    const std::vector<std::string>& paths, const DeleteFilesOptions& options,
+    const std::function<Status(int worker, const std::string& path)>& delete_one);
+
+/// \brief List the regular files of the local file system whose path starts with
+/// `prefix`, walking directories on `options.parallelism` background threads.
+///
+/// Directories are read in batches with getdents(2) where available, and the entries
+/// of each batch are stat-ed as separate tasks, so that large directories are not
+/// stat-ed serially either. Symbolic links are not followed.
+ICEBERG_EXPORT Result<std::unique_ptr<FileInfoIterator>> ListLocalPrefix(
+    const std::string& prefix, const ListPrefixOptions& options);
+
+}  // namespace internal
+}  // namespace io
+}  // namespace iceberg
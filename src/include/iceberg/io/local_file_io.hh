@@ -1,58 +1,189 @@
 #pragma once
 
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "iceberg/buffer.hh"
+#include "iceberg/io/direct_io.hh"
 #include "iceberg/io/file_io.hh"
+#include "iceberg/io/memory.hh"
+#include "iceberg/io/readahead.hh"
 #include "iceberg/util/macros.hh"
 #include "iceberg/util/visibility.hh"
 
 namespace iceberg {
 namespace io {
 
+/// \brief Expected access pattern of a stream, passed down to the kernel as a hint.
+enum class AccessPattern : int8_t {
+  /// No particular pattern; the kernel default applies.
+  NORMAL,
+  /// Data will be read front to back; read ahead aggressively.
+  SEQUENTIAL,
+  /// Data will be read at random offsets; do not read ahead.
+  RANDOM,
+};
+
+/// \brief A thread-safe cache of file lengths keyed by path.
+///
+/// Iceberg files are immutable, so a length once observed stays valid until the file is
+/// overwritten or deleted, which LocalFileIO reports through Invalidate. Lengths of files
+/// open for writing, bracketed by BeginWrite and EndWrite, are not cached.
+class ICEBERG_EXPORT StatCache {
+ public:
+  /// \brief Create a cache holding at most `capacity` entries
+  explicit StatCache(size_t capacity = 100000) : capacity_(capacity) {}
+
+  std::optional<int64_t> GetLength(const std::string& path) const;
+
+  void PutLength(const std::string& path, int64_t length);
+
+  void Invalidate(const std::string& path);
+
+  /// \brief Invalidate `path` and stop caching its length until the matching EndWrite
+  void BeginWrite(const std::string& path);
+
+  /// \brief Invalidate `path` again, once a writer opened through BeginWrite is closed
+  void EndWrite(const std::string& path);
+
+  size_t size() const;
+
+ private:
+  const size_t capacity_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, int64_t> lengths_;
+  // Number of open writers per path
+  std::unordered_map<std::string, int> writers_;
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(StatCache);
+};
+
+/// \brief Options controlling how LocalFileIO opens files.
+struct ICEBERG_EXPORT LocalFileIOOptions {
+  /// Map input files into memory instead of reading them through a file descriptor.
+  /// Reads from the mapping can hand out zero-copy buffers, see MemoryMappedInputStream.
+  bool use_mmap = false;
+  /// Access pattern hint for input files, given to madvise(2) for memory-mapped files
+  /// and to posix_fadvise(2) otherwise.
+  AccessPattern access_pattern = AccessPattern::NORMAL;
+  /// If set, input streams not memory-mapped prefetch ahead of sequential readers in
+  /// the background, see ReadaheadInputStream.
+  std::optional<ReadaheadOptions> readahead;
+  /// Serve ReadAtAsync through io_uring where the kernel supports it, instead of the I/O
+  /// thread pool.
+  bool use_io_uring = true;
+  /// Size of the buffer coalescing small writes to output files, or 0 to write through.
+  int64_t write_buffer_size = 64 * 1024;
+  /// Read and write files with O_DIRECT, bypassing the page cache, so that streaming
+  /// large data files does not evict hot metadata. Memory mapping takes precedence for
+  /// input files. Files on file systems without direct I/O support are accessed
+  /// normally.
+  bool use_direct_io = false;
+  DirectIOOptions direct_io;
+  /// Optional cache of file lengths shared by the files of a LocalFileIO, sparing a
+  /// stat(2) per file when the length is not known up front.
+  std::shared_ptr<StatCache> stat_cache;
+};
+
 class ICEBERG_EXPORT SeekableFileInputStream : public SeekableInputStream {
  public:
-  explicit SeekableFileInputStream(int fd) : fd_(fd){};
+  explicit SeekableFileInputStream(int fd, bool use_io_uring = true)
+      : fd_(fd), use_io_uring_(use_io_uring){};
   ~SeekableFileInputStream();
 
   Status Close() override;
 
   Result<int64_t> Tell() const override;
 
+  using SeekableInputStream::Read;
   Result<int64_t> Read(int64_t nbytes, void* out) override;
 
+  using SeekableInputStream::ReadAt;
+  /// \brief Read with pread(2), which neither uses nor moves the shared file offset, so
+  /// concurrent readers of one stream need no locking.
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override;
+
+  /// \brief Submit the read to the calling thread's io_uring instance, falling back to
+  /// the I/O thread pool when io_uring is unavailable or its queue is full.
+  std::future<Result<int64_t>> ReadAtAsync(int64_t position, int64_t nbytes,
+                                           void* out) override;
+
   Status Seek(int64_t position) override;
 
   bool closed() const override;
 
  private:
   int fd_ = -1;
+  bool use_io_uring_;
   Status CheckClosed() const;
   ICEBERG_DISALLOW_COPY_AND_ASSIGN(SeekableFileInputStream);
 };
 
+/// \brief A SeekableInputStream over a read-only memory mapping of a whole file.
+///
+/// The Read variants returning buffers hand out slices pointing straight into the
+/// mapping. The mapping is reference counted: it stays valid as long as the
+/// stream or any buffer returned by it is alive, even after the stream is closed.
+class ICEBERG_EXPORT MemoryMappedInputStream : public BufferReader {
+ public:
+  /// \brief Map `size` bytes of the open file `fd`.
+  ///
+  /// The descriptor is not retained and may be closed by the caller once this returns.
+  static Result<std::shared_ptr<MemoryMappedInputStream>> Open(
+      int fd, int64_t size, AccessPattern access_pattern = AccessPattern::NORMAL);
+
+  explicit MemoryMappedInputStream(std::shared_ptr<Buffer> region)
+      : BufferReader(std::move(region)){};
+  ~MemoryMappedInputStream() = default;
+
+  /// \brief Give the kernel an access pattern hint for a range of the mapping
+  Status Advise(AccessPattern access_pattern, int64_t position, int64_t nbytes);
+
+ private:
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(MemoryMappedInputStream);
+};
+
+/// \brief A PositionOutputStream writing straight to a file descriptor.
+///
+/// The position is tracked in user space, starting at `position`, so Tell costs no
+/// system call. Flush is a no-op since nothing is buffered; Sync calls fsync(2). Wrap the
+/// stream in a BufferedOutputStream to coalesce small writes.
 class ICEBERG_EXPORT PositionFileOutputStream : public PositionOutputStream {
  public:
-  explicit PositionFileOutputStream(int fd) : fd_(fd){};
+  explicit PositionFileOutputStream(int fd, int64_t position = 0)
+      : fd_(fd), position_(position){};
   ~PositionFileOutputStream();
 
   Status Close() override;
 
   Result<int64_t> Tell() const override;
 
+  using PositionOutputStream::Write;
   Status Write(const void* data, int64_t nbytes) override;
 
   Status Flush() override;
 
+  Status Sync() override;
+
   bool closed() const override;
 
  private:
   int fd_ = -1;
+  int64_t position_;
   Status CheckClosed() const;
   ICEBERG_DISALLOW_COPY_AND_ASSIGN(PositionFileOutputStream);
 };
 
 /// \brief An local implementation of InputFile.
+///
+/// A length known up front, e.g. from a manifest, is trusted: getLength returns it and
+/// newStream opens the file with a single open(2). Otherwise the length is looked up in
+/// the stat cache, or taken from fstat(2) when opening and remembered.
 class ICEBERG_EXPORT LocalInputFile : public InputFile {
  public:
-  explicit LocalInputFile(std::string location) : InputFile(std::move(location)) {}
+  explicit LocalInputFile(std::string location, LocalFileIOOptions options = {},
+                          std::optional<int64_t> length = std::nullopt);
   ~LocalInputFile() = default;
 
   Result<int64_t> getLength() override;
@@ -62,13 +193,18 @@ class ICEBERG_EXPORT LocalInputFile : public InputFile {
   bool exists() const override;
 
  private:
+  void SetLength(int64_t length);
+
+  LocalFileIOOptions options_;
+  std::optional<int64_t> length_;
   ICEBERG_DISALLOW_COPY_AND_ASSIGN(LocalInputFile);
 };
 
 /// \brief An local implementation of OutputFile
 class ICEBERG_EXPORT LocalOutputFile : public OutputFile {
  public:
-  explicit LocalOutputFile(std::string location) : OutputFile(std::move(location)) {}
+  explicit LocalOutputFile(std::string location, LocalFileIOOptions options = {})
+      : OutputFile(std::move(location)), options_(options) {}
   ~LocalOutputFile() = default;
 
   Result<std::shared_ptr<io::PositionOutputStream>> create() override;
@@ -78,26 +214,50 @@ class ICEBERG_EXPORT LocalOutputFile : public OutputFile {
   Result<std::shared_ptr<InputFile>> toInputFile() const override;
 
  private:
+  Result<std::shared_ptr<io::PositionOutputStream>> Open(int flags);
+
+  LocalFileIOOptions options_;
   ICEBERG_DISALLOW_COPY_AND_ASSIGN(LocalOutputFile);
 };
 
 class ICEBERG_EXPORT LocalFileIO : public FileIO {
  public:
   LocalFileIO() = default;
+  explicit LocalFileIO(LocalFileIOOptions options) : options_(options) {}
 
   ~LocalFileIO();
 
+  const LocalFileIOOptions& options() const { return options_; }
+
   std::string name() const override { return "local"; }
 
   bool Equals(const FileIO& other) const override;
 
+  using FileIO::newInputFile;
   Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path) override;
 
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path,
+                                                  int64_t length) override;
+
   Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) override;
 
   Status DeleteFile(const std::string& path) override;
 
+  /// \brief Delete files with unlinkat(2) from a pool of workers, each resolving paths
+  /// relative to the directories it has already opened.
+  Result<DeleteFilesResult> DeleteFiles(const std::vector<std::string>& paths,
+                                        const DeleteFilesOptions& options = {}) override;
+
+  Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {}) override;
+
+  /// \brief Copy within the kernel: clone the file's extents where the file system
+  /// supports reflinks, else copy with copy_file_range(2), else read and write through
+  /// a buffer.
+  Status CopyFile(const std::string& src, const std::string& dst) override;
+
  private:
+  LocalFileIOOptions options_;
   ICEBERG_DISALLOW_COPY_AND_ASSIGN(LocalFileIO);
 };
 
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iceberg/buffer.hh"
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+/// \brief A SeekableInputStream over the contents of a Buffer.
+///
+/// The Read variants returning buffers hand out slices of the underlying buffer without
+/// copying. The buffer is reference counted: slices stay valid after the reader is
+/// closed.
+class ICEBERG_EXPORT BufferReader : public SeekableInputStream {
+ public:
+  explicit BufferReader(std::shared_ptr<Buffer> buffer) : buffer_(std::move(buffer)) {}
+  ~BufferReader() = default;
+
+  Status Close() override;
+
+  Result<int64_t> Tell() const override;
+
+  Result<int64_t> Read(int64_t nbytes, void* out) override;
+
+  /// \brief Return at most `nbytes` from the current position without copying, and
+  /// advance the position.
+  Result<std::shared_ptr<Buffer>> Read(int64_t nbytes) override;
+
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override;
+
+  /// \brief Return at most `nbytes` from `position` without copying.
+  ///
+  /// This method does not move the stream position and is thread-safe.
+  Result<std::shared_ptr<Buffer>> ReadAt(int64_t position, int64_t nbytes) override;
+
+  /// \brief Copy out of the buffer on the calling thread and return a ready future
+  std::future<Result<int64_t>> ReadAtAsync(int64_t position, int64_t nbytes,
+                                           void* out) override;
+
+  /// \brief Return slices of the buffer; no coalescing or copying is needed
+  Result<std::vector<std::shared_ptr<Buffer>>> ReadRanges(
+      const std::vector<ReadRange>& ranges, const CoalesceOptions& options = {}) override;
+
+  Status Seek(int64_t position) override;
+
+  bool closed() const override;
+
+  /// \brief Return the size of the underlying buffer
+  int64_t size() const { return buffer_ ? buffer_->size() : 0; }
+
+ protected:
+  Status CheckClosed() const;
+
+  std::shared_ptr<Buffer> buffer_;
+  int64_t position_ = 0;
+
+ private:
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(BufferReader);
+};
+
+/// \brief A PositionOutputStream collecting the written bytes in memory.
+class ICEBERG_EXPORT BufferOutputStream : public PositionOutputStream {
+ public:
+  BufferOutputStream() = default;
+  ~BufferOutputStream() = default;
+
+  Status Close() override;
+
+  Result<int64_t> Tell() const override;
+
+  using PositionOutputStream::Write;
+  Status Write(const void* data, int64_t nbytes) override;
+
+  bool closed() const override { return closed_; }
+
+  /// \brief Close the stream and return the written bytes, without copying them
+  Result<std::shared_ptr<Buffer>> Finish();
+
+ private:
+  Status CheckClosed() const;
+
+  std::string data_;
+  bool closed_ = false;
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(BufferOutputStream);
+};
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace internal {
+class MemoryFileSystem;
+}  // namespace internal
+
+/// \brief A FileIO keeping files in reference-counted buffers.
+///
+/// Files behave as with LocalFileIO: create() fails with AlreadyExists if the file
+/// exists, and opening a missing file fails with Invalid. A file's contents become
+/// visible to readers when its output stream is closed. Input streams read the
+/// contents as of newStream without copying, so they are unaffected by later
+/// overwrites or deletes.
+class ICEBERG_EXPORT MemoryFileIO : public FileIO {
+ public:
+  MemoryFileIO();
+  ~MemoryFileIO() override;
+
+  std::string name() const override { return "memory"; }
+
+  bool Equals(const FileIO& other) const override;
+
+  using FileIO::newInputFile;
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path) override;
+
+  Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) override;
+
+  Status DeleteFile(const std::string& path) override;
+
+  Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {}) override;
+
+  /// \brief Copy without copying data, the files sharing the same immutable buffer
+  Status CopyFile(const std::string& src, const std::string& dst) override;
+
+  /// \brief Return the number of files
+  int64_t num_files() const;
+
+  /// \brief Return the total size of the files, in bytes
+  int64_t size() const;
+
+ private:
+  std::shared_ptr<internal::MemoryFileSystem> files_;
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(MemoryFileIO);
+};
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+
+#include "iceberg/buffer.hh"
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+struct ICEBERG_EXPORT ReadaheadOptions {
+  /// Size of the first window read ahead of the consumer.
+  int64_t initial_window = 256 * 1024;
+  /// Each window consumed in full doubles the size of the next ones, up to this size.
+  int64_t max_window = 8 * 1024 * 1024;
+  /// Number of windows kept in flight ahead of the consumer.
+  int depth = 2;
+  /// Readahead is suspended after this many consecutive seeks outside the windows read
+  /// ahead, and resumes once as many consecutive reads continue where the previous one
+  /// ended.
+  int random_access_threshold = 2;
+};
+
+/// \brief A SeekableInputStream decorator prefetching the data ahead of a sequential
+/// reader in the background, so that decoding one window overlaps reading the next.
+///
+/// Windows are read with the raw stream's ReadAtAsync, which must be safe to call
+/// concurrently with ReadAt. Seeks within the windows in flight keep them; other seeks
+/// drop them and restart with a small window, and repeated ones suspend readahead until
+/// the access pattern is sequential again. ReadAt bypasses the windows.
+class ICEBERG_EXPORT ReadaheadInputStream : public SeekableInputStream {
+ public:
+  ~ReadaheadInputStream() override;
+
+  /// \brief Create a stream reading ahead of its position in `raw`, starting at the
+  /// position of `raw`
+  static Result<std::shared_ptr<ReadaheadInputStream>> Create(
+      std::shared_ptr<SeekableInputStream> raw, ReadaheadOptions options = {});
+
+  Status Close() override;
+
+  Result<int64_t> Tell() const override;
+
+  bool closed() const override;
+
+  Status Seek(int64_t position) override;
+
+  Result<int64_t> Read(int64_t nbytes, void* out) override;
+
+  /// \brief Return a slice of a window without copying if the bytes lie within one
+  Result<std::shared_ptr<Buffer>> Read(int64_t nbytes) override;
+
+  using SeekableInputStream::ReadAt;
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override;
+
+  /// \brief Return whether readahead is currently suspended by random access
+  bool suspended() const { return suspended_; }
+
+  /// \brief Return the size of the windows currently being issued
+  int64_t window_size() const { return window_size_; }
+
+  /// \brief Return the raw stream
+  const std::shared_ptr<SeekableInputStream>& raw() const { return raw_; }
+
+ private:
+  struct Window {
+    int64_t offset;
+    int64_t length;
+    std::shared_ptr<Buffer> buffer;
+    std::future<Result<int64_t>> future;
+    // Bytes read, once the future is resolved, or -1
+    int64_t bytes_read = -1;
+  };
+
+  ReadaheadInputStream(std::shared_ptr<SeekableInputStream> raw, ReadaheadOptions options,
+                       int64_t position);
+
+  // Advance past bytes of the front window, retiring it once consumed
+  Status Consume(int64_t nbytes);
+
+  // Keep `depth` windows in flight past the last one
+  Status Schedule();
+
+  // Wait for the front window and return it, or nullptr at the end of the stream
+  Result<Window*> FrontWindow();
+
+  // Wait for the reads in flight and forget every window
+  void DropWindows();
+
+  Status CheckClosed() const;
+
+  std::shared_ptr<SeekableInputStream> raw_;
+  const ReadaheadOptions options_;
+  int64_t position_;
+  std::deque<Window> windows_;
+  // Offset at which the next window starts
+  int64_t next_window_offset_;
+  int64_t window_size_;
+  // Set once a window came back short
+  bool eof_ = false;
+  bool suspended_ = false;
+  int random_seeks_ = 0;
+  int sequential_reads_ = 0;
+  bool closed_ = false;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(ReadaheadInputStream);
+};
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/io/http_client.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+struct ICEBERG_EXPORT S3FileIOOptions {
+  /// Endpoint of the S3-compatible service, such as "http://localhost:9000". Buckets are
+  /// addressed in the path. Only plain HTTP is supported, e.g. to an object store on
+  /// the local network or a TLS-terminating proxy.
+  std::string endpoint;
+  std::string region = "us-east-1";
+  /// Credentials signing the requests with AWS Signature Version 4; requests are sent
+  /// unsigned if empty.
+  std::string access_key_id;
+  std::string secret_access_key;
+  std::string session_token;
+  /// Reads larger than this are split into ranged GETs of this size, sent in parallel.
+  int64_t read_part_size = 8 * 1024 * 1024;
+  /// Size of the parts of multipart uploads; smaller files are uploaded with one PUT.
+  /// S3 requires at least 5 MiB.
+  int64_t upload_part_size = 16 * 1024 * 1024;
+  /// Maximum number of connections, and so of requests in flight.
+  int max_connections = 32;
+  /// Bound on the bytes of parts buffered for upload by all output streams of the
+  /// FileIO; writers block while it is reached.
+  int64_t max_upload_buffer_bytes = 256 * 1024 * 1024;
+  /// Retries of requests failing with a server error or a connection failure.
+  int max_retries = 3;
+  int64_t timeout_millis = 30000;
+};
+
+namespace internal {
+
+struct S3Client;
+
+/// \brief Return the Authorization header of an S3 request, per AWS Signature Version
+/// 4. `headers` are the signed headers, with lowercase names, including host and
+/// x-amz-date; `amz_date` is the latter's value, as "20130524T000000Z".
+ICEBERG_EXPORT std::string SignS3Request(
+    const std::string& method, const std::string& canonical_uri,
+    const std::string& canonical_query,
+    std::vector<std::pair<std::string, std::string>> headers,
+    const std::string& payload_hash, const std::string& amz_date,
+    const std::string& region, const std::string& access_key_id,
+    const std::string& secret_access_key);
+
+}  // namespace internal
+
+/// \brief A FileIO over an S3-compatible object store, for locations such as
+/// "s3://bucket/path/to/file".
+///
+/// Object stores serve each request with a latency of tens of milliseconds, so
+/// throughput on a single file comes from having many requests in flight:
+/// - Reads larger than `read_part_size` are split into ranged GETs issued in parallel
+///   and written straight into the caller's buffer. Small reads are a single GET each;
+///   wrap the streams in a ReadaheadInputStream for small sequential reads.
+/// - Output streams buffer `upload_part_size` bytes at a time and upload each full part
+///   in the background as part of a multipart upload, while the writer fills the next.
+///   The buffered parts of all streams are bounded by `max_upload_buffer_bytes`.
+///   Closing the stream completes the upload; destroying it unclosed aborts it.
+/// Connections are kept alive and reused across requests. Requests run on a thread
+/// pool of `max_connections` threads owned by the FileIO.
+///
+/// OutputFile::create fails if the object exists, and also makes the upload
+/// conditional on that with If-None-Match. CopyFile copies on the server, with one
+/// CopyObject request, so up to 5 GiB.
+class ICEBERG_EXPORT S3FileIO : public FileIO {
+ public:
+  static Result<std::shared_ptr<S3FileIO>> Make(S3FileIOOptions options);
+
+  ~S3FileIO() override;
+
+  std::string name() const override { return "s3"; }
+
+  bool Equals(const FileIO& other) const override;
+
+  using FileIO::newInputFile;
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path) override;
+
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path,
+                                                  int64_t length) override;
+
+  Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) override;
+
+  Status DeleteFile(const std::string& path) override;
+
+  /// \brief List with ListObjectsV2, one page of up to `options.batch_size` objects
+  /// per batch
+  Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {}) override;
+
+  Status CopyFile(const std::string& src, const std::string& dst) override;
+
+  /// \brief Return the request and connection counts of the FileIO
+  HttpClient::Stats http_stats() const;
+
+  const S3FileIOOptions& options() const;
+
+ private:
+  explicit S3FileIO(std::shared_ptr<internal::S3Client> client);
+
+  std::shared_ptr<internal::S3Client> client_;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(S3FileIO);
+};
+
+}  // namespace io
+}  // namespace iceberg
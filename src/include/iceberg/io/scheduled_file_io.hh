@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/io/io_scheduler.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+/// \brief A FileIO decorator passing every request on the files of a base FileIO
+/// through an IOScheduler, under a given I/O class.
+///
+/// Each read, write, flush, open, length lookup, deletion and listing batch is admitted
+/// by the scheduler before reaching the base FileIO. ReadAtAsync, and hence ReadRanges,
+/// queue their reads in the scheduler instead of blocking the caller; admitted ones run
+/// on the scheduler's threads. Several ScheduledFileIOs of different classes usually
+/// share one scheduler and base, e.g. a planner using METADATA and a compaction job
+/// using BACKGROUND.
+class ICEBERG_EXPORT ScheduledFileIO : public FileIO {
+ public:
+  ScheduledFileIO(std::shared_ptr<FileIO> base, std::shared_ptr<IOScheduler> scheduler,
+                  IOClass io_class);
+  ~ScheduledFileIO() override;
+
+  std::string name() const override { return "scheduled"; }
+
+  bool Equals(const FileIO& other) const override;
+
+  using FileIO::newInputFile;
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path) override;
+
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path,
+                                                  int64_t length) override;
+
+  Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) override;
+
+  Status DeleteFile(const std::string& path) override;
+
+  /// \brief Delete the files as a single request, leaving the batching to the base
+  Result<DeleteFilesResult> DeleteFiles(const std::vector<std::string>& paths,
+                                        const DeleteFilesOptions& options = {}) override;
+
+  Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {}) override;
+
+  /// \brief Copy within the base FileIO as a single request
+  Status CopyFile(const std::string& src, const std::string& dst) override;
+
+  /// \brief Return a FileIO sharing the base and scheduler of this one, issuing its
+  /// requests under another class
+  std::shared_ptr<ScheduledFileIO> WithClass(IOClass io_class) const;
+
+  IOClass io_class() const { return io_class_; }
+
+  const std::shared_ptr<IOScheduler>& scheduler() const { return scheduler_; }
+
+  const std::shared_ptr<FileIO>& base() const { return base_; }
+
+ private:
+  std::shared_ptr<FileIO> base_;
+  std::shared_ptr<IOScheduler> scheduler_;
+  const IOClass io_class_;
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(ScheduledFileIO);
+};
+
+}  // namespace io
+}  // namespace iceberg
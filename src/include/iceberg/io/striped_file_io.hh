@@ -0,0 +1,111 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/io/local_file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/status.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace internal {
+class StripedVolumes;
+}  // namespace internal
+
+/// \brief How StripedFileIO picks the volume of a new file.
+enum class VolumePlacement : int8_t {
+  /// Cycle through the volumes.
+  ROUND_ROBIN,
+  /// Pick a volume at random, weighted by its available space, so that volumes of
+  /// different sizes fill up evenly while concurrent writers still spread across them.
+  FREE_SPACE,
+};
+
+struct ICEBERG_EXPORT StripedFileIOOptions {
+  /// Logical directory the served locations live under, e.g. "/warehouse".
+  std::string root;
+  /// Directories, typically the mount points of separate devices, that the files under
+  /// the root are spread across. A location "<root>/t/data/f" is stored as
+  /// "<volume>/t/data/f" on one of them.
+  std::vector<std::string> volumes;
+  VolumePlacement placement = VolumePlacement::ROUND_ROBIN;
+  /// How long the available space of the volumes, read for FREE_SPACE placement, is
+  /// reused before the volumes are asked again.
+  std::chrono::milliseconds free_space_refresh{1000};
+  /// Number of locations whose volume is remembered. The least recently used ones are
+  /// forgotten beyond it, and looked up on the volumes again when next needed.
+  size_t max_remembered_locations = 100000;
+  /// Index of the volume every new metadata file is placed on, usually the fastest
+  /// one, or none to place them like data files. Metadata files are the ones with a
+  /// "metadata" directory in their location, as laid out by Iceberg tables.
+  std::optional<int> metadata_volume;
+  /// Options of the files on the volumes.
+  LocalFileIOOptions local;
+};
+
+/// \brief A FileIO spreading the files under a logical root across several local
+/// volumes, so that writes are not capped by the throughput of a single device.
+///
+/// Each new file goes to one volume, chosen by the placement policy, and parent
+/// directories are created on it as needed. Reads resolve a location to the volume
+/// holding the file through a bounded mapping of the files written or found recently;
+/// locations not in the mapping are looked up on each volume, then remembered. The
+/// volumes themselves hold the mapping, so a new StripedFileIO over the same volumes
+/// finds the files of an earlier one. Listings merge the listings of all volumes.
+///
+/// OutputFile::create stays exclusive across volumes: once the file is created, the
+/// other volumes are checked for it, and of two racing creators at most one succeeds.
+class ICEBERG_EXPORT StripedFileIO : public FileIO {
+ public:
+  static Result<std::shared_ptr<StripedFileIO>> Make(StripedFileIOOptions options);
+
+  ~StripedFileIO() override;
+
+  std::string name() const override { return "striped"; }
+
+  bool Equals(const FileIO& other) const override;
+
+  using FileIO::newInputFile;
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path) override;
+
+  Result<std::shared_ptr<InputFile>> newInputFile(const std::string& path,
+                                                  int64_t length) override;
+
+  /// \brief Return a file on the volume already holding `path` if any, else on a
+  /// volume picked by the placement policy
+  Result<std::shared_ptr<OutputFile>> newOutputFile(const std::string& path) override;
+
+  Status DeleteFile(const std::string& path) override;
+
+  Result<std::unique_ptr<FileInfoIterator>> ListPrefix(
+      const std::string& prefix, const ListPrefixOptions& options = {}) override;
+
+  /// \brief Copy within the volume of `src`, where the local file system can clone or
+  /// copy in the kernel, unless `dst` is a metadata file pinned to another volume
+  Status CopyFile(const std::string& src, const std::string& dst) override;
+
+  /// \brief Return the index of the volume holding `path`, or none if no volume does
+  Result<std::optional<int>> VolumeOf(const std::string& path);
+
+  const StripedFileIOOptions& options() const;
+
+ private:
+  explicit StripedFileIO(std::shared_ptr<internal::StripedVolumes> volumes);
+
+  // Shared with the files, which record the volumes of the files they create
+  std::shared_ptr<internal::StripedVolumes> volumes_;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(StripedFileIO);
+};
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/string_column.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace avro {
+class FileReader;
+}  // namespace avro
+
+namespace table {
+
+enum class ManifestContent : int8_t {
+  /// The manifest tracks data files.
+  DATA = 0,
+  /// The manifest tracks position or equality delete files.
+  DELETES = 1,
+};
+
+/// \brief The fields of manifest list entries to decode. Fields left out are skipped
+/// without being decoded, and their columns stay empty.
+struct ICEBERG_EXPORT ManifestListProjection {
+  bool manifest_path = true;
+  bool manifest_length = true;
+  bool partition_spec_id = true;
+  bool content = true;
+  /// sequence_number and min_sequence_number
+  bool sequence_numbers = true;
+  bool added_snapshot_id = true;
+  /// The file and row counts: added, existing and deleted
+  bool counts = true;
+  /// The partition field summaries
+  bool partitions = true;
+};
+
+/// \brief Summaries of the partition fields of the manifests of a manifest list, one per
+/// partition field of each manifest's spec, stored in flat columns.
+struct ICEBERG_EXPORT PartitionSummaryColumns {
+  /// The summaries of manifest i are the rows [offsets[i], offsets[i + 1]) of the
+  /// other columns. Manifests without summaries have an empty range.
+  std::vector<int64_t> offsets{0};
+  std::vector<uint8_t> contains_null;
+  /// 1 or 0, or -1 if the writer did not record it
+  std::vector<int8_t> contains_nan;
+  /// Bounds serialized with Iceberg's single-value serialization, null if unknown
+  util::StringColumn lower_bound;
+  util::StringColumn upper_bound;
+};
+
+/// \brief The manifests of a manifest list in columnar form, one row per manifest.
+///
+/// Only the columns of the projected fields are filled; the others stay empty. Fields
+/// absent from version 1 manifest lists take their version 2 defaults: content DATA and
+/// sequence numbers 0. Counts a version 1 writer did not record are -1.
+struct ICEBERG_EXPORT ManifestListColumns {
+  int64_t num_rows = 0;
+  util::StringColumn manifest_path;
+  std::vector<int64_t> manifest_length;
+  std::vector<int32_t> partition_spec_id;
+  std::vector<ManifestContent> content;
+  std::vector<int64_t> sequence_number;
+  std::vector<int64_t> min_sequence_number;
+  std::vector<int64_t> added_snapshot_id;
+  std::vector<int32_t> added_files_count;
+  std::vector<int32_t> existing_files_count;
+  std::vector<int32_t> deleted_files_count;
+  std::vector<int64_t> added_rows_count;
+  std::vector<int64_t> existing_rows_count;
+  std::vector<int64_t> deleted_rows_count;
+  PartitionSummaryColumns partitions;
+};
+
+/// \brief Reads a manifest list, the Avro file a Snapshot's manifest_list points to,
+/// into columns.
+///
+/// The file is streamed one Avro block at a time with avro-cpp. A decoder is planned
+/// once from the writer's schema: fields are matched to the manifest_file fields by
+/// field id, or by name for writers that omit ids, and every value is decoded straight
+/// into its column or skipped, without building a generic datum per manifest.
+/// Unprojected fields and fields the reader does not know, such as key_metadata, are
+/// skipped over.
+class ICEBERG_EXPORT ManifestListReader {
+ public:
+  ~ManifestListReader();
+
+  static Result<std::unique_ptr<ManifestListReader>> Open(
+      const std::shared_ptr<io::InputFile>& file, ManifestListProjection projection = {});
+
+  static Result<std::unique_ptr<ManifestListReader>> Open(
+      io::FileIO& file_io, const std::string& path,
+      ManifestListProjection projection = {});
+
+  /// \brief Decode the next block of the file, appending its manifests to `out`.
+  /// Return the number of manifests appended, 0 at the end of the file.
+  Result<int64_t> ReadBatch(ManifestListColumns* out);
+
+  /// \brief Decode the rest of the file
+  Result<ManifestListColumns> ReadAll();
+
+  const ManifestListProjection& projection() const { return projection_; }
+
+ private:
+  struct Plan;
+
+  ManifestListReader(std::unique_ptr<avro::FileReader> file,
+                     ManifestListProjection projection, std::unique_ptr<Plan> plan);
+
+  std::unique_ptr<avro::FileReader> file_;
+  const ManifestListProjection projection_;
+  std::unique_ptr<Plan> plan_;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(ManifestListReader);
+};
+
+}  // namespace table
+}  // namespace iceberg
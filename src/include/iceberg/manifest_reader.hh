@@ -0,0 +1,137 @@
+#pragma once
+
+#include <avro/Node.hh>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/file_io.hh"
+#include "iceberg/result.hh"
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/string_column.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace avro {
+class FileReader;
+}  // namespace avro
+
+namespace table {
+
+enum class ManifestEntryStatus : int8_t {
+  EXISTING = 0,
+  ADDED = 1,
+  DELETED = 2,
+};
+
+enum class DataFileContent : int8_t {
+  DATA = 0,
+  POSITION_DELETES = 1,
+  EQUALITY_DELETES = 2,
+};
+
+struct ICEBERG_EXPORT ManifestReaderOptions {
+  /// Field ids of the table columns whose metrics are decoded, typically the columns
+  /// referenced by a scan's filter. The metrics of all other columns are skipped over
+  /// without being decoded.
+  std::vector<int32_t> metrics_field_ids;
+  /// Whether to also decode the column_sizes of these columns, which filters do not use
+  bool column_sizes = false;
+  /// Whether to keep the partition tuples
+  bool partition = true;
+};
+
+/// \brief The metrics of one table column in the data files of a manifest, one row per
+/// manifest entry. Metrics a data file does not record are -1, respectively null.
+struct ICEBERG_EXPORT ColumnMetricsColumns {
+  int32_t field_id = 0;
+  /// Only filled if ManifestReaderOptions::column_sizes is set
+  std::vector<int64_t> column_size;
+  std::vector<int64_t> value_count;
+  std::vector<int64_t> null_value_count;
+  std::vector<int64_t> nan_value_count;
+  /// Bounds serialized with Iceberg's single-value serialization
+  util::StringColumn lower_bound;
+  util::StringColumn upper_bound;
+};
+
+/// \brief The entries of a manifest in columnar form, one row per entry.
+struct ICEBERG_EXPORT ManifestEntryColumns {
+  int64_t num_rows = 0;
+  std::vector<ManifestEntryStatus> status;
+  /// -1 if null, i.e. inherited from the manifest
+  std::vector<int64_t> snapshot_id;
+  /// -1 if null, i.e. inherited from the manifest; 0 in version 1 manifests
+  std::vector<int64_t> sequence_number;
+  std::vector<int64_t> file_sequence_number;
+
+  std::vector<DataFileContent> content;
+  util::StringColumn file_path;
+  /// Such as "PARQUET"
+  util::StringColumn file_format;
+  /// The Avro binary encoding of each partition tuple, to be decoded lazily with
+  /// ManifestReader::partition_schema(). Empty if the partition is not kept.
+  util::StringColumn partition;
+  std::vector<int64_t> record_count;
+  std::vector<int64_t> file_size_in_bytes;
+
+  /// The metrics of the columns of ManifestReaderOptions::metrics_field_ids, in order
+  std::vector<ColumnMetricsColumns> metrics;
+};
+
+/// \brief Reads the entries of a manifest file into columns.
+///
+/// In manifests of wide tables, the per-column metrics maps of data files, from
+/// column_sizes to upper_bounds, make up most of the bytes. The file is streamed one
+/// Avro block at a time with avro-cpp, and the reader plans a decoder for the writer's
+/// schema once per file, which walks each entry field by field: the metrics maps are
+/// decoded only for the keys of the requested columns, whose values go straight into
+/// ColumnMetricsColumns, and other keys' values are stepped over without being
+/// decoded. Maps written with byte sizes, and all fields the reader does not know, such
+/// as split_offsets or key_metadata, are skipped whole. Nothing is materialized as a
+/// generic record.
+class ICEBERG_EXPORT ManifestReader {
+ public:
+  ~ManifestReader();
+
+  static Result<std::unique_ptr<ManifestReader>> Open(
+      const std::shared_ptr<io::InputFile>& file, ManifestReaderOptions options = {});
+
+  static Result<std::unique_ptr<ManifestReader>> Open(io::FileIO& file_io,
+                                                      const std::string& path,
+                                                      ManifestReaderOptions options = {});
+
+  /// \brief Decode the next block of the file, appending its entries to `out`. Return
+  /// the number of entries appended, 0 at the end of the file.
+  Result<int64_t> ReadBatch(ManifestEntryColumns* out);
+
+  /// \brief Decode the rest of the file
+  Result<ManifestEntryColumns> ReadAll();
+
+  /// \brief Return the writer's Avro schema of the partition tuples
+  const ::avro::NodePtr& partition_schema() const;
+
+  /// \brief Return a value of the manifest's metadata, such as "partition-spec-id" or
+  /// "format-version", if present
+  std::optional<std::string> metadata(const std::string& key) const;
+
+  const ManifestReaderOptions& options() const { return options_; }
+
+ private:
+  class Plan;
+
+  ManifestReader(std::unique_ptr<avro::FileReader> file,
+                 ManifestReaderOptions options, std::unique_ptr<Plan> plan);
+
+  std::unique_ptr<avro::FileReader> file_;
+  const ManifestReaderOptions options_;
+  std::unique_ptr<Plan> plan_;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(ManifestReader);
+};
+
+}  // namespace table
+}  // namespace iceberg
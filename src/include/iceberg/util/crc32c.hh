@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace util {
+
+/// \brief Extend `crc`, the CRC32C (Castagnoli) of some data, with `length` more bytes.
+///
+/// Start from 0 for the checksum of a single buffer. Uses the CRC32 instructions of
+/// SSE4.2 or ARMv8 where the CPU has them, else table lookups, slicing by 8 bytes.
+ICEBERG_EXPORT uint32_t Crc32c(const void* data, size_t length, uint32_t crc = 0);
+
+/// \brief Return whether Crc32c runs on CRC32 instructions
+ICEBERG_EXPORT bool IsCrc32cAccelerated();
+
+namespace internal {
+
+/// \brief The table based implementation of Crc32c, regardless of the CPU
+ICEBERG_EXPORT uint32_t Crc32cPortable(const void* data, size_t length, uint32_t crc);
+
+}  // namespace internal
+
+}  // namespace util
+}  // namespace iceberg
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace util {
+
+using Sha256Digest = std::array<uint8_t, 32>;
+
+/// \brief Incremental SHA-256 (FIPS 180-4), as needed to sign object store requests.
+class ICEBERG_EXPORT Sha256 {
+ public:
+  Sha256();
+
+  void Update(const void* data, size_t length);
+  void Update(std::string_view data) { Update(data.data(), data.size()); }
+
+  /// \brief Return the digest of the data so far; the hasher must not be reused after
+  Sha256Digest Finish();
+
+ private:
+  void Compress(const uint8_t* block);
+
+  uint32_t state_[8];
+  uint8_t block_[64];
+  size_t block_size_ = 0;
+  uint64_t length_ = 0;
+};
+
+/// \brief Return the SHA-256 digest of `data`
+ICEBERG_EXPORT Sha256Digest Sha256Hash(std::string_view data);
+
+/// \brief Return the HMAC-SHA256 (RFC 2104) of `data` under `key`
+ICEBERG_EXPORT Sha256Digest HmacSha256(std::string_view key, std::string_view data);
+
+/// \brief Return a digest as lowercase hexadecimal
+ICEBERG_EXPORT std::string ToHex(const Sha256Digest& digest);
+
+}  // namespace util
+}  // namespace iceberg
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace util {
+
+/// \brief A column of nullable strings or binary values, stored back to back in one
+/// buffer.
+///
+/// Appending costs no allocation per value, unlike a vector of strings, and the values
+/// of thousands of rows stay contiguous in memory.
+class ICEBERG_EXPORT StringColumn {
+ public:
+  int64_t size() const { return static_cast<int64_t>(valid_.size()); }
+
+  bool empty() const { return valid_.empty(); }
+
+  /// \brief Return the value of row i, or an empty view if it is null
+  std::string_view operator[](int64_t i) const {
+    return std::string_view(data_.data() + offsets_[i],
+                            static_cast<size_t>(offsets_[i + 1] - offsets_[i]));
+  }
+
+  bool IsNull(int64_t i) const { return !valid_[i]; }
+
+  void Append(std::string_view value) {
+    data_.append(value.data(), value.size());
+    offsets_.push_back(static_cast<int64_t>(data_.size()));
+    valid_.push_back(1);
+  }
+
+  void AppendNull() {
+    offsets_.push_back(static_cast<int64_t>(data_.size()));
+    valid_.push_back(0);
+  }
+
+  void Reserve(int64_t rows, int64_t bytes) {
+    offsets_.reserve(static_cast<size_t>(rows + 1));
+    valid_.reserve(static_cast<size_t>(rows));
+    data_.reserve(static_cast<size_t>(bytes));
+  }
+
+  void Clear() {
+    data_.clear();
+    offsets_.assign(1, 0);
+    valid_.clear();
+  }
+
+  /// \brief Return the total size of the values
+  int64_t data_size() const { return static_cast<int64_t>(data_.size()); }
+
+ private:
+  std::string data_;
+  std::vector<int64_t> offsets_{0};
+  std::vector<uint8_t> valid_;
+};
+
+}  // namespace util
+}  // namespace iceberg
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/visibility.hh"
+
+namespace iceberg {
+namespace util {
+
+/// \brief A fixed-size pool of worker threads executing tasks in FIFO order.
+class ICEBERG_EXPORT ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads);
+
+  /// \brief Run the queued tasks to completion and join the workers
+  ~ThreadPool();
+
+  /// \brief Return the number of worker threads
+  int num_threads() const { return static_cast<int>(workers_.size()); }
+
+  /// \brief Queue a task for execution, without a way to wait for its completion
+  void Spawn(std::function<void()> task);
+
+  /// \brief Queue a callable and return a future for its result
+  template <typename Function, typename R = std::invoke_result_t<Function>>
+  std::future<R> Submit(Function&& func) {
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<Function>(func));
+    std::future<R> future = task->get_future();
+    Spawn([task]() { (*task)(); });
+    return future;
+  }
+
+ private:
+  void WorkerLoop();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool shutdown_ = false;
+  std::vector<std::thread> workers_;
+
+  ICEBERG_DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+/// \brief Return the process-wide thread pool used for blocking I/O.
+///
+/// Its size defaults to 8 threads and can be overridden with the ICEBERG_IO_THREADS
+/// environment variable.
+ICEBERG_EXPORT ThreadPool* GetIOThreadPool();
+
+}  // namespace util
+}  // namespace iceberg
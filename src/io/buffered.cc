@@ -0,0 +1,258 @@
+#include "iceberg/io/buffered.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "iceberg/util/logging.hh"
+
+namespace iceberg {
+namespace io {
+
+BufferedInputStream::BufferedInputStream(int64_t buffer_size,
+                                         std::shared_ptr<InputStream> raw,
+                                         std::shared_ptr<Buffer> buffer, int64_t raw_pos)
+    : buffer_size_(buffer_size),
+      raw_(std::move(raw)),
+      buffer_(std::move(buffer)),
+      raw_pos_(raw_pos) {}
+
+BufferedInputStream::~BufferedInputStream() {
+  if (!closed()) {
+    ICEBERG_CHECK_OK(Close());
+  }
+}
+
+Result<std::shared_ptr<BufferedInputStream>> BufferedInputStream::Create(
+    int64_t buffer_size, std::shared_ptr<InputStream> raw) {
+  if (buffer_size <= 0) {
+    return Status::Invalid("Buffer size must be positive");
+  }
+  ICEBERG_ASSIGN_OR_RAISE(int64_t raw_pos, raw->Tell());
+  ICEBERG_ASSIGN_OR_RAISE(auto buffer, AllocateBuffer(buffer_size));
+  return std::shared_ptr<BufferedInputStream>(
+      new BufferedInputStream(buffer_size, std::move(raw), std::move(buffer), raw_pos));
+}
+
+Status BufferedInputStream::Close() {
+  if (closed_) {
+    return Status::OK();
+  }
+  closed_ = true;
+  buffer_.reset();
+  bytes_buffered_ = 0;
+  return raw_->Close();
+}
+
+Result<int64_t> BufferedInputStream::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return raw_pos_ - bytes_buffered_;
+}
+
+bool BufferedInputStream::closed() const { return closed_; }
+
+Status BufferedInputStream::FillBuffer(int64_t nbytes) {
+  if (nbytes > buffer_->size()) {
+    ICEBERG_ASSIGN_OR_RAISE(auto larger, AllocateBuffer(nbytes));
+    std::memcpy(larger->mutable_data(), buffer_->data() + buffer_pos_,
+                static_cast<size_t>(bytes_buffered_));
+    buffer_ = std::move(larger);
+  } else if (buffer_pos_ > 0) {
+    std::memmove(buffer_->mutable_data(), buffer_->data() + buffer_pos_,
+                 static_cast<size_t>(bytes_buffered_));
+  }
+  buffer_pos_ = 0;
+  while (bytes_buffered_ < nbytes) {
+    ICEBERG_ASSIGN_OR_RAISE(
+        int64_t bytes_read,
+        raw_->Read(buffer_->size() - bytes_buffered_,
+                   buffer_->mutable_data() + bytes_buffered_));
+    if (bytes_read == 0) {
+      // EOF
+      break;
+    }
+    bytes_buffered_ += bytes_read;
+    raw_pos_ += bytes_read;
+  }
+  return Status::OK();
+}
+
+Result<int64_t> BufferedInputStream::Read(int64_t nbytes, void* out) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (nbytes < 0) {
+    return Status::Invalid("Cannot read a negative number of bytes");
+  }
+  uint8_t* dest = reinterpret_cast<uint8_t*>(out);
+  int64_t total_bytes_read = std::min(nbytes, bytes_buffered_);
+  if (total_bytes_read > 0) {
+    std::memcpy(dest, buffer_->data() + buffer_pos_,
+                static_cast<size_t>(total_bytes_read));
+    buffer_pos_ += total_bytes_read;
+    bytes_buffered_ -= total_bytes_read;
+  }
+  const int64_t remaining = nbytes - total_bytes_read;
+  if (remaining == 0) {
+    return total_bytes_read;
+  }
+  if (remaining >= buffer_size_) {
+    // Large read: go straight to the raw stream instead of copying through the buffer
+    ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read,
+                            raw_->Read(remaining, dest + total_bytes_read));
+    raw_pos_ += bytes_read;
+    return total_bytes_read + bytes_read;
+  }
+  ICEBERG_RETURN_NOT_OK(FillBuffer(std::min(remaining, buffer_size_)));
+  const int64_t from_buffer = std::min(remaining, bytes_buffered_);
+  std::memcpy(dest + total_bytes_read, buffer_->data() + buffer_pos_,
+              static_cast<size_t>(from_buffer));
+  buffer_pos_ += from_buffer;
+  bytes_buffered_ -= from_buffer;
+  return total_bytes_read + from_buffer;
+}
+
+Status BufferedInputStream::Advance(int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (nbytes < 0) {
+    return Status::Invalid("Cannot advance by a negative number of bytes");
+  }
+  const int64_t from_buffer = std::min(nbytes, bytes_buffered_);
+  buffer_pos_ += from_buffer;
+  bytes_buffered_ -= from_buffer;
+  const int64_t remaining = nbytes - from_buffer;
+  if (remaining == 0) {
+    return Status::OK();
+  }
+  ICEBERG_RETURN_NOT_OK(raw_->Advance(remaining));
+  auto raw_pos = raw_->Tell();
+  raw_pos_ = raw_pos.ok() ? raw_pos.ValueUnsafe() : raw_pos_ + remaining;
+  return Status::OK();
+}
+
+Result<std::string_view> BufferedInputStream::Peek(int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (nbytes < 0) {
+    return Status::Invalid("Cannot peek a negative number of bytes");
+  }
+  if (nbytes > bytes_buffered_) {
+    ICEBERG_RETURN_NOT_OK(FillBuffer(nbytes));
+  }
+  return std::string_view(reinterpret_cast<const char*>(buffer_->data() + buffer_pos_),
+                          static_cast<size_t>(std::min(nbytes, bytes_buffered_)));
+}
+
+Status BufferedInputStream::CheckClosed() const {
+  if (closed()) {
+    return Status::Invalid("Operation on closed stream");
+  }
+  return Status::OK();
+}
+
+BufferedOutputStream::BufferedOutputStream(std::shared_ptr<OutputStream> raw,
+                                           std::shared_ptr<Buffer> buffer,
+                                           int64_t raw_pos)
+    : raw_(std::move(raw)), buffer_(std::move(buffer)), raw_pos_(raw_pos) {}
+
+BufferedOutputStream::~BufferedOutputStream() {
+  if (!closed()) {
+    // Closing flushes the buffer, which may fail for reasons such as a full disk that
+    // must not take down the process
+    ICEBERG_WARN_NOT_OK(Close(), "Failed to close BufferedOutputStream on destruction");
+  }
+}
+
+Result<std::shared_ptr<BufferedOutputStream>> BufferedOutputStream::Create(
+    int64_t buffer_size, std::shared_ptr<OutputStream> raw) {
+  if (buffer_size <= 0) {
+    return Status::Invalid("Buffer size must be positive");
+  }
+  ICEBERG_ASSIGN_OR_RAISE(int64_t raw_pos, raw->Tell());
+  ICEBERG_ASSIGN_OR_RAISE(auto buffer, AllocateBuffer(buffer_size));
+  return std::shared_ptr<BufferedOutputStream>(
+      new BufferedOutputStream(std::move(raw), std::move(buffer), raw_pos));
+}
+
+Status BufferedOutputStream::Close() {
+  if (closed_) {
+    return Status::OK();
+  }
+  closed_ = true;
+  Status st = FlushBuffer();
+  st &= raw_->Close();
+  return st;
+}
+
+Result<int64_t> BufferedOutputStream::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return raw_pos_ + bytes_buffered_;
+}
+
+bool BufferedOutputStream::closed() const { return closed_; }
+
+Status BufferedOutputStream::Write(const void* data, int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (nbytes < 0) {
+    return Status::Invalid("Cannot write a negative number of bytes");
+  }
+  if (bytes_buffered_ + nbytes <= buffer_->size()) {
+    std::memcpy(buffer_->mutable_data() + bytes_buffered_, data,
+                static_cast<size_t>(nbytes));
+    bytes_buffered_ += nbytes;
+    if (bytes_buffered_ == buffer_->size()) {
+      return FlushBuffer();
+    }
+    return Status::OK();
+  }
+  ICEBERG_RETURN_NOT_OK(FlushBuffer());
+  if (nbytes >= buffer_->size()) {
+    // Large write: hand it to the raw stream without copying it through the buffer
+    ICEBERG_RETURN_NOT_OK(raw_->Write(data, nbytes));
+    raw_pos_ += nbytes;
+    return Status::OK();
+  }
+  std::memcpy(buffer_->mutable_data(), data, static_cast<size_t>(nbytes));
+  bytes_buffered_ = nbytes;
+  return Status::OK();
+}
+
+Status BufferedOutputStream::Write(const std::shared_ptr<Buffer>& data) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (data->size() < buffer_->size()) {
+    return Write(data->data(), data->size());
+  }
+  ICEBERG_RETURN_NOT_OK(FlushBuffer());
+  ICEBERG_RETURN_NOT_OK(raw_->Write(data));
+  raw_pos_ += data->size();
+  return Status::OK();
+}
+
+Status BufferedOutputStream::FlushBuffer() {
+  if (bytes_buffered_ > 0) {
+    // Drop the buffered bytes even on failure, so that a retried Close terminates
+    const int64_t nbytes = bytes_buffered_;
+    bytes_buffered_ = 0;
+    ICEBERG_RETURN_NOT_OK(raw_->Write(buffer_->data(), nbytes));
+    raw_pos_ += nbytes;
+  }
+  return Status::OK();
+}
+
+Status BufferedOutputStream::Flush() {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  ICEBERG_RETURN_NOT_OK(FlushBuffer());
+  return raw_->Flush();
+}
+
+Status BufferedOutputStream::Sync() {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  ICEBERG_RETURN_NOT_OK(FlushBuffer());
+  return raw_->Sync();
+}
+
+Status BufferedOutputStream::CheckClosed() const {
+  if (closed()) {
+    return Status::Invalid("Operation on closed stream");
+  }
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace iceberg
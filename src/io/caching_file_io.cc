@@ -0,0 +1,464 @@
+#include "iceberg/io/caching_file_io.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+struct BlockKey {
+  std::string location;
+  int64_t block_index;
+
+  bool operator==(const BlockKey& other) const {
+    return block_index == other.block_index && location == other.location;
+  }
+};
+
+struct BlockKeyHash {
+  size_t operator()(const BlockKey& key) const {
+    size_t h = std::hash<std::string>()(key.location);
+    return h ^ (std::hash<int64_t>()(key.block_index) + 0x9e3779b97f4a7c15ULL + (h << 6) +
+                (h >> 2));
+  }
+};
+
+}  // namespace
+
+struct BlockCache::Shard {
+  using Entry = std::pair<BlockKey, std::shared_ptr<Buffer>>;
+
+  std::mutex mutex;
+  int64_t capacity = 0;
+  int64_t size = 0;
+  int64_t evictions = 0;
+  // Most recently used first
+  std::list<Entry> lru;
+  std::unordered_map<BlockKey, std::list<Entry>::iterator, BlockKeyHash> index;
+  // Block indexes of each location, for Erase
+  std::unordered_map<std::string, std::unordered_set<int64_t>> blocks_of;
+  // Fetches in flight
+  std::unordered_map<BlockKey, std::shared_ptr<PendingBlock>, BlockKeyHash> pending;
+
+  void Remove(std::list<Entry>::iterator it) {
+    size -= it->second->size();
+    auto blocks = blocks_of.find(it->first.location);
+    blocks->second.erase(it->first.block_index);
+    if (blocks->second.empty()) {
+      blocks_of.erase(blocks);
+    }
+    index.erase(it->first);
+    lru.erase(it);
+  }
+
+  void Insert(BlockKey key, std::shared_ptr<Buffer> block) {
+    auto it = index.find(key);
+    if (it != index.end()) {
+      Remove(it->second);
+    }
+    if (block->size() > capacity) {
+      return;
+    }
+    while (size + block->size() > capacity && !lru.empty()) {
+      Remove(std::prev(lru.end()));
+      ++evictions;
+    }
+    size += block->size();
+    blocks_of[key.location].insert(key.block_index);
+    lru.emplace_front(key, std::move(block));
+    index.emplace(std::move(key), lru.begin());
+  }
+};
+
+Result<std::shared_ptr<Buffer>> BlockCache::PendingBlock::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this]() { return result_.has_value(); });
+  return *result_;
+}
+
+BlockCache::BlockCache(BlockCacheOptions options) : options_(options) {
+  options_.num_shards = std::max(options_.num_shards, 1);
+  for (int i = 0; i < options_.num_shards; ++i) {
+    auto shard = std::make_unique<Shard>();
+    shard->capacity = options_.capacity / options_.num_shards;
+    shards_.push_back(std::move(shard));
+  }
+}
+
+BlockCache::~BlockCache() = default;
+
+BlockCache::Shard& BlockCache::ShardFor(const std::string& location,
+                                        int64_t block_index) {
+  const size_t h = BlockKeyHash()(BlockKey{location, block_index});
+  return *shards_[(h >> 8) % shards_.size()];
+}
+
+std::shared_ptr<Buffer> BlockCache::Lookup(const std::string& location,
+                                           int64_t block_index) {
+  Shard& shard = ShardFor(location, block_index);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(BlockKey{location, block_index});
+  if (it == shard.index.end()) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  return it->second->second;
+}
+
+void BlockCache::Insert(const std::string& location, int64_t block_index,
+                        std::shared_ptr<Buffer> block) {
+  Shard& shard = ShardFor(location, block_index);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.Insert(BlockKey{location, block_index}, std::move(block));
+}
+
+BlockCache::Claimed BlockCache::Claim(const std::string& location, int64_t block_index) {
+  Shard& shard = ShardFor(location, block_index);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  BlockKey key{location, block_index};
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return Claimed{it->second->second, nullptr, false};
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  auto pending = shard.pending.find(key);
+  if (pending != shard.pending.end()) {
+    return Claimed{nullptr, pending->second, false};
+  }
+  auto fetch = std::make_shared<PendingBlock>();
+  shard.pending.emplace(std::move(key), fetch);
+  return Claimed{nullptr, std::move(fetch), true};
+}
+
+void BlockCache::Complete(const std::string& location, int64_t block_index,
+                          const std::shared_ptr<PendingBlock>& pending,
+                          Result<std::shared_ptr<Buffer>> block) {
+  {
+    Shard& shard = ShardFor(location, block_index);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    BlockKey key{location, block_index};
+    auto it = shard.pending.find(key);
+    // Erase detaches the fetch; its block may predate a rewrite of the file
+    if (it != shard.pending.end() && it->second == pending) {
+      shard.pending.erase(it);
+      if (block.ok() && (*block)->size() > 0) {
+        shard.Insert(std::move(key), *block);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lock(pending->mutex_);
+  pending->result_ = std::move(block);
+  pending->done_.notify_all();
+}
+
+void BlockCache::Erase(const std::string& location) {
+  // Blocks of one file are spread over all shards
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    auto blocks = shard->blocks_of.find(location);
+    if (blocks != shard->blocks_of.end()) {
+      const std::vector<int64_t> indexes(blocks->second.begin(), blocks->second.end());
+      for (int64_t block_index : indexes) {
+        shard->Remove(shard->index.at(BlockKey{location, block_index}));
+      }
+    }
+    // Only as many fetches as concurrent misses are ever in flight
+    for (auto it = shard->pending.begin(); it != shard->pending.end();) {
+      it = it->first.location == location ? shard->pending.erase(it) : std::next(it);
+    }
+  }
+}
+
+int64_t BlockCache::size() const {
+  int64_t total = 0;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    total += shard->size;
+  }
+  return total;
+}
+
+BlockCache::Stats BlockCache::stats() const {
+  Stats stats{hits_.load(), misses_.load(), 0};
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    stats.evictions += shard->evictions;
+  }
+  return stats;
+}
+
+namespace {
+
+class CachingInputStream : public SeekableInputStream {
+ public:
+  CachingInputStream(std::shared_ptr<InputFile> base_file,
+                     std::shared_ptr<BlockCache> cache, int64_t length)
+      : base_file_(std::move(base_file)), cache_(std::move(cache)), length_(length) {}
+
+  ~CachingInputStream() override {
+    if (base_stream_ != nullptr && !base_stream_->closed()) {
+      ICEBERG_WARN_NOT_OK(base_stream_->Close(), "Failed to close cached stream");
+    }
+  }
+
+  Status Close() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    if (base_stream_ != nullptr) {
+      return base_stream_->Close();
+    }
+    return Status::OK();
+  }
+
+  Result<int64_t> Tell() const override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    return position_;
+  }
+
+  bool closed() const override { return closed_; }
+
+  Status Seek(int64_t position) override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    if (position < 0) {
+      return Status::Invalid("Invalid position");
+    }
+    position_ = position;
+    return Status::OK();
+  }
+
+  using SeekableInputStream::Read;
+  Result<int64_t> Read(int64_t nbytes, void* out) override {
+    ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read, ReadAt(position_, nbytes, out));
+    position_ += bytes_read;
+    return bytes_read;
+  }
+
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    if (position < 0 || nbytes < 0) {
+      return Status::Invalid("Invalid read range");
+    }
+    nbytes = std::min(nbytes, std::max<int64_t>(0, length_ - position));
+    if (nbytes == 0) {
+      return 0;
+    }
+    const int64_t block_size = cache_->options().block_size;
+    const int64_t first = position / block_size;
+    const int64_t last = (position + nbytes - 1) / block_size;
+    ICEBERG_ASSIGN_OR_RAISE(auto blocks, GetBlocks(first, last));
+
+    uint8_t* dest = reinterpret_cast<uint8_t*>(out);
+    int64_t copied = 0;
+    for (int64_t i = first; i <= last && copied < nbytes; ++i) {
+      const auto& block = blocks[i - first];
+      const int64_t offset = position + copied - i * block_size;
+      const int64_t n = std::min(nbytes - copied, block->size() - offset);
+      if (n <= 0) {
+        break;
+      }
+      std::memcpy(dest + copied, block->data() + offset, static_cast<size_t>(n));
+      copied += n;
+    }
+    return copied;
+  }
+
+  /// \brief Return a slice of the cached block if the range lies within one block
+  Result<std::shared_ptr<Buffer>> ReadAt(int64_t position, int64_t nbytes) override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    const int64_t block_size = cache_->options().block_size;
+    if (position >= 0 && nbytes > 0 &&
+        position / block_size == (position + nbytes - 1) / block_size) {
+      ICEBERG_ASSIGN_OR_RAISE(auto blocks,
+                              GetBlocks(position / block_size, position / block_size));
+      const auto& block = blocks[0];
+      const int64_t offset = std::min(position % block_size, block->size());
+      return SliceBuffer(block, offset, std::min(nbytes, block->size() - offset));
+    }
+    return SeekableInputStream::ReadAt(position, nbytes);
+  }
+
+ private:
+  Status CheckClosed() const {
+    if (closed_) {
+      return Status::Invalid("Invalid operation on closed file");
+    }
+    return Status::OK();
+  }
+
+  Result<std::shared_ptr<SeekableInputStream>> BaseStream() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (base_stream_ == nullptr) {
+      ICEBERG_ASSIGN_OR_RAISE(base_stream_, base_file_->newStream());
+    }
+    return base_stream_;
+  }
+
+  // Return blocks [first, last], fetching each run of consecutive misses with one read.
+  // Blocks whose fetch another reader started are waited for once this reader's own
+  // fetches are done, so that two readers never wait on each other.
+  Result<std::vector<std::shared_ptr<Buffer>>> GetBlocks(int64_t first, int64_t last) {
+    const std::string& location = base_file_->location();
+    std::vector<BlockCache::Claimed> claims;
+    claims.reserve(static_cast<size_t>(last - first + 1));
+    for (int64_t i = first; i <= last; ++i) {
+      claims.push_back(cache_->Claim(location, i));
+    }
+    Status status;
+    for (int64_t run_start = first; run_start <= last;) {
+      if (!claims[run_start - first].owner) {
+        ++run_start;
+        continue;
+      }
+      int64_t run_end = run_start;
+      while (run_end + 1 <= last && claims[run_end + 1 - first].owner) {
+        ++run_end;
+      }
+      // Every owned fetch is completed, failed ones included, to release its waiters
+      auto data = status.ok() ? ReadRun(run_start, run_end)
+                              : Result<std::shared_ptr<Buffer>>(status);
+      for (int64_t i = run_start; i <= run_end; ++i) {
+        auto& claim = claims[i - first];
+        Result<std::shared_ptr<Buffer>> block =
+            data.ok() ? SliceBlock(*data, i - run_start) : data.status();
+        if (block.ok()) {
+          claim.block = *block;
+        } else if (status.ok()) {
+          status = block.status();
+        }
+        cache_->Complete(location, i, claim.pending, std::move(block));
+      }
+      run_start = run_end + 1;
+    }
+    ICEBERG_RETURN_NOT_OK(status);
+    std::vector<std::shared_ptr<Buffer>> blocks;
+    blocks.reserve(claims.size());
+    for (auto& claim : claims) {
+      if (claim.block == nullptr) {
+        ICEBERG_ASSIGN_OR_RAISE(claim.block, claim.pending->Wait());
+      }
+      blocks.push_back(std::move(claim.block));
+    }
+    return blocks;
+  }
+
+  Result<std::shared_ptr<Buffer>> ReadRun(int64_t run_start, int64_t run_end) {
+    const int64_t block_size = cache_->options().block_size;
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, BaseStream());
+    return stream->ReadAt(run_start * block_size, (run_end - run_start + 1) * block_size);
+  }
+
+  // The block at `index` blocks into the run `data`
+  Result<std::shared_ptr<Buffer>> SliceBlock(const std::shared_ptr<Buffer>& data,
+                                             int64_t index) {
+    const int64_t block_size = cache_->options().block_size;
+    const int64_t offset = std::min(index * block_size, data->size());
+    std::shared_ptr<Buffer> block =
+        SliceBuffer(data, offset, std::min(block_size, data->size() - offset));
+    // A cached slice would keep the whole run alive past the cache's capacity
+    if (block->size() < data->size()) {
+      ICEBERG_ASSIGN_OR_RAISE(block, Buffer::CopyOf(block->ToStringView()));
+    }
+    return block;
+  }
+
+  std::shared_ptr<InputFile> base_file_;
+  std::shared_ptr<BlockCache> cache_;
+  const int64_t length_;
+  int64_t position_ = 0;
+  std::atomic<bool> closed_{false};
+  std::mutex mutex_;
+  std::shared_ptr<SeekableInputStream> base_stream_;
+};
+
+class CachingInputFile : public InputFile {
+ public:
+  CachingInputFile(std::shared_ptr<InputFile> base, std::shared_ptr<BlockCache> cache,
+                   int64_t length)
+      : InputFile(base->location()),
+        base_(std::move(base)),
+        cache_(std::move(cache)),
+        length_(length) {}
+
+  Result<int64_t> getLength() override {
+    int64_t length = length_.load();
+    if (length < 0) {
+      ICEBERG_ASSIGN_OR_RAISE(length, base_->getLength());
+      length_.store(length);
+    }
+    return length;
+  }
+
+  Result<std::shared_ptr<SeekableInputStream>> newStream() override {
+    ICEBERG_ASSIGN_OR_RAISE(int64_t length, getLength());
+    return std::make_shared<CachingInputStream>(base_, cache_, length);
+  }
+
+  bool exists() const override { return base_->exists(); }
+
+ private:
+  std::shared_ptr<InputFile> base_;
+  std::shared_ptr<BlockCache> cache_;
+  // -1 until known
+  std::atomic<int64_t> length_;
+};
+
+}  // namespace
+
+bool CachingFileIO::Equals(const FileIO& other) const {
+  auto caching = dynamic_cast<const CachingFileIO*>(&other);
+  return caching != nullptr && cache_ == caching->cache_ && base_->Equals(*caching->base_);
+}
+
+Result<std::shared_ptr<InputFile>> CachingFileIO::newInputFile(const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newInputFile(path));
+  return std::make_shared<CachingInputFile>(std::move(base), cache_, -1);
+}
+
+Result<std::shared_ptr<InputFile>> CachingFileIO::newInputFile(const std::string& path,
+                                                               int64_t length) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newInputFile(path, length));
+  return std::make_shared<CachingInputFile>(std::move(base), cache_, length);
+}
+
+Result<std::shared_ptr<OutputFile>> CachingFileIO::newOutputFile(
+    const std::string& path) {
+  cache_->Erase(path);
+  return base_->newOutputFile(path);
+}
+
+Status CachingFileIO::DeleteFile(const std::string& path) {
+  cache_->Erase(path);
+  return base_->DeleteFile(path);
+}
+
+Result<DeleteFilesResult> CachingFileIO::DeleteFiles(
+    const std::vector<std::string>& paths, const DeleteFilesOptions& options) {
+  for (const auto& path : paths) {
+    cache_->Erase(path);
+  }
+  return base_->DeleteFiles(paths, options);
+}
+
+Result<std::unique_ptr<FileInfoIterator>> CachingFileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  return base_->ListPrefix(prefix, options);
+}
+
+Status CachingFileIO::CopyFile(const std::string& src, const std::string& dst) {
+  cache_->Erase(dst);
+  return base_->CopyFile(src, dst);
+}
+
+}  // namespace io
+}  // namespace iceberg
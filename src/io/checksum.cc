@@ -0,0 +1,518 @@
+#include "iceberg/io/checksum.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "iceberg/util/crc32c.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+constexpr char kMagic[] = "ICRC";
+constexpr size_t kMagicSize = 4;
+constexpr uint8_t kVersion = 1;
+// Magic, version, length, block size and number of checksums
+constexpr size_t kHeaderSize = kMagicSize + 1 + 8 + 8 + 4;
+
+void PutLittleEndian(std::string* out, uint64_t value, int nbytes) {
+  for (int i = 0; i < nbytes; ++i) {
+    out->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+uint64_t GetLittleEndian(const char* data, int nbytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < nbytes; ++i) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+  }
+  return value;
+}
+
+// The number of checksums of a file of `length` bytes
+int64_t NumBlocks(int64_t length, int64_t block_size) {
+  return block_size == 0 ? 1 : (length + block_size - 1) / block_size;
+}
+
+std::string SidecarPath(const std::string& path) { return path + kChecksumFileSuffix; }
+
+bool IsSidecarPath(const std::string& path) {
+  const size_t suffix = sizeof(kChecksumFileSuffix) - 1;
+  return path.size() >= suffix &&
+         path.compare(path.size() - suffix, suffix, kChecksumFileSuffix) == 0;
+}
+
+}  // namespace
+
+std::string FileChecksums::Serialize() const {
+  std::string out(kMagic, kMagicSize);
+  out.push_back(static_cast<char>(kVersion));
+  PutLittleEndian(&out, static_cast<uint64_t>(length), 8);
+  PutLittleEndian(&out, static_cast<uint64_t>(block_size), 8);
+  PutLittleEndian(&out, crcs.size(), 4);
+  for (uint32_t crc : crcs) {
+    PutLittleEndian(&out, crc, 4);
+  }
+  PutLittleEndian(&out, util::Crc32c(out.data(), out.size()), 4);
+  return out;
+}
+
+Result<FileChecksums> FileChecksums::Deserialize(std::string_view data) {
+  if (data.size() < kHeaderSize + 4 || data.compare(0, kMagicSize, kMagic) != 0) {
+    return Status::IOError("Invalid checksum file");
+  }
+  const size_t body = data.size() - 4;
+  if (util::Crc32c(data.data(), body) != GetLittleEndian(data.data() + body, 4)) {
+    return Status::IOError("Corrupted checksum file");
+  }
+  if (static_cast<uint8_t>(data[kMagicSize]) != kVersion) {
+    return Status::IOError("Unsupported checksum file version: ",
+                           static_cast<int>(data[kMagicSize]));
+  }
+  FileChecksums checksums;
+  const char* next = data.data() + kMagicSize + 1;
+  checksums.length = static_cast<int64_t>(GetLittleEndian(next, 8));
+  checksums.block_size = static_cast<int64_t>(GetLittleEndian(next + 8, 8));
+  const uint64_t count = GetLittleEndian(next + 16, 4);
+  if (checksums.length < 0 || checksums.block_size < 0 ||
+      static_cast<int64_t>(count) != NumBlocks(checksums.length, checksums.block_size) ||
+      body != kHeaderSize + 4 * count) {
+    return Status::IOError("Inconsistent checksum file");
+  }
+  checksums.crcs.reserve(count);
+  for (next = data.data() + kHeaderSize; next < data.data() + body; next += 4) {
+    checksums.crcs.push_back(static_cast<uint32_t>(GetLittleEndian(next, 4)));
+  }
+  return checksums;
+}
+
+FileChecksums ComputeChecksums(const void* data, int64_t length, int64_t block_size) {
+  FileChecksums checksums;
+  checksums.length = length;
+  checksums.block_size = block_size;
+  const auto bytes = static_cast<const uint8_t*>(data);
+  if (block_size == 0) {
+    checksums.crcs.push_back(util::Crc32c(bytes, static_cast<size_t>(length)));
+    return checksums;
+  }
+  for (int64_t offset = 0; offset < length; offset += block_size) {
+    const int64_t n = std::min(block_size, length - offset);
+    checksums.crcs.push_back(util::Crc32c(bytes + offset, static_cast<size_t>(n)));
+  }
+  return checksums;
+}
+
+ChecksummingOutputStream::ChecksummingOutputStream(
+    std::shared_ptr<PositionOutputStream> base, int64_t block_size,
+    std::shared_ptr<OutputFile> sidecar)
+    : base_(std::move(base)), sidecar_(std::move(sidecar)) {
+  checksums_.block_size = block_size;
+}
+
+Result<std::shared_ptr<ChecksummingOutputStream>> ChecksummingOutputStream::Create(
+    std::shared_ptr<PositionOutputStream> base, int64_t block_size,
+    std::shared_ptr<OutputFile> sidecar) {
+  if (block_size < 0) {
+    return Status::Invalid("Invalid checksum block size: ", block_size);
+  }
+  return std::shared_ptr<ChecksummingOutputStream>(
+      new ChecksummingOutputStream(std::move(base), block_size, std::move(sidecar)));
+}
+
+Status ChecksummingOutputStream::Close() {
+  if (closed_) {
+    return Status::OK();
+  }
+  closed_ = true;
+  ICEBERG_RETURN_NOT_OK(base_->Close());
+  // The last, partial block; a whole file checksum is the only block, even if empty
+  if (block_filled_ > 0 || checksums_.block_size == 0) {
+    checksums_.crcs.push_back(block_crc_);
+  }
+  return WriteSidecar();
+}
+
+Result<int64_t> ChecksummingOutputStream::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return checksums_.length;
+}
+
+bool ChecksummingOutputStream::closed() const { return closed_; }
+
+Status ChecksummingOutputStream::Write(const void* data, int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  ICEBERG_RETURN_NOT_OK(base_->Write(data, nbytes));
+  auto next = static_cast<const uint8_t*>(data);
+  const int64_t block_size = checksums_.block_size;
+  for (int64_t remaining = nbytes; remaining > 0;) {
+    const int64_t n =
+        block_size == 0 ? remaining : std::min(remaining, block_size - block_filled_);
+    block_crc_ = util::Crc32c(next, static_cast<size_t>(n), block_crc_);
+    block_filled_ += n;
+    next += n;
+    remaining -= n;
+    if (block_filled_ == block_size) {
+      checksums_.crcs.push_back(block_crc_);
+      block_crc_ = 0;
+      block_filled_ = 0;
+    }
+  }
+  checksums_.length += nbytes;
+  return Status::OK();
+}
+
+Status ChecksummingOutputStream::Flush() {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return base_->Flush();
+}
+
+Status ChecksummingOutputStream::Sync() {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return base_->Sync();
+}
+
+Status ChecksummingOutputStream::WriteSidecar() {
+  if (sidecar_ == nullptr) {
+    return Status::OK();
+  }
+  // A sidecar left over from an earlier file of the same name is stale
+  ICEBERG_ASSIGN_OR_RAISE(auto stream, sidecar_->createOrOverwrite());
+  ICEBERG_RETURN_NOT_OK(stream->Write(checksums_.Serialize()));
+  return stream->Close();
+}
+
+Status ChecksummingOutputStream::CheckClosed() const {
+  if (closed_) {
+    return Status::Invalid("Operation on closed stream");
+  }
+  return Status::OK();
+}
+
+VerifyingInputStream::VerifyingInputStream(std::shared_ptr<SeekableInputStream> base,
+                                           FileChecksums checksums)
+    : base_(std::move(base)), checksums_(std::move(checksums)) {}
+
+Result<std::shared_ptr<VerifyingInputStream>> VerifyingInputStream::Create(
+    std::shared_ptr<SeekableInputStream> base, FileChecksums checksums) {
+  if (checksums.length < 0 || checksums.block_size < 0 ||
+      checksums.num_blocks() != NumBlocks(checksums.length, checksums.block_size)) {
+    return Status::Invalid("Inconsistent checksums");
+  }
+  return std::shared_ptr<VerifyingInputStream>(
+      new VerifyingInputStream(std::move(base), std::move(checksums)));
+}
+
+Status VerifyingInputStream::Close() {
+  current_.reset();
+  return base_->Close();
+}
+
+Result<int64_t> VerifyingInputStream::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return position_;
+}
+
+bool VerifyingInputStream::closed() const { return base_->closed(); }
+
+Status VerifyingInputStream::Seek(int64_t position) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (position < 0) {
+    return Status::Invalid("Invalid seek position: ", position);
+  }
+  position_ = position;
+  return Status::OK();
+}
+
+Result<int64_t> VerifyingInputStream::Read(int64_t nbytes, void* out) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (checksums_.block_size == 0) {
+    return ReadWholeFile(nbytes, out);
+  }
+  const int64_t block_size = checksums_.block_size;
+  auto next = static_cast<uint8_t*>(out);
+  int64_t total = 0;
+  while (total < nbytes && position_ < checksums_.length) {
+    const int64_t block = position_ / block_size;
+    const int64_t offset = position_ % block_size;
+    const int64_t block_length = BlockLength(block);
+    const int64_t n = std::min(nbytes - total, block_length - offset);
+    if (block == current_block_) {
+      std::memcpy(next, current_->data() + offset, static_cast<size_t>(n));
+    } else if (n == block_length) {
+      // Whole blocks go straight to the caller
+      ICEBERG_RETURN_NOT_OK(ReadBlock(block, next));
+    } else {
+      if (current_ == nullptr) {
+        ICEBERG_ASSIGN_OR_RAISE(current_, AllocateBuffer(block_size));
+      }
+      current_block_ = -1;
+      ICEBERG_RETURN_NOT_OK(ReadBlock(block, current_->mutable_data()));
+      current_block_ = block;
+      std::memcpy(next, current_->data() + offset, static_cast<size_t>(n));
+    }
+    next += n;
+    total += n;
+    position_ += n;
+  }
+  return total;
+}
+
+Result<int64_t> VerifyingInputStream::ReadAt(int64_t position, int64_t nbytes,
+                                             void* out) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (position < 0 || nbytes < 0) {
+    return Status::Invalid("Invalid read range: ", position, ", ", nbytes);
+  }
+  if (checksums_.block_size == 0) {
+    return base_->ReadAt(position, nbytes, out);
+  }
+  const int64_t block_size = checksums_.block_size;
+  const int64_t end = std::min(position + nbytes, checksums_.length);
+  auto next = static_cast<uint8_t*>(out);
+  std::shared_ptr<Buffer> scratch;
+  for (int64_t pos = position; pos < end;) {
+    const int64_t block = pos / block_size;
+    const int64_t offset = pos % block_size;
+    const int64_t block_length = BlockLength(block);
+    const int64_t n = std::min(end - pos, block_length - offset);
+    if (n == block_length) {
+      ICEBERG_RETURN_NOT_OK(ReadBlock(block, next));
+    } else {
+      // Partial blocks are only at the ends of the range
+      if (scratch == nullptr) {
+        ICEBERG_ASSIGN_OR_RAISE(scratch, AllocateBuffer(block_size));
+      }
+      ICEBERG_RETURN_NOT_OK(ReadBlock(block, scratch->mutable_data()));
+      std::memcpy(next, scratch->data() + offset, static_cast<size_t>(n));
+    }
+    next += n;
+    pos += n;
+  }
+  return std::max<int64_t>(end - position, 0);
+}
+
+int64_t VerifyingInputStream::BlockLength(int64_t block) const {
+  const int64_t offset = block * checksums_.block_size;
+  return std::min(checksums_.block_size, checksums_.length - offset);
+}
+
+Status VerifyingInputStream::ReadBlock(int64_t block, uint8_t* out) const {
+  const int64_t offset = block * checksums_.block_size;
+  const int64_t length = BlockLength(block);
+  for (int64_t filled = 0; filled < length;) {
+    ICEBERG_ASSIGN_OR_RAISE(
+        auto n, base_->ReadAt(offset + filled, length - filled, out + filled));
+    if (n == 0) {
+      return Status::IOError("File is shorter than its recorded length of ",
+                             checksums_.length, " bytes");
+    }
+    filled += n;
+  }
+  if (util::Crc32c(out, static_cast<size_t>(length)) != checksums_.crcs[block]) {
+    return Status::IOError("Checksum mismatch in block ", block, " at offset ", offset);
+  }
+  return Status::OK();
+}
+
+Result<int64_t> VerifyingInputStream::ReadWholeFile(int64_t nbytes, void* out) {
+  ICEBERG_ASSIGN_OR_RAISE(auto n, base_->ReadAt(position_, nbytes, out));
+  if (position_ == verified_length_) {
+    running_crc_ = util::Crc32c(out, static_cast<size_t>(n), running_crc_);
+    verified_length_ += n;
+    if (verified_length_ > checksums_.length) {
+      return Status::IOError("File is longer than its recorded length of ",
+                             checksums_.length, " bytes");
+    }
+    if (verified_length_ == checksums_.length && running_crc_ != checksums_.crcs[0]) {
+      return Status::IOError("Checksum mismatch of file of ", checksums_.length,
+                             " bytes");
+    }
+  }
+  position_ += n;
+  return n;
+}
+
+Status VerifyingInputStream::CheckClosed() const {
+  if (closed()) {
+    return Status::Invalid("Operation on closed stream");
+  }
+  return Status::OK();
+}
+
+namespace {
+
+class ChecksumInputFile : public InputFile {
+ public:
+  ChecksumInputFile(std::shared_ptr<InputFile> base, std::shared_ptr<FileIO> base_io,
+                    ChecksumOptions options)
+      : InputFile(base->location()),
+        base_(std::move(base)),
+        base_io_(std::move(base_io)),
+        options_(options) {}
+
+  Result<int64_t> getLength() override { return base_->getLength(); }
+
+  Result<std::shared_ptr<SeekableInputStream>> newStream() override {
+    ICEBERG_ASSIGN_OR_RAISE(auto sidecar,
+                            base_io_->newInputFile(SidecarPath(location())));
+    if (!sidecar->exists()) {
+      if (options_.require_checksums) {
+        return Status::IOError("Missing checksums of file ", location());
+      }
+      return base_->newStream();
+    }
+    ICEBERG_ASSIGN_OR_RAISE(auto sidecar_length, sidecar->getLength());
+    ICEBERG_ASSIGN_OR_RAISE(auto sidecar_stream, sidecar->newStream());
+    ICEBERG_ASSIGN_OR_RAISE(auto data, sidecar_stream->ReadAt(0, sidecar_length));
+    ICEBERG_RETURN_NOT_OK(sidecar_stream->Close());
+    ICEBERG_ASSIGN_OR_RAISE(auto checksums,
+                            FileChecksums::Deserialize(data->ToStringView()));
+    ICEBERG_ASSIGN_OR_RAISE(auto length, base_->getLength());
+    if (length != checksums.length) {
+      return Status::IOError("File ", location(), " has ", length,
+                             " bytes instead of the recorded ", checksums.length);
+    }
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, base_->newStream());
+    ICEBERG_ASSIGN_OR_RAISE(auto verifying,
+                            VerifyingInputStream::Create(stream, std::move(checksums)));
+    return verifying;
+  }
+
+  bool exists() const override { return base_->exists(); }
+
+ private:
+  std::shared_ptr<InputFile> base_;
+  std::shared_ptr<FileIO> base_io_;
+  const ChecksumOptions options_;
+};
+
+class ChecksumOutputFile : public OutputFile {
+ public:
+  ChecksumOutputFile(std::shared_ptr<OutputFile> base, std::shared_ptr<FileIO> base_io,
+                     ChecksumOptions options)
+      : OutputFile(base->location()),
+        base_(std::move(base)),
+        base_io_(std::move(base_io)),
+        options_(options) {}
+
+  Result<std::shared_ptr<PositionOutputStream>> create() override {
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, base_->create());
+    return Wrap(std::move(stream));
+  }
+
+  Result<std::shared_ptr<PositionOutputStream>> createOrOverwrite() override {
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, base_->createOrOverwrite());
+    return Wrap(std::move(stream));
+  }
+
+  Result<std::shared_ptr<InputFile>> toInputFile() const override {
+    ICEBERG_ASSIGN_OR_RAISE(auto file, base_->toInputFile());
+    return std::make_shared<ChecksumInputFile>(std::move(file), base_io_, options_);
+  }
+
+ private:
+  Result<std::shared_ptr<PositionOutputStream>> Wrap(
+      std::shared_ptr<PositionOutputStream> stream) {
+    ICEBERG_ASSIGN_OR_RAISE(auto sidecar,
+                            base_io_->newOutputFile(SidecarPath(location())));
+    ICEBERG_ASSIGN_OR_RAISE(auto checksumming,
+                            ChecksummingOutputStream::Create(
+                                std::move(stream), options_.block_size, sidecar));
+    return checksumming;
+  }
+
+  std::shared_ptr<OutputFile> base_;
+  std::shared_ptr<FileIO> base_io_;
+  const ChecksumOptions options_;
+};
+
+/// Leaves sidecars out of the batches of a base listing.
+class ChecksumFileInfoIterator : public FileInfoIterator {
+ public:
+  explicit ChecksumFileInfoIterator(std::unique_ptr<FileInfoIterator> base)
+      : base_(std::move(base)) {}
+
+  Result<std::vector<FileInfo>> Next() override {
+    while (true) {
+      ICEBERG_ASSIGN_OR_RAISE(auto batch, base_->Next());
+      if (batch.empty()) {
+        return batch;
+      }
+      batch.erase(std::remove_if(batch.begin(), batch.end(),
+                                 [](const FileInfo& info) {
+                                   return IsSidecarPath(info.location());
+                                 }),
+                  batch.end());
+      // A batch of sidecars only must not end the listing
+      if (!batch.empty()) {
+        return batch;
+      }
+    }
+  }
+
+ private:
+  std::unique_ptr<FileInfoIterator> base_;
+};
+
+}  // namespace
+
+bool ChecksumFileIO::Equals(const FileIO& other) const {
+  auto checksum = dynamic_cast<const ChecksumFileIO*>(&other);
+  return checksum != nullptr && options_.block_size == checksum->options_.block_size &&
+         options_.require_checksums == checksum->options_.require_checksums &&
+         base_->Equals(*checksum->base_);
+}
+
+Result<std::shared_ptr<InputFile>> ChecksumFileIO::newInputFile(const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto file, base_->newInputFile(path));
+  return std::make_shared<ChecksumInputFile>(std::move(file), base_, options_);
+}
+
+Result<std::shared_ptr<InputFile>> ChecksumFileIO::newInputFile(const std::string& path,
+                                                                int64_t length) {
+  ICEBERG_ASSIGN_OR_RAISE(auto file, base_->newInputFile(path, length));
+  return std::make_shared<ChecksumInputFile>(std::move(file), base_, options_);
+}
+
+Result<std::shared_ptr<OutputFile>> ChecksumFileIO::newOutputFile(
+    const std::string& path) {
+  if (options_.block_size < 0) {
+    return Status::Invalid("Invalid checksum block size: ", options_.block_size);
+  }
+  ICEBERG_ASSIGN_OR_RAISE(auto file, base_->newOutputFile(path));
+  return std::make_shared<ChecksumOutputFile>(std::move(file), base_, options_);
+}
+
+Status ChecksumFileIO::DeleteFile(const std::string& path) {
+  ICEBERG_RETURN_NOT_OK(base_->DeleteFile(path));
+  // Files written elsewhere have no sidecar
+  ICEBERG_UNUSED(base_->DeleteFile(SidecarPath(path)));
+  return Status::OK();
+}
+
+Result<std::unique_ptr<FileInfoIterator>> ChecksumFileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->ListPrefix(prefix, options));
+  return std::make_unique<ChecksumFileInfoIterator>(std::move(base));
+}
+
+Status ChecksumFileIO::CopyFile(const std::string& src, const std::string& dst) {
+  ICEBERG_RETURN_NOT_OK(base_->CopyFile(src, dst));
+  ICEBERG_ASSIGN_OR_RAISE(auto sidecar, base_->newInputFile(SidecarPath(src)));
+  if (!sidecar->exists()) {
+    return Status::OK();
+  }
+  // The copy holds the same bytes, so the checksums carry over. A sidecar left over
+  // from an earlier file of the same name is stale.
+  ICEBERG_UNUSED(base_->DeleteFile(SidecarPath(dst)));
+  auto status = base_->CopyFile(SidecarPath(src), SidecarPath(dst));
+  if (!status.ok()) {
+    ICEBERG_UNUSED(base_->DeleteFile(dst));
+  }
+  return status;
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,613 @@
+#include "iceberg/io/compression.hh"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <string>
+#include <utility>
+
+#ifdef ICEBERG_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include "iceberg/util/logging.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace internal {
+
+/// Bytes of input consumed and of output produced by a codec call.
+struct CodecProgress {
+  int64_t consumed = 0;
+  int64_t produced = 0;
+  // For Flush and End: whether the call must be repeated with more output space
+  bool more = false;
+};
+
+class Decompressor {
+ public:
+  virtual ~Decompressor() = default;
+
+  virtual Result<CodecProgress> Decompress(const uint8_t* input, int64_t input_len,
+                                           uint8_t* output, int64_t output_len) = 0;
+
+  /// Return whether the end of a gzip member or zstd frame was reached.
+  virtual bool finished() const = 0;
+
+  /// Prepare for the next member or frame.
+  virtual Status Reset() = 0;
+};
+
+class Compressor {
+ public:
+  virtual ~Compressor() = default;
+
+  virtual Result<CodecProgress> Compress(const uint8_t* input, int64_t input_len,
+                                         uint8_t* output, int64_t output_len) = 0;
+
+  /// Emit the pending compressed bytes so that all input so far can be decompressed.
+  virtual Result<CodecProgress> Flush(uint8_t* output, int64_t output_len) = 0;
+
+  /// End the compressed stream.
+  virtual Result<CodecProgress> End(uint8_t* output, int64_t output_len) = 0;
+};
+
+}  // namespace internal
+
+namespace {
+
+using internal::CodecProgress;
+using internal::Compressor;
+using internal::Decompressor;
+
+// zlib counts bytes in 32 bits
+uInt ZlibLength(int64_t length) {
+  return static_cast<uInt>(
+      std::min<int64_t>(length, std::numeric_limits<uInt>::max()));
+}
+
+Status ZlibError(const char* prefix, const z_stream& stream, int ret) {
+  return Status::IOError(prefix, stream.msg != nullptr ? stream.msg : zError(ret));
+}
+
+class GzipDecompressor : public Decompressor {
+ public:
+  ~GzipDecompressor() override { inflateEnd(&stream_); }
+
+  Status Init() {
+    // 32 on top of the window bits detects gzip and zlib headers alike
+    const int ret = inflateInit2(&stream_, MAX_WBITS + 32);
+    if (ret != Z_OK) {
+      return ZlibError("zlib inflateInit failed: ", stream_, ret);
+    }
+    return Status::OK();
+  }
+
+  Result<CodecProgress> Decompress(const uint8_t* input, int64_t input_len,
+                                   uint8_t* output, int64_t output_len) override {
+    stream_.next_in = const_cast<Bytef*>(input);
+    stream_.avail_in = ZlibLength(input_len);
+    stream_.next_out = output;
+    stream_.avail_out = ZlibLength(output_len);
+    const uInt avail_in = stream_.avail_in;
+    const uInt avail_out = stream_.avail_out;
+    const int ret = inflate(&stream_, Z_SYNC_FLUSH);
+    if (ret == Z_STREAM_END) {
+      finished_ = true;
+    } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+      return ZlibError("zlib inflate failed: ", stream_, ret);
+    }
+    return CodecProgress{avail_in - stream_.avail_in, avail_out - stream_.avail_out};
+  }
+
+  bool finished() const override { return finished_; }
+
+  Status Reset() override {
+    const int ret = inflateReset(&stream_);
+    if (ret != Z_OK) {
+      return ZlibError("zlib inflateReset failed: ", stream_, ret);
+    }
+    finished_ = false;
+    return Status::OK();
+  }
+
+ private:
+  z_stream stream_{};
+  bool finished_ = false;
+};
+
+class GzipCompressor : public Compressor {
+ public:
+  ~GzipCompressor() override { deflateEnd(&stream_); }
+
+  Status Init(std::optional<int> level) {
+    // 16 on top of the window bits writes a gzip header and trailer
+    const int ret = deflateInit2(&stream_, level.value_or(Z_DEFAULT_COMPRESSION),
+                                 Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK) {
+      return ZlibError("zlib deflateInit failed: ", stream_, ret);
+    }
+    return Status::OK();
+  }
+
+  Result<CodecProgress> Compress(const uint8_t* input, int64_t input_len,
+                                 uint8_t* output, int64_t output_len) override {
+    return Deflate(input, input_len, output, output_len, Z_NO_FLUSH);
+  }
+
+  Result<CodecProgress> Flush(uint8_t* output, int64_t output_len) override {
+    return Deflate(nullptr, 0, output, output_len, Z_SYNC_FLUSH);
+  }
+
+  Result<CodecProgress> End(uint8_t* output, int64_t output_len) override {
+    return Deflate(nullptr, 0, output, output_len, Z_FINISH);
+  }
+
+ private:
+  Result<CodecProgress> Deflate(const uint8_t* input, int64_t input_len, uint8_t* output,
+                                int64_t output_len, int flush) {
+    stream_.next_in = const_cast<Bytef*>(input);
+    stream_.avail_in = ZlibLength(input_len);
+    stream_.next_out = output;
+    stream_.avail_out = ZlibLength(output_len);
+    const uInt avail_in = stream_.avail_in;
+    const uInt avail_out = stream_.avail_out;
+    const int ret = deflate(&stream_, flush);
+    if (ret == Z_STREAM_ERROR) {
+      return ZlibError("zlib deflate failed: ", stream_, ret);
+    }
+    CodecProgress progress{avail_in - stream_.avail_in, avail_out - stream_.avail_out};
+    if (flush == Z_FINISH) {
+      progress.more = ret != Z_STREAM_END;
+    } else if (flush == Z_SYNC_FLUSH) {
+      // The flush is complete once deflate leaves output space unused
+      progress.more = stream_.avail_out == 0;
+    }
+    return progress;
+  }
+
+  z_stream stream_{};
+};
+
+#ifdef ICEBERG_WITH_ZSTD
+
+Status ZstdError(const char* prefix, size_t ret) {
+  return Status::IOError(prefix, ZSTD_getErrorName(ret));
+}
+
+class ZstdDecompressor : public Decompressor {
+ public:
+  ZstdDecompressor() : stream_(ZSTD_createDStream()) {}
+
+  ~ZstdDecompressor() override { ZSTD_freeDStream(stream_); }
+
+  Status Init() {
+    if (stream_ == nullptr) {
+      return Status::OutOfMemory("ZSTD_createDStream failed");
+    }
+    return Reset();
+  }
+
+  Result<CodecProgress> Decompress(const uint8_t* input, int64_t input_len,
+                                   uint8_t* output, int64_t output_len) override {
+    ZSTD_inBuffer in{input, static_cast<size_t>(input_len), 0};
+    ZSTD_outBuffer out{output, static_cast<size_t>(output_len), 0};
+    const size_t ret = ZSTD_decompressStream(stream_, &out, &in);
+    if (ZSTD_isError(ret)) {
+      return ZstdError("ZSTD decompress failed: ", ret);
+    }
+    // Zero means a frame was completely decoded and flushed
+    finished_ = ret == 0;
+    return CodecProgress{static_cast<int64_t>(in.pos), static_cast<int64_t>(out.pos)};
+  }
+
+  bool finished() const override { return finished_; }
+
+  Status Reset() override {
+    const size_t ret = ZSTD_DCtx_reset(stream_, ZSTD_reset_session_only);
+    if (ZSTD_isError(ret)) {
+      return ZstdError("ZSTD reset failed: ", ret);
+    }
+    finished_ = false;
+    return Status::OK();
+  }
+
+ private:
+  ZSTD_DStream* stream_;
+  bool finished_ = false;
+};
+
+class ZstdCompressor : public Compressor {
+ public:
+  ZstdCompressor() : stream_(ZSTD_createCStream()) {}
+
+  ~ZstdCompressor() override { ZSTD_freeCStream(stream_); }
+
+  Status Init(std::optional<int> level) {
+    if (stream_ == nullptr) {
+      return Status::OutOfMemory("ZSTD_createCStream failed");
+    }
+    const size_t ret = ZSTD_CCtx_setParameter(stream_, ZSTD_c_compressionLevel,
+                                              level.value_or(ZSTD_CLEVEL_DEFAULT));
+    if (ZSTD_isError(ret)) {
+      return ZstdError("ZSTD init failed: ", ret);
+    }
+    return Status::OK();
+  }
+
+  Result<CodecProgress> Compress(const uint8_t* input, int64_t input_len,
+                                 uint8_t* output, int64_t output_len) override {
+    return CompressStream(input, input_len, output, output_len, ZSTD_e_continue);
+  }
+
+  Result<CodecProgress> Flush(uint8_t* output, int64_t output_len) override {
+    return CompressStream(nullptr, 0, output, output_len, ZSTD_e_flush);
+  }
+
+  Result<CodecProgress> End(uint8_t* output, int64_t output_len) override {
+    return CompressStream(nullptr, 0, output, output_len, ZSTD_e_end);
+  }
+
+ private:
+  Result<CodecProgress> CompressStream(const uint8_t* input, int64_t input_len,
+                                       uint8_t* output, int64_t output_len,
+                                       ZSTD_EndDirective directive) {
+    ZSTD_inBuffer in{input, static_cast<size_t>(input_len), 0};
+    ZSTD_outBuffer out{output, static_cast<size_t>(output_len), 0};
+    const size_t ret = ZSTD_compressStream2(stream_, &out, &in, directive);
+    if (ZSTD_isError(ret)) {
+      return ZstdError("ZSTD compress failed: ", ret);
+    }
+    CodecProgress progress{static_cast<int64_t>(in.pos), static_cast<int64_t>(out.pos)};
+    // For flush and end, the bytes left in the internal buffers
+    progress.more = directive != ZSTD_e_continue && ret != 0;
+    return progress;
+  }
+
+  ZSTD_CStream* stream_;
+};
+
+#endif  // ICEBERG_WITH_ZSTD
+
+Status CodecNotAvailable(CompressionCodec codec) {
+  return Status::NotImplemented("Compression codec ", CompressionCodecName(codec),
+                                " is not available in this build");
+}
+
+Result<std::unique_ptr<Decompressor>> MakeDecompressor(CompressionCodec codec) {
+  switch (codec) {
+    case CompressionCodec::GZIP: {
+      auto decompressor = std::make_unique<GzipDecompressor>();
+      ICEBERG_RETURN_NOT_OK(decompressor->Init());
+      return decompressor;
+    }
+#ifdef ICEBERG_WITH_ZSTD
+    case CompressionCodec::ZSTD: {
+      auto decompressor = std::make_unique<ZstdDecompressor>();
+      ICEBERG_RETURN_NOT_OK(decompressor->Init());
+      return decompressor;
+    }
+#endif
+    case CompressionCodec::NONE:
+      return Status::Invalid("No decompressor for uncompressed data");
+    default:
+      return CodecNotAvailable(codec);
+  }
+}
+
+Result<std::unique_ptr<Compressor>> MakeCompressor(CompressionCodec codec,
+                                                   std::optional<int> level) {
+  switch (codec) {
+    case CompressionCodec::GZIP: {
+      auto compressor = std::make_unique<GzipCompressor>();
+      ICEBERG_RETURN_NOT_OK(compressor->Init(level));
+      return compressor;
+    }
+#ifdef ICEBERG_WITH_ZSTD
+    case CompressionCodec::ZSTD: {
+      auto compressor = std::make_unique<ZstdCompressor>();
+      ICEBERG_RETURN_NOT_OK(compressor->Init(level));
+      return compressor;
+    }
+#endif
+    case CompressionCodec::NONE:
+      return Status::Invalid("No compressor for uncompressed data");
+    default:
+      return CodecNotAvailable(codec);
+  }
+}
+
+bool EndsWith(std::string_view s, std::string_view suffix) {
+  return s.size() >= suffix.size() && s.substr(s.size() - suffix.size()) == suffix;
+}
+
+}  // namespace
+
+Result<CompressionCodec> CompressionCodecFromName(std::string_view name) {
+  std::string lower(name);
+  std::transform(lower.begin(), lower.end(), lower.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  if (lower == "none") {
+    return CompressionCodec::NONE;
+  } else if (lower == "gzip") {
+    return CompressionCodec::GZIP;
+  } else if (lower == "zstd") {
+    return CompressionCodec::ZSTD;
+  }
+  return Status::Invalid("Unknown compression codec: ", name);
+}
+
+const char* CompressionCodecName(CompressionCodec codec) {
+  switch (codec) {
+    case CompressionCodec::NONE:
+      return "none";
+    case CompressionCodec::GZIP:
+      return "gzip";
+    case CompressionCodec::ZSTD:
+      return "zstd";
+  }
+  return "unknown";
+}
+
+const char* CompressionCodecExtension(CompressionCodec codec) {
+  switch (codec) {
+    case CompressionCodec::GZIP:
+      return ".gz";
+    case CompressionCodec::ZSTD:
+      return ".zst";
+    default:
+      return "";
+  }
+}
+
+CompressionCodec CompressionCodecFromPath(std::string_view path) {
+  std::string_view name = path.substr(path.find_last_of('/') + 1);
+  // The codec extension either ends the name or precedes the format's extensions, as in
+  // "v3.gz.metadata.json"
+  for (auto codec : {CompressionCodec::GZIP, CompressionCodec::ZSTD}) {
+    const std::string extension = CompressionCodecExtension(codec);
+    if (EndsWith(name, extension) || name.find(extension + ".") != std::string::npos) {
+      return codec;
+    }
+  }
+  return CompressionCodec::NONE;
+}
+
+bool IsCompressionCodecAvailable(CompressionCodec codec) {
+  switch (codec) {
+    case CompressionCodec::NONE:
+    case CompressionCodec::GZIP:
+      return true;
+    case CompressionCodec::ZSTD:
+#ifdef ICEBERG_WITH_ZSTD
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+// ----------------------------------------------------------------------
+// DecompressingInputStream
+
+DecompressingInputStream::DecompressingInputStream(
+    std::shared_ptr<InputStream> raw, std::unique_ptr<Decompressor> decompressor,
+    int64_t buffer_size)
+    : raw_(std::move(raw)),
+      decompressor_(std::move(decompressor)),
+      buffer_size_(buffer_size) {}
+
+DecompressingInputStream::~DecompressingInputStream() {
+  if (!closed()) {
+    ICEBERG_CHECK_OK(Close());
+  }
+}
+
+Result<std::shared_ptr<DecompressingInputStream>> DecompressingInputStream::Create(
+    CompressionCodec codec, std::shared_ptr<InputStream> raw,
+    const CompressionOptions& options) {
+  if (options.buffer_size <= 0) {
+    return Status::Invalid("Buffer size should be positive");
+  }
+  ICEBERG_ASSIGN_OR_RAISE(auto decompressor, MakeDecompressor(codec));
+  return std::shared_ptr<DecompressingInputStream>(new DecompressingInputStream(
+      std::move(raw), std::move(decompressor), options.buffer_size));
+}
+
+Status DecompressingInputStream::Close() {
+  if (closed_) {
+    return Status::OK();
+  }
+  closed_ = true;
+  input_.reset();
+  return raw_->Close();
+}
+
+Result<int64_t> DecompressingInputStream::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return position_;
+}
+
+bool DecompressingInputStream::closed() const { return closed_; }
+
+Result<int64_t> DecompressingInputStream::Read(int64_t nbytes, void* out) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  uint8_t* dest = reinterpret_cast<uint8_t*>(out);
+  int64_t total = 0;
+  while (total < nbytes) {
+    ICEBERG_RETURN_NOT_OK(FillInput());
+    const int64_t available = input_ == nullptr ? 0 : input_->size() - input_pos_;
+    if (decompressor_->finished()) {
+      if (available == 0) {
+        break;
+      }
+      // Another gzip member or zstd frame follows
+      ICEBERG_RETURN_NOT_OK(decompressor_->Reset());
+    }
+    if (available == 0) {
+      return Status::IOError("Truncated compressed stream");
+    }
+    ICEBERG_ASSIGN_OR_RAISE(auto progress,
+                            decompressor_->Decompress(input_->data() + input_pos_,
+                                                      available, dest + total,
+                                                      nbytes - total));
+    input_pos_ += progress.consumed;
+    total += progress.produced;
+    if (progress.consumed == 0 && progress.produced == 0 && !decompressor_->finished()) {
+      return Status::IOError("Corrupt compressed stream");
+    }
+  }
+  position_ += total;
+  return total;
+}
+
+Status DecompressingInputStream::FillInput() {
+  if ((input_ != nullptr && input_pos_ < input_->size()) || raw_eof_) {
+    return Status::OK();
+  }
+  ICEBERG_ASSIGN_OR_RAISE(input_, raw_->Read(buffer_size_));
+  input_pos_ = 0;
+  raw_eof_ = input_->size() == 0;
+  return Status::OK();
+}
+
+Status DecompressingInputStream::CheckClosed() const {
+  if (closed_) {
+    return Status::Invalid("Operation forbidden on closed DecompressingInputStream");
+  }
+  return Status::OK();
+}
+
+// ----------------------------------------------------------------------
+// CompressingOutputStream
+
+CompressingOutputStream::CompressingOutputStream(std::shared_ptr<OutputStream> raw,
+                                                 std::unique_ptr<Compressor> compressor,
+                                                 std::shared_ptr<Buffer> output)
+    : raw_(std::move(raw)),
+      compressor_(std::move(compressor)),
+      output_(std::move(output)) {}
+
+CompressingOutputStream::~CompressingOutputStream() {
+  if (!closed()) {
+    ICEBERG_CHECK_OK(Close());
+  }
+}
+
+Result<std::shared_ptr<CompressingOutputStream>> CompressingOutputStream::Create(
+    CompressionCodec codec, std::shared_ptr<OutputStream> raw,
+    const CompressionOptions& options) {
+  if (options.buffer_size <= 0) {
+    return Status::Invalid("Buffer size should be positive");
+  }
+  ICEBERG_ASSIGN_OR_RAISE(auto compressor, MakeCompressor(codec, options.level));
+  ICEBERG_ASSIGN_OR_RAISE(auto output, AllocateBuffer(options.buffer_size));
+  return std::shared_ptr<CompressingOutputStream>(new CompressingOutputStream(
+      std::move(raw), std::move(compressor), std::move(output)));
+}
+
+Status CompressingOutputStream::Close() {
+  if (closed_) {
+    return Status::OK();
+  }
+  closed_ = true;
+  auto status = DrainCompressor(/*end=*/true);
+  return status & raw_->Close();
+}
+
+Result<int64_t> CompressingOutputStream::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return position_;
+}
+
+bool CompressingOutputStream::closed() const { return closed_; }
+
+Status CompressingOutputStream::Write(const void* data, int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  const uint8_t* input = reinterpret_cast<const uint8_t*>(data);
+  int64_t consumed = 0;
+  while (consumed < nbytes) {
+    if (output_size_ == output_->size()) {
+      ICEBERG_RETURN_NOT_OK(WriteOutput());
+    }
+    ICEBERG_ASSIGN_OR_RAISE(
+        auto progress,
+        compressor_->Compress(input + consumed, nbytes - consumed,
+                              output_->mutable_data() + output_size_,
+                              output_->size() - output_size_));
+    consumed += progress.consumed;
+    output_size_ += progress.produced;
+  }
+  position_ += nbytes;
+  return Status::OK();
+}
+
+Status CompressingOutputStream::Flush() {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  ICEBERG_RETURN_NOT_OK(DrainCompressor(/*end=*/false));
+  return raw_->Flush();
+}
+
+Status CompressingOutputStream::Sync() {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  ICEBERG_RETURN_NOT_OK(DrainCompressor(/*end=*/false));
+  return raw_->Sync();
+}
+
+Status CompressingOutputStream::WriteOutput() {
+  if (output_size_ > 0) {
+    ICEBERG_RETURN_NOT_OK(raw_->Write(output_->data(), output_size_));
+    output_size_ = 0;
+  }
+  return Status::OK();
+}
+
+Status CompressingOutputStream::DrainCompressor(bool end) {
+  while (true) {
+    if (output_size_ == output_->size()) {
+      ICEBERG_RETURN_NOT_OK(WriteOutput());
+    }
+    uint8_t* output = output_->mutable_data() + output_size_;
+    const int64_t output_len = output_->size() - output_size_;
+    ICEBERG_ASSIGN_OR_RAISE(auto progress, end ? compressor_->End(output, output_len)
+                                               : compressor_->Flush(output, output_len));
+    output_size_ += progress.produced;
+    if (!progress.more) {
+      break;
+    }
+  }
+  return WriteOutput();
+}
+
+Status CompressingOutputStream::CheckClosed() const {
+  if (closed_) {
+    return Status::Invalid("Operation forbidden on closed CompressingOutputStream");
+  }
+  return Status::OK();
+}
+
+Result<std::shared_ptr<InputStream>> OpenDecompressedStream(
+    const std::shared_ptr<InputFile>& file, const CompressionOptions& options) {
+  ICEBERG_ASSIGN_OR_RAISE(std::shared_ptr<InputStream> stream, file->newStream());
+  const CompressionCodec codec = CompressionCodecFromPath(file->location());
+  if (codec == CompressionCodec::NONE) {
+    return stream;
+  }
+  return DecompressingInputStream::Create(codec, std::move(stream), options);
+}
+
+Result<std::shared_ptr<PositionOutputStream>> MaybeCompress(
+    CompressionCodec codec, std::shared_ptr<PositionOutputStream> raw,
+    const CompressionOptions& options) {
+  if (codec == CompressionCodec::NONE) {
+    return raw;
+  }
+  return CompressingOutputStream::Create(codec, std::move(raw), options);
+}
+
+}  // namespace io
+}  // namespace iceberg
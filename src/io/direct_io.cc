@@ -0,0 +1,439 @@
+#include "iceberg/io/direct_io.hh"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "iceberg/util/logging.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace internal {
+
+namespace {
+
+/// Aligned allocations recycled by shape, so that streams opened and closed in a loop
+/// do not each allocate their megabyte-sized buffers.
+class AlignedBufferPool {
+ public:
+  uint8_t* Acquire(int64_t size, int64_t alignment) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = free_.find({size, alignment});
+      if (it != free_.end() && !it->second.empty()) {
+        uint8_t* data = it->second.back();
+        it->second.pop_back();
+        cached_bytes_ -= size;
+        return data;
+      }
+    }
+    void* data = nullptr;
+    if (posix_memalign(&data, static_cast<size_t>(alignment),
+                       static_cast<size_t>(size)) != 0) {
+      return nullptr;
+    }
+    return reinterpret_cast<uint8_t*>(data);
+  }
+
+  void Release(uint8_t* data, int64_t size, int64_t alignment) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (cached_bytes_ + size <= kMaxCachedBytes) {
+        free_[{size, alignment}].push_back(data);
+        cached_bytes_ += size;
+        return;
+      }
+    }
+    std::free(data);
+  }
+
+ private:
+  static constexpr int64_t kMaxCachedBytes = 64 * 1024 * 1024;
+
+  std::mutex mutex_;
+  std::map<std::pair<int64_t, int64_t>, std::vector<uint8_t*>> free_;
+  int64_t cached_bytes_ = 0;
+};
+
+AlignedBufferPool* GetAlignedBufferPool() {
+  // Leaked on purpose, as buffers may be released during static destruction
+  static auto* pool = new AlignedBufferPool();
+  return pool;
+}
+
+class PooledBuffer : public MutableBuffer {
+ public:
+  PooledBuffer(uint8_t* data, int64_t size, int64_t alignment)
+      : MutableBuffer(data, size), alignment_(alignment) {}
+
+  ~PooledBuffer() override {
+    GetAlignedBufferPool()->Release(const_cast<uint8_t*>(data_), size_, alignment_);
+  }
+
+ private:
+  const int64_t alignment_;
+};
+
+}  // namespace
+
+Result<std::shared_ptr<Buffer>> AllocateAlignedBuffer(int64_t size, int64_t alignment) {
+  if (size <= 0 || alignment <= 0 || (alignment & (alignment - 1)) != 0) {
+    return Status::Invalid("Invalid aligned buffer shape: ", size, ", ", alignment);
+  }
+  uint8_t* data = GetAlignedBufferPool()->Acquire(size, alignment);
+  if (data == nullptr) {
+    return Status::OutOfMemory("aligned allocation of size ", size, " failed");
+  }
+  return std::make_shared<PooledBuffer>(data, size, alignment);
+}
+
+Status ValidateDirectIOOptions(const DirectIOOptions& options) {
+  if (options.alignment <= 0 || (options.alignment & (options.alignment - 1)) != 0) {
+    return Status::Invalid("Direct I/O alignment must be a power of two");
+  }
+  if (options.buffer_size <= 0 || options.buffer_size % options.alignment != 0) {
+    return Status::Invalid("Direct I/O buffer size must be a multiple of the alignment");
+  }
+  return Status::OK();
+}
+
+namespace {
+
+std::atomic<bool> direct_io_unsupported{false};
+
+}  // namespace
+
+int OpenMaybeDirect(const std::string& path, int flags, bool* direct) {
+#ifdef O_DIRECT
+  if (*direct && !direct_io_unsupported.load(std::memory_order_relaxed)) {
+    int fd = open(path.c_str(), flags | O_DIRECT, 0666);
+    if (fd >= 0 || errno != EINVAL) {
+      return fd;
+    }
+  }
+#endif
+  *direct = false;
+  return open(path.c_str(), flags, 0666);
+}
+
+void SimulateDirectIOUnsupported(bool unsupported) {
+  direct_io_unsupported.store(unsupported, std::memory_order_relaxed);
+}
+
+}  // namespace internal
+
+namespace {
+
+int64_t AlignDown(int64_t value, int64_t alignment) { return value & ~(alignment - 1); }
+
+int64_t AlignUp(int64_t value, int64_t alignment) {
+  return AlignDown(value + alignment - 1, alignment);
+}
+
+/// The largest aligned size passed to a single pread or pwrite
+int64_t MaxChunkSize(int64_t alignment) {
+  return AlignDown(static_cast<int64_t>(ICEBERG_MAX_IO_CHUNKSIZE), alignment);
+}
+
+#ifdef O_DIRECT
+/// Turn O_DIRECT on or off for `fd`
+Status SetDirect(int fd, bool direct) {
+  int flags = fcntl(fd, F_GETFL);
+  if (flags == -1) {
+    return Status::IOError("fcntl failed, errno: ", errno);
+  }
+  flags = direct ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+  if (fcntl(fd, F_SETFL, flags) == -1) {
+    return Status::IOError("fcntl failed, errno: ", errno);
+  }
+  return Status::OK();
+}
+#else
+Status SetDirect(int fd, bool direct) { return Status::OK(); }
+#endif
+
+}  // namespace
+
+Result<std::shared_ptr<DirectFileOutputStream>> DirectFileOutputStream::Create(
+    int fd, DirectIOOptions options) {
+  Status st = internal::ValidateDirectIOOptions(options);
+  if (st.ok()) {
+    auto res = internal::AllocateAlignedBuffer(options.buffer_size, options.alignment);
+    if (res.ok()) {
+      return std::shared_ptr<DirectFileOutputStream>(
+          new DirectFileOutputStream(fd, options, std::move(res).ValueUnsafe()));
+    }
+    st = res.status();
+  }
+  close(fd);
+  return st;
+}
+
+DirectFileOutputStream::DirectFileOutputStream(int fd, DirectIOOptions options,
+                                               std::shared_ptr<Buffer> buffer)
+    : fd_(fd), options_(options), buffer_(std::move(buffer)) {}
+
+DirectFileOutputStream::~DirectFileOutputStream() {
+  if (!closed_) {
+    ICEBERG_CHECK_OK(Close());
+  }
+}
+
+Status DirectFileOutputStream::Close() {
+  if (closed_) {
+    return Status::OK();
+  }
+  Status st = WriteBlocks();
+  if (st.ok()) {
+    st = WriteTail();
+  }
+  closed_ = true;
+  buffer_.reset();
+  if (close(fd_) == -1 && st.ok()) {
+    st = Status::IOError("error closing file");
+  }
+  return st;
+}
+
+Result<int64_t> DirectFileOutputStream::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return buffer_offset_ + buffered_;
+}
+
+Status DirectFileOutputStream::Write(const void* data, int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (nbytes < 0) {
+    return Status::Invalid("Invalid write size");
+  }
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+  while (nbytes > 0) {
+    const int64_t n = std::min(nbytes, options_.buffer_size - buffered_);
+    std::memcpy(buffer_->mutable_data() + buffered_, src, static_cast<size_t>(n));
+    buffered_ += n;
+    src += n;
+    nbytes -= n;
+    if (buffered_ == options_.buffer_size) {
+      ICEBERG_RETURN_NOT_OK(WriteBlocks());
+    }
+  }
+  return Status::OK();
+}
+
+Status DirectFileOutputStream::Flush() {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  ICEBERG_RETURN_NOT_OK(WriteBlocks());
+  return WriteTail();
+}
+
+Status DirectFileOutputStream::Sync() {
+  ICEBERG_RETURN_NOT_OK(Flush());
+  if (fsync(fd_) == -1) {
+    return Status::IOError("fsync failed, errno: ", errno);
+  }
+  return Status::OK();
+}
+
+bool DirectFileOutputStream::closed() const { return closed_; }
+
+Status DirectFileOutputStream::WriteBlocks() {
+  const int64_t whole = AlignDown(buffered_, options_.alignment);
+  if (whole == 0) {
+    return Status::OK();
+  }
+  ICEBERG_RETURN_NOT_OK(PositionedWrite(buffer_->data(), whole, buffer_offset_));
+  uint8_t* data = buffer_->mutable_data();
+  std::memmove(data, data + whole, static_cast<size_t>(buffered_ - whole));
+  buffer_offset_ += whole;
+  buffered_ -= whole;
+  return Status::OK();
+}
+
+Status DirectFileOutputStream::WriteTail() {
+  if (buffered_ == 0) {
+    return Status::OK();
+  }
+  if (direct_) {
+    ICEBERG_RETURN_NOT_OK(SetDirect(fd_, false));
+  }
+  Status st = PositionedWrite(buffer_->data(), buffered_, buffer_offset_);
+  if (direct_ && !SetDirect(fd_, true).ok()) {
+    // The file system refuses to turn O_DIRECT back on; carry on through the page cache
+    direct_ = false;
+  }
+  return st;
+}
+
+Status DirectFileOutputStream::PositionedWrite(const uint8_t* data, int64_t nbytes,
+                                               int64_t position) {
+  while (nbytes > 0) {
+    const int64_t chunksize = std::min(MaxChunkSize(options_.alignment), nbytes);
+    ssize_t ret = pwrite(fd_, data, static_cast<size_t>(chunksize), position);
+    if (ret == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EINVAL && direct_) {
+        // The file system does not support direct I/O after all
+        direct_ = false;
+        ICEBERG_RETURN_NOT_OK(SetDirect(fd_, false));
+        continue;
+      }
+      return Status::IOError("Failed to write local file, errno: ", errno);
+    }
+    data += ret;
+    position += ret;
+    nbytes -= ret;
+  }
+  return Status::OK();
+}
+
+Status DirectFileOutputStream::CheckClosed() const {
+  if (closed_) {
+    return Status::Invalid("Operation on closed stream");
+  }
+  return Status::OK();
+}
+
+DirectFileInputStream::~DirectFileInputStream() {
+  if (!closed()) {
+    ICEBERG_CHECK_OK(Close());
+  }
+}
+
+Status DirectFileInputStream::Close() {
+  if (closed()) {
+    return Status::OK();
+  }
+  int ret = close(fd_);
+  fd_ = -1;
+  if (ret == -1) {
+    return Status::IOError("error closing file");
+  }
+  return Status::OK();
+}
+
+Result<int64_t> DirectFileInputStream::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return position_;
+}
+
+bool DirectFileInputStream::closed() const { return fd_ == -1; }
+
+Status DirectFileInputStream::Seek(int64_t position) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (position < 0) {
+    return Status::Invalid("Invalid position");
+  }
+  position_ = position;
+  return Status::OK();
+}
+
+Result<int64_t> DirectFileInputStream::Read(int64_t nbytes, void* out) {
+  ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read, ReadAt(position_, nbytes, out));
+  position_ += bytes_read;
+  return bytes_read;
+}
+
+Result<int64_t> DirectFileInputStream::ReadAt(int64_t position, int64_t nbytes,
+                                              void* out) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (position < 0 || nbytes < 0) {
+    return Status::Invalid("Invalid read range");
+  }
+  const int64_t alignment = options_.alignment;
+  uint8_t* dest = reinterpret_cast<uint8_t*>(out);
+  if (position % alignment == 0 && nbytes % alignment == 0 &&
+      reinterpret_cast<uintptr_t>(dest) % alignment == 0) {
+    return ReadBlocks(position, nbytes, dest);
+  }
+
+  ICEBERG_ASSIGN_OR_RAISE(
+      auto buffer, internal::AllocateAlignedBuffer(options_.buffer_size, alignment));
+  int64_t copied = 0;
+  while (copied < nbytes) {
+    const int64_t start = AlignDown(position + copied, alignment);
+    const int64_t length =
+        std::min(options_.buffer_size, AlignUp(position + nbytes, alignment) - start);
+    ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read,
+                            ReadBlocks(start, length, buffer->mutable_data()));
+    const int64_t offset = position + copied - start;
+    const int64_t n = std::min(nbytes - copied, bytes_read - offset);
+    if (n <= 0) {
+      break;
+    }
+    std::memcpy(dest + copied, buffer->data() + offset, static_cast<size_t>(n));
+    copied += n;
+    if (bytes_read < length) {
+      break;
+    }
+  }
+  return copied;
+}
+
+Result<std::shared_ptr<Buffer>> DirectFileInputStream::ReadAt(int64_t position,
+                                                              int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (position < 0 || nbytes < 0) {
+    return Status::Invalid("Invalid read range");
+  }
+  if (nbytes == 0) {
+    return std::make_shared<Buffer>(nullptr, 0);
+  }
+  const int64_t start = AlignDown(position, options_.alignment);
+  const int64_t length = AlignUp(position + nbytes, options_.alignment) - start;
+  ICEBERG_ASSIGN_OR_RAISE(auto buffer,
+                          internal::AllocateAlignedBuffer(length, options_.alignment));
+  ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read,
+                          ReadBlocks(start, length, buffer->mutable_data()));
+  const int64_t offset = std::min(position - start, bytes_read);
+  return SliceBuffer(std::move(buffer), offset, std::min(nbytes, bytes_read - offset));
+}
+
+Result<int64_t> DirectFileInputStream::ReadBlocks(int64_t position, int64_t nbytes,
+                                                  uint8_t* out) {
+  int64_t total = 0;
+  bool direct = true;
+  while (total < nbytes) {
+    const int64_t chunksize = std::min(MaxChunkSize(options_.alignment), nbytes - total);
+    ssize_t ret =
+        pread(fd_, out + total, static_cast<size_t>(chunksize), position + total);
+    if (ret == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EINVAL && direct) {
+        // The file system does not support direct I/O after all; reads through the
+        // page cache accept the same aligned ranges
+        direct = false;
+        ICEBERG_RETURN_NOT_OK(SetDirect(fd_, false));
+        continue;
+      }
+      return Status::IOError("Failed to read local file, errno: ", errno);
+    }
+    total += ret;
+    // End of file, which may fall in the middle of a block
+    if (ret == 0 || ret % options_.alignment != 0) {
+      break;
+    }
+  }
+  return total;
+}
+
+Status DirectFileInputStream::CheckClosed() const {
+  if (closed()) {
+    return Status::Invalid("Invalid operation on closed file");
+  }
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace iceberg
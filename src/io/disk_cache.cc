@@ -0,0 +1,882 @@
+#include "iceberg/io/disk_cache.hh"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <system_error>
+#include <utility>
+
+#include "iceberg/util/crc32c.hh"
+#include "iceberg/util/thread_pool.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+constexpr char kIndexMagic[] = "IDKC";
+constexpr uint32_t kIndexVersion = 1;
+// Magic, version, block size and number of slots
+constexpr size_t kIndexHeaderSize = 4 + 4 + 8 + 8;
+
+constexpr uint8_t kStoreRecord = 1;
+constexpr uint8_t kEraseRecord = 2;
+// Checksum, type, slot, block index, size, block checksum and location length. The
+// cache is local to the host, so integers are in its byte order.
+constexpr size_t kRecordHeaderSize = 4 + 1 + 4 + 8 + 8 + 4 + 4;
+
+template <typename T>
+void Put(std::string* out, T value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T Get(const char* data) {
+  T value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+std::string EncodeHeader(int64_t block_size, int64_t num_slots) {
+  std::string header(kIndexMagic, 4);
+  Put(&header, kIndexVersion);
+  Put(&header, block_size);
+  Put(&header, num_slots);
+  return header;
+}
+
+std::string EncodeRecord(uint8_t type, uint32_t slot, const std::string& location = "",
+                         int64_t block_index = 0, int64_t size = 0, uint32_t crc = 0) {
+  std::string record(4, '\0');
+  Put(&record, type);
+  Put(&record, slot);
+  Put(&record, block_index);
+  Put(&record, size);
+  Put(&record, crc);
+  Put(&record, static_cast<uint32_t>(location.size()));
+  record += location;
+  const uint32_t checksum = util::Crc32c(record.data() + 4, record.size() - 4);
+  std::memcpy(&record[0], &checksum, sizeof(checksum));
+  return record;
+}
+
+Status ErrnoError(const char* what, const std::string& path, int err) {
+  return Status::IOError(what, " '", path, "': ", std::strerror(err));
+}
+
+Status WriteFully(int fd, const void* data, int64_t nbytes, int64_t offset,
+                  const std::string& path) {
+  auto next = static_cast<const uint8_t*>(data);
+  while (nbytes > 0) {
+    const ssize_t ret = pwrite(fd, next, static_cast<size_t>(nbytes), offset);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return ErrnoError("Failed to write", path, errno);
+    }
+    next += ret;
+    nbytes -= ret;
+    offset += ret;
+  }
+  return Status::OK();
+}
+
+Status ReadFully(int fd, void* out, int64_t nbytes, int64_t offset,
+                 const std::string& path) {
+  auto next = static_cast<uint8_t*>(out);
+  while (nbytes > 0) {
+    const ssize_t ret = pread(fd, next, static_cast<size_t>(nbytes), offset);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return ErrnoError("Failed to read", path, errno);
+    }
+    if (ret == 0) {
+      return Status::IOError("Unexpected end of '", path, "'");
+    }
+    next += ret;
+    nbytes -= ret;
+    offset += ret;
+  }
+  return Status::OK();
+}
+
+size_t MissKey(const std::string& location, int64_t block_index) {
+  const size_t h = std::hash<std::string>()(location);
+  return h ^ (std::hash<int64_t>()(block_index) + 0x9e3779b97f4a7c15ULL + (h << 6) +
+              (h >> 2));
+}
+
+}  // namespace
+
+DiskCache::DiskCache(DiskCacheOptions options)
+    : options_(std::move(options)),
+      num_slots_(options_.capacity / options_.block_size),
+      slots_(static_cast<size_t>(num_slots_)) {}
+
+DiskCache::~DiskCache() {
+  WaitForPendingInserts();
+  for (int fd : {index_fd_, data_fd_, lock_fd_}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+Result<std::shared_ptr<DiskCache>> DiskCache::Open(DiskCacheOptions options) {
+  if (options.directory.empty()) {
+    return Status::Invalid("A disk cache needs a directory");
+  }
+  if (options.block_size <= 0 || options.capacity < options.block_size ||
+      options.capacity / options.block_size > UINT32_MAX) {
+    return Status::Invalid("Invalid disk cache block size ", options.block_size,
+                           " or capacity ", options.capacity);
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(options.directory, ec);
+  if (ec) {
+    return Status::IOError("Failed to create cache directory '", options.directory,
+                           "': ", ec.message());
+  }
+  std::shared_ptr<DiskCache> cache(new DiskCache(std::move(options)));
+  const std::string& directory = cache->options_.directory;
+  const std::string lock_path = directory + "/LOCK";
+  cache->lock_fd_ = open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (cache->lock_fd_ < 0) {
+    return ErrnoError("Failed to open", lock_path, errno);
+  }
+  if (flock(cache->lock_fd_, LOCK_EX | LOCK_NB) != 0) {
+    return Status::IOError("Cache directory '", directory, "' is in use");
+  }
+  const std::string data_path = directory + "/data";
+  cache->data_fd_ = open(data_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (cache->data_fd_ < 0) {
+    return ErrnoError("Failed to open", data_path, errno);
+  }
+  std::lock_guard<std::mutex> index_lock(cache->index_mutex_);
+  std::lock_guard<std::mutex> lock(cache->mutex_);
+  ICEBERG_RETURN_NOT_OK(cache->Load());
+  return cache;
+}
+
+Status DiskCache::Load() {
+  const std::string index_path = options_.directory + "/index";
+  std::string index;
+  int fd = open(index_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd >= 0) {
+    struct stat st;
+    Status status;
+    if (fstat(fd, &st) != 0) {
+      status = ErrnoError("Failed to stat", index_path, errno);
+    } else {
+      index.resize(static_cast<size_t>(st.st_size));
+      status = ReadFully(fd, &index[0], st.st_size, 0, index_path);
+    }
+    close(fd);
+    ICEBERG_RETURN_NOT_OK(status);
+  } else if (errno != ENOENT) {
+    return ErrnoError("Failed to open", index_path, errno);
+  }
+
+  struct stat data_stat;
+  if (fstat(data_fd_, &data_stat) != 0) {
+    return ErrnoError("Failed to stat", options_.directory + "/data", errno);
+  }
+  const std::string header = EncodeHeader(options_.block_size, num_slots_);
+  if (index.compare(0, header.size(), header) != 0 ||
+      data_stat.st_size != num_slots_ * options_.block_size) {
+    return Reset();
+  }
+
+  // Replay the records up to the first one torn by a crash
+  for (size_t pos = header.size(); pos + kRecordHeaderSize <= index.size();) {
+    const char* record = index.data() + pos;
+    const auto location_size = Get<uint32_t>(record + kRecordHeaderSize - 4);
+    const size_t record_size = kRecordHeaderSize + location_size;
+    if (pos + record_size > index.size() ||
+        util::Crc32c(record + 4, record_size - 4) != Get<uint32_t>(record)) {
+      break;
+    }
+    const auto type = Get<uint8_t>(record + 4);
+    const auto slot = Get<uint32_t>(record + 5);
+    if (slot >= num_slots_ || Get<int64_t>(record + 17) > options_.block_size) {
+      break;
+    }
+    if (slots_[slot].state == SlotState::USED) {
+      FreeLocked(slot);
+    }
+    if (type == kStoreRecord) {
+      UseLocked(slot, std::string(record + kRecordHeaderSize, location_size),
+                Get<int64_t>(record + 9), Get<int64_t>(record + 17),
+                Get<uint32_t>(record + 25));
+    }
+    pos += record_size;
+  }
+  free_.clear();
+  for (int64_t slot = num_slots_ - 1; slot >= 0; --slot) {
+    if (slots_[slot].state == SlotState::FREE) {
+      free_.push_back(static_cast<uint32_t>(slot));
+    }
+  }
+  return RewriteIndexLocked(EncodeIndexLocked(), static_cast<int64_t>(lru_.size()));
+}
+
+Status DiskCache::Reset() {
+  // Drop the blocks of the earlier configuration, leaving a sparse file
+  if (ftruncate(data_fd_, 0) != 0 ||
+      ftruncate(data_fd_, num_slots_ * options_.block_size) != 0) {
+    return ErrnoError("Failed to resize", options_.directory + "/data", errno);
+  }
+  free_.clear();
+  for (int64_t slot = num_slots_ - 1; slot >= 0; --slot) {
+    free_.push_back(static_cast<uint32_t>(slot));
+  }
+  return RewriteIndexLocked(EncodeIndexLocked(), 0);
+}
+
+std::string DiskCache::EncodeIndexLocked() const {
+  std::string index = EncodeHeader(options_.block_size, num_slots_);
+  // Oldest first, so that replaying the records restores the LRU order
+  for (auto it = lru_.rbegin(); it != lru_.rend(); ++it) {
+    const Slot& slot = slots_[*it];
+    index += EncodeRecord(kStoreRecord, *it, slot.location, slot.block_index, slot.size,
+                          slot.crc);
+  }
+  return index;
+}
+
+Status DiskCache::RewriteIndexLocked(const std::string& index, int64_t num_records) {
+  const std::string index_path = options_.directory + "/index";
+  const std::string temp_path = index_path + ".tmp";
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return ErrnoError("Failed to open", temp_path, errno);
+  }
+  Status status = WriteFully(fd, index.data(), static_cast<int64_t>(index.size()), 0,
+                             temp_path);
+  if (status.ok() && fdatasync(fd) != 0) {
+    status = ErrnoError("Failed to sync", temp_path, errno);
+  }
+  close(fd);
+  if (status.ok() && rename(temp_path.c_str(), index_path.c_str()) != 0) {
+    status = ErrnoError("Failed to rename", temp_path, errno);
+  }
+  ICEBERG_RETURN_NOT_OK(status);
+  fd = open(index_path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+  if (fd < 0) {
+    return ErrnoError("Failed to open", index_path, errno);
+  }
+  if (index_fd_ >= 0) {
+    close(index_fd_);
+  }
+  index_fd_ = fd;
+  index_records_ = num_records;
+  return Status::OK();
+}
+
+Status DiskCache::AppendIndexLocked(const std::string& records, int64_t num_records,
+                                    bool sync) {
+  const std::string index_path = options_.directory + "/index";
+  // Superseded records pile up as blocks come and go. The blocks whose records were
+  // appended so far are all reflected in memory, so the rewrite loses none of them.
+  if (index_records_ > 2 * num_slots_ + 1024) {
+    std::string index;
+    int64_t num_blocks;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      index = EncodeIndexLocked();
+      num_blocks = static_cast<int64_t>(lru_.size());
+    }
+    ICEBERG_RETURN_NOT_OK(RewriteIndexLocked(index, num_blocks));
+  }
+  for (size_t written = 0; written < records.size();) {
+    const ssize_t ret =
+        write(index_fd_, records.data() + written, records.size() - written);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return ErrnoError("Failed to append to", index_path, errno);
+    }
+    written += static_cast<size_t>(ret);
+  }
+  index_records_ += num_records;
+  if (sync && fdatasync(index_fd_) != 0) {
+    return ErrnoError("Failed to sync", index_path, errno);
+  }
+  return Status::OK();
+}
+
+Status DiskCache::AppendIndex(const std::string& records, int64_t num_records,
+                              bool sync) {
+  std::lock_guard<std::mutex> index_lock(index_mutex_);
+  return AppendIndexLocked(records, num_records, sync);
+}
+
+void DiskCache::UseLocked(uint32_t slot, const std::string& location,
+                          int64_t block_index, int64_t size, uint32_t crc) {
+  Slot& entry = slots_[slot];
+  entry.state = SlotState::USED;
+  entry.location = location;
+  entry.block_index = block_index;
+  entry.size = size;
+  entry.crc = crc;
+  lru_.push_front(slot);
+  entry.lru = lru_.begin();
+  files_[location][block_index] = slot;
+  size_ += size;
+}
+
+void DiskCache::FreeLocked(uint32_t slot) {
+  Slot& entry = slots_[slot];
+  auto it = files_.find(entry.location);
+  it->second.erase(entry.block_index);
+  if (it->second.empty()) {
+    files_.erase(it);
+  }
+  lru_.erase(entry.lru);
+  size_ -= entry.size;
+  entry.state = SlotState::FREE;
+  entry.location.clear();
+  // A slot still being read is freed up by the last reader
+  if (entry.readers == 0) {
+    free_.push_back(slot);
+  }
+}
+
+void DiskCache::RetireLocked(uint32_t slot) {
+  FreeLocked(slot);
+  if (slots_[slot].readers == 0) {
+    free_.pop_back();
+  }
+  slots_[slot].state = SlotState::PENDING;
+}
+
+void DiskCache::ReleaseLocked(uint32_t slot) {
+  Slot& entry = slots_[slot];
+  entry.state = SlotState::FREE;
+  entry.location.clear();
+  if (entry.readers == 0) {
+    free_.push_back(slot);
+  }
+}
+
+int64_t DiskCache::TakeSlotLocked(bool* evicted) {
+  *evicted = false;
+  if (free_.empty()) {
+    for (auto it = lru_.rbegin(); it != lru_.rend(); ++it) {
+      if (slots_[*it].readers == 0) {
+        const uint32_t victim = *it;
+        RetireLocked(victim);
+        ++stats_.evictions;
+        *evicted = true;
+        return victim;
+      }
+    }
+    return -1;
+  }
+  const uint32_t slot = free_.back();
+  free_.pop_back();
+  return slot;
+}
+
+Status DiskCache::ReleaseRetired(const std::vector<uint32_t>& slots) {
+  std::string records;
+  for (uint32_t slot : slots) {
+    records += EncodeRecord(kEraseRecord, slot);
+  }
+  Status status = AppendIndex(records, static_cast<int64_t>(slots.size()), true);
+  if (status.ok()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint32_t slot : slots) {
+      ReleaseLocked(slot);
+    }
+  }
+  return status;
+}
+
+bool DiskCache::AdmitLocked(const std::string& location, int64_t block_index) {
+  if (options_.admission == CacheAdmission::ALL) {
+    return true;
+  }
+  const size_t key = MissKey(location, block_index);
+  if (recent_misses_.erase(key) > 0) {
+    return true;
+  }
+  if (static_cast<int64_t>(recent_misses_.size()) >= options_.admission_window) {
+    recent_misses_.clear();
+  }
+  recent_misses_.insert(key);
+  return false;
+}
+
+void DiskCache::Unpin(uint32_t slot) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Slot& entry = slots_[slot];
+  if (--entry.readers == 0 && entry.state == SlotState::FREE) {
+    free_.push_back(slot);
+  }
+}
+
+Result<std::shared_ptr<Buffer>> DiskCache::Lookup(const std::string& location,
+                                                  int64_t block_index) {
+  uint32_t slot;
+  int64_t size;
+  uint32_t crc;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto file = files_.find(location);
+    if (file == files_.end() || file->second.count(block_index) == 0) {
+      ++stats_.misses;
+      return nullptr;
+    }
+    slot = file->second[block_index];
+    Slot& entry = slots_[slot];
+    ++entry.readers;
+    if (options_.eviction == CacheEviction::LRU) {
+      lru_.splice(lru_.begin(), lru_, entry.lru);
+    }
+    size = entry.size;
+    crc = entry.crc;
+    ++stats_.hits;
+  }
+  auto block = AllocateBuffer(size);
+  Status status = block.status();
+  if (status.ok()) {
+    status = ReadFully(data_fd_, (*block)->mutable_data(), size,
+                       slot * options_.block_size, options_.directory + "/data");
+  }
+  Unpin(slot);
+  ICEBERG_RETURN_NOT_OK(status);
+  if (!options_.verify_checksums ||
+      util::Crc32c((*block)->data(), static_cast<size_t>(size)) == crc) {
+    return block;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --stats_.hits;
+    ++stats_.misses;
+    ++stats_.corruptions;
+    const Slot& entry = slots_[slot];
+    // Unless the block was dropped meanwhile
+    if (entry.state != SlotState::USED || entry.crc != crc ||
+        entry.block_index != block_index || entry.location != location) {
+      return nullptr;
+    }
+    RetireLocked(slot);
+  }
+  ICEBERG_RETURN_NOT_OK(ReleaseRetired({slot}));
+  return nullptr;
+}
+
+Status DiskCache::Insert(const std::string& location, int64_t block_index,
+                         const Buffer& block) {
+  const int64_t size = block.size();
+  if (size > options_.block_size) {
+    return Status::Invalid("Block of ", size, " bytes exceeds the cache block size of ",
+                           options_.block_size);
+  }
+  if (size == 0) {
+    return Status::OK();
+  }
+  int64_t slot;
+  bool evicted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto file = files_.find(location);
+    if (file != files_.end() && file->second.count(block_index) > 0) {
+      return Status::OK();
+    }
+    if (!AdmitLocked(location, block_index)) {
+      ++stats_.rejections;
+      return Status::OK();
+    }
+    slot = TakeSlotLocked(&evicted);
+    if (slot < 0) {
+      ++stats_.rejections;
+      return Status::OK();
+    }
+    Slot& entry = slots_[slot];
+    entry.state = SlotState::PENDING;
+    entry.erased = false;
+    inserting_[location].insert(static_cast<uint32_t>(slot));
+  }
+  auto done_inserting = [&]() {
+    auto it = inserting_.find(location);
+    it->second.erase(static_cast<uint32_t>(slot));
+    if (it->second.empty()) {
+      inserting_.erase(it);
+    }
+  };
+  Status status;
+  if (evicted) {
+    // The index must stop mapping the evicted block to the slot before its bytes are
+    // overwritten, or a crash would leave the old key pointing at new data
+    status = AppendIndex(EncodeRecord(kEraseRecord, static_cast<uint32_t>(slot)), 1,
+                         true);
+    if (!status.ok()) {
+      // Keep the slot out of use until the index is rewritten on the next open
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_inserting();
+      return status;
+    }
+  }
+  const uint32_t crc = util::Crc32c(block.data(), static_cast<size_t>(size));
+  status = WriteFully(data_fd_, block.data(), size, slot * options_.block_size,
+                      options_.directory + "/data");
+  // The block must be on disk before the record that makes it visible after a restart
+  if (status.ok() && fdatasync(data_fd_) != 0) {
+    status = ErrnoError("Failed to sync", options_.directory + "/data", errno);
+  }
+
+  // Held until the block is in memory, so that an index compaction does not miss it
+  std::lock_guard<std::mutex> index_lock(index_mutex_);
+  bool recorded = false;
+  if (status.ok()) {
+    status = AppendIndexLocked(
+        EncodeRecord(kStoreRecord, static_cast<uint32_t>(slot), location, block_index,
+                     size, crc),
+        1, false);
+    recorded = status.ok();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_inserting();
+    auto file = files_.find(location);
+    const bool stored = file != files_.end() && file->second.count(block_index) > 0;
+    // Blocks of a file erased meanwhile may be stale
+    if (recorded && !stored && !slots_[slot].erased) {
+      UseLocked(static_cast<uint32_t>(slot), location, block_index, size, crc);
+      ++stats_.insertions;
+      return Status::OK();
+    }
+    if (!recorded) {
+      ReleaseLocked(static_cast<uint32_t>(slot));
+      return status;
+    }
+  }
+  // Take the record back before the slot is reused
+  status = AppendIndexLocked(EncodeRecord(kEraseRecord, static_cast<uint32_t>(slot)), 1,
+                             true);
+  if (status.ok()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReleaseLocked(static_cast<uint32_t>(slot));
+  }
+  return status;
+}
+
+void DiskCache::InsertAsync(const std::string& location, int64_t block_index,
+                            std::shared_ptr<Buffer> block) {
+  const int64_t size = block->size();
+  {
+    std::lock_guard<std::mutex> pending_lock(pending_mutex_);
+    if (pending_bytes_ + size > options_.max_pending_bytes) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.rejections;
+      return;
+    }
+    pending_bytes_ += size;
+  }
+  // The destructor waits for the pending inserts
+  util::GetIOThreadPool()->Spawn([this, location, block_index, block, size]() {
+    ICEBERG_WARN_NOT_OK(Insert(location, block_index, *block),
+                        "Failed to store block in disk cache");
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_bytes_ -= size;
+    pending_cv_.notify_all();
+  });
+}
+
+void DiskCache::WaitForPendingInserts() {
+  std::unique_lock<std::mutex> lock(pending_mutex_);
+  pending_cv_.wait(lock, [this]() { return pending_bytes_ == 0; });
+}
+
+Status DiskCache::Erase(const std::string& location) {
+  std::vector<uint32_t> slots;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto inserting = inserting_.find(location);
+    if (inserting != inserting_.end()) {
+      for (uint32_t slot : inserting->second) {
+        slots_[slot].erased = true;
+      }
+    }
+    auto file = files_.find(location);
+    if (file == files_.end()) {
+      return Status::OK();
+    }
+    for (const auto& block : file->second) {
+      slots.push_back(block.second);
+    }
+    for (uint32_t slot : slots) {
+      RetireLocked(slot);
+    }
+  }
+  return ReleaseRetired(slots);
+}
+
+int64_t DiskCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+int64_t DiskCache::num_blocks() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<int64_t>(lru_.size());
+}
+
+DiskCache::Stats DiskCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+namespace {
+
+class DiskCachingInputStream : public SeekableInputStream {
+ public:
+  DiskCachingInputStream(std::shared_ptr<InputFile> base_file,
+                         std::shared_ptr<DiskCache> cache, int64_t length)
+      : base_file_(std::move(base_file)), cache_(std::move(cache)), length_(length) {}
+
+  ~DiskCachingInputStream() override {
+    if (base_stream_ != nullptr && !base_stream_->closed()) {
+      ICEBERG_WARN_NOT_OK(base_stream_->Close(), "Failed to close cached stream");
+    }
+  }
+
+  Status Close() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    if (base_stream_ != nullptr) {
+      return base_stream_->Close();
+    }
+    return Status::OK();
+  }
+
+  Result<int64_t> Tell() const override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    return position_;
+  }
+
+  bool closed() const override { return closed_; }
+
+  Status Seek(int64_t position) override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    if (position < 0) {
+      return Status::Invalid("Invalid position");
+    }
+    position_ = position;
+    return Status::OK();
+  }
+
+  using SeekableInputStream::Read;
+  Result<int64_t> Read(int64_t nbytes, void* out) override {
+    ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read, ReadAt(position_, nbytes, out));
+    position_ += bytes_read;
+    return bytes_read;
+  }
+
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    if (position < 0 || nbytes < 0) {
+      return Status::Invalid("Invalid read range");
+    }
+    nbytes = std::min(nbytes, std::max<int64_t>(0, length_ - position));
+    if (nbytes == 0) {
+      return 0;
+    }
+    const int64_t block_size = cache_->options().block_size;
+    const int64_t first = position / block_size;
+    const int64_t last = (position + nbytes - 1) / block_size;
+    ICEBERG_ASSIGN_OR_RAISE(auto blocks, GetBlocks(first, last));
+
+    uint8_t* dest = reinterpret_cast<uint8_t*>(out);
+    int64_t copied = 0;
+    for (int64_t i = first; i <= last && copied < nbytes; ++i) {
+      const auto& block = blocks[i - first];
+      const int64_t offset = position + copied - i * block_size;
+      const int64_t n = std::min(nbytes - copied, block->size() - offset);
+      if (n <= 0) {
+        break;
+      }
+      std::memcpy(dest + copied, block->data() + offset, static_cast<size_t>(n));
+      copied += n;
+    }
+    return copied;
+  }
+
+  /// \brief Return a slice of the cached block if the range lies within one block
+  Result<std::shared_ptr<Buffer>> ReadAt(int64_t position, int64_t nbytes) override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    const int64_t block_size = cache_->options().block_size;
+    if (position >= 0 && nbytes > 0 &&
+        position / block_size == (position + nbytes - 1) / block_size) {
+      ICEBERG_ASSIGN_OR_RAISE(auto blocks,
+                              GetBlocks(position / block_size, position / block_size));
+      const auto& block = blocks[0];
+      const int64_t offset = std::min(position % block_size, block->size());
+      return SliceBuffer(block, offset, std::min(nbytes, block->size() - offset));
+    }
+    return SeekableInputStream::ReadAt(position, nbytes);
+  }
+
+ private:
+  Status CheckClosed() const {
+    if (closed_) {
+      return Status::Invalid("Invalid operation on closed file");
+    }
+    return Status::OK();
+  }
+
+  Result<std::shared_ptr<SeekableInputStream>> BaseStream() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (base_stream_ == nullptr) {
+      ICEBERG_ASSIGN_OR_RAISE(base_stream_, base_file_->newStream());
+    }
+    return base_stream_;
+  }
+
+  // Return blocks [first, last], fetching each run of consecutive misses with one read
+  Result<std::vector<std::shared_ptr<Buffer>>> GetBlocks(int64_t first, int64_t last) {
+    const std::string& location = base_file_->location();
+    const int64_t block_size = cache_->options().block_size;
+    std::vector<std::shared_ptr<Buffer>> blocks(static_cast<size_t>(last - first + 1));
+    for (int64_t i = first; i <= last; ++i) {
+      ICEBERG_ASSIGN_OR_RAISE(blocks[i - first], cache_->Lookup(location, i));
+    }
+    for (int64_t run_start = first; run_start <= last;) {
+      if (blocks[run_start - first] != nullptr) {
+        ++run_start;
+        continue;
+      }
+      int64_t run_end = run_start;
+      while (run_end + 1 <= last && blocks[run_end + 1 - first] == nullptr) {
+        ++run_end;
+      }
+      ICEBERG_ASSIGN_OR_RAISE(auto stream, BaseStream());
+      ICEBERG_ASSIGN_OR_RAISE(
+          auto data,
+          stream->ReadAt(run_start * block_size, (run_end - run_start + 1) * block_size));
+      for (int64_t i = run_start; i <= run_end; ++i) {
+        const int64_t offset = std::min((i - run_start) * block_size, data->size());
+        auto block =
+            SliceBuffer(data, offset, std::min(block_size, data->size() - offset));
+        if (block->size() > 0) {
+          // A slice would keep the whole run alive while queued, escaping
+          // max_pending_bytes, so queue a copy unless the block is all of it
+          std::shared_ptr<Buffer> pending = data;
+          if (block->size() < data->size()) {
+            ICEBERG_ASSIGN_OR_RAISE(pending, Buffer::CopyOf(block->ToStringView()));
+          }
+          cache_->InsertAsync(location, i, std::move(pending));
+        }
+        blocks[i - first] = std::move(block);
+      }
+      run_start = run_end + 1;
+    }
+    return blocks;
+  }
+
+  std::shared_ptr<InputFile> base_file_;
+  std::shared_ptr<DiskCache> cache_;
+  const int64_t length_;
+  int64_t position_ = 0;
+  std::atomic<bool> closed_{false};
+  std::mutex mutex_;
+  std::shared_ptr<SeekableInputStream> base_stream_;
+};
+
+class DiskCachingInputFile : public InputFile {
+ public:
+  DiskCachingInputFile(std::shared_ptr<InputFile> base, std::shared_ptr<DiskCache> cache,
+                       int64_t length)
+      : InputFile(base->location()),
+        base_(std::move(base)),
+        cache_(std::move(cache)),
+        length_(length) {}
+
+  Result<int64_t> getLength() override {
+    int64_t length = length_.load();
+    if (length < 0) {
+      ICEBERG_ASSIGN_OR_RAISE(length, base_->getLength());
+      length_.store(length);
+    }
+    return length;
+  }
+
+  Result<std::shared_ptr<SeekableInputStream>> newStream() override {
+    ICEBERG_ASSIGN_OR_RAISE(int64_t length, getLength());
+    return std::make_shared<DiskCachingInputStream>(base_, cache_, length);
+  }
+
+  bool exists() const override { return base_->exists(); }
+
+ private:
+  std::shared_ptr<InputFile> base_;
+  std::shared_ptr<DiskCache> cache_;
+  // -1 until known
+  std::atomic<int64_t> length_;
+};
+
+}  // namespace
+
+bool DiskCachingFileIO::Equals(const FileIO& other) const {
+  auto caching = dynamic_cast<const DiskCachingFileIO*>(&other);
+  return caching != nullptr && cache_ == caching->cache_ &&
+         base_->Equals(*caching->base_);
+}
+
+Result<std::shared_ptr<InputFile>> DiskCachingFileIO::newInputFile(
+    const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newInputFile(path));
+  return std::make_shared<DiskCachingInputFile>(std::move(base), cache_, -1);
+}
+
+Result<std::shared_ptr<InputFile>> DiskCachingFileIO::newInputFile(
+    const std::string& path, int64_t length) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newInputFile(path, length));
+  return std::make_shared<DiskCachingInputFile>(std::move(base), cache_, length);
+}
+
+Result<std::shared_ptr<OutputFile>> DiskCachingFileIO::newOutputFile(
+    const std::string& path) {
+  ICEBERG_RETURN_NOT_OK(cache_->Erase(path));
+  return base_->newOutputFile(path);
+}
+
+Status DiskCachingFileIO::DeleteFile(const std::string& path) {
+  ICEBERG_RETURN_NOT_OK(cache_->Erase(path));
+  return base_->DeleteFile(path);
+}
+
+Result<DeleteFilesResult> DiskCachingFileIO::DeleteFiles(
+    const std::vector<std::string>& paths, const DeleteFilesOptions& options) {
+  for (const auto& path : paths) {
+    ICEBERG_RETURN_NOT_OK(cache_->Erase(path));
+  }
+  return base_->DeleteFiles(paths, options);
+}
+
+Result<std::unique_ptr<FileInfoIterator>> DiskCachingFileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  return base_->ListPrefix(prefix, options);
+}
+
+Status DiskCachingFileIO::CopyFile(const std::string& src, const std::string& dst) {
+  ICEBERG_RETURN_NOT_OK(cache_->Erase(dst));
+  return base_->CopyFile(src, dst);
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,346 @@
+#include "iceberg/io/emulated_file_io.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+
+namespace iceberg {
+namespace io {
+
+namespace internal {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void SleepUntil(Clock::time_point deadline) {
+  if (deadline > Clock::now()) {
+    std::this_thread::sleep_until(deadline);
+  }
+}
+
+/// Paces units, bytes or requests, to a rate shared by all callers: each reservation
+/// gets the next free slot of the timeline.
+class Pacer {
+ public:
+  explicit Pacer(double units_per_second) : units_per_second_(units_per_second) {}
+
+  /// Reserve `units` and return the start and end of their slot.
+  std::pair<Clock::time_point, Clock::time_point> Reserve(double units) {
+    if (units_per_second_ <= 0) {
+      return {Clock::time_point(), Clock::time_point()};
+    }
+    const auto duration = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(units / units_per_second_));
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Clock::time_point start = std::max(next_, Clock::now());
+    next_ = start + duration;
+    return {start, next_};
+  }
+
+ private:
+  const double units_per_second_;
+  std::mutex mutex_;
+  Clock::time_point next_;
+};
+
+}  // namespace
+
+class StorageEmulator {
+ public:
+  explicit StorageEmulator(const EmulatedStorageOptions& options)
+      : options_(options),
+        requests_pacer_(options.max_requests_per_second),
+        read_pacer_(static_cast<double>(options.read_bandwidth)),
+        write_pacer_(static_cast<double>(options.write_bandwidth)),
+        random_(options.seed) {}
+
+  /// Wait for admission of a request and pay its overhead.
+  void Request() {
+    requests_.fetch_add(1, std::memory_order_relaxed);
+    SleepUntil(requests_pacer_.Reserve(1).first);
+    std::this_thread::sleep_for(options_.request_overhead);
+  }
+
+  /// A request returning or accepting data, paying the first-byte latency as well.
+  void DataRequest() {
+    Request();
+    const int64_t waiting = waiting_.fetch_add(1, std::memory_order_relaxed) + 1;
+    int64_t max = max_waiting_.load(std::memory_order_relaxed);
+    while (waiting > max && !max_waiting_.compare_exchange_weak(max, waiting)) {
+    }
+    std::this_thread::sleep_for(SampleLatency());
+    waiting_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void Read(int64_t nbytes) {
+    bytes_read_.fetch_add(nbytes, std::memory_order_relaxed);
+    SleepUntil(read_pacer_.Reserve(static_cast<double>(nbytes)).second);
+  }
+
+  void Write(int64_t nbytes) {
+    bytes_written_.fetch_add(nbytes, std::memory_order_relaxed);
+    SleepUntil(write_pacer_.Reserve(static_cast<double>(nbytes)).second);
+  }
+
+  EmulatedStorageStats stats() const {
+    return {requests_.load(), bytes_read_.load(), bytes_written_.load(),
+            max_waiting_.load()};
+  }
+
+ private:
+  std::chrono::microseconds SampleLatency() {
+    const double median = static_cast<double>(options_.first_byte_latency.count());
+    if (median <= 0 || options_.latency_distribution == LatencyDistribution::FIXED) {
+      return options_.first_byte_latency;
+    }
+    double sample;
+    {
+      std::lock_guard<std::mutex> lock(random_mutex_);
+      if (options_.latency_distribution == LatencyDistribution::UNIFORM) {
+        sample = std::uniform_real_distribution<double>(0, 2 * median)(random_);
+      } else {
+        sample = std::lognormal_distribution<double>(std::log(median),
+                                                     options_.latency_sigma)(random_);
+      }
+    }
+    return std::chrono::microseconds(static_cast<int64_t>(sample));
+  }
+
+  const EmulatedStorageOptions options_;
+  Pacer requests_pacer_;
+  Pacer read_pacer_;
+  Pacer write_pacer_;
+  std::mutex random_mutex_;
+  std::mt19937_64 random_;
+  std::atomic<int64_t> requests_{0};
+  std::atomic<int64_t> bytes_read_{0};
+  std::atomic<int64_t> bytes_written_{0};
+  // Requests paying their first-byte latency at the moment, and at most so far
+  std::atomic<int64_t> waiting_{0};
+  std::atomic<int64_t> max_waiting_{0};
+};
+
+}  // namespace internal
+
+namespace {
+
+using internal::StorageEmulator;
+
+class EmulatedInputStream : public SeekableInputStream {
+ public:
+  EmulatedInputStream(std::shared_ptr<SeekableInputStream> base,
+                      std::shared_ptr<StorageEmulator> emulator)
+      : base_(std::move(base)), emulator_(std::move(emulator)) {}
+
+  Status Close() override { return base_->Close(); }
+
+  Result<int64_t> Tell() const override { return base_->Tell(); }
+
+  bool closed() const override { return base_->closed(); }
+
+  /// \brief Seeking elsewhere ends the current GET; the next Read issues a new one
+  Status Seek(int64_t position) override {
+    ICEBERG_ASSIGN_OR_RAISE(int64_t current, base_->Tell());
+    ICEBERG_RETURN_NOT_OK(base_->Seek(position));
+    if (position != current) {
+      streaming_ = false;
+    }
+    return Status::OK();
+  }
+
+  using SeekableInputStream::Read;
+  Result<int64_t> Read(int64_t nbytes, void* out) override {
+    if (!streaming_) {
+      emulator_->DataRequest();
+      streaming_ = true;
+    }
+    ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read, base_->Read(nbytes, out));
+    emulator_->Read(bytes_read);
+    return bytes_read;
+  }
+
+  using SeekableInputStream::ReadAt;
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override {
+    emulator_->DataRequest();
+    ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read, base_->ReadAt(position, nbytes, out));
+    emulator_->Read(bytes_read);
+    return bytes_read;
+  }
+
+ private:
+  std::shared_ptr<SeekableInputStream> base_;
+  std::shared_ptr<StorageEmulator> emulator_;
+  // Whether sequential reads continue an already issued GET
+  bool streaming_ = false;
+};
+
+class EmulatedInputFile : public InputFile {
+ public:
+  EmulatedInputFile(std::shared_ptr<InputFile> base,
+                    std::shared_ptr<StorageEmulator> emulator, bool length_known)
+      : InputFile(base->location()),
+        base_(std::move(base)),
+        emulator_(std::move(emulator)),
+        length_known_(length_known) {}
+
+  Result<int64_t> getLength() override {
+    if (!length_known_) {
+      // A HEAD request
+      emulator_->Request();
+    }
+    return base_->getLength();
+  }
+
+  Result<std::shared_ptr<SeekableInputStream>> newStream() override {
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, base_->newStream());
+    return std::make_shared<EmulatedInputStream>(std::move(stream), emulator_);
+  }
+
+  bool exists() const override {
+    emulator_->Request();
+    return base_->exists();
+  }
+
+ private:
+  std::shared_ptr<InputFile> base_;
+  std::shared_ptr<StorageEmulator> emulator_;
+  const bool length_known_;
+};
+
+class EmulatedOutputStream : public PositionOutputStream {
+ public:
+  EmulatedOutputStream(std::shared_ptr<PositionOutputStream> base,
+                       std::shared_ptr<StorageEmulator> emulator)
+      : base_(std::move(base)), emulator_(std::move(emulator)) {}
+
+  /// \brief Complete the upload
+  Status Close() override {
+    if (!base_->closed()) {
+      emulator_->DataRequest();
+    }
+    return base_->Close();
+  }
+
+  Result<int64_t> Tell() const override { return base_->Tell(); }
+
+  bool closed() const override { return base_->closed(); }
+
+  using PositionOutputStream::Write;
+  Status Write(const void* data, int64_t nbytes) override {
+    ICEBERG_RETURN_NOT_OK(base_->Write(data, nbytes));
+    emulator_->Write(nbytes);
+    return Status::OK();
+  }
+
+  Status Flush() override { return base_->Flush(); }
+
+  Status Sync() override { return base_->Sync(); }
+
+ private:
+  std::shared_ptr<PositionOutputStream> base_;
+  std::shared_ptr<StorageEmulator> emulator_;
+};
+
+class EmulatedOutputFile : public OutputFile {
+ public:
+  EmulatedOutputFile(std::shared_ptr<OutputFile> base,
+                     std::shared_ptr<StorageEmulator> emulator)
+      : OutputFile(base->location()),
+        base_(std::move(base)),
+        emulator_(std::move(emulator)) {}
+
+  Result<std::shared_ptr<PositionOutputStream>> create() override {
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, base_->create());
+    return std::make_shared<EmulatedOutputStream>(std::move(stream), emulator_);
+  }
+
+  Result<std::shared_ptr<PositionOutputStream>> createOrOverwrite() override {
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, base_->createOrOverwrite());
+    return std::make_shared<EmulatedOutputStream>(std::move(stream), emulator_);
+  }
+
+  Result<std::shared_ptr<InputFile>> toInputFile() const override {
+    ICEBERG_ASSIGN_OR_RAISE(auto file, base_->toInputFile());
+    return std::make_shared<EmulatedInputFile>(std::move(file), emulator_, false);
+  }
+
+ private:
+  std::shared_ptr<OutputFile> base_;
+  std::shared_ptr<StorageEmulator> emulator_;
+};
+
+/// Charges one LIST request per batch.
+class EmulatedFileInfoIterator : public FileInfoIterator {
+ public:
+  EmulatedFileInfoIterator(std::unique_ptr<FileInfoIterator> base,
+                           std::shared_ptr<StorageEmulator> emulator)
+      : base_(std::move(base)), emulator_(std::move(emulator)) {}
+
+  Result<std::vector<FileInfo>> Next() override {
+    emulator_->Request();
+    return base_->Next();
+  }
+
+ private:
+  std::unique_ptr<FileInfoIterator> base_;
+  std::shared_ptr<StorageEmulator> emulator_;
+};
+
+}  // namespace
+
+EmulatedFileIO::EmulatedFileIO(std::shared_ptr<FileIO> base,
+                               EmulatedStorageOptions options)
+    : base_(std::move(base)),
+      emulator_(std::make_shared<StorageEmulator>(options)) {}
+
+EmulatedFileIO::~EmulatedFileIO() = default;
+
+bool EmulatedFileIO::Equals(const FileIO& other) const {
+  auto emulated = dynamic_cast<const EmulatedFileIO*>(&other);
+  return emulated != nullptr && emulator_ == emulated->emulator_ &&
+         base_->Equals(*emulated->base_);
+}
+
+Result<std::shared_ptr<InputFile>> EmulatedFileIO::newInputFile(const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newInputFile(path));
+  return std::make_shared<EmulatedInputFile>(std::move(base), emulator_, false);
+}
+
+Result<std::shared_ptr<InputFile>> EmulatedFileIO::newInputFile(const std::string& path,
+                                                                int64_t length) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newInputFile(path, length));
+  return std::make_shared<EmulatedInputFile>(std::move(base), emulator_, true);
+}
+
+Result<std::shared_ptr<OutputFile>> EmulatedFileIO::newOutputFile(
+    const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newOutputFile(path));
+  return std::make_shared<EmulatedOutputFile>(std::move(base), emulator_);
+}
+
+Status EmulatedFileIO::DeleteFile(const std::string& path) {
+  emulator_->Request();
+  return base_->DeleteFile(path);
+}
+
+Result<std::unique_ptr<FileInfoIterator>> EmulatedFileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->ListPrefix(prefix, options));
+  return std::make_unique<EmulatedFileInfoIterator>(std::move(base), emulator_);
+}
+
+Status EmulatedFileIO::CopyFile(const std::string& src, const std::string& dst) {
+  // The data moves within the store, so no bandwidth is charged
+  emulator_->DataRequest();
+  return base_->CopyFile(src, dst);
+}
+
+EmulatedStorageStats EmulatedFileIO::stats() const { return emulator_->stats(); }
+
+}  // namespace io
+}  // namespace iceberg
@@ -1,5 +1,10 @@
 #include "iceberg/io/file_io.hh"
 
+#include <algorithm>
+
+#include "iceberg/io/io_util.hh"
+#include "iceberg/util/thread_pool.hh"
+
 namespace iceberg {
 namespace io {
 
@@ -9,13 +14,164 @@ Status Writable::Write(std::string_view data) {
   return Write(data.data(), static_cast<int64_t>(data.size()));
 }
 
+Status Writable::Write(const std::shared_ptr<Buffer>& data) {
+  return Write(data->data(), data->size());
+}
+
 Status Writable::Flush() { return Status::OK(); }
 
+Status Writable::Sync() { return Flush(); }
+
+Result<std::shared_ptr<Buffer>> Readable::Read(int64_t nbytes) {
+  ICEBERG_ASSIGN_OR_RAISE(auto buffer, AllocateBuffer(nbytes));
+  ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read, Read(nbytes, buffer->mutable_data()));
+  if (bytes_read < nbytes) {
+    return SliceBuffer(std::move(buffer), 0, bytes_read);
+  }
+  return buffer;
+}
+
 Status InputStream::Advance(int64_t nbytes) {
-  uint8_t* buffer = new uint8_t[nbytes];
-  auto res = Read(nbytes, static_cast<void*>(buffer));
-  delete[] buffer;
-  return res.status();
+  constexpr int64_t kScratchSize = 64 * 1024;
+  std::unique_ptr<uint8_t[]> scratch;
+  while (nbytes > 0) {
+    const int64_t chunksize = std::min(nbytes, kScratchSize);
+    if (scratch == nullptr) {
+      scratch.reset(new uint8_t[chunksize]);
+    }
+    ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read, Read(chunksize, scratch.get()));
+    if (bytes_read == 0) {
+      // EOF
+      break;
+    }
+    nbytes -= bytes_read;
+  }
+  return Status::OK();
+}
+
+Status SeekableInputStream::Advance(int64_t nbytes) {
+  if (nbytes < 0) {
+    return Status::Invalid("Cannot advance by a negative number of bytes");
+  }
+  ICEBERG_ASSIGN_OR_RAISE(int64_t position, Tell());
+  return Seek(position + nbytes);
+}
+
+Result<int64_t> SeekableInputStream::ReadAt(int64_t position, int64_t nbytes,
+                                            void* out) {
+  ICEBERG_ASSIGN_OR_RAISE(int64_t current, Tell());
+  ICEBERG_RETURN_NOT_OK(Seek(position));
+  auto res = Read(nbytes, out);
+  ICEBERG_RETURN_NOT_OK(Seek(current));
+  return res;
+}
+
+Result<std::shared_ptr<Buffer>> SeekableInputStream::ReadAt(int64_t position,
+                                                            int64_t nbytes) {
+  ICEBERG_ASSIGN_OR_RAISE(auto buffer, AllocateBuffer(nbytes));
+  ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read,
+                          ReadAt(position, nbytes, buffer->mutable_data()));
+  if (bytes_read < nbytes) {
+    return SliceBuffer(std::move(buffer), 0, bytes_read);
+  }
+  return buffer;
+}
+
+std::future<Result<int64_t>> SeekableInputStream::ReadAtAsync(int64_t position,
+                                                              int64_t nbytes, void* out) {
+  return util::GetIOThreadPool()->Submit(
+      [this, position, nbytes, out]() { return ReadAt(position, nbytes, out); });
+}
+
+Result<std::vector<std::shared_ptr<Buffer>>> SeekableInputStream::ReadRanges(
+    const std::vector<ReadRange>& ranges, const CoalesceOptions& options) {
+  ICEBERG_ASSIGN_OR_RAISE(auto coalesced, internal::CoalesceReadRanges(ranges, options));
+
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  std::vector<std::future<Result<int64_t>>> futures;
+  buffers.reserve(coalesced.size());
+  futures.reserve(coalesced.size());
+  // Allocate every buffer before issuing the first read, so that no error can return
+  // while reads are writing into buffers
+  for (const auto& range : coalesced) {
+    ICEBERG_ASSIGN_OR_RAISE(auto buffer, AllocateBuffer(range.length));
+    buffers.push_back(std::move(buffer));
+  }
+  for (size_t i = 0; i < coalesced.size(); ++i) {
+    futures.push_back(ReadAtAsync(coalesced[i].offset, coalesced[i].length,
+                                  buffers[i]->mutable_data()));
+  }
+  // Wait for every read before returning, even on error, since they write into buffers
+  std::vector<int64_t> bytes_read(coalesced.size());
+  Status status;
+  for (size_t i = 0; i < futures.size(); ++i) {
+    auto res = futures[i].get();
+    if (res.ok()) {
+      bytes_read[i] = res.ValueUnsafe();
+    } else {
+      status &= res.status();
+    }
+  }
+  ICEBERG_RETURN_NOT_OK(status);
+
+  std::vector<std::shared_ptr<Buffer>> out;
+  out.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    if (range.length == 0) {
+      out.push_back(std::make_shared<Buffer>(nullptr, 0));
+      continue;
+    }
+    // Coalesced ranges are sorted and disjoint; the last one starting at or before the
+    // requested range contains it
+    auto it = std::upper_bound(
+        coalesced.begin(), coalesced.end(), range.offset,
+        [](int64_t offset, const ReadRange& merged) { return offset < merged.offset; });
+    const size_t index = static_cast<size_t>(it - coalesced.begin()) - 1;
+    const int64_t start = range.offset - coalesced[index].offset;
+    const int64_t available = std::max<int64_t>(0, bytes_read[index] - start);
+    out.push_back(SliceBuffer(buffers[index], std::min(start, bytes_read[index]),
+                              std::min(range.length, available)));
+  }
+  return out;
+}
+
+Result<std::vector<std::shared_ptr<Buffer>>> InputFile::ReadRanges(
+    const std::vector<ReadRange>& ranges, const CoalesceOptions& options) {
+  ICEBERG_ASSIGN_OR_RAISE(auto stream, newStream());
+  ICEBERG_ASSIGN_OR_RAISE(auto buffers, stream->ReadRanges(ranges, options));
+  ICEBERG_RETURN_NOT_OK(stream->Close());
+  return buffers;
+}
+
+Result<DeleteFilesResult> FileIO::DeleteFiles(const std::vector<std::string>& paths,
+                                              const DeleteFilesOptions& options) {
+  return internal::RunDeleteFiles(
+      paths, options,
+      [this](int, const std::string& path) { return DeleteFile(path); });
+}
+
+Result<std::unique_ptr<FileInfoIterator>> FileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  return Status::NotImplemented("Listing is not supported by FileIO ", name());
+}
+
+Status FileIO::CopyFile(const std::string& src, const std::string& dst) {
+  ICEBERG_ASSIGN_OR_RAISE(auto input_file, newInputFile(src));
+  ICEBERG_ASSIGN_OR_RAISE(auto input, input_file->newStream());
+  ICEBERG_ASSIGN_OR_RAISE(auto output_file, newOutputFile(dst));
+  ICEBERG_ASSIGN_OR_RAISE(auto output, output_file->create());
+  auto status = internal::CopyStream(input.get(), output.get());
+  status &= input->Close();
+  if (status.ok()) {
+    status = output->Close();
+  } else {
+    ICEBERG_UNUSED(output->Close());
+  }
+  if (!status.ok()) {
+    // Best effort, the copy error is what matters
+    ICEBERG_UNUSED(DeleteFile(dst));
+  }
+  return status;
 }
 
 Status InputFile::CheckExists() const {
@@ -0,0 +1,91 @@
+#include "iceberg/io/group_commit.hh"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace iceberg {
+namespace io {
+
+struct GroupCommitter::Batch {
+  std::vector<std::shared_ptr<OutputStream>> streams;
+  std::vector<Status> results;
+  bool done = false;
+
+  size_t Add(const std::shared_ptr<OutputStream>& stream) {
+    for (size_t i = 0; i < streams.size(); ++i) {
+      if (streams[i] == stream) {
+        return i;
+      }
+    }
+    streams.push_back(stream);
+    return streams.size() - 1;
+  }
+
+  void SyncAll() {
+    results.resize(streams.size());
+    // Not the I/O thread pool: the writers waiting on this batch may be its workers.
+    // The leader syncs alongside at most kMaxHelpers threads, each taking every
+    // (kMaxHelpers + 1)-th stream, so a large batch does not start a thread per stream.
+    constexpr size_t kMaxHelpers = 7;
+    const size_t num_workers = std::min(streams.size(), kMaxHelpers + 1);
+    auto sync_share = [this, num_workers](size_t worker) {
+      for (size_t i = worker; i < streams.size(); i += num_workers) {
+        results[i] = streams[i]->Sync();
+      }
+    };
+    std::vector<std::thread> helpers;
+    for (size_t worker = 1; worker < num_workers; ++worker) {
+      helpers.emplace_back(sync_share, worker);
+    }
+    sync_share(0);
+    for (auto& helper : helpers) {
+      helper.join();
+    }
+  }
+};
+
+GroupCommitter::GroupCommitter(std::chrono::microseconds max_delay)
+    : max_delay_(max_delay) {}
+
+GroupCommitter::~GroupCommitter() = default;
+
+Status GroupCommitter::Sync(const std::shared_ptr<OutputStream>& stream) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (pending_ == nullptr) {
+    pending_ = std::make_shared<Batch>();
+  }
+  std::shared_ptr<Batch> batch = pending_;
+  const size_t index = batch->Add(stream);
+
+  while (!batch->done) {
+    if (!leader_active_ && pending_ == batch) {
+      // Lead this batch
+      leader_active_ = true;
+      if (max_delay_.count() > 0) {
+        lock.unlock();
+        std::this_thread::sleep_for(max_delay_);
+        lock.lock();
+      }
+      pending_ = nullptr;
+      lock.unlock();
+      batch->SyncAll();
+      lock.lock();
+      batch->done = true;
+      leader_active_ = false;
+      ++num_batches_;
+      cv_.notify_all();
+      break;
+    }
+    cv_.wait(lock);
+  }
+  return batch->results[index];
+}
+
+int64_t GroupCommitter::num_batches() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_batches_;
+}
+
+}  // namespace io
+}  // namespace iceberg
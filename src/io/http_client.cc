@@ -0,0 +1,417 @@
+#include "iceberg/io/http_client.hh"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+constexpr size_t kReadBufferSize = 64 * 1024;
+
+std::string ToLower(std::string_view s) {
+  std::string lower(s);
+  std::transform(lower.begin(), lower.end(), lower.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return lower;
+}
+
+std::string_view Trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+    s.remove_prefix(1);
+  }
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+    s.remove_suffix(1);
+  }
+  return s;
+}
+
+}  // namespace
+
+Result<int64_t> ParseHttpLength(std::string_view value, int base) {
+  const std::string digits(Trim(value));
+  const bool valid_start = !digits.empty() && std::isxdigit(digits[0]) &&
+                           (base == 16 || std::isdigit(digits[0]));
+  char* end = nullptr;
+  errno = 0;
+  const long long length = valid_start ? std::strtoll(digits.c_str(), &end, base) : -1;
+  if (length < 0 || errno == ERANGE || *end != '\0') {
+    return Status::IOError("Invalid HTTP length '", value, "'");
+  }
+  return static_cast<int64_t>(length);
+}
+
+const std::string* HttpResponse::header(std::string_view name) const {
+  for (const auto& header : headers) {
+    if (header.first == name) {
+      return &header.second;
+    }
+  }
+  return nullptr;
+}
+
+struct HttpClient::Connection {
+  explicit Connection(int fd) : fd(fd), buffer(new char[kReadBufferSize]) {}
+  ~Connection() { close(fd); }
+
+  Status Fail(const char* what, int err) const {
+    return Status::IOError("HTTP ", what, " failed: ", std::strerror(err));
+  }
+
+  Status SendAll(std::string_view head, std::string_view body) {
+    iovec iov[2] = {{const_cast<char*>(head.data()), head.size()},
+                    {const_cast<char*>(body.data()), body.size()}};
+    int first = 0;
+    while (first < 2) {
+      msghdr msg{};
+      msg.msg_iov = iov + first;
+      msg.msg_iovlen = 2 - first;
+      const ssize_t ret = sendmsg(fd, &msg, MSG_NOSIGNAL);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return Fail("send", errno);
+      }
+      size_t sent = static_cast<size_t>(ret);
+      while (first < 2 && sent >= iov[first].iov_len) {
+        sent -= iov[first].iov_len;
+        ++first;
+      }
+      if (first < 2) {
+        iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + sent;
+        iov[first].iov_len -= sent;
+      }
+    }
+    return Status::OK();
+  }
+
+  // Buffer more bytes; return false at the end of the stream
+  Result<bool> Fill() {
+    if (begin > 0 && begin == end) {
+      begin = end = 0;
+    }
+    for (;;) {
+      const ssize_t ret = recv(fd, buffer.get() + end, kReadBufferSize - end, 0);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return Fail("receive", errno);
+      }
+      end += static_cast<size_t>(ret);
+      return ret > 0;
+    }
+  }
+
+  Result<std::string> ReadLine() {
+    std::string line;
+    for (;;) {
+      const char* start = buffer.get() + begin;
+      const char* newline =
+          static_cast<const char*>(std::memchr(start, '\n', end - begin));
+      if (newline != nullptr) {
+        line.append(start, newline - start);
+        begin += newline - start + 1;
+        if (!line.empty() && line.back() == '\r') {
+          line.pop_back();
+        }
+        return line;
+      }
+      line.append(start, end - begin);
+      begin = end = 0;
+      if (line.size() > kReadBufferSize) {
+        return Status::IOError("HTTP response line too long");
+      }
+      ICEBERG_ASSIGN_OR_RAISE(bool more, Fill());
+      if (!more) {
+        return Status::IOError("HTTP connection closed mid-response");
+      }
+    }
+  }
+
+  // Read exactly `nbytes`, large reads going straight to `out`
+  Status ReadExact(char* out, int64_t nbytes) {
+    const int64_t buffered = std::min<int64_t>(nbytes, end - begin);
+    std::memcpy(out, buffer.get() + begin, static_cast<size_t>(buffered));
+    begin += static_cast<size_t>(buffered);
+    for (int64_t done = buffered; done < nbytes;) {
+      const ssize_t ret = recv(fd, out + done, static_cast<size_t>(nbytes - done), 0);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return Fail("receive", errno);
+      }
+      if (ret == 0) {
+        return Status::IOError("HTTP connection closed mid-response");
+      }
+      done += ret;
+    }
+    return Status::OK();
+  }
+
+  Status ReadToEnd(std::string* out, int64_t limit) {
+    for (;;) {
+      if (static_cast<int64_t>(out->size() + (end - begin)) > limit) {
+        return Status::IOError("HTTP response body exceeds ", limit, " bytes");
+      }
+      out->append(buffer.get() + begin, end - begin);
+      begin = end = 0;
+      ICEBERG_ASSIGN_OR_RAISE(bool more, Fill());
+      if (!more) {
+        return Status::OK();
+      }
+    }
+  }
+
+  int fd;
+  std::unique_ptr<char[]> buffer;
+  size_t begin = 0;
+  size_t end = 0;
+  bool reused = false;
+};
+
+HttpClient::HttpClient(HttpClientOptions options)
+    : options_(std::move(options)),
+      host_header_(options_.port == 80
+                       ? options_.host
+                       : options_.host + ":" + std::to_string(options_.port)) {}
+
+HttpClient::~HttpClient() = default;
+
+Result<std::unique_ptr<HttpClient::Connection>> HttpClient::Connect() {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addresses = nullptr;
+  std::string host = options_.host;
+  if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+    host = host.substr(1, host.size() - 2);
+  }
+  const int ret = getaddrinfo(host.c_str(), std::to_string(options_.port).c_str(),
+                              &hints, &addresses);
+  if (ret != 0) {
+    return Status::IOError("Failed to resolve '", options_.host,
+                           "': ", gai_strerror(ret));
+  }
+  timeval timeout;
+  timeout.tv_sec = options_.timeout_millis / 1000;
+  timeout.tv_usec = (options_.timeout_millis % 1000) * 1000;
+  int err = 0;
+  for (addrinfo* address = addresses; address != nullptr; address = address->ai_next) {
+    int fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC,
+                    address->ai_protocol);
+    if (fd < 0) {
+      err = errno;
+      continue;
+    }
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    // Also bounds connect on Linux
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+      freeaddrinfo(addresses);
+      return std::make_unique<Connection>(fd);
+    }
+    err = errno;
+    close(fd);
+  }
+  freeaddrinfo(addresses);
+  return Status::IOError("Failed to connect to ", host_header_, ": ",
+                         std::strerror(err));
+}
+
+Result<std::unique_ptr<HttpClient::Connection>> HttpClient::Acquire() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() {
+      return !idle_.empty() || num_open_ < std::max(options_.max_connections, 1);
+    });
+    if (!idle_.empty()) {
+      auto connection = std::move(idle_.back());
+      idle_.pop_back();
+      connection->reused = true;
+      return connection;
+    }
+    ++num_open_;
+    ++stats_.connections_opened;
+  }
+  auto connection = Connect();
+  if (!connection.ok()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --num_open_;
+    cv_.notify_one();
+  }
+  return connection;
+}
+
+void HttpClient::Release(std::unique_ptr<Connection> connection, bool reusable) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (reusable) {
+    idle_.push_back(std::move(connection));
+  } else {
+    connection.reset();
+    --num_open_;
+  }
+  cv_.notify_one();
+}
+
+Status HttpClient::Exchange(Connection* connection, const HttpRequest& request,
+                            HttpResponse* response, bool* received, bool* keep_alive) {
+  std::string head = request.method + " " + request.target + " HTTP/1.1\r\nHost: " +
+                     host_header_ + "\r\n";
+  for (const auto& header : request.headers) {
+    head += header.first + ": " + header.second + "\r\n";
+  }
+  if (!request.body.empty() || request.method == "PUT" || request.method == "POST") {
+    head += "Content-Length: " + std::to_string(request.body.size()) + "\r\n";
+  }
+  head += "\r\n";
+  ICEBERG_RETURN_NOT_OK(connection->SendAll(head, request.body));
+
+  std::string line;
+  // Skip interim responses such as 100 Continue
+  do {
+    if (connection->begin == connection->end) {
+      ICEBERG_ASSIGN_OR_RAISE(bool more, connection->Fill());
+      if (!more) {
+        return Status::IOError("HTTP connection closed before the response");
+      }
+    }
+    *received = true;
+    ICEBERG_ASSIGN_OR_RAISE(line, connection->ReadLine());
+    if (line.compare(0, 5, "HTTP/") != 0 || line.size() < 12) {
+      return Status::IOError("Invalid HTTP status line '", line, "'");
+    }
+    response->status = std::atoi(line.c_str() + 9);
+    response->headers.clear();
+    for (;;) {
+      ICEBERG_ASSIGN_OR_RAISE(std::string header, connection->ReadLine());
+      if (header.empty()) {
+        break;
+      }
+      const size_t colon = header.find(':');
+      if (colon == std::string::npos) {
+        return Status::IOError("Invalid HTTP header '", header, "'");
+      }
+      response->headers.emplace_back(
+          ToLower(Trim(std::string_view(header).substr(0, colon))),
+          std::string(Trim(std::string_view(header).substr(colon + 1))));
+    }
+  } while (response->status >= 100 && response->status < 200);
+
+  const std::string* connection_header = response->header("connection");
+  *keep_alive = line.compare(0, 8, "HTTP/1.0") != 0 &&
+                (connection_header == nullptr || ToLower(*connection_header) != "close");
+  if (request.method == "HEAD" || response->status == 204 || response->status == 304) {
+    return Status::OK();
+  }
+  const bool to_out = request.body_out != nullptr && response->status >= 200 &&
+                      response->status < 300;
+  // A body read into `body_out` only ends up there if it fits
+  const int64_t limit = to_out ? request.body_capacity : options_.max_body_bytes;
+  const std::string* encoding = response->header("transfer-encoding");
+  const std::string* length = response->header("content-length");
+  if (encoding != nullptr && ToLower(*encoding).find("chunked") != std::string::npos) {
+    for (;;) {
+      ICEBERG_ASSIGN_OR_RAISE(std::string size_line, connection->ReadLine());
+      // Chunk extensions follow a semicolon
+      ICEBERG_ASSIGN_OR_RAISE(
+          const int64_t chunk_size,
+          ParseHttpLength(std::string_view(size_line).substr(0, size_line.find(';')),
+                          16));
+      if (chunk_size == 0) {
+        break;
+      }
+      if (chunk_size > limit - static_cast<int64_t>(response->body.size())) {
+        return Status::IOError("HTTP response body exceeds ", limit, " bytes");
+      }
+      const size_t offset = response->body.size();
+      response->body.resize(offset + static_cast<size_t>(chunk_size));
+      ICEBERG_RETURN_NOT_OK(connection->ReadExact(&response->body[offset], chunk_size));
+      ICEBERG_RETURN_NOT_OK(connection->ReadLine().status());
+    }
+    // Trailers
+    for (;;) {
+      ICEBERG_ASSIGN_OR_RAISE(std::string trailer, connection->ReadLine());
+      if (trailer.empty()) {
+        break;
+      }
+    }
+  } else if (length != nullptr) {
+    ICEBERG_ASSIGN_OR_RAISE(const int64_t content_length, ParseHttpLength(*length));
+    if (content_length > limit) {
+      return Status::IOError("HTTP response of ", content_length, " bytes exceeds the ",
+                             limit, " bytes expected");
+    }
+    if (to_out) {
+      ICEBERG_RETURN_NOT_OK(connection->ReadExact(static_cast<char*>(request.body_out),
+                                                  content_length));
+      response->body_size = content_length;
+      return Status::OK();
+    }
+    response->body.resize(static_cast<size_t>(content_length));
+    ICEBERG_RETURN_NOT_OK(connection->ReadExact(&response->body[0], content_length));
+  } else {
+    ICEBERG_RETURN_NOT_OK(connection->ReadToEnd(&response->body, limit));
+    *keep_alive = false;
+  }
+  response->body_size = static_cast<int64_t>(response->body.size());
+  if (to_out) {
+    if (response->body_size > request.body_capacity) {
+      return Status::IOError("HTTP response of ", response->body_size,
+                             " bytes exceeds the ", request.body_capacity,
+                             " bytes expected");
+    }
+    std::memcpy(request.body_out, response->body.data(), response->body.size());
+    response->body.clear();
+  }
+  return Status::OK();
+}
+
+Result<HttpResponse> HttpClient::Send(const HttpRequest& request) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.requests;
+  }
+  for (;;) {
+    ICEBERG_ASSIGN_OR_RAISE(auto connection, Acquire());
+    HttpResponse response;
+    bool received = false;
+    bool keep_alive = false;
+    Status status =
+        Exchange(connection.get(), request, &response, &received, &keep_alive);
+    const bool reused = connection->reused;
+    if (status.ok()) {
+      // Stray bytes would be taken for the next response
+      keep_alive &= connection->begin == connection->end;
+      Release(std::move(connection), keep_alive);
+      return response;
+    }
+    Release(std::move(connection), false);
+    if (!reused || received) {
+      return status;
+    }
+    // The server likely closed the idle connection; retry on another one
+  }
+}
+
+HttpClient::Stats HttpClient::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,536 @@
+#include "iceberg/io/instrumented_file_io.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+#include "iceberg/util/thread_pool.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t NanosSince(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+const char* IOOperationName(IOOperation operation) {
+  switch (operation) {
+    case IOOperation::OPEN:
+      return "open";
+    case IOOperation::READ:
+      return "read";
+    case IOOperation::SEEK:
+      return "seek";
+    case IOOperation::WRITE:
+      return "write";
+    case IOOperation::FLUSH:
+      return "flush";
+    case IOOperation::DELETE:
+      return "delete";
+    case IOOperation::COPY:
+      return "copy";
+  }
+  return "unknown";
+}
+
+int Log2Histogram::BucketOf(int64_t value) {
+  int bucket = 0;
+  for (uint64_t v = static_cast<uint64_t>(std::max<int64_t>(value, 0)); v != 0; v >>= 1) {
+    ++bucket;
+  }
+  return std::min(bucket, kNumBuckets - 1);
+}
+
+int64_t Log2Histogram::BucketUpperBound(int bucket) {
+  if (bucket == kNumBuckets - 1) {
+    return INT64_MAX;
+  }
+  return (int64_t{1} << bucket) - 1;
+}
+
+int64_t Log2Histogram::count() const {
+  int64_t total = 0;
+  for (int64_t n : buckets) {
+    total += n;
+  }
+  return total;
+}
+
+int64_t Log2Histogram::Quantile(double quantile) const {
+  const int64_t total = count();
+  if (total == 0) {
+    return 0;
+  }
+  const auto rank = std::max<int64_t>(
+      1, static_cast<int64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * total)));
+  int64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return BucketUpperBound(i);
+    }
+  }
+  return BucketUpperBound(kNumBuckets - 1);
+}
+
+std::string IOMetrics::ToString() const {
+  std::ostringstream ss;
+  for (int i = 0; i < kNumIOOperations; ++i) {
+    const auto& op = operations[i];
+    ss << IOOperationName(static_cast<IOOperation>(i)) << ": count=" << op.count
+       << " errors=" << op.errors << " bytes=" << op.bytes
+       << " p50<=" << op.latency_nanos.Quantile(0.5)
+       << "ns p99<=" << op.latency_nanos.Quantile(0.99) << "ns\n";
+  }
+  return ss.str();
+}
+
+namespace internal {
+
+class MetricsRecorder {
+ public:
+  MetricsRecorder() : shards_(std::make_unique<Shard[]>(kNumShards)) {}
+
+  void Record(IOOperation operation, bool ok, int64_t bytes, int64_t nanos) {
+    auto& counters = shards_[ShardIndex()].operations[static_cast<int>(operation)];
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    if (!ok) {
+      counters.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (operation == IOOperation::READ || operation == IOOperation::WRITE) {
+      counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+      counters.sizes[Log2Histogram::BucketOf(bytes)].fetch_add(1,
+                                                               std::memory_order_relaxed);
+    }
+    counters.latency_nanos[Log2Histogram::BucketOf(nanos)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  /// Record `count` operations sharing a single latency sample.
+  void RecordBatch(IOOperation operation, int64_t count, int64_t errors, int64_t nanos) {
+    auto& counters = shards_[ShardIndex()].operations[static_cast<int>(operation)];
+    counters.count.fetch_add(count, std::memory_order_relaxed);
+    counters.errors.fetch_add(errors, std::memory_order_relaxed);
+    counters.latency_nanos[Log2Histogram::BucketOf(nanos)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  IOMetrics Snapshot() const {
+    IOMetrics metrics;
+    for (int s = 0; s < kNumShards; ++s) {
+      for (int i = 0; i < kNumIOOperations; ++i) {
+        const auto& counters = shards_[s].operations[i];
+        auto& out = metrics.operations[i];
+        out.count += counters.count.load(std::memory_order_relaxed);
+        out.errors += counters.errors.load(std::memory_order_relaxed);
+        out.bytes += counters.bytes.load(std::memory_order_relaxed);
+        for (int b = 0; b < Log2Histogram::kNumBuckets; ++b) {
+          out.sizes.buckets[b] += counters.sizes[b].load(std::memory_order_relaxed);
+          out.latency_nanos.buckets[b] +=
+              counters.latency_nanos[b].load(std::memory_order_relaxed);
+        }
+      }
+    }
+    return metrics;
+  }
+
+ private:
+  static constexpr int kNumShards = 16;
+
+  using Buckets = std::array<std::atomic<int64_t>, Log2Histogram::kNumBuckets>;
+
+  struct OperationCounters {
+    std::atomic<int64_t> count;
+    std::atomic<int64_t> errors;
+    std::atomic<int64_t> bytes;
+    Buckets sizes;
+    Buckets latency_nanos;
+  };
+
+  // Cache-line aligned, so that threads on different shards do not share lines
+  struct alignas(64) Shard {
+    std::array<OperationCounters, kNumIOOperations> operations;
+  };
+
+  // Threads are assigned shards round-robin on their first operation
+  static int ShardIndex() {
+    static std::atomic<int> next_shard{0};
+    thread_local const int shard =
+        next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+    return shard;
+  }
+
+  // Value-initialized, which zeroes the counters
+  std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace internal
+
+namespace {
+
+using internal::MetricsRecorder;
+
+/// The recorders an operation on a given path is reported to.
+class MetricsSink {
+ public:
+  MetricsSink(std::shared_ptr<MetricsRecorder> total,
+              std::shared_ptr<MetricsRecorder> prefix)
+      : total_(std::move(total)), prefix_(std::move(prefix)) {}
+
+  void Record(IOOperation operation, const Status& status, int64_t bytes,
+              Clock::time_point start) const {
+    const int64_t nanos = NanosSince(start);
+    total_->Record(operation, status.ok(), bytes, nanos);
+    if (prefix_ != nullptr) {
+      prefix_->Record(operation, status.ok(), bytes, nanos);
+    }
+  }
+
+  template <typename T>
+  void Record(IOOperation operation, const Result<T>& res,
+              Clock::time_point start) const {
+    Record(operation, res.status(), 0, start);
+  }
+
+  void RecordRead(IOOperation operation, const Result<int64_t>& res,
+                  Clock::time_point start) const {
+    Record(operation, res.status(), res.ok() ? res.ValueUnsafe() : 0, start);
+  }
+
+  void RecordRead(IOOperation operation, const Result<std::shared_ptr<Buffer>>& res,
+                  Clock::time_point start) const {
+    Record(operation, res.status(), res.ok() ? res.ValueUnsafe()->size() : 0, start);
+  }
+
+ private:
+  std::shared_ptr<MetricsRecorder> total_;
+  std::shared_ptr<MetricsRecorder> prefix_;
+};
+
+// Waits for the futures of the base streams' ReadAtAsync. Separate from the I/O pool
+// whose tasks complete those futures, so that waiters never hold up the reads they wait
+// for; futures of nested decorators are queued before their wrappers, so FIFO order
+// keeps them from waiting on each other either.
+util::ThreadPool* CompletionThreadPool() {
+  // Intentionally leaked, like the I/O pool
+  static util::ThreadPool* pool =
+      new util::ThreadPool(util::GetIOThreadPool()->num_threads());
+  return pool;
+}
+
+class InstrumentedInputStream : public SeekableInputStream {
+ public:
+  InstrumentedInputStream(std::shared_ptr<SeekableInputStream> base,
+                          std::shared_ptr<const MetricsSink> sink)
+      : base_(std::move(base)), sink_(std::move(sink)) {}
+
+  Status Close() override { return base_->Close(); }
+
+  Result<int64_t> Tell() const override { return base_->Tell(); }
+
+  bool closed() const override { return base_->closed(); }
+
+  Status Seek(int64_t position) override {
+    const auto start = Clock::now();
+    auto status = base_->Seek(position);
+    sink_->Record(IOOperation::SEEK, status, 0, start);
+    return status;
+  }
+
+  Result<int64_t> Read(int64_t nbytes, void* out) override {
+    const auto start = Clock::now();
+    auto res = base_->Read(nbytes, out);
+    sink_->RecordRead(IOOperation::READ, res, start);
+    return res;
+  }
+
+  Result<std::shared_ptr<Buffer>> Read(int64_t nbytes) override {
+    const auto start = Clock::now();
+    auto res = base_->Read(nbytes);
+    sink_->RecordRead(IOOperation::READ, res, start);
+    return res;
+  }
+
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override {
+    const auto start = Clock::now();
+    auto res = base_->ReadAt(position, nbytes, out);
+    sink_->RecordRead(IOOperation::READ, res, start);
+    return res;
+  }
+
+  Result<std::shared_ptr<Buffer>> ReadAt(int64_t position, int64_t nbytes) override {
+    const auto start = Clock::now();
+    auto res = base_->ReadAt(position, nbytes);
+    sink_->RecordRead(IOOperation::READ, res, start);
+    return res;
+  }
+
+  std::future<Result<int64_t>> ReadAtAsync(int64_t position, int64_t nbytes,
+                                           void* out) override {
+    // The base stream reads as it would by itself, through io_uring for instance. A
+    // waiter records the read once the base future completes, whether or not anyone
+    // waits for the returned one, and then makes it ready.
+    auto base_future = std::make_shared<std::future<Result<int64_t>>>(
+        base_->ReadAtAsync(position, nbytes, out));
+    return CompletionThreadPool()->Submit(
+        [base_future, sink = sink_, start = Clock::now()]() {
+          auto res = base_future->get();
+          sink->RecordRead(IOOperation::READ, res, start);
+          return res;
+        });
+  }
+
+  // Forwarded, keeping the base stream's own way of reading ranges, and recorded as a
+  // single read of the ranges' total size
+  Result<std::vector<std::shared_ptr<Buffer>>> ReadRanges(
+      const std::vector<ReadRange>& ranges, const CoalesceOptions& options) override {
+    const auto start = Clock::now();
+    auto res = base_->ReadRanges(ranges, options);
+    int64_t bytes = 0;
+    if (res.ok()) {
+      for (const auto& buffer : *res) {
+        bytes += buffer->size();
+      }
+    }
+    sink_->Record(IOOperation::READ, res.status(), bytes, start);
+    return res;
+  }
+
+ private:
+  std::shared_ptr<SeekableInputStream> base_;
+  std::shared_ptr<const MetricsSink> sink_;
+};
+
+class InstrumentedInputFile : public InputFile {
+ public:
+  InstrumentedInputFile(std::shared_ptr<InputFile> base,
+                        std::shared_ptr<const MetricsSink> sink)
+      : InputFile(base->location()), base_(std::move(base)), sink_(std::move(sink)) {}
+
+  Result<int64_t> getLength() override { return base_->getLength(); }
+
+  Result<std::shared_ptr<SeekableInputStream>> newStream() override {
+    const auto start = Clock::now();
+    auto res = base_->newStream();
+    sink_->Record(IOOperation::OPEN, res, start);
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, std::move(res));
+    return std::make_shared<InstrumentedInputStream>(std::move(stream), sink_);
+  }
+
+  bool exists() const override { return base_->exists(); }
+
+ private:
+  std::shared_ptr<InputFile> base_;
+  std::shared_ptr<const MetricsSink> sink_;
+};
+
+class InstrumentedOutputStream : public PositionOutputStream {
+ public:
+  InstrumentedOutputStream(std::shared_ptr<PositionOutputStream> base,
+                           std::shared_ptr<const MetricsSink> sink)
+      : base_(std::move(base)), sink_(std::move(sink)) {}
+
+  Status Close() override { return base_->Close(); }
+
+  Result<int64_t> Tell() const override { return base_->Tell(); }
+
+  bool closed() const override { return base_->closed(); }
+
+  using PositionOutputStream::Write;
+  Status Write(const void* data, int64_t nbytes) override {
+    const auto start = Clock::now();
+    auto status = base_->Write(data, nbytes);
+    sink_->Record(IOOperation::WRITE, status, status.ok() ? nbytes : 0, start);
+    return status;
+  }
+
+  Status Flush() override {
+    const auto start = Clock::now();
+    auto status = base_->Flush();
+    sink_->Record(IOOperation::FLUSH, status, 0, start);
+    return status;
+  }
+
+  Status Sync() override {
+    const auto start = Clock::now();
+    auto status = base_->Sync();
+    sink_->Record(IOOperation::FLUSH, status, 0, start);
+    return status;
+  }
+
+ private:
+  std::shared_ptr<PositionOutputStream> base_;
+  std::shared_ptr<const MetricsSink> sink_;
+};
+
+class InstrumentedOutputFile : public OutputFile {
+ public:
+  InstrumentedOutputFile(std::shared_ptr<OutputFile> base,
+                         std::shared_ptr<const MetricsSink> sink)
+      : OutputFile(base->location()), base_(std::move(base)), sink_(std::move(sink)) {}
+
+  Result<std::shared_ptr<PositionOutputStream>> create() override {
+    const auto start = Clock::now();
+    return Wrap(base_->create(), start);
+  }
+
+  Result<std::shared_ptr<PositionOutputStream>> createOrOverwrite() override {
+    const auto start = Clock::now();
+    return Wrap(base_->createOrOverwrite(), start);
+  }
+
+  Result<std::shared_ptr<InputFile>> toInputFile() const override {
+    ICEBERG_ASSIGN_OR_RAISE(auto file, base_->toInputFile());
+    return std::make_shared<InstrumentedInputFile>(std::move(file), sink_);
+  }
+
+ private:
+  Result<std::shared_ptr<PositionOutputStream>> Wrap(
+      Result<std::shared_ptr<PositionOutputStream>> res, Clock::time_point start) {
+    sink_->Record(IOOperation::OPEN, res, start);
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, std::move(res));
+    return std::make_shared<InstrumentedOutputStream>(std::move(stream), sink_);
+  }
+
+  std::shared_ptr<OutputFile> base_;
+  std::shared_ptr<const MetricsSink> sink_;
+};
+
+}  // namespace
+
+InstrumentedFileIO::InstrumentedFileIO(std::shared_ptr<FileIO> base,
+                                       InstrumentedFileIOOptions options)
+    : base_(std::move(base)),
+      options_(std::move(options)),
+      total_(std::make_shared<MetricsRecorder>()) {
+  for (size_t i = 0; i < options_.prefixes.size(); ++i) {
+    by_prefix_.push_back(std::make_shared<MetricsRecorder>());
+  }
+}
+
+InstrumentedFileIO::~InstrumentedFileIO() = default;
+
+bool InstrumentedFileIO::Equals(const FileIO& other) const {
+  auto instrumented = dynamic_cast<const InstrumentedFileIO*>(&other);
+  return instrumented != nullptr && total_ == instrumented->total_ &&
+         base_->Equals(*instrumented->base_);
+}
+
+Result<std::shared_ptr<InputFile>> InstrumentedFileIO::newInputFile(
+    const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newInputFile(path));
+  return std::make_shared<InstrumentedInputFile>(
+      std::move(base), std::make_shared<MetricsSink>(total_, PrefixRecorder(path)));
+}
+
+Result<std::shared_ptr<InputFile>> InstrumentedFileIO::newInputFile(
+    const std::string& path, int64_t length) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newInputFile(path, length));
+  return std::make_shared<InstrumentedInputFile>(
+      std::move(base), std::make_shared<MetricsSink>(total_, PrefixRecorder(path)));
+}
+
+Result<std::shared_ptr<OutputFile>> InstrumentedFileIO::newOutputFile(
+    const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newOutputFile(path));
+  return std::make_shared<InstrumentedOutputFile>(
+      std::move(base), std::make_shared<MetricsSink>(total_, PrefixRecorder(path)));
+}
+
+Status InstrumentedFileIO::DeleteFile(const std::string& path) {
+  const auto start = Clock::now();
+  auto status = base_->DeleteFile(path);
+  MetricsSink(total_, PrefixRecorder(path)).Record(IOOperation::DELETE, status, 0, start);
+  return status;
+}
+
+Result<DeleteFilesResult> InstrumentedFileIO::DeleteFiles(
+    const std::vector<std::string>& paths, const DeleteFilesOptions& options) {
+  const auto start = Clock::now();
+  auto res = base_->DeleteFiles(paths, options);
+  const int64_t nanos = NanosSince(start);
+  // A failure of the whole batch counts as a failure of each of its deletes
+  const int64_t total_errors = res.ok()
+                                   ? static_cast<int64_t>(res->failures.size())
+                                   : static_cast<int64_t>(paths.size());
+  total_->RecordBatch(IOOperation::DELETE, static_cast<int64_t>(paths.size()),
+                      total_errors, nanos);
+  if (!by_prefix_.empty()) {
+    // Split the batch between the prefixes, each getting the latency of the batch
+    std::vector<int64_t> counts(by_prefix_.size());
+    std::vector<int64_t> errors(by_prefix_.size());
+    for (const auto& path : paths) {
+      if (int i = PrefixIndex(path); i >= 0) {
+        ++counts[i];
+      }
+    }
+    if (res.ok()) {
+      for (const auto& failure : res->failures) {
+        if (int i = PrefixIndex(failure.first); i >= 0) {
+          ++errors[i];
+        }
+      }
+    } else {
+      errors = counts;
+    }
+    for (size_t i = 0; i < by_prefix_.size(); ++i) {
+      if (counts[i] > 0) {
+        by_prefix_[i]->RecordBatch(IOOperation::DELETE, counts[i], errors[i], nanos);
+      }
+    }
+  }
+  return res;
+}
+
+Result<std::unique_ptr<FileInfoIterator>> InstrumentedFileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  return base_->ListPrefix(prefix, options);
+}
+
+Status InstrumentedFileIO::CopyFile(const std::string& src, const std::string& dst) {
+  const auto start = Clock::now();
+  auto status = base_->CopyFile(src, dst);
+  MetricsSink(total_, PrefixRecorder(dst)).Record(IOOperation::COPY, status, 0, start);
+  return status;
+}
+
+IOMetrics InstrumentedFileIO::metrics() const { return total_->Snapshot(); }
+
+Result<IOMetrics> InstrumentedFileIO::metrics(const std::string& prefix) const {
+  auto it = std::find(options_.prefixes.begin(), options_.prefixes.end(), prefix);
+  if (it == options_.prefixes.end()) {
+    return Status::KeyError("Prefix '", prefix, "' is not instrumented");
+  }
+  return by_prefix_[it - options_.prefixes.begin()]->Snapshot();
+}
+
+int InstrumentedFileIO::PrefixIndex(const std::string& path) const {
+  int best = -1;
+  for (size_t i = 0; i < options_.prefixes.size(); ++i) {
+    const auto& prefix = options_.prefixes[i];
+    if (path.compare(0, prefix.size(), prefix) == 0 &&
+        (best < 0 || prefix.size() > options_.prefixes[best].size())) {
+      best = static_cast<int>(i);
+    }
+  }
+  return best;
+}
+
+std::shared_ptr<MetricsRecorder> InstrumentedFileIO::PrefixRecorder(
+    const std::string& path) const {
+  const int index = PrefixIndex(path);
+  return index < 0 ? nullptr : by_prefix_[index];
+}
+
+}  // namespace io
+}  // namespace iceberg
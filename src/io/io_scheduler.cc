@@ -0,0 +1,231 @@
+#include "iceberg/io/io_scheduler.hh"
+
+#include <algorithm>
+#include <condition_variable>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+// The scheduler whose task the current thread is running, if any
+thread_local const IOScheduler* current_scheduler = nullptr;
+
+}  // namespace
+
+/// Threads running the admitted tasks of a scheduler. Admission bounds the tasks in
+/// flight, so threads are only started when none is idle, and never more than the
+/// scheduler's overall limit.
+class IOScheduler::Workers : public std::enable_shared_from_this<Workers> {
+ public:
+  explicit Workers(int max_threads) : max_threads_(max_threads) {}
+
+  void Run(std::function<void()> task) {
+    bool start_thread = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+      if (idle_ == 0 && num_threads_ < max_threads_) {
+        ++num_threads_;
+        start_thread = true;
+      }
+    }
+    if (start_thread) {
+      // Detached, as the last reference to the scheduler may be dropped by its task
+      std::thread([self = shared_from_this()]() { self->WorkerLoop(); }).detach();
+    } else {
+      cv_.notify_one();
+    }
+  }
+
+  void Shutdown() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      ++idle_;
+      cv_.wait(lock, [this]() { return shutdown_ || !tasks_.empty(); });
+      --idle_;
+      if (tasks_.empty()) {
+        return;
+      }
+      std::function<void()> task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+      // Destroyed outside the lock, as it may hold the last reference to the scheduler
+      task = nullptr;
+      lock.lock();
+    }
+  }
+
+  const int max_threads_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  int num_threads_ = 0;
+  int idle_ = 0;
+  bool shutdown_ = false;
+};
+
+const char* IOClassName(IOClass io_class) {
+  switch (io_class) {
+    case IOClass::METADATA:
+      return "metadata";
+    case IOClass::DATA_SCAN:
+      return "data-scan";
+    case IOClass::PREFETCH:
+      return "prefetch";
+    case IOClass::BACKGROUND:
+      return "background";
+  }
+  return "unknown";
+}
+
+IOScheduler::Permit::Permit(Permit&& other) noexcept
+    : scheduler_(other.scheduler_), io_class_(other.io_class_) {
+  other.scheduler_ = nullptr;
+}
+
+IOScheduler::Permit& IOScheduler::Permit::operator=(Permit&& other) noexcept {
+  if (this != &other) {
+    Release();
+    scheduler_ = other.scheduler_;
+    io_class_ = other.io_class_;
+    other.scheduler_ = nullptr;
+  }
+  return *this;
+}
+
+IOScheduler::Permit::~Permit() { Release(); }
+
+void IOScheduler::Permit::Release() {
+  if (scheduler_ != nullptr) {
+    scheduler_->Release(io_class_);
+    scheduler_ = nullptr;
+  }
+}
+
+IOScheduler::IOScheduler(IOSchedulerOptions options)
+    : options_(options), workers_(std::make_shared<Workers>(options_.max_concurrency)) {
+  std::iota(order_.begin(), order_.end(), 0);
+  // Stable, so that classes of equal priority keep the order of IOClass
+  std::stable_sort(order_.begin(), order_.end(), [this](int a, int b) {
+    return options_.classes[a].priority > options_.classes[b].priority;
+  });
+}
+
+IOScheduler::~IOScheduler() { workers_->Shutdown(); }
+
+Result<std::shared_ptr<IOScheduler>> IOScheduler::Make(IOSchedulerOptions options) {
+  if (options.max_concurrency <= 0) {
+    return Status::Invalid("Invalid I/O scheduler concurrency: ",
+                           options.max_concurrency);
+  }
+  for (int i = 0; i < kNumIOClasses; ++i) {
+    if (options.classes[i].max_concurrency <= 0) {
+      return Status::Invalid("Invalid concurrency of I/O class ",
+                             IOClassName(static_cast<IOClass>(i)), ": ",
+                             options.classes[i].max_concurrency);
+    }
+  }
+  return std::shared_ptr<IOScheduler>(new IOScheduler(options));
+}
+
+IOScheduler::Permit IOScheduler::Acquire(IOClass io_class) {
+  if (current_scheduler == this) {
+    return Permit(nullptr, io_class);
+  }
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool admitted = false;
+  Enqueue(io_class, [&]() {
+    // Notify under the lock, as the waiter returns and destroys them once admitted
+    std::lock_guard<std::mutex> lock(mutex);
+    admitted = true;
+    cv.notify_one();
+  });
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&admitted]() { return admitted; });
+  return Permit(this, io_class);
+}
+
+void IOScheduler::Spawn(IOClass io_class, std::function<void()> task) {
+  Enqueue(io_class, [self = shared_from_this(), io_class, task = std::move(task)]() {
+    self->workers_->Run([self, io_class, task]() {
+      current_scheduler = self.get();
+      task();
+      current_scheduler = nullptr;
+      self->Release(io_class);
+    });
+  });
+}
+
+IOClassStats IOScheduler::stats(IOClass io_class) const {
+  const int i = static_cast<int>(io_class);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return {admitted_[i], in_flight_[i], static_cast<int64_t>(queues_[i].size()),
+          wait_nanos_[i]};
+}
+
+void IOScheduler::Enqueue(IOClass io_class, std::function<void()> start) {
+  std::vector<std::function<void()>> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_[static_cast<int>(io_class)].push_back({std::move(start), Clock::now()});
+    ready = DispatchLocked();
+  }
+  for (auto& callback : ready) {
+    callback();
+  }
+}
+
+void IOScheduler::Release(IOClass io_class) {
+  std::vector<std::function<void()>> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --in_flight_[static_cast<int>(io_class)];
+    --total_in_flight_;
+    ready = DispatchLocked();
+  }
+  for (auto& callback : ready) {
+    callback();
+  }
+}
+
+std::vector<std::function<void()>> IOScheduler::DispatchLocked() {
+  std::vector<std::function<void()>> ready;
+  const auto now = Clock::now();
+  while (total_in_flight_ < options_.max_concurrency) {
+    auto it = std::find_if(order_.begin(), order_.end(), [this](int i) {
+      return !queues_[i].empty() && in_flight_[i] < options_.classes[i].max_concurrency;
+    });
+    if (it == order_.end()) {
+      break;
+    }
+    const int i = *it;
+    Request request = std::move(queues_[i].front());
+    queues_[i].pop_front();
+    ++in_flight_[i];
+    ++admitted_[i];
+    ++total_in_flight_;
+    wait_nanos_[i] +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - request.enqueued)
+            .count();
+    ready.push_back(std::move(request.start));
+  }
+  return ready;
+}
+
+}  // namespace io
+}  // namespace iceberg
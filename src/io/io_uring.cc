@@ -0,0 +1,348 @@
+#include "iceberg/io/io_uring.hh"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ICEBERG_HAVE_IO_URING
+#endif
+
+#ifdef ICEBERG_HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "iceberg/io/io_util.hh"
+#include "iceberg/util/macros.hh"
+
+namespace iceberg {
+namespace io {
+namespace internal {
+
+namespace {
+
+// user_data of the no-op used to wake the completion thread on shutdown
+constexpr uint64_t kWakeupUserData = 0;
+
+// Rings alive, each owned by a submitting thread and counted until it exits
+std::atomic<int> num_rings{0};
+
+struct ReadRequest {
+  int fd;
+  int64_t position;
+  int64_t nbytes;
+  uint8_t* out;
+  std::promise<Result<int64_t>> promise;
+};
+
+int IoUringSetup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete,
+                 unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                                  flags, nullptr, 0));
+}
+
+/// \brief An io_uring instance with a single submitting thread and a completion thread
+class IoUring {
+ public:
+  static std::unique_ptr<IoUring> Make(unsigned entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int ring_fd = IoUringSetup(entries, &params);
+    if (ring_fd < 0) {
+      return nullptr;
+    }
+    std::unique_ptr<IoUring> ring(new IoUring(ring_fd, params));
+    if (!ring->Map()) {
+      return nullptr;
+    }
+    ring->reaper_ = std::thread([ring = ring.get()]() { ring->ReapLoop(); });
+    return ring;
+  }
+
+  ~IoUring() {
+    num_rings.fetch_sub(1, std::memory_order_relaxed);
+    if (reaper_.joinable()) {
+      stopping_.store(true);
+      // Wake the completion thread, which exits once every read has completed
+      while (!Push(IORING_OP_NOP, -1, 0, nullptr, 0, kWakeupUserData)) {
+        sched_yield();
+      }
+      if (!Submit()) {
+        // The completion thread cannot be woken: leave it blocked on the ring, which
+        // must then stay mapped
+        reaper_.detach();
+        return;
+      }
+      reaper_.join();
+    }
+    if (sqes_ != nullptr) {
+      munmap(sqes_, params_.sq_entries * sizeof(io_uring_sqe));
+    }
+    if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+      munmap(cq_ptr_, cq_ring_size_);
+    }
+    if (sq_ptr_ != nullptr) {
+      munmap(sq_ptr_, sq_ring_size_);
+    }
+    close(ring_fd_);
+  }
+
+  std::optional<std::future<Result<int64_t>>> SubmitRead(int fd, int64_t position,
+                                                         int64_t nbytes, void* out) {
+    if (in_flight_.load(std::memory_order_acquire) >= params_.cq_entries) {
+      return std::nullopt;
+    }
+    auto request = new ReadRequest{fd, position, nbytes, reinterpret_cast<uint8_t*>(out),
+                                   std::promise<Result<int64_t>>()};
+    auto future = request->promise.get_future();
+    const int64_t len = std::min(nbytes, static_cast<int64_t>(ICEBERG_MAX_IO_CHUNKSIZE));
+    // Counting the request before the kernel sees it also publishes it to the completion
+    // thread, which acquires in_flight_ before touching the request.
+    in_flight_.fetch_add(1, std::memory_order_acq_rel);
+    if (!Push(IORING_OP_READ, fd, position, out, static_cast<uint32_t>(len),
+              reinterpret_cast<uint64_t>(request))) {
+      in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+      delete request;
+      return std::nullopt;
+    }
+    Submit();
+    return future;
+  }
+
+ private:
+  IoUring(int ring_fd, const io_uring_params& params)
+      : ring_fd_(ring_fd), params_(params) {
+    num_rings.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  bool Map() {
+    sq_ring_size_ = params_.sq_off.array + params_.sq_entries * sizeof(uint32_t);
+    cq_ring_size_ = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params_.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    void* sq_ptr = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED) {
+      return false;
+    }
+    sq_ptr_ = reinterpret_cast<uint8_t*>(sq_ptr);
+    if (single_mmap) {
+      cq_ptr_ = sq_ptr_;
+    } else {
+      void* cq_ptr = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+      if (cq_ptr == MAP_FAILED) {
+        return false;
+      }
+      cq_ptr_ = reinterpret_cast<uint8_t*>(cq_ptr);
+    }
+    void* sqes = mmap(nullptr, params_.sq_entries * sizeof(io_uring_sqe),
+                      PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                      IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      return false;
+    }
+    sqes_ = reinterpret_cast<io_uring_sqe*>(sqes);
+
+    sq_head_ = reinterpret_cast<unsigned*>(sq_ptr_ + params_.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq_ptr_ + params_.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq_ptr_ + params_.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq_ptr_ + params_.sq_off.array);
+    cq_head_ = reinterpret_cast<unsigned*>(cq_ptr_ + params_.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq_ptr_ + params_.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq_ptr_ + params_.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ptr_ + params_.cq_off.cqes);
+    return true;
+  }
+
+  // Only called from the owning thread, which is the sole writer of the SQ tail
+  bool Push(uint8_t opcode, int fd, int64_t offset, void* addr, uint32_t len,
+            uint64_t user_data) {
+    const unsigned tail = *sq_tail_;
+    const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (tail - head >= params_.sq_entries) {
+      return false;
+    }
+    const unsigned index = tail & sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->off = static_cast<uint64_t>(offset);
+    sqe->addr = reinterpret_cast<uint64_t>(addr);
+    sqe->len = len;
+    sqe->user_data = user_data;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    ++to_submit_;
+    return true;
+  }
+
+  // Return false if the kernel refused the queued entries. Their reads are then
+  // completed with pread(2) instead, so that no future is left unresolved.
+  bool Submit() {
+    while (to_submit_ > 0) {
+      int ret = IoUringEnter(ring_fd_, to_submit_, 0, 0);
+      if (ret < 0) {
+        // EBUSY and EAGAIN are transient; the completion thread frees up resources
+        if (errno == EINTR || errno == EBUSY || errno == EAGAIN) {
+          sched_yield();
+          continue;
+        }
+        FailQueued(errno);
+        return false;
+      }
+      to_submit_ -= static_cast<unsigned>(ret);
+    }
+    return true;
+  }
+
+  // Take back the entries the kernel has not consumed, which only it reads and only
+  // while entering the ring, and complete their reads on this thread
+  void FailQueued(int error) {
+    const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    const unsigned tail = *sq_tail_;
+    for (unsigned i = head; i != tail; ++i) {
+      const uint64_t user_data = sqes_[sq_array_[i & sq_mask_]].user_data;
+      if (user_data != kWakeupUserData) {
+        Complete(reinterpret_cast<ReadRequest*>(user_data), -error);
+        in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+      }
+    }
+    __atomic_store_n(sq_tail_, head, __ATOMIC_RELEASE);
+    to_submit_ = 0;
+  }
+
+  void ReapLoop() {
+    while (true) {
+      const unsigned head = *cq_head_;
+      const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      if (head == tail) {
+        if (stopping_.load() && in_flight_.load(std::memory_order_acquire) == 0) {
+          return;
+        }
+        IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+        continue;
+      }
+      const io_uring_cqe cqe = cqes_[head & cq_mask_];
+      __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+      if (cqe.user_data == kWakeupUserData) {
+        continue;
+      }
+      Complete(reinterpret_cast<ReadRequest*>(cqe.user_data), cqe.res);
+      in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }
+
+  static void Complete(ReadRequest* request, int32_t res) {
+    std::unique_ptr<ReadRequest> owned(request);
+    if (res == 0 || res == request->nbytes) {
+      owned->promise.set_value(static_cast<int64_t>(res));
+      return;
+    }
+    // Either a short read or an error (e.g. a kernel without IORING_OP_READ): let pread
+    // finish the request and report any error itself.
+    const int64_t done = std::max<int64_t>(res, 0);
+    auto rest = FileReadAt(request->fd, request->position + done,
+                           request->nbytes - done, request->out + done);
+    if (!rest.ok()) {
+      owned->promise.set_value(rest.status());
+    } else {
+      owned->promise.set_value(done + rest.ValueUnsafe());
+    }
+  }
+
+  int ring_fd_;
+  io_uring_params params_;
+  size_t sq_ring_size_ = 0;
+  size_t cq_ring_size_ = 0;
+  uint8_t* sq_ptr_ = nullptr;
+  uint8_t* cq_ptr_ = nullptr;
+  io_uring_sqe* sqes_ = nullptr;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned* sq_array_ = nullptr;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  unsigned to_submit_ = 0;
+  std::atomic<unsigned> in_flight_{0};
+  std::atomic<bool> stopping_{false};
+  std::thread reaper_;
+};
+
+// Set once setting up a ring failed, so that later threads skip the attempt
+std::atomic<bool> io_uring_disabled{false};
+
+IoUring* GetThreadRing() {
+  if (io_uring_disabled.load(std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  thread_local std::unique_ptr<IoUring> ring = []() -> std::unique_ptr<IoUring> {
+    // Each ring has a completion thread, so threads past the cap read through the
+    // I/O pool instead
+    if (num_rings.load(std::memory_order_relaxed) >= kMaxIoUringRings) {
+      return nullptr;
+    }
+    auto ring = IoUring::Make(kIoUringQueueDepth);
+    if (ring == nullptr) {
+      io_uring_disabled.store(true, std::memory_order_relaxed);
+    }
+    return ring;
+  }();
+  return ring.get();
+}
+
+}  // namespace
+
+bool IoUringAvailable() { return GetThreadRing() != nullptr; }
+
+std::optional<std::future<Result<int64_t>>> IoUringReadAt(int fd, int64_t position,
+                                                          int64_t nbytes, void* out) {
+  if (position < 0 || nbytes < 0) {
+    return std::nullopt;
+  }
+  IoUring* ring = GetThreadRing();
+  if (ring == nullptr) {
+    return std::nullopt;
+  }
+  return ring->SubmitRead(fd, position, nbytes, out);
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace iceberg
+
+#else  // ICEBERG_HAVE_IO_URING
+
+namespace iceberg {
+namespace io {
+namespace internal {
+
+bool IoUringAvailable() { return false; }
+
+std::optional<std::future<Result<int64_t>>> IoUringReadAt(int fd, int64_t position,
+                                                          int64_t nbytes, void* out) {
+  return std::nullopt;
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace iceberg
+
+#endif  // ICEBERG_HAVE_IO_URING
@@ -0,0 +1,144 @@
+#include "iceberg/io/io_util.hh"
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <future>
+#include <mutex>
+
+#include "iceberg/util/macros.hh"
+#include "iceberg/util/thread_pool.hh"
+
+namespace iceberg {
+namespace io {
+namespace internal {
+
+Result<int64_t> FileReadAt(int fd, int64_t position, int64_t nbytes, void* out) {
+  if (position < 0) {
+    return Status::Invalid("Invalid position");
+  }
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(out);
+  int64_t total_bytes_read = 0;
+  while (total_bytes_read < nbytes) {
+    const int64_t chunksize = std::min(static_cast<int64_t>(ICEBERG_MAX_IO_CHUNKSIZE),
+                                       nbytes - total_bytes_read);
+
+    int64_t bytes_read = static_cast<int64_t>(pread(fd, buffer,
+                                                    static_cast<size_t>(chunksize),
+                                                    position + total_bytes_read));
+    if (bytes_read == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return Status::IOError("Error reading bytes from file, errno: ", errno);
+    }
+
+    if (bytes_read == 0) {
+      // EOF
+      break;
+    }
+    buffer += bytes_read;
+    total_bytes_read += bytes_read;
+  }
+  return total_bytes_read;
+}
+
+Status CopyStream(InputStream* input, OutputStream* output, int64_t chunk_size) {
+  if (chunk_size <= 0) {
+    return Status::Invalid("Invalid copy chunk size: ", chunk_size);
+  }
+  while (true) {
+    ICEBERG_ASSIGN_OR_RAISE(auto chunk, input->Read(chunk_size));
+    if (chunk->size() == 0) {
+      return Status::OK();
+    }
+    ICEBERG_RETURN_NOT_OK(output->Write(chunk));
+  }
+}
+
+Result<std::vector<ReadRange>> CoalesceReadRanges(std::vector<ReadRange> ranges,
+                                                  const CoalesceOptions& options) {
+  for (const auto& range : ranges) {
+    if (range.offset < 0 || range.length < 0) {
+      return Status::Invalid("Invalid read range [", range.offset, ", +", range.length,
+                             ")");
+    }
+  }
+  ranges.erase(std::remove_if(ranges.begin(), ranges.end(),
+                              [](const ReadRange& range) { return range.length == 0; }),
+               ranges.end());
+  std::sort(ranges.begin(), ranges.end(), [](const ReadRange& a, const ReadRange& b) {
+    return a.offset < b.offset;
+  });
+
+  std::vector<ReadRange> coalesced;
+  for (const auto& range : ranges) {
+    if (!coalesced.empty()) {
+      ReadRange& current = coalesced.back();
+      const int64_t current_end = current.offset + current.length;
+      const int64_t end = std::max(current_end, range.offset + range.length);
+      const bool overlaps = range.offset < current_end;
+      if (overlaps || (range.offset - current_end <= options.hole_size_limit &&
+                       end - current.offset <= options.range_size_limit)) {
+        current.length = end - current.offset;
+        continue;
+      }
+    }
+    coalesced.push_back(range);
+  }
+  return coalesced;
+}
+
+Result<DeleteFilesResult> RunDeleteFiles(
+    const std::vector<std::string>& paths, const DeleteFilesOptions& options,
+    const std::function<Status(int worker, const std::string& path)>& delete_one) {
+  if (options.parallelism <= 0) {
+    return Status::Invalid("Invalid delete parallelism: ", options.parallelism);
+  }
+  const int64_t total = static_cast<int64_t>(paths.size());
+  std::vector<Status> statuses(paths.size());
+  std::atomic<int64_t> next{0};
+  std::mutex progress_mutex;
+  int64_t completed = 0;
+
+  auto work = [&](int worker) {
+    for (int64_t i = next.fetch_add(1); i < total; i = next.fetch_add(1)) {
+      statuses[i] = delete_one(worker, paths[i]);
+      if (options.progress) {
+        std::lock_guard<std::mutex> lock(progress_mutex);
+        options.progress(++completed, total);
+      }
+    }
+  };
+
+  const int num_workers =
+      static_cast<int>(std::min<int64_t>(options.parallelism, total));
+  if (num_workers <= 1) {
+    work(0);
+  } else {
+    // A dedicated pool: deletions block, and the caller may itself be an I/O pool task
+    util::ThreadPool pool(num_workers);
+    std::vector<std::future<void>> futures;
+    for (int worker = 0; worker < num_workers; ++worker) {
+      futures.push_back(pool.Submit([&work, worker]() { work(worker); }));
+    }
+    for (auto& future : futures) {
+      future.get();
+    }
+  }
+
+  DeleteFilesResult result;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    if (statuses[i].ok()) {
+      ++result.num_deleted;
+    } else {
+      result.failures.emplace_back(paths[i], std::move(statuses[i]));
+    }
+  }
+  return result;
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace iceberg
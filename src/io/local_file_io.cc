@@ -1,13 +1,25 @@
 #include "iceberg/io/local_file_io.hh"
 
 #include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+#include <algorithm>
+#include <cerrno>
 #include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <memory>
 #include <system_error>
+#include <unordered_map>
 
+#include "iceberg/io/buffered.hh"
+#include "iceberg/io/io_uring.hh"
+#include "iceberg/io/io_util.hh"
 #include "iceberg/result.hh"
 #include "iceberg/util/logging.hh"
 #include "iceberg/util/macros.hh"
@@ -66,6 +78,24 @@ Result<int64_t> SeekableFileInputStream::Read(int64_t nbytes, void* out) {
   return total_bytes_read;
 }
 
+Result<int64_t> SeekableFileInputStream::ReadAt(int64_t position, int64_t nbytes,
+                                                void* out) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return internal::FileReadAt(fd_, position, nbytes, out);
+}
+
+std::future<Result<int64_t>> SeekableFileInputStream::ReadAtAsync(int64_t position,
+                                                                  int64_t nbytes,
+                                                                  void* out) {
+  if (use_io_uring_ && !closed()) {
+    auto future = internal::IoUringReadAt(fd_, position, nbytes, out);
+    if (future.has_value()) {
+      return std::move(*future);
+    }
+  }
+  return SeekableInputStream::ReadAtAsync(position, nbytes, out);
+}
+
 Status SeekableFileInputStream::Seek(int64_t position) {
   ICEBERG_RETURN_NOT_OK(CheckClosed());
   if (position < 0) {
@@ -87,6 +117,195 @@ Status SeekableFileInputStream::CheckClosed() const {
   return Status::OK();
 }
 
+namespace {
+
+/// \brief A buffer owning a read-only memory mapping, unmapped on destruction
+class MemoryMappedBuffer : public Buffer {
+ public:
+  MemoryMappedBuffer(void* addr, int64_t size)
+      : Buffer(reinterpret_cast<const uint8_t*>(addr), size) {}
+
+  ~MemoryMappedBuffer() override {
+    if (size_ > 0) {
+      munmap(const_cast<uint8_t*>(data_), static_cast<size_t>(size_));
+    }
+  }
+};
+
+int ToMadvise(AccessPattern access_pattern) {
+  switch (access_pattern) {
+    case AccessPattern::SEQUENTIAL:
+      return MADV_SEQUENTIAL;
+    case AccessPattern::RANDOM:
+      return MADV_RANDOM;
+    case AccessPattern::NORMAL:
+      break;
+  }
+  return MADV_NORMAL;
+}
+
+/// \brief Forwards to a local output stream and ends the write on the stat cache once
+/// the stream is closed, so the final length is observed afresh
+class StatCacheOutputStream : public PositionOutputStream {
+ public:
+  StatCacheOutputStream(std::shared_ptr<PositionOutputStream> raw,
+                        std::shared_ptr<StatCache> cache, std::string path)
+      : raw_(std::move(raw)), cache_(std::move(cache)), path_(std::move(path)) {
+    cache_->BeginWrite(path_);
+  }
+
+  ~StatCacheOutputStream() override {
+    if (!closed()) {
+      ICEBERG_WARN_NOT_OK(Close(), "Failed to close local file on destruction");
+    }
+    EndWrite();
+  }
+
+  Status Close() override {
+    Status status = raw_->Close();
+    EndWrite();
+    return status;
+  }
+
+  Result<int64_t> Tell() const override { return raw_->Tell(); }
+
+  bool closed() const override { return raw_->closed(); }
+
+  Status Write(const void* data, int64_t nbytes) override {
+    return raw_->Write(data, nbytes);
+  }
+
+  Status Write(const std::shared_ptr<Buffer>& data) override { return raw_->Write(data); }
+
+  using Writable::Write;
+
+  Status Flush() override { return raw_->Flush(); }
+
+  Status Sync() override { return raw_->Sync(); }
+
+ private:
+  void EndWrite() {
+    if (!ended_) {
+      ended_ = true;
+      cache_->EndWrite(path_);
+    }
+  }
+
+  std::shared_ptr<PositionOutputStream> raw_;
+  std::shared_ptr<StatCache> cache_;
+  std::string path_;
+  bool ended_ = false;
+};
+
+int ToFadvise(AccessPattern access_pattern) {
+  switch (access_pattern) {
+    case AccessPattern::SEQUENTIAL:
+      return POSIX_FADV_SEQUENTIAL;
+    case AccessPattern::RANDOM:
+      return POSIX_FADV_RANDOM;
+    case AccessPattern::NORMAL:
+      break;
+  }
+  return POSIX_FADV_NORMAL;
+}
+
+}  // namespace
+
+Result<std::shared_ptr<MemoryMappedInputStream>> MemoryMappedInputStream::Open(
+    int fd, int64_t size, AccessPattern access_pattern) {
+  if (size < 0) {
+    return Status::Invalid("Invalid mapping size");
+  }
+  if (size == 0) {
+    // mmap rejects empty mappings
+    return std::make_shared<MemoryMappedInputStream>(
+        std::make_shared<MemoryMappedBuffer>(nullptr, 0));
+  }
+  void* addr = mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    return Status::IOError("mmap failed, errno: ", errno);
+  }
+  auto stream = std::make_shared<MemoryMappedInputStream>(
+      std::make_shared<MemoryMappedBuffer>(addr, size));
+  if (access_pattern != AccessPattern::NORMAL) {
+    ICEBERG_RETURN_NOT_OK(stream->Advise(access_pattern, 0, size));
+  }
+  return stream;
+}
+
+Status MemoryMappedInputStream::Advise(AccessPattern access_pattern, int64_t position,
+                                       int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (position < 0 || nbytes < 0) {
+    return Status::Invalid("Invalid advise range");
+  }
+  position = std::min(position, buffer_->size());
+  nbytes = std::min(nbytes, buffer_->size() - position);
+  if (nbytes == 0) {
+    return Status::OK();
+  }
+  // madvise needs a page-aligned start address
+  static const int64_t page_size = static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+  const int64_t aligned = position - position % page_size;
+  int ret = madvise(const_cast<uint8_t*>(buffer_->data()) + aligned,
+                    static_cast<size_t>(nbytes + position - aligned),
+                    ToMadvise(access_pattern));
+  if (ret == -1) {
+    return Status::IOError("madvise failed, errno: ", errno);
+  }
+  return Status::OK();
+}
+
+std::optional<int64_t> StatCache::GetLength(const std::string& path) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = lengths_.find(path);
+  if (it == lengths_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void StatCache::PutLength(const std::string& path, int64_t length) {
+  if (capacity_ == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (writers_.find(path) != writers_.end()) {
+    // The file is still growing
+    return;
+  }
+  if (lengths_.size() >= capacity_ && lengths_.find(path) == lengths_.end()) {
+    // Iceberg lookups have little locality to exploit; drop an arbitrary entry
+    lengths_.erase(lengths_.begin());
+  }
+  lengths_[path] = length;
+}
+
+void StatCache::Invalidate(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  lengths_.erase(path);
+}
+
+void StatCache::BeginWrite(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  lengths_.erase(path);
+  ++writers_[path];
+}
+
+void StatCache::EndWrite(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  lengths_.erase(path);
+  auto it = writers_.find(path);
+  if (it != writers_.end() && --it->second == 0) {
+    writers_.erase(it);
+  }
+}
+
+size_t StatCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lengths_.size();
+}
+
 PositionFileOutputStream::~PositionFileOutputStream() {
   if (!closed()) {
     ICEBERG_CHECK_OK(Close());
@@ -104,11 +323,7 @@ Status PositionFileOutputStream::Close() {
 
 Result<int64_t> PositionFileOutputStream::Tell() const {
   ICEBERG_RETURN_NOT_OK(CheckClosed());
-  int64_t ret = lseek(fd_, 0, SEEK_CUR);
-  if (ret == -1) {
-    return Status::IOError("lseek failed");
-  }
-  return ret;
+  return position_;
 }
 
 Status PositionFileOutputStream::Write(const void* data, int64_t nbytes) {
@@ -125,19 +340,26 @@ Status PositionFileOutputStream::Write(const void* data, int64_t nbytes) {
     }
 
     if (ret == -1) {
+      position_ += bytes_written;
       return Status::IOError("Error writing bytes to file, errno: ", errno);
     }
     bytes_written += ret;
   }
 
+  position_ += bytes_written;
   return Status::OK();
 }
 
 Status PositionFileOutputStream::Flush() {
+  // Writes go straight to the operating system, nothing to flush
+  return CheckClosed();
+}
+
+Status PositionFileOutputStream::Sync() {
   ICEBERG_RETURN_NOT_OK(CheckClosed());
   int ret = fsync(fd_);
   if (ret == -1) {
-    return Status::IOError("flush failed");
+    return Status::IOError("fsync failed, errno: ", errno);
   }
   return Status::OK();
 }
@@ -151,54 +373,151 @@ Status PositionFileOutputStream::CheckClosed() const {
   return Status::OK();
 }
 
+LocalInputFile::LocalInputFile(std::string location, LocalFileIOOptions options,
+                               std::optional<int64_t> length)
+    : InputFile(std::move(location)), options_(std::move(options)), length_(length) {
+  if (!length_.has_value() && options_.stat_cache != nullptr) {
+    length_ = options_.stat_cache->GetLength(location_);
+  }
+}
+
+void LocalInputFile::SetLength(int64_t length) {
+  length_ = length;
+  if (options_.stat_cache != nullptr) {
+    options_.stat_cache->PutLength(location_, length);
+  }
+}
+
 Result<int64_t> LocalInputFile::getLength() {
-  if (!exists()) {
-    return Status::Invalid("File not exists.");
+  if (!length_.has_value()) {
+    struct stat st;
+    if (stat(location().c_str(), &st) == -1) {
+      if (errno == ENOENT) {
+        return Status::Invalid("File not exists.");
+      }
+      return Status::IOError("Failed to stat local file '", location(),
+                             "' errno: ", errno);
+    }
+    SetLength(static_cast<int64_t>(st.st_size));
   }
-  return std::filesystem::file_size(location_);
+  return *length_;
 }
 
 Result<std::shared_ptr<SeekableInputStream>> LocalInputFile::newStream() {
-  ICEBERG_RETURN_NOT_OK(CheckExists());
-  int fd = open(location().c_str(), O_RDONLY);
+  bool direct = options_.use_direct_io && !options_.use_mmap;
+  if (direct) {
+    ICEBERG_RETURN_NOT_OK(internal::ValidateDirectIOOptions(options_.direct_io));
+  }
+  // A missing file is reported by open itself, no separate existence check
+  int fd = internal::OpenMaybeDirect(location(), O_RDONLY, &direct);
   if (fd < 0) {
+    if (errno == ENOENT) {
+      return Status::Invalid("Input file not exists");
+    }
     return Status::IOError("Failed to open local file '", location(), "' errno: ", errno);
   }
-  struct stat st;
-  int ret = fstat(fd, &st);
-  if (ret == 0 && S_ISDIR(st.st_mode)) {
-    return Status::IOError("Cannot open for reading: path '", location(),
-                           "' is a directory");
+  // Only needed to learn the length, or to map no more than the file holds: a stale
+  // known length past the end of the file would raise SIGBUS on access. Otherwise, with
+  // a known length a directory is instead reported by the first read, failing with
+  // EISDIR.
+  if (!length_.has_value() || options_.use_mmap) {
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+      close(fd);
+      return Status::IOError("Failed to stat local file '", location(),
+                             "' errno: ", errno);
+    }
+    if (S_ISDIR(st.st_mode)) {
+      close(fd);
+      return Status::IOError("Cannot open for reading: path '", location(),
+                             "' is a directory");
+    }
+    if (!length_.has_value()) {
+      SetLength(static_cast<int64_t>(st.st_size));
+    }
+    if (options_.use_mmap) {
+      const int64_t length = std::min(*length_, static_cast<int64_t>(st.st_size));
+      auto res = MemoryMappedInputStream::Open(fd, length, options_.access_pattern);
+      // The mapping stays valid after the descriptor is closed
+      close(fd);
+      ICEBERG_ASSIGN_OR_RAISE(auto stream, std::move(res));
+      return stream;
+    }
   }
-  return std::make_shared<SeekableFileInputStream>(fd);
+  if (options_.access_pattern != AccessPattern::NORMAL && !direct) {
+    // Only a hint; a failure is not worth failing the open for
+    posix_fadvise(fd, 0, 0, ToFadvise(options_.access_pattern));
+  }
+  std::shared_ptr<SeekableInputStream> stream;
+  if (direct) {
+    stream = std::make_shared<DirectFileInputStream>(fd, options_.direct_io);
+  } else {
+    stream = std::make_shared<SeekableFileInputStream>(fd, options_.use_io_uring);
+  }
+  if (options_.readahead.has_value()) {
+    ICEBERG_ASSIGN_OR_RAISE(auto readahead,
+                            ReadaheadInputStream::Create(stream, *options_.readahead));
+    return readahead;
+  }
+  return stream;
 }
 
-bool LocalInputFile::exists() const { return std::filesystem::exists(location()); }
-
-Result<std::shared_ptr<PositionOutputStream>> LocalOutputFile::create() {
-  if (std::filesystem::exists(location())) {
-    return Status::AlreadyExists("output file ", location(), " already exisits");
+bool LocalInputFile::exists() const {
+  if (length_.has_value()) {
+    return true;
   }
-
-  int fd = open(location().c_str(), O_CREAT | O_WRONLY, 0666);
-  if (fd == -1) {
-    return Status::IOError("Failed to open local file '", location(),
-                           "', errno: ", errno);
+  struct stat st;
+  if (stat(location().c_str(), &st) == -1) {
+    return false;
+  }
+  if (options_.stat_cache != nullptr) {
+    options_.stat_cache->PutLength(location(), static_cast<int64_t>(st.st_size));
   }
-  return std::make_shared<PositionFileOutputStream>(fd);
+  return true;
+}
+
+Result<std::shared_ptr<PositionOutputStream>> LocalOutputFile::create() {
+  // O_EXCL folds the existence check into open
+  return Open(O_CREAT | O_WRONLY | O_EXCL);
 }
 
 Result<std::shared_ptr<PositionOutputStream>> LocalOutputFile::createOrOverwrite() {
-  int fd = open(location().c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0666);
+  return Open(O_CREAT | O_WRONLY | O_TRUNC);
+}
+
+Result<std::shared_ptr<PositionOutputStream>> LocalOutputFile::Open(int flags) {
+  if (options_.use_direct_io) {
+    ICEBERG_RETURN_NOT_OK(internal::ValidateDirectIOOptions(options_.direct_io));
+  }
+  bool direct = options_.use_direct_io;
+  int fd = internal::OpenMaybeDirect(location(), flags, &direct);
   if (fd == -1) {
+    if (errno == EEXIST) {
+      return Status::AlreadyExists("output file ", location(), " already exisits");
+    }
     return Status::IOError("Failed to open local file '", location(),
                            "', errno: ", errno);
   }
-  return std::make_shared<PositionFileOutputStream>(fd);
+  std::shared_ptr<PositionOutputStream> stream;
+  if (direct) {
+    // Buffers on its own, in aligned memory
+    ICEBERG_ASSIGN_OR_RAISE(stream, DirectFileOutputStream::Create(fd, options_.direct_io));
+  } else if (options_.write_buffer_size > 0) {
+    ICEBERG_ASSIGN_OR_RAISE(
+        stream, BufferedOutputStream::Create(options_.write_buffer_size,
+                                             std::make_shared<PositionFileOutputStream>(fd)));
+  } else {
+    stream = std::make_shared<PositionFileOutputStream>(fd);
+  }
+  if (options_.stat_cache != nullptr) {
+    return std::make_shared<StatCacheOutputStream>(std::move(stream), options_.stat_cache,
+                                                   location());
+  }
+  return stream;
 }
 
 Result<std::shared_ptr<InputFile>> LocalOutputFile::toInputFile() const {
-  return std::make_shared<LocalInputFile>(location());
+  return std::make_shared<LocalInputFile>(location(), options_);
 }
 
 bool LocalFileIO::Equals(const FileIO& other) const {
@@ -212,14 +531,25 @@ bool LocalFileIO::Equals(const FileIO& other) const {
 LocalFileIO::~LocalFileIO() {}
 
 Result<std::shared_ptr<InputFile>> LocalFileIO::newInputFile(const std::string& path) {
-  return std::make_shared<LocalInputFile>(path);
+  return std::make_shared<LocalInputFile>(path, options_);
+}
+
+Result<std::shared_ptr<InputFile>> LocalFileIO::newInputFile(const std::string& path,
+                                                             int64_t length) {
+  if (length < 0) {
+    return Status::Invalid("Invalid file length: ", length);
+  }
+  return std::make_shared<LocalInputFile>(path, options_, length);
 }
 
 Result<std::shared_ptr<OutputFile>> LocalFileIO::newOutputFile(const std::string& path) {
-  return std::make_shared<LocalOutputFile>(path);
+  return std::make_shared<LocalOutputFile>(path, options_);
 }
 
 Status LocalFileIO::DeleteFile(const std::string& path) {
+  if (options_.stat_cache != nullptr) {
+    options_.stat_cache->Invalidate(path);
+  }
   std::error_code ec;
   bool ret = std::filesystem::remove(path, ec);
   if (!ret) {
@@ -229,5 +559,214 @@ Status LocalFileIO::DeleteFile(const std::string& path) {
   return Status::OK();
 }
 
+namespace {
+
+/// Directory descriptors opened by one delete worker, so that deleting many files of a
+/// directory resolves the directory path only once.
+class DirectoryCache {
+ public:
+  ~DirectoryCache() { Clear(); }
+
+  /// Return a descriptor for `dir`, or -1 with errno set.
+  int Get(const std::string& dir) {
+    auto it = fds_.find(dir);
+    if (it != fds_.end()) {
+      return it->second;
+    }
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+      return -1;
+    }
+    if (fds_.size() >= kMaxOpenDirectories) {
+      Clear();
+    }
+    fds_.emplace(dir, fd);
+    return fd;
+  }
+
+ private:
+  static constexpr size_t kMaxOpenDirectories = 64;
+
+  void Clear() {
+    for (const auto& entry : fds_) {
+      close(entry.second);
+    }
+    fds_.clear();
+  }
+
+  std::unordered_map<std::string, int> fds_;
+};
+
+Status DeleteError(const std::string& path, int err) {
+  return Status::IOError("Delete file '", path, "' failed, error message: ",
+                         std::error_code(err, std::generic_category()).message());
+}
+
+}  // namespace
+
+Result<DeleteFilesResult> LocalFileIO::DeleteFiles(const std::vector<std::string>& paths,
+                                                   const DeleteFilesOptions& options) {
+  if (options.parallelism <= 0) {
+    return Status::Invalid("Invalid delete parallelism: ", options.parallelism);
+  }
+  std::vector<DirectoryCache> directories(
+      std::max<size_t>(1, std::min<size_t>(options.parallelism, paths.size())));
+  return internal::RunDeleteFiles(
+      paths, options, [&](int worker, const std::string& path) -> Status {
+        if (options_.stat_cache != nullptr) {
+          options_.stat_cache->Invalidate(path);
+        }
+        int dir_fd = AT_FDCWD;
+        const char* name = path.c_str();
+        const size_t slash = path.rfind('/');
+        if (slash != std::string::npos) {
+          dir_fd = directories[worker].Get(slash == 0 ? "/" : path.substr(0, slash));
+          if (dir_fd < 0) {
+            return DeleteError(path, errno);
+          }
+          name += slash + 1;
+        }
+        if (unlinkat(dir_fd, name, 0) != 0) {
+          return DeleteError(path, errno);
+        }
+        return Status::OK();
+      });
+}
+
+Result<std::unique_ptr<FileInfoIterator>> LocalFileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  return internal::ListLocalPrefix(prefix, options);
+}
+
+namespace {
+
+/// Closes a descriptor on scope exit.
+class FdGuard {
+ public:
+  explicit FdGuard(int fd) : fd_(fd) {}
+  ~FdGuard() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  int fd() const { return fd_; }
+
+  /// Close now, returning the error of close(2).
+  int Close() {
+    const int ret = close(fd_);
+    fd_ = -1;
+    return ret;
+  }
+
+ private:
+  int fd_;
+};
+
+// Whether an in-kernel copy failed because the file systems or kernel cannot do it,
+// rather than because of an I/O error
+bool CopyUnsupported(int err) {
+  return err == ENOSYS || err == EXDEV || err == EINVAL || err == EOPNOTSUPP ||
+         err == ENOTTY || err == EBADF || err == EPERM;
+}
+
+// Copy from the current offsets of the descriptors to the end of `src_fd`. Return 0 or
+// an errno value.
+int CopyContents(int src_fd, int dst_fd, int64_t size) {
+#ifdef __linux__
+  // A reflink shares the extents of the source, costing no data I/O at all
+  if (ioctl(dst_fd, FICLONE, src_fd) == 0) {
+    return 0;
+  }
+  int64_t remaining = size;
+  while (remaining > 0) {
+    const ssize_t ret = copy_file_range(src_fd, nullptr, dst_fd, nullptr,
+                                        static_cast<size_t>(remaining), 0);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (CopyUnsupported(errno)) {
+        // Continue from the offsets reached with a buffered copy
+        break;
+      }
+      return errno;
+    }
+    if (ret == 0) {
+      // The source shrank; the buffered copy below finds its end too
+      break;
+    }
+    remaining -= ret;
+  }
+#endif
+  constexpr size_t kBufferSize = 1024 * 1024;
+  std::unique_ptr<uint8_t[]> buffer;
+  while (true) {
+    if (buffer == nullptr) {
+      buffer.reset(new uint8_t[kBufferSize]);
+    }
+    const ssize_t nread = read(src_fd, buffer.get(), kBufferSize);
+    if (nread < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno;
+    }
+    if (nread == 0) {
+      return 0;
+    }
+    for (ssize_t written = 0; written < nread;) {
+      const ssize_t ret = write(dst_fd, buffer.get() + written, nread - written);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return errno;
+      }
+      written += ret;
+    }
+  }
+}
+
+}  // namespace
+
+Status LocalFileIO::CopyFile(const std::string& src, const std::string& dst) {
+  FdGuard src_fd(open(src.c_str(), O_RDONLY));
+  if (src_fd.fd() < 0) {
+    if (errno == ENOENT) {
+      return Status::Invalid("Input file not exists");
+    }
+    return Status::IOError("Failed to open local file '", src, "' errno: ", errno);
+  }
+  struct stat st;
+  if (fstat(src_fd.fd(), &st) == -1) {
+    return Status::IOError("Failed to stat local file '", src, "' errno: ", errno);
+  }
+  if (S_ISDIR(st.st_mode)) {
+    return Status::IOError("Cannot copy: path '", src, "' is a directory");
+  }
+  FdGuard dst_fd(open(dst.c_str(), O_CREAT | O_WRONLY | O_EXCL, 0666));
+  if (dst_fd.fd() < 0) {
+    if (errno == EEXIST) {
+      return Status::AlreadyExists("output file ", dst, " already exisits");
+    }
+    return Status::IOError("Failed to open local file '", dst, "', errno: ", errno);
+  }
+  if (options_.stat_cache != nullptr) {
+    options_.stat_cache->Invalidate(dst);
+  }
+  int err = CopyContents(src_fd.fd(), dst_fd.fd(), static_cast<int64_t>(st.st_size));
+  if (dst_fd.Close() != 0 && err == 0) {
+    err = errno;
+  }
+  if (err != 0) {
+    unlink(dst.c_str());
+    return Status::IOError("Failed to copy local file '", src, "' to '", dst,
+                           "', error message: ",
+                           std::error_code(err, std::generic_category()).message());
+  }
+  return Status::OK();
+}
+
 }  // namespace io
 }  // namespace iceberg
\ No newline at end of file
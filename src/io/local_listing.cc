@@ -0,0 +1,343 @@
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <variant>
+
+#include "iceberg/io/io_util.hh"
+#include "iceberg/util/macros.hh"
+
+namespace iceberg {
+namespace io {
+namespace internal {
+
+namespace {
+
+// Size of the buffer filled by one getdents call, i.e. a few hundred entries
+constexpr size_t kDirentBufferSize = 32 * 1024;
+
+struct DirectoryEntry {
+  std::string name;
+  unsigned char type;
+};
+
+/// An open directory, shared by the tasks stat-ing its entries.
+class DirectoryHandle {
+ public:
+  explicit DirectoryHandle(int fd) : fd_(fd) {}
+
+  ~DirectoryHandle() {
+    if (dir_ != nullptr) {
+      closedir(dir_);
+    }
+    close(fd_);
+  }
+
+  int fd() const { return fd_; }
+
+  /// Read the next batch of entries. An empty batch means the end of the directory.
+  Status ReadBatch(std::vector<DirectoryEntry>* entries) {
+#if defined(__linux__)
+    struct linux_dirent64 {
+      ino64_t d_ino;
+      off64_t d_off;
+      unsigned short d_reclen;  // NOLINT
+      unsigned char d_type;
+      char d_name[];
+    };
+    alignas(linux_dirent64) char buffer[kDirentBufferSize];
+    auto nread = syscall(SYS_getdents64, fd_, buffer, sizeof(buffer));
+    if (nread < 0) {
+      return Status::IOError("Failed to read directory, errno: ", errno);
+    }
+    for (decltype(nread) offset = 0; offset < nread;) {
+      auto* entry = reinterpret_cast<linux_dirent64*>(buffer + offset);
+      entries->push_back({entry->d_name, entry->d_type});
+      offset += entry->d_reclen;
+    }
+#else
+    if (dir_ == nullptr) {
+      // readdir works on its own descriptor, leaving fd_ for fstatat
+      dir_ = fdopendir(dup(fd_));
+      if (dir_ == nullptr) {
+        return Status::IOError("Failed to read directory, errno: ", errno);
+      }
+    }
+    errno = 0;
+    struct dirent* entry;
+    while (entries->size() < kDirentBufferSize / 64 && (entry = readdir(dir_))) {
+      entries->push_back({entry->d_name, entry->d_type});
+    }
+    if (errno != 0) {
+      return Status::IOError("Failed to read directory, errno: ", errno);
+    }
+#endif
+    return Status::OK();
+  }
+
+ private:
+  int fd_;
+  // Only used where getdents is unavailable
+  DIR* dir_ = nullptr;
+};
+
+std::string JoinPath(const std::string& dir, const std::string& name) {
+  if (dir.empty()) {
+    return name;
+  }
+  if (dir.back() == '/') {
+    return dir + name;
+  }
+  return dir + "/" + name;
+}
+
+/// Read a directory and queue its subdirectories and files.
+struct ListDirectoryTask {
+  std::string path;
+  // Only names starting with this are listed, for the directory holding the prefix
+  std::string name_prefix;
+};
+
+/// Stat a batch of names of a directory and emit the regular files.
+struct StatTask {
+  std::shared_ptr<DirectoryHandle> directory;
+  std::string path;
+  std::vector<std::string> names;
+};
+
+using ListTask = std::variant<ListDirectoryTask, StatTask>;
+
+class LocalFileInfoIterator : public FileInfoIterator {
+ public:
+  LocalFileInfoIterator(ListDirectoryTask root, const ListPrefixOptions& options)
+      : batch_size_(options.batch_size),
+        max_queued_batches_(static_cast<size_t>(options.parallelism) * 4),
+        max_queued_tasks_(static_cast<size_t>(options.parallelism) * 4) {
+    tasks_.push_back(std::move(root));
+    pending_ = 1;
+    for (int i = 0; i < options.parallelism; ++i) {
+      workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+  }
+
+  ~LocalFileInfoIterator() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cancelled_ = true;
+    }
+    work_cv_.notify_all();
+    space_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  Result<std::vector<FileInfo>> Next() override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    result_cv_.wait(
+        lock, [&]() { return !results_.empty() || pending_ == 0 || !status_.ok(); });
+    ICEBERG_RETURN_NOT_OK(status_);
+    if (results_.empty()) {
+      return std::vector<FileInfo>();
+    }
+    std::vector<FileInfo> batch = std::move(results_.front());
+    results_.pop_front();
+    space_cv_.notify_one();
+    return batch;
+  }
+
+ private:
+  void WorkerLoop() {
+    while (true) {
+      ListTask task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_cv_.wait(lock,
+                      [&]() { return cancelled_ || !tasks_.empty() || pending_ == 0; });
+        if (cancelled_ || tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      Status st = Run(task);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!st.ok() && status_.ok()) {
+          status_ = std::move(st);
+          cancelled_ = true;
+        }
+        if (--pending_ == 0 || cancelled_) {
+          work_cv_.notify_all();
+          space_cv_.notify_all();
+        }
+      }
+      result_cv_.notify_all();
+    }
+  }
+
+  Status Run(const ListTask& task) {
+    return std::holds_alternative<ListDirectoryTask>(task)
+               ? ListDirectory(std::get<ListDirectoryTask>(task))
+               : StatEntries(std::get<StatTask>(task));
+  }
+
+  /// Queue a task for the workers, or run it right away while too many tasks are
+  /// queued. A worker listing a huge directory is so held to the pace of the others and
+  /// of the consumer, rather than queueing its entries without bound. Waiting for space
+  /// instead could deadlock, since only workers take tasks off the queue.
+  Status Push(ListTask task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (cancelled_) {
+        return Status::OK();
+      }
+      if (tasks_.size() < max_queued_tasks_) {
+        tasks_.push_back(std::move(task));
+        ++pending_;
+        work_cv_.notify_one();
+        return Status::OK();
+      }
+    }
+    return Run(task);
+  }
+
+  /// Hand a batch to the consumer, waiting while too many batches are queued.
+  void Emit(std::vector<FileInfo> batch) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      space_cv_.wait(
+          lock, [&]() { return cancelled_ || results_.size() < max_queued_batches_; });
+      if (cancelled_) {
+        return;
+      }
+      results_.push_back(std::move(batch));
+    }
+    result_cv_.notify_one();
+  }
+
+  Status ListDirectory(const ListDirectoryTask& task) {
+    const std::string& path = task.path.empty() ? "." : task.path;
+    int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+      // The prefix matches nothing, or the directory was removed during the listing
+      if (errno == ENOENT || errno == ENOTDIR) {
+        return Status::OK();
+      }
+      return Status::IOError("Failed to open directory '", path, "', errno: ", errno);
+    }
+    auto directory = std::make_shared<DirectoryHandle>(fd);
+    std::vector<DirectoryEntry> entries;
+    do {
+      entries.clear();
+      ICEBERG_RETURN_NOT_OK(directory->ReadBatch(&entries));
+      StatTask stat_task{directory, task.path, {}};
+      for (auto& entry : entries) {
+        if (entry.name == "." || entry.name == ".." ||
+            entry.name.compare(0, task.name_prefix.size(), task.name_prefix) != 0) {
+          continue;
+        }
+        if (entry.type == DT_DIR) {
+          ICEBERG_RETURN_NOT_OK(
+              Push(ListDirectoryTask{JoinPath(task.path, entry.name), ""}));
+        } else if (entry.type == DT_REG || entry.type == DT_UNKNOWN) {
+          stat_task.names.push_back(std::move(entry.name));
+        }
+      }
+      if (!stat_task.names.empty()) {
+        ICEBERG_RETURN_NOT_OK(Push(std::move(stat_task)));
+      }
+    } while (!entries.empty() && !IsCancelled());
+    return Status::OK();
+  }
+
+  Status StatEntries(const StatTask& task) {
+    std::vector<FileInfo> batch;
+    for (const auto& name : task.names) {
+      struct stat st;
+      if (fstatat(task.directory->fd(), name.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0) {
+        if (errno == ENOENT) {
+          continue;
+        }
+        return Status::IOError("Failed to stat '", JoinPath(task.path, name),
+                               "', errno: ", errno);
+      }
+      if (S_ISDIR(st.st_mode)) {
+        // Only reached when the file system does not report entry types
+        ICEBERG_RETURN_NOT_OK(Push(ListDirectoryTask{JoinPath(task.path, name), ""}));
+      } else if (S_ISREG(st.st_mode)) {
+        const int64_t modified_millis = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000 +
+                                        st.st_mtim.tv_nsec / 1000000;
+        batch.emplace_back(JoinPath(task.path, name), static_cast<int64_t>(st.st_size),
+                           modified_millis);
+        if (static_cast<int64_t>(batch.size()) == batch_size_) {
+          Emit(std::move(batch));
+          batch = {};
+        }
+      }
+    }
+    if (!batch.empty()) {
+      Emit(std::move(batch));
+    }
+    return Status::OK();
+  }
+
+  bool IsCancelled() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_;
+  }
+
+  const int64_t batch_size_;
+  const size_t max_queued_batches_;
+  const size_t max_queued_tasks_;
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable space_cv_;
+  std::condition_variable result_cv_;
+  // At most max_queued_tasks_
+  std::deque<ListTask> tasks_;
+  // Tasks queued or running; the listing is complete when it drops to zero
+  int64_t pending_ = 0;
+  std::deque<std::vector<FileInfo>> results_;
+  bool cancelled_ = false;
+  Status status_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace
+
+Result<std::unique_ptr<FileInfoIterator>> ListLocalPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  if (options.parallelism <= 0) {
+    return Status::Invalid("Invalid listing parallelism: ", options.parallelism);
+  }
+  if (options.batch_size <= 0) {
+    return Status::Invalid("Invalid listing batch size: ", options.batch_size);
+  }
+  // The last path component of the prefix may be partial: "/t/data/a" lists the entries
+  // of "/t/data" whose name starts with "a"
+  ListDirectoryTask root;
+  const size_t slash = prefix.rfind('/');
+  if (slash == std::string::npos) {
+    root.name_prefix = prefix;
+  } else {
+    root.path = prefix.substr(0, slash == 0 ? 1 : slash);
+    root.name_prefix = prefix.substr(slash + 1);
+  }
+  return std::make_unique<LocalFileInfoIterator>(std::move(root), options);
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace iceberg
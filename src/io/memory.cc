@@ -0,0 +1,119 @@
+#include "iceberg/io/memory.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace iceberg {
+namespace io {
+
+Status BufferReader::Close() {
+  buffer_.reset();
+  return Status::OK();
+}
+
+Result<int64_t> BufferReader::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return position_;
+}
+
+Result<int64_t> BufferReader::Read(int64_t nbytes, void* out) {
+  ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read, ReadAt(position_, nbytes, out));
+  position_ += bytes_read;
+  return bytes_read;
+}
+
+Result<int64_t> BufferReader::ReadAt(int64_t position, int64_t nbytes, void* out) {
+  ICEBERG_ASSIGN_OR_RAISE(auto buffer, ReadAt(position, nbytes));
+  if (buffer->size() > 0) {
+    std::memcpy(out, buffer->data(), static_cast<size_t>(buffer->size()));
+  }
+  return buffer->size();
+}
+
+std::future<Result<int64_t>> BufferReader::ReadAtAsync(int64_t position, int64_t nbytes,
+                                                       void* out) {
+  std::promise<Result<int64_t>> promise;
+  promise.set_value(ReadAt(position, nbytes, out));
+  return promise.get_future();
+}
+
+Result<std::vector<std::shared_ptr<Buffer>>> BufferReader::ReadRanges(
+    const std::vector<ReadRange>& ranges, const CoalesceOptions& options) {
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  buffers.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    ICEBERG_ASSIGN_OR_RAISE(auto buffer, ReadAt(range.offset, range.length));
+    buffers.push_back(std::move(buffer));
+  }
+  return buffers;
+}
+
+Result<std::shared_ptr<Buffer>> BufferReader::Read(int64_t nbytes) {
+  ICEBERG_ASSIGN_OR_RAISE(auto buffer, ReadAt(position_, nbytes));
+  position_ += buffer->size();
+  return buffer;
+}
+
+Result<std::shared_ptr<Buffer>> BufferReader::ReadAt(int64_t position, int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (position < 0 || nbytes < 0) {
+    return Status::Invalid("Invalid read range");
+  }
+  position = std::min(position, buffer_->size());
+  nbytes = std::min(nbytes, buffer_->size() - position);
+  return SliceBuffer(buffer_, position, nbytes);
+}
+
+Status BufferReader::Seek(int64_t position) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (position < 0) {
+    return Status::Invalid("Invalid position");
+  }
+  position_ = position;
+  return Status::OK();
+}
+
+bool BufferReader::closed() const { return buffer_ == nullptr; }
+
+Status BufferReader::CheckClosed() const {
+  if (closed()) {
+    return Status::Invalid("Invalid operation on closed file");
+  }
+  return Status::OK();
+}
+
+Status BufferOutputStream::Close() {
+  closed_ = true;
+  return Status::OK();
+}
+
+Result<int64_t> BufferOutputStream::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return static_cast<int64_t>(data_.size());
+}
+
+Status BufferOutputStream::Write(const void* data, int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (nbytes < 0) {
+    return Status::Invalid("Invalid write size");
+  }
+  data_.append(reinterpret_cast<const char*>(data), static_cast<size_t>(nbytes));
+  return Status::OK();
+}
+
+Result<std::shared_ptr<Buffer>> BufferOutputStream::Finish() {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  closed_ = true;
+  return Buffer::FromString(std::move(data_));
+}
+
+Status BufferOutputStream::CheckClosed() const {
+  if (closed_) {
+    return Status::Invalid("Invalid operation on closed stream");
+  }
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,245 @@
+#include "iceberg/io/memory_file_io.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "iceberg/io/memory.hh"
+#include "iceberg/util/logging.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace internal {
+
+class MemoryFileSystem {
+ public:
+  /// Return the contents of a file, or nullptr if it does not exist.
+  std::shared_ptr<Buffer> Get(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(path);
+    return it == files_.end() ? nullptr : it->second.data;
+  }
+
+  /// Create an empty file unless the file exists. Return whether it was created.
+  bool Create(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return files_.emplace(path, File{EmptyBuffer(), NowMillis()}).second;
+  }
+
+  void Put(const std::string& path, std::shared_ptr<Buffer> data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    files_[path] = File{std::move(data), NowMillis()};
+  }
+
+  bool Remove(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return files_.erase(path) > 0;
+  }
+
+  std::vector<FileInfo> List(const std::string& prefix) const {
+    std::vector<FileInfo> infos;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : files_) {
+      if (entry.first.compare(0, prefix.size(), prefix) == 0) {
+        infos.emplace_back(entry.first, entry.second.data->size(),
+                           entry.second.modified_millis);
+      }
+    }
+    return infos;
+  }
+
+  int64_t num_files() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int64_t>(files_.size());
+  }
+
+  int64_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t total = 0;
+    for (const auto& entry : files_) {
+      total += entry.second.data->size();
+    }
+    return total;
+  }
+
+  static std::shared_ptr<Buffer> EmptyBuffer() {
+    return std::make_shared<Buffer>(nullptr, 0);
+  }
+
+ private:
+  struct File {
+    std::shared_ptr<Buffer> data;
+    int64_t modified_millis;
+  };
+
+  static int64_t NowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  }
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, File> files_;
+};
+
+}  // namespace internal
+
+namespace {
+
+using internal::MemoryFileSystem;
+
+/// Publishes the written bytes as the file's contents on close.
+class MemoryOutputStream : public BufferOutputStream {
+ public:
+  MemoryOutputStream(std::shared_ptr<MemoryFileSystem> files, std::string location)
+      : files_(std::move(files)), location_(std::move(location)) {}
+
+  ~MemoryOutputStream() override {
+    if (!closed()) {
+      ICEBERG_CHECK_OK(Close());
+    }
+  }
+
+  Status Close() override {
+    if (closed()) {
+      return Status::OK();
+    }
+    ICEBERG_ASSIGN_OR_RAISE(auto data, Finish());
+    files_->Put(location_, std::move(data));
+    return Status::OK();
+  }
+
+ private:
+  std::shared_ptr<MemoryFileSystem> files_;
+  std::string location_;
+};
+
+class MemoryInputFile : public InputFile {
+ public:
+  MemoryInputFile(std::string location, std::shared_ptr<MemoryFileSystem> files)
+      : InputFile(std::move(location)), files_(std::move(files)) {}
+
+  Result<int64_t> getLength() override {
+    auto data = files_->Get(location_);
+    if (data == nullptr) {
+      return Status::Invalid("File not exists.");
+    }
+    return data->size();
+  }
+
+  Result<std::shared_ptr<SeekableInputStream>> newStream() override {
+    auto data = files_->Get(location_);
+    if (data == nullptr) {
+      return Status::Invalid("Input file not exists");
+    }
+    return std::make_shared<BufferReader>(std::move(data));
+  }
+
+  bool exists() const override { return files_->Get(location_) != nullptr; }
+
+ private:
+  std::shared_ptr<MemoryFileSystem> files_;
+};
+
+class MemoryOutputFile : public OutputFile {
+ public:
+  MemoryOutputFile(std::string location, std::shared_ptr<MemoryFileSystem> files)
+      : OutputFile(std::move(location)), files_(std::move(files)) {}
+
+  Result<std::shared_ptr<PositionOutputStream>> create() override {
+    if (!files_->Create(location_)) {
+      return Status::AlreadyExists("output file ", location_, " already exists");
+    }
+    return std::make_shared<MemoryOutputStream>(files_, location_);
+  }
+
+  Result<std::shared_ptr<PositionOutputStream>> createOrOverwrite() override {
+    // Truncate right away, as opening a local file for writing does
+    files_->Put(location_, MemoryFileSystem::EmptyBuffer());
+    return std::make_shared<MemoryOutputStream>(files_, location_);
+  }
+
+  Result<std::shared_ptr<InputFile>> toInputFile() const override {
+    return std::make_shared<MemoryInputFile>(location_, files_);
+  }
+
+ private:
+  std::shared_ptr<MemoryFileSystem> files_;
+};
+
+class VectorFileInfoIterator : public FileInfoIterator {
+ public:
+  VectorFileInfoIterator(std::vector<FileInfo> infos, int64_t batch_size)
+      : infos_(std::move(infos)), batch_size_(batch_size) {}
+
+  Result<std::vector<FileInfo>> Next() override {
+    const size_t end = std::min(infos_.size(), next_ + static_cast<size_t>(batch_size_));
+    std::vector<FileInfo> batch(infos_.begin() + next_, infos_.begin() + end);
+    next_ = end;
+    return batch;
+  }
+
+ private:
+  std::vector<FileInfo> infos_;
+  const int64_t batch_size_;
+  size_t next_ = 0;
+};
+
+}  // namespace
+
+MemoryFileIO::MemoryFileIO() : files_(std::make_shared<MemoryFileSystem>()) {}
+
+MemoryFileIO::~MemoryFileIO() = default;
+
+bool MemoryFileIO::Equals(const FileIO& other) const {
+  auto memory = dynamic_cast<const MemoryFileIO*>(&other);
+  return memory != nullptr && files_ == memory->files_;
+}
+
+Result<std::shared_ptr<InputFile>> MemoryFileIO::newInputFile(const std::string& path) {
+  return std::make_shared<MemoryInputFile>(path, files_);
+}
+
+Result<std::shared_ptr<OutputFile>> MemoryFileIO::newOutputFile(const std::string& path) {
+  return std::make_shared<MemoryOutputFile>(path, files_);
+}
+
+Status MemoryFileIO::DeleteFile(const std::string& path) {
+  if (!files_->Remove(path)) {
+    return Status::IOError("Delete file '", path, "' failed, error message: ",
+                           "No such file or directory");
+  }
+  return Status::OK();
+}
+
+Result<std::unique_ptr<FileInfoIterator>> MemoryFileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  if (options.batch_size <= 0) {
+    return Status::Invalid("Invalid listing batch size: ", options.batch_size);
+  }
+  return std::make_unique<VectorFileInfoIterator>(files_->List(prefix),
+                                                  options.batch_size);
+}
+
+Status MemoryFileIO::CopyFile(const std::string& src, const std::string& dst) {
+  auto data = files_->Get(src);
+  if (data == nullptr) {
+    return Status::Invalid("Input file not exists");
+  }
+  if (!files_->Create(dst)) {
+    return Status::AlreadyExists("output file ", dst, " already exists");
+  }
+  files_->Put(dst, std::move(data));
+  return Status::OK();
+}
+
+int64_t MemoryFileIO::num_files() const { return files_->num_files(); }
+
+int64_t MemoryFileIO::size() const { return files_->size(); }
+
+}  // namespace io
+}  // namespace iceberg
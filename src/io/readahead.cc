@@ -0,0 +1,230 @@
+#include "iceberg/io/readahead.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "iceberg/util/logging.hh"
+
+namespace iceberg {
+namespace io {
+
+ReadaheadInputStream::ReadaheadInputStream(std::shared_ptr<SeekableInputStream> raw,
+                                           ReadaheadOptions options, int64_t position)
+    : raw_(std::move(raw)),
+      options_(options),
+      position_(position),
+      next_window_offset_(position),
+      window_size_(options.initial_window) {}
+
+ReadaheadInputStream::~ReadaheadInputStream() {
+  if (!closed()) {
+    ICEBERG_CHECK_OK(Close());
+  }
+}
+
+Result<std::shared_ptr<ReadaheadInputStream>> ReadaheadInputStream::Create(
+    std::shared_ptr<SeekableInputStream> raw, ReadaheadOptions options) {
+  if (options.initial_window <= 0 || options.max_window < options.initial_window) {
+    return Status::Invalid("Invalid readahead window sizes: ", options.initial_window,
+                           ", ", options.max_window);
+  }
+  if (options.depth <= 0 || options.random_access_threshold <= 0) {
+    return Status::Invalid(
+        "Readahead depth and random access threshold must be positive");
+  }
+  ICEBERG_ASSIGN_OR_RAISE(int64_t position, raw->Tell());
+  auto stream = std::shared_ptr<ReadaheadInputStream>(
+      new ReadaheadInputStream(std::move(raw), options, position));
+  ICEBERG_RETURN_NOT_OK(stream->Schedule());
+  return stream;
+}
+
+Status ReadaheadInputStream::Close() {
+  if (closed_) {
+    return Status::OK();
+  }
+  DropWindows();
+  closed_ = true;
+  return raw_->Close();
+}
+
+Result<int64_t> ReadaheadInputStream::Tell() const {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return position_;
+}
+
+bool ReadaheadInputStream::closed() const { return closed_; }
+
+Status ReadaheadInputStream::Seek(int64_t position) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (position < 0) {
+    return Status::Invalid("Invalid position");
+  }
+  if (position == position_) {
+    return Status::OK();
+  }
+  if (!windows_.empty() && position >= windows_.front().offset &&
+      position < next_window_offset_) {
+    // A skip within the windows in flight; keep the ones still ahead
+    while (position >= windows_.front().offset + windows_.front().length) {
+      if (windows_.front().bytes_read < 0) {
+        windows_.front().future.wait();
+      }
+      windows_.pop_front();
+    }
+    position_ = position;
+    random_seeks_ = 0;
+    return Schedule();
+  }
+
+  DropWindows();
+  position_ = position;
+  next_window_offset_ = position;
+  eof_ = false;
+  if (suspended_) {
+    sequential_reads_ = 0;
+    return Status::OK();
+  }
+  if (++random_seeks_ >= options_.random_access_threshold) {
+    suspended_ = true;
+    sequential_reads_ = 0;
+    return Status::OK();
+  }
+  window_size_ = options_.initial_window;
+  return Schedule();
+}
+
+Result<int64_t> ReadaheadInputStream::Read(int64_t nbytes, void* out) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (nbytes < 0) {
+    return Status::Invalid("Invalid read size");
+  }
+  if (suspended_) {
+    ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read, raw_->ReadAt(position_, nbytes, out));
+    position_ += bytes_read;
+    if (++sequential_reads_ >= options_.random_access_threshold) {
+      suspended_ = false;
+      random_seeks_ = 0;
+      window_size_ = options_.initial_window;
+      next_window_offset_ = position_;
+      ICEBERG_RETURN_NOT_OK(Schedule());
+    }
+    return bytes_read;
+  }
+
+  uint8_t* dest = reinterpret_cast<uint8_t*>(out);
+  int64_t copied = 0;
+  while (copied < nbytes) {
+    ICEBERG_ASSIGN_OR_RAISE(Window * window, FrontWindow());
+    if (window == nullptr) {
+      break;
+    }
+    const int64_t offset = position_ - window->offset;
+    const int64_t n = std::min(nbytes - copied, window->bytes_read - offset);
+    if (n <= 0) {
+      break;
+    }
+    std::memcpy(dest + copied, window->buffer->data() + offset, static_cast<size_t>(n));
+    copied += n;
+    ICEBERG_RETURN_NOT_OK(Consume(n));
+  }
+  return copied;
+}
+
+Result<std::shared_ptr<Buffer>> ReadaheadInputStream::Read(int64_t nbytes) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  if (!suspended_ && nbytes > 0) {
+    ICEBERG_ASSIGN_OR_RAISE(Window * window, FrontWindow());
+    if (window != nullptr) {
+      const int64_t offset = position_ - window->offset;
+      if (offset + nbytes <= window->bytes_read) {
+        auto slice = SliceBuffer(window->buffer, offset, nbytes);
+        ICEBERG_RETURN_NOT_OK(Consume(nbytes));
+        return slice;
+      }
+    }
+  }
+  return SeekableInputStream::Read(nbytes);
+}
+
+Result<int64_t> ReadaheadInputStream::ReadAt(int64_t position, int64_t nbytes,
+                                             void* out) {
+  ICEBERG_RETURN_NOT_OK(CheckClosed());
+  return raw_->ReadAt(position, nbytes, out);
+}
+
+Status ReadaheadInputStream::Consume(int64_t nbytes) {
+  position_ += nbytes;
+  const Window& window = windows_.front();
+  if (position_ == window.offset + window.length) {
+    // A window read through sequentially: read further ahead from now on
+    windows_.pop_front();
+    window_size_ = std::min(window_size_ * 2, options_.max_window);
+    random_seeks_ = 0;
+    return Schedule();
+  }
+  return Status::OK();
+}
+
+Status ReadaheadInputStream::Schedule() {
+  if (suspended_ || eof_) {
+    return Status::OK();
+  }
+  while (windows_.size() < static_cast<size_t>(options_.depth)) {
+    Window window;
+    window.offset = next_window_offset_;
+    window.length = window_size_;
+    ICEBERG_ASSIGN_OR_RAISE(window.buffer, AllocateBuffer(window.length));
+    window.future =
+        raw_->ReadAtAsync(window.offset, window.length, window.buffer->mutable_data());
+    next_window_offset_ += window.length;
+    windows_.push_back(std::move(window));
+  }
+  return Status::OK();
+}
+
+Result<ReadaheadInputStream::Window*> ReadaheadInputStream::FrontWindow() {
+  if (windows_.empty()) {
+    ICEBERG_RETURN_NOT_OK(Schedule());
+    if (windows_.empty()) {
+      return nullptr;
+    }
+  }
+  Window& window = windows_.front();
+  if (window.bytes_read < 0) {
+    auto res = window.future.get();
+    if (!res.ok()) {
+      // The window is forgotten along with the others; a retry issues it again
+      window.bytes_read = 0;
+      DropWindows();
+      next_window_offset_ = position_;
+      return res.status();
+    }
+    window.bytes_read = res.ValueUnsafe();
+    if (window.bytes_read < window.length) {
+      eof_ = true;
+    }
+  }
+  return &window;
+}
+
+void ReadaheadInputStream::DropWindows() {
+  for (auto& window : windows_) {
+    // The reads write into the window buffers; wait for them before freeing those
+    if (window.bytes_read < 0) {
+      window.future.wait();
+    }
+  }
+  windows_.clear();
+}
+
+Status ReadaheadInputStream::CheckClosed() const {
+  if (closed_) {
+    return Status::Invalid("Operation forbidden on closed ReadaheadInputStream");
+  }
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace iceberg
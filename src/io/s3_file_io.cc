@@ -0,0 +1,871 @@
+#include "iceberg/io/s3_file_io.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "iceberg/util/sha256.hh"
+#include "iceberg/util/thread_pool.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+constexpr char kUnsignedPayload[] = "UNSIGNED-PAYLOAD";
+
+using Headers = std::vector<std::pair<std::string, std::string>>;
+using Query = std::vector<std::pair<std::string, std::string>>;
+
+struct S3Location {
+  std::string scheme;
+  std::string bucket;
+  std::string key;
+};
+
+Result<S3Location> ParseLocation(const std::string& location) {
+  const size_t separator = location.find("://");
+  if (separator != std::string::npos) {
+    S3Location parsed;
+    parsed.scheme = location.substr(0, separator);
+    const std::string rest = location.substr(separator + 3);
+    const size_t slash = rest.find('/');
+    parsed.bucket = rest.substr(0, slash);
+    parsed.key = slash == std::string::npos ? "" : rest.substr(slash + 1);
+    if ((parsed.scheme == "s3" || parsed.scheme == "s3a" || parsed.scheme == "s3n") &&
+        !parsed.bucket.empty()) {
+      return parsed;
+    }
+  }
+  return Status::Invalid("Invalid S3 location '", location, "'");
+}
+
+std::string UriEncode(std::string_view s, bool keep_slash) {
+  static const char kDigits[] = "0123456789ABCDEF";
+  std::string encoded;
+  for (unsigned char c : s) {
+    if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' ||
+        (keep_slash && c == '/')) {
+      encoded.push_back(static_cast<char>(c));
+    } else {
+      encoded.push_back('%');
+      encoded.push_back(kDigits[c >> 4]);
+      encoded.push_back(kDigits[c & 0xf]);
+    }
+  }
+  return encoded;
+}
+
+std::string XmlEscape(std::string_view s) {
+  std::string escaped;
+  for (char c : s) {
+    switch (c) {
+      case '&':
+        escaped += "&amp;";
+        break;
+      case '<':
+        escaped += "&lt;";
+        break;
+      case '>':
+        escaped += "&gt;";
+        break;
+      case '"':
+        escaped += "&quot;";
+        break;
+      default:
+        escaped.push_back(c);
+    }
+  }
+  return escaped;
+}
+
+std::string XmlUnescape(std::string_view s) {
+  static const std::pair<std::string_view, char> kEntities[] = {
+      {"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}};
+  std::string unescaped;
+  for (size_t i = 0; i < s.size();) {
+    bool replaced = false;
+    if (s[i] == '&') {
+      for (const auto& entity : kEntities) {
+        if (s.compare(i, entity.first.size(), entity.first) == 0) {
+          unescaped.push_back(entity.second);
+          i += entity.first.size();
+          replaced = true;
+          break;
+        }
+      }
+    }
+    if (!replaced) {
+      unescaped.push_back(s[i++]);
+    }
+  }
+  return unescaped;
+}
+
+// Find the next <tag> element at or after `*pos`, set `*text` to its unescaped content
+// and move `*pos` past it. The responses parsed here have no attributes on the elements
+// looked up.
+bool NextElement(std::string_view xml, const std::string& tag, size_t* pos,
+                 std::string* text) {
+  const std::string open = "<" + tag + ">";
+  const std::string close = "</" + tag + ">";
+  const size_t start = xml.find(open, *pos);
+  if (start == std::string::npos) {
+    return false;
+  }
+  const size_t end = xml.find(close, start + open.size());
+  if (end == std::string::npos) {
+    return false;
+  }
+  *text = XmlUnescape(xml.substr(start + open.size(), end - start - open.size()));
+  *pos = end + close.size();
+  return true;
+}
+
+std::string Element(std::string_view xml, const std::string& tag) {
+  size_t pos = 0;
+  std::string text;
+  NextElement(xml, tag, &pos, &text);
+  return text;
+}
+
+// Parse a timestamp as "2013-05-24T00:00:00.000Z" into milliseconds since the epoch
+int64_t ParseTimestampMillis(const std::string& timestamp) {
+  std::tm tm{};
+  int millis = 0;
+  if (std::sscanf(timestamp.c_str(), "%d-%d-%dT%d:%d:%d.%dZ", &tm.tm_year, &tm.tm_mon,
+                  &tm.tm_mday, &tm.tm_hour, &tm.tm_min, &tm.tm_sec, &millis) < 6) {
+    return 0;
+  }
+  tm.tm_year -= 1900;
+  tm.tm_mon -= 1;
+  return static_cast<int64_t>(timegm(&tm)) * 1000 + millis;
+}
+
+std::string AmzDate() {
+  const std::time_t now = std::time(nullptr);
+  std::tm tm;
+  gmtime_r(&now, &tm);
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y%m%dT%H%M%SZ", &tm);
+  return date;
+}
+
+Status ResponseError(const char* operation, const std::string& location,
+                     const HttpResponse& response) {
+  const std::string code = Element(response.body, "Code");
+  const std::string message = Element(response.body, "Message");
+  return Status::IOError("S3 ", operation, " of '", location,
+                         "' failed with HTTP status ", response.status,
+                         code.empty() ? "" : ": ", code, message.empty() ? "" : ": ",
+                         message);
+}
+
+// Some S3 requests report failures in the body of a 200 response
+bool IsSuccess(const HttpResponse& response) {
+  return response.status / 100 == 2 &&
+         response.body.find("<Error>") == std::string::npos;
+}
+
+}  // namespace
+
+namespace internal {
+
+std::string SignS3Request(const std::string& method, const std::string& canonical_uri,
+                          const std::string& canonical_query,
+                          std::vector<std::pair<std::string, std::string>> headers,
+                          const std::string& payload_hash, const std::string& amz_date,
+                          const std::string& region, const std::string& access_key_id,
+                          const std::string& secret_access_key) {
+  std::sort(headers.begin(), headers.end());
+  std::string canonical_headers;
+  std::string signed_headers;
+  for (const auto& header : headers) {
+    canonical_headers += header.first + ":" + header.second + "\n";
+    signed_headers += (signed_headers.empty() ? "" : ";") + header.first;
+  }
+  const std::string canonical_request = method + "\n" + canonical_uri + "\n" +
+                                        canonical_query + "\n" + canonical_headers +
+                                        "\n" + signed_headers + "\n" + payload_hash;
+  const std::string date = amz_date.substr(0, 8);
+  const std::string scope = date + "/" + region + "/s3/aws4_request";
+  const std::string string_to_sign =
+      "AWS4-HMAC-SHA256\n" + amz_date + "\n" + scope + "\n" +
+      util::ToHex(util::Sha256Hash(canonical_request));
+
+  util::Sha256Digest key = util::HmacSha256("AWS4" + secret_access_key, date);
+  for (std::string_view data : {std::string_view(region), std::string_view("s3"),
+                                std::string_view("aws4_request"),
+                                std::string_view(string_to_sign)}) {
+    key = util::HmacSha256(
+        std::string_view(reinterpret_cast<const char*>(key.data()), key.size()), data);
+  }
+  return "AWS4-HMAC-SHA256 Credential=" + access_key_id + "/" + scope +
+         ", SignedHeaders=" + signed_headers + ", Signature=" + util::ToHex(key);
+}
+
+/// State shared by an S3FileIO and its files and streams, which may outlive it.
+struct S3Client {
+  S3Client(S3FileIOOptions options, HttpClientOptions http_options)
+      : options(std::move(options)),
+        http(std::move(http_options)),
+        pool(std::max(this->options.max_connections, 1)),
+        upload_budget(this->options.max_upload_buffer_bytes) {}
+
+  // Send a request on an object, or on a bucket if the key is empty, retrying server
+  // errors and failed connections
+  Result<HttpResponse> Execute(const std::string& method, const S3Location& location,
+                               Query query = {}, const Headers& headers = {},
+                               std::string_view body = {}, void* body_out = nullptr,
+                               int64_t body_capacity = 0) {
+    const std::string canonical_uri =
+        "/" + location.bucket + (location.key.empty() ? "" : "/") +
+        UriEncode(location.key, true);
+    for (auto& parameter : query) {
+      parameter.first = UriEncode(parameter.first, false);
+      parameter.second = UriEncode(parameter.second, false);
+    }
+    std::sort(query.begin(), query.end());
+    std::string canonical_query;
+    for (const auto& parameter : query) {
+      canonical_query += (canonical_query.empty() ? "" : "&") + parameter.first + "=" +
+                         parameter.second;
+    }
+
+    HttpRequest request;
+    request.method = method;
+    request.target =
+        canonical_uri + (canonical_query.empty() ? "" : "?") + canonical_query;
+    request.body = body;
+    request.body_out = body_out;
+    request.body_capacity = body_capacity;
+    for (int attempt = 0;; ++attempt) {
+      request.headers = headers;
+      if (!options.access_key_id.empty()) {
+        const std::string amz_date = AmzDate();
+        request.headers.emplace_back("x-amz-date", amz_date);
+        request.headers.emplace_back("x-amz-content-sha256", kUnsignedPayload);
+        if (!options.session_token.empty()) {
+          request.headers.emplace_back("x-amz-security-token", options.session_token);
+        }
+        Headers signed_headers = request.headers;
+        signed_headers.emplace_back("host", http.host_header());
+        request.headers.emplace_back(
+            "authorization",
+            SignS3Request(method, canonical_uri, canonical_query,
+                          std::move(signed_headers), kUnsignedPayload, amz_date,
+                          options.region, options.access_key_id,
+                          options.secret_access_key));
+      }
+      auto response = http.Send(request);
+      const bool retry = !response.ok() || response->status >= 500 ||
+                         response->status == 429;
+      if (!retry || attempt >= options.max_retries) {
+        return response;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(50 << attempt));
+    }
+  }
+
+  // Return the length of an object, or -1 if it does not exist
+  Result<int64_t> Head(const S3Location& location, const std::string& path) {
+    ICEBERG_ASSIGN_OR_RAISE(auto response, Execute("HEAD", location));
+    if (response.status == 404) {
+      return -1;
+    }
+    const std::string* length = response.header("content-length");
+    if (response.status != 200 || length == nullptr) {
+      return ResponseError("HEAD", path, response);
+    }
+    return ParseHttpLength(*length);
+  }
+
+  // Take up to `nbytes` of the upload budget, waiting until they are available, and
+  // return the bytes taken
+  int64_t AcquireUploadBuffer(int64_t nbytes) {
+    nbytes = std::min(nbytes, options.max_upload_buffer_bytes);
+    std::unique_lock<std::mutex> lock(budget_mutex);
+    budget_cv.wait(lock, [&]() { return upload_budget >= nbytes; });
+    upload_budget -= nbytes;
+    return nbytes;
+  }
+
+  void ReleaseUploadBuffer(int64_t nbytes) {
+    std::lock_guard<std::mutex> lock(budget_mutex);
+    upload_budget += nbytes;
+    budget_cv.notify_all();
+  }
+
+  // Run tasks [0, num_tasks) on the pool, the calling thread taking its share. Tasks
+  // are claimed by the threads that get to run, so this cannot wait on tasks queued
+  // behind blocked ones.
+  Status RunParallel(int64_t num_tasks, std::function<Status(int64_t)> task) {
+    struct State {
+      std::function<Status(int64_t)> task;
+      int64_t num_tasks;
+      std::atomic<int64_t> next{0};
+      std::mutex mutex;
+      std::condition_variable cv;
+      int64_t done = 0;
+      Status status;
+    };
+    auto state = std::make_shared<State>();
+    state->task = std::move(task);
+    state->num_tasks = num_tasks;
+    auto work = [state]() {
+      for (int64_t i = state->next++; i < state->num_tasks; i = state->next++) {
+        Status status = state->task(i);
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->status &= status;
+        if (++state->done == state->num_tasks) {
+          state->cv.notify_all();
+        }
+      }
+    };
+    const int64_t helpers = std::min<int64_t>(num_tasks, pool.num_threads()) - 1;
+    for (int64_t i = 0; i < helpers; ++i) {
+      pool.Spawn(work);
+    }
+    work();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&]() { return state->done == num_tasks; });
+    return state->status;
+  }
+
+  const S3FileIOOptions options;
+  HttpClient http;
+  util::ThreadPool pool;
+
+  std::mutex budget_mutex;
+  std::condition_variable budget_cv;
+  int64_t upload_budget;
+};
+
+}  // namespace internal
+
+namespace {
+
+using internal::S3Client;
+
+class S3InputStream : public SeekableInputStream {
+ public:
+  S3InputStream(std::shared_ptr<S3Client> client, S3Location location, std::string path,
+                int64_t length)
+      : client_(std::move(client)),
+        location_(std::move(location)),
+        path_(std::move(path)),
+        length_(length) {}
+
+  Status Close() override {
+    closed_ = true;
+    return Status::OK();
+  }
+
+  Result<int64_t> Tell() const override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    return position_;
+  }
+
+  bool closed() const override { return closed_; }
+
+  Status Seek(int64_t position) override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    if (position < 0) {
+      return Status::Invalid("Invalid position");
+    }
+    position_ = position;
+    return Status::OK();
+  }
+
+  using SeekableInputStream::Read;
+  Result<int64_t> Read(int64_t nbytes, void* out) override {
+    ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read, ReadAt(position_, nbytes, out));
+    position_ += bytes_read;
+    return bytes_read;
+  }
+
+  using SeekableInputStream::ReadAt;
+  /// \brief Read with one ranged GET per `read_part_size` bytes, in parallel
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    if (position < 0 || nbytes < 0) {
+      return Status::Invalid("Invalid read range");
+    }
+    nbytes = std::min(nbytes, std::max<int64_t>(0, length_ - position));
+    if (nbytes == 0) {
+      return 0;
+    }
+    const int64_t part_size = std::max<int64_t>(client_->options.read_part_size, 1);
+    const int64_t num_parts = (nbytes + part_size - 1) / part_size;
+    if (num_parts == 1) {
+      return ReadRange(position, nbytes, out);
+    }
+    auto dest = static_cast<uint8_t*>(out);
+    ICEBERG_RETURN_NOT_OK(client_->RunParallel(num_parts, [&](int64_t part) -> Status {
+      const int64_t offset = part * part_size;
+      const int64_t length = std::min(part_size, nbytes - offset);
+      ICEBERG_ASSIGN_OR_RAISE(int64_t bytes_read,
+                              ReadRange(position + offset, length, dest + offset));
+      if (bytes_read < length) {
+        return Status::IOError("Unexpected end of '", path_, "' at ",
+                               position + offset + bytes_read);
+      }
+      return Status::OK();
+    }));
+    return nbytes;
+  }
+
+ private:
+  Status CheckClosed() const {
+    if (closed_) {
+      return Status::Invalid("Invalid operation on closed file");
+    }
+    return Status::OK();
+  }
+
+  Result<int64_t> ReadRange(int64_t position, int64_t nbytes, void* out) {
+    const Headers headers = {
+        {"range", "bytes=" + std::to_string(position) + "-" +
+                      std::to_string(position + nbytes - 1)}};
+    ICEBERG_ASSIGN_OR_RAISE(
+        auto response, client_->Execute("GET", location_, {}, headers, {}, out, nbytes));
+    if (response.status == 404) {
+      return Status::Invalid("Input file not exists");
+    }
+    if (response.status == 416) {
+      return 0;
+    }
+    if (response.status != 206 && response.status != 200) {
+      return ResponseError("GET", path_, response);
+    }
+    return response.body_size;
+  }
+
+  std::shared_ptr<S3Client> client_;
+  const S3Location location_;
+  const std::string path_;
+  const int64_t length_;
+  int64_t position_ = 0;
+  std::atomic<bool> closed_{false};
+};
+
+class S3InputFile : public InputFile {
+ public:
+  S3InputFile(std::shared_ptr<S3Client> client, S3Location s3_location,
+              std::string location, int64_t length)
+      : InputFile(std::move(location)),
+        client_(std::move(client)),
+        s3_location_(std::move(s3_location)),
+        length_(length) {}
+
+  Result<int64_t> getLength() override {
+    int64_t length = length_.load();
+    if (length < 0) {
+      ICEBERG_ASSIGN_OR_RAISE(length, client_->Head(s3_location_, location_));
+      if (length < 0) {
+        return Status::Invalid("Input file not exists");
+      }
+      length_.store(length);
+    }
+    return length;
+  }
+
+  Result<std::shared_ptr<SeekableInputStream>> newStream() override {
+    ICEBERG_ASSIGN_OR_RAISE(int64_t length, getLength());
+    return std::make_shared<S3InputStream>(client_, s3_location_, location_, length);
+  }
+
+  bool exists() const override {
+    auto length = client_->Head(s3_location_, location_);
+    return length.ok() && *length >= 0;
+  }
+
+ private:
+  std::shared_ptr<S3Client> client_;
+  const S3Location s3_location_;
+  // -1 until known
+  std::atomic<int64_t> length_;
+};
+
+class S3OutputStream : public PositionOutputStream {
+ public:
+  S3OutputStream(std::shared_ptr<S3Client> client, S3Location location, std::string path,
+                 bool exclusive)
+      : client_(std::move(client)),
+        location_(std::move(location)),
+        path_(std::move(path)),
+        exclusive_(exclusive) {}
+
+  ~S3OutputStream() override {
+    if (!closed_) {
+      ICEBERG_WARN_NOT_OK(Abort(), "Failed to abort the upload of an unclosed stream");
+    }
+  }
+
+  /// \brief Upload the buffered bytes and complete the upload
+  Status Close() override {
+    if (closed_) {
+      return Status::OK();
+    }
+    closed_ = true;
+    Status status = Complete();
+    if (!status.ok()) {
+      ICEBERG_WARN_NOT_OK(Abort(), "Failed to abort upload");
+    }
+    return status;
+  }
+
+  Result<int64_t> Tell() const override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    return position_;
+  }
+
+  bool closed() const override { return closed_; }
+
+  Status Write(const void* data, int64_t nbytes) override {
+    ICEBERG_RETURN_NOT_OK(CheckClosed());
+    {
+      // Fail early once a part failed
+      std::lock_guard<std::mutex> lock(mutex_);
+      ICEBERG_RETURN_NOT_OK(status_);
+    }
+    const int64_t part_size = std::max<int64_t>(client_->options.upload_part_size, 1);
+    auto next = static_cast<const char*>(data);
+    for (int64_t remaining = nbytes; remaining > 0;) {
+      const int64_t n =
+          std::min(remaining, part_size - static_cast<int64_t>(buffer_.size()));
+      buffer_.append(next, static_cast<size_t>(n));
+      next += n;
+      remaining -= n;
+      if (static_cast<int64_t>(buffer_.size()) == part_size) {
+        ICEBERG_RETURN_NOT_OK(UploadPart());
+      }
+    }
+    position_ += nbytes;
+    return Status::OK();
+  }
+
+ private:
+  Status CheckClosed() const {
+    if (closed_) {
+      return Status::Invalid("Invalid operation on closed file");
+    }
+    return Status::OK();
+  }
+
+  Headers ConditionalHeaders() const {
+    if (exclusive_) {
+      return {{"if-none-match", "*"}};
+    }
+    return {};
+  }
+
+  // Upload the buffer as the next part, in the background
+  Status UploadPart() {
+    if (upload_id_.empty()) {
+      ICEBERG_ASSIGN_OR_RAISE(auto response,
+                              client_->Execute("POST", location_, {{"uploads", ""}}));
+      if (!IsSuccess(response)) {
+        return ResponseError("CreateMultipartUpload", path_, response);
+      }
+      upload_id_ = Element(response.body, "UploadId");
+      if (upload_id_.empty()) {
+        return Status::IOError("No upload id in the response for '", path_, "'");
+      }
+    }
+    const int part_number = ++num_parts_;
+    auto part = std::make_shared<std::string>(std::move(buffer_));
+    buffer_.clear();
+    const int64_t reserved = client_->AcquireUploadBuffer(part->size());
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++pending_;
+      etags_.resize(part_number);
+    }
+    // Close and the destructor wait for the pending parts
+    client_->pool.Spawn([this, part, part_number, reserved]() {
+      auto response = client_->Execute(
+          "PUT", location_,
+          {{"partNumber", std::to_string(part_number)}, {"uploadId", upload_id_}}, {},
+          *part);
+      client_->ReleaseUploadBuffer(reserved);
+      Status status = response.status();
+      const std::string* etag = nullptr;
+      if (status.ok()) {
+        etag = response->header("etag");
+        if (response->status != 200 || etag == nullptr) {
+          status = ResponseError("UploadPart", path_, *response);
+        }
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (status.ok()) {
+        etags_[part_number - 1] = *etag;
+      }
+      status_ &= status;
+      --pending_;
+      cv_.notify_all();
+    });
+    return Status::OK();
+  }
+
+  Status WaitForParts() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return pending_ == 0; });
+    return status_;
+  }
+
+  Status Complete() {
+    if (upload_id_.empty()) {
+      ICEBERG_ASSIGN_OR_RAISE(
+          auto response,
+          client_->Execute("PUT", location_, {}, ConditionalHeaders(), buffer_));
+      if (response.status == 412) {
+        return Status::AlreadyExists("output file ", path_, " already exisits");
+      }
+      if (!IsSuccess(response)) {
+        return ResponseError("PUT", path_, response);
+      }
+      return Status::OK();
+    }
+    if (!buffer_.empty()) {
+      ICEBERG_RETURN_NOT_OK(UploadPart());
+    }
+    ICEBERG_RETURN_NOT_OK(WaitForParts());
+    std::string body = "<CompleteMultipartUpload>";
+    for (size_t i = 0; i < etags_.size(); ++i) {
+      body += "<Part><PartNumber>" + std::to_string(i + 1) + "</PartNumber><ETag>" +
+              XmlEscape(etags_[i]) + "</ETag></Part>";
+    }
+    body += "</CompleteMultipartUpload>";
+    ICEBERG_ASSIGN_OR_RAISE(
+        auto response, client_->Execute("POST", location_, {{"uploadId", upload_id_}},
+                                        ConditionalHeaders(), body));
+    if (response.status == 412) {
+      return Status::AlreadyExists("output file ", path_, " already exisits");
+    }
+    if (!IsSuccess(response)) {
+      return ResponseError("CompleteMultipartUpload", path_, response);
+    }
+    upload_id_.clear();
+    return Status::OK();
+  }
+
+  Status Abort() {
+    closed_ = true;
+    ICEBERG_UNUSED(WaitForParts());
+    if (upload_id_.empty()) {
+      return Status::OK();
+    }
+    ICEBERG_ASSIGN_OR_RAISE(auto response, client_->Execute("DELETE", location_,
+                                                            {{"uploadId", upload_id_}}));
+    if (response.status / 100 != 2 && response.status != 404) {
+      return ResponseError("AbortMultipartUpload", path_, response);
+    }
+    upload_id_.clear();
+    return Status::OK();
+  }
+
+  std::shared_ptr<S3Client> client_;
+  const S3Location location_;
+  const std::string path_;
+  const bool exclusive_;
+  std::string buffer_;
+  int64_t position_ = 0;
+  bool closed_ = false;
+  std::string upload_id_;
+  int num_parts_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  int pending_ = 0;
+  std::vector<std::string> etags_;
+  // First failure of a part upload
+  Status status_;
+};
+
+class S3OutputFile : public OutputFile {
+ public:
+  S3OutputFile(std::shared_ptr<S3Client> client, S3Location s3_location,
+               std::string location)
+      : OutputFile(std::move(location)),
+        client_(std::move(client)),
+        s3_location_(std::move(s3_location)) {}
+
+  Result<std::shared_ptr<PositionOutputStream>> create() override {
+    ICEBERG_ASSIGN_OR_RAISE(int64_t length, client_->Head(s3_location_, location_));
+    if (length >= 0) {
+      return Status::AlreadyExists("output file ", location(), " already exisits");
+    }
+    return std::make_shared<S3OutputStream>(client_, s3_location_, location_, true);
+  }
+
+  Result<std::shared_ptr<PositionOutputStream>> createOrOverwrite() override {
+    return std::make_shared<S3OutputStream>(client_, s3_location_, location_, false);
+  }
+
+  Result<std::shared_ptr<InputFile>> toInputFile() const override {
+    return std::make_shared<S3InputFile>(client_, s3_location_, location_, -1);
+  }
+
+ private:
+  std::shared_ptr<S3Client> client_;
+  const S3Location s3_location_;
+};
+
+class S3ListIterator : public FileInfoIterator {
+ public:
+  S3ListIterator(std::shared_ptr<S3Client> client, S3Location prefix, int64_t page_size)
+      : client_(std::move(client)), prefix_(std::move(prefix)), page_size_(page_size) {}
+
+  Result<std::vector<FileInfo>> Next() override {
+    std::vector<FileInfo> batch;
+    while (batch.empty() && !done_) {
+      S3Location bucket{prefix_.scheme, prefix_.bucket, ""};
+      Query query = {{"list-type", "2"},
+                     {"prefix", prefix_.key},
+                     {"max-keys", std::to_string(page_size_)}};
+      if (!continuation_token_.empty()) {
+        query.emplace_back("continuation-token", continuation_token_);
+      }
+      ICEBERG_ASSIGN_OR_RAISE(auto response,
+                              client_->Execute("GET", bucket, std::move(query)));
+      if (!IsSuccess(response)) {
+        return ResponseError("LIST", prefix_.scheme + "://" + prefix_.bucket + "/" +
+                                         prefix_.key,
+                             response);
+      }
+      size_t pos = 0;
+      std::string contents;
+      while (NextElement(response.body, "Contents", &pos, &contents)) {
+        batch.emplace_back(
+            prefix_.scheme + "://" + prefix_.bucket + "/" + Element(contents, "Key"),
+            std::strtoll(Element(contents, "Size").c_str(), nullptr, 10),
+            ParseTimestampMillis(Element(contents, "LastModified")));
+      }
+      continuation_token_ = Element(response.body, "NextContinuationToken");
+      done_ = Element(response.body, "IsTruncated") != "true" ||
+              continuation_token_.empty();
+    }
+    return batch;
+  }
+
+ private:
+  std::shared_ptr<S3Client> client_;
+  const S3Location prefix_;
+  const int64_t page_size_;
+  std::string continuation_token_;
+  bool done_ = false;
+};
+
+}  // namespace
+
+S3FileIO::S3FileIO(std::shared_ptr<internal::S3Client> client)
+    : client_(std::move(client)) {}
+
+S3FileIO::~S3FileIO() = default;
+
+Result<std::shared_ptr<S3FileIO>> S3FileIO::Make(S3FileIOOptions options) {
+  const std::string& endpoint = options.endpoint;
+  if (endpoint.compare(0, 8, "https://") == 0) {
+    return Status::NotImplemented("TLS is not supported, for endpoint '", endpoint, "'");
+  }
+  if (endpoint.compare(0, 7, "http://") != 0) {
+    return Status::Invalid("Invalid S3 endpoint '", endpoint, "'");
+  }
+  if (options.read_part_size <= 0 || options.upload_part_size <= 0 ||
+      options.max_connections <= 0 || options.max_upload_buffer_bytes <= 0) {
+    return Status::Invalid("Invalid S3FileIO options");
+  }
+  HttpClientOptions http_options;
+  std::string authority = endpoint.substr(7, endpoint.find('/', 7) - 7);
+  const size_t colon = authority.rfind(':');
+  if (colon != std::string::npos && authority.find(']', colon) == std::string::npos) {
+    http_options.port = std::atoi(authority.c_str() + colon + 1);
+    authority.resize(colon);
+  }
+  if (authority.empty() || http_options.port <= 0) {
+    return Status::Invalid("Invalid S3 endpoint '", endpoint, "'");
+  }
+  http_options.host = authority;
+  http_options.max_connections = options.max_connections;
+  http_options.timeout_millis = options.timeout_millis;
+  auto client = std::make_shared<internal::S3Client>(std::move(options), http_options);
+  return std::shared_ptr<S3FileIO>(new S3FileIO(std::move(client)));
+}
+
+bool S3FileIO::Equals(const FileIO& other) const {
+  auto s3 = dynamic_cast<const S3FileIO*>(&other);
+  return s3 != nullptr && client_ == s3->client_;
+}
+
+Result<std::shared_ptr<InputFile>> S3FileIO::newInputFile(const std::string& path) {
+  return newInputFile(path, -1);
+}
+
+Result<std::shared_ptr<InputFile>> S3FileIO::newInputFile(const std::string& path,
+                                                          int64_t length) {
+  ICEBERG_ASSIGN_OR_RAISE(auto location, ParseLocation(path));
+  return std::make_shared<S3InputFile>(client_, std::move(location), path, length);
+}
+
+Result<std::shared_ptr<OutputFile>> S3FileIO::newOutputFile(const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto location, ParseLocation(path));
+  return std::make_shared<S3OutputFile>(client_, std::move(location), path);
+}
+
+Status S3FileIO::DeleteFile(const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto location, ParseLocation(path));
+  ICEBERG_ASSIGN_OR_RAISE(auto response, client_->Execute("DELETE", location));
+  if (response.status / 100 != 2) {
+    return ResponseError("DELETE", path, response);
+  }
+  return Status::OK();
+}
+
+Result<std::unique_ptr<FileInfoIterator>> S3FileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  ICEBERG_ASSIGN_OR_RAISE(auto location, ParseLocation(prefix));
+  if (options.batch_size <= 0) {
+    return Status::Invalid("Invalid listing batch size ", options.batch_size);
+  }
+  // ListObjectsV2 returns at most 1000 keys per page
+  return std::make_unique<S3ListIterator>(client_, std::move(location),
+                                          std::min<int64_t>(options.batch_size, 1000));
+}
+
+Status S3FileIO::CopyFile(const std::string& src, const std::string& dst) {
+  ICEBERG_ASSIGN_OR_RAISE(auto src_location, ParseLocation(src));
+  ICEBERG_ASSIGN_OR_RAISE(auto dst_location, ParseLocation(dst));
+  ICEBERG_ASSIGN_OR_RAISE(int64_t src_length, client_->Head(src_location, src));
+  if (src_length < 0) {
+    return Status::Invalid("Input file not exists");
+  }
+  ICEBERG_ASSIGN_OR_RAISE(int64_t dst_length, client_->Head(dst_location, dst));
+  if (dst_length >= 0) {
+    return Status::AlreadyExists("output file ", dst, " already exisits");
+  }
+  const Headers headers = {
+      {"x-amz-copy-source",
+       "/" + src_location.bucket + "/" + UriEncode(src_location.key, true)}};
+  ICEBERG_ASSIGN_OR_RAISE(auto response,
+                          client_->Execute("PUT", dst_location, {}, headers));
+  if (!IsSuccess(response)) {
+    return ResponseError("CopyObject", dst, response);
+  }
+  return Status::OK();
+}
+
+HttpClient::Stats S3FileIO::http_stats() const { return client_->http.stats(); }
+
+const S3FileIOOptions& S3FileIO::options() const { return client_->options; }
+
+}  // namespace io
+}  // namespace iceberg
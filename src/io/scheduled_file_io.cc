@@ -0,0 +1,247 @@
+#include "iceberg/io/scheduled_file_io.hh"
+
+#include <utility>
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+/// The scheduler and class requests on a file are admitted under.
+struct Scheduling {
+  std::shared_ptr<IOScheduler> scheduler;
+  IOClass io_class;
+
+  IOScheduler::Permit Acquire() const { return scheduler->Acquire(io_class); }
+};
+
+class ScheduledInputStream : public SeekableInputStream {
+ public:
+  ScheduledInputStream(std::shared_ptr<SeekableInputStream> base, Scheduling scheduling)
+      : base_(std::move(base)), scheduling_(std::move(scheduling)) {}
+
+  Status Close() override { return base_->Close(); }
+
+  Result<int64_t> Tell() const override { return base_->Tell(); }
+
+  bool closed() const override { return base_->closed(); }
+
+  Status Seek(int64_t position) override { return base_->Seek(position); }
+
+  Result<int64_t> Read(int64_t nbytes, void* out) override {
+    auto permit = scheduling_.Acquire();
+    return base_->Read(nbytes, out);
+  }
+
+  Result<std::shared_ptr<Buffer>> Read(int64_t nbytes) override {
+    auto permit = scheduling_.Acquire();
+    return base_->Read(nbytes);
+  }
+
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override {
+    auto permit = scheduling_.Acquire();
+    return base_->ReadAt(position, nbytes, out);
+  }
+
+  Result<std::shared_ptr<Buffer>> ReadAt(int64_t position, int64_t nbytes) override {
+    auto permit = scheduling_.Acquire();
+    return base_->ReadAt(position, nbytes);
+  }
+
+  std::future<Result<int64_t>> ReadAtAsync(int64_t position, int64_t nbytes,
+                                           void* out) override {
+    return scheduling_.scheduler->Submit(
+        scheduling_.io_class, [base = base_, position, nbytes, out]() {
+          return base->ReadAt(position, nbytes, out);
+        });
+  }
+
+ private:
+  std::shared_ptr<SeekableInputStream> base_;
+  const Scheduling scheduling_;
+};
+
+class ScheduledInputFile : public InputFile {
+ public:
+  ScheduledInputFile(std::shared_ptr<InputFile> base, Scheduling scheduling)
+      : InputFile(base->location()),
+        base_(std::move(base)),
+        scheduling_(std::move(scheduling)) {}
+
+  Result<int64_t> getLength() override {
+    auto permit = scheduling_.Acquire();
+    return base_->getLength();
+  }
+
+  Result<std::shared_ptr<SeekableInputStream>> newStream() override {
+    std::shared_ptr<SeekableInputStream> stream;
+    {
+      auto permit = scheduling_.Acquire();
+      ICEBERG_ASSIGN_OR_RAISE(stream, base_->newStream());
+    }
+    return std::make_shared<ScheduledInputStream>(std::move(stream), scheduling_);
+  }
+
+  bool exists() const override {
+    auto permit = scheduling_.Acquire();
+    return base_->exists();
+  }
+
+ private:
+  std::shared_ptr<InputFile> base_;
+  const Scheduling scheduling_;
+};
+
+class ScheduledOutputStream : public PositionOutputStream {
+ public:
+  ScheduledOutputStream(std::shared_ptr<PositionOutputStream> base, Scheduling scheduling)
+      : base_(std::move(base)), scheduling_(std::move(scheduling)) {}
+
+  Status Close() override {
+    if (base_->closed()) {
+      return Status::OK();
+    }
+    auto permit = scheduling_.Acquire();
+    return base_->Close();
+  }
+
+  Result<int64_t> Tell() const override { return base_->Tell(); }
+
+  bool closed() const override { return base_->closed(); }
+
+  using PositionOutputStream::Write;
+  Status Write(const void* data, int64_t nbytes) override {
+    auto permit = scheduling_.Acquire();
+    return base_->Write(data, nbytes);
+  }
+
+  Status Flush() override {
+    auto permit = scheduling_.Acquire();
+    return base_->Flush();
+  }
+
+  Status Sync() override {
+    auto permit = scheduling_.Acquire();
+    return base_->Sync();
+  }
+
+ private:
+  std::shared_ptr<PositionOutputStream> base_;
+  const Scheduling scheduling_;
+};
+
+class ScheduledOutputFile : public OutputFile {
+ public:
+  ScheduledOutputFile(std::shared_ptr<OutputFile> base, Scheduling scheduling)
+      : OutputFile(base->location()),
+        base_(std::move(base)),
+        scheduling_(std::move(scheduling)) {}
+
+  Result<std::shared_ptr<PositionOutputStream>> create() override {
+    std::shared_ptr<PositionOutputStream> stream;
+    {
+      auto permit = scheduling_.Acquire();
+      ICEBERG_ASSIGN_OR_RAISE(stream, base_->create());
+    }
+    return std::make_shared<ScheduledOutputStream>(std::move(stream), scheduling_);
+  }
+
+  Result<std::shared_ptr<PositionOutputStream>> createOrOverwrite() override {
+    std::shared_ptr<PositionOutputStream> stream;
+    {
+      auto permit = scheduling_.Acquire();
+      ICEBERG_ASSIGN_OR_RAISE(stream, base_->createOrOverwrite());
+    }
+    return std::make_shared<ScheduledOutputStream>(std::move(stream), scheduling_);
+  }
+
+  Result<std::shared_ptr<InputFile>> toInputFile() const override {
+    ICEBERG_ASSIGN_OR_RAISE(auto file, base_->toInputFile());
+    return std::make_shared<ScheduledInputFile>(std::move(file), scheduling_);
+  }
+
+ private:
+  std::shared_ptr<OutputFile> base_;
+  const Scheduling scheduling_;
+};
+
+/// Admits each batch as one request.
+class ScheduledFileInfoIterator : public FileInfoIterator {
+ public:
+  ScheduledFileInfoIterator(std::unique_ptr<FileInfoIterator> base, Scheduling scheduling)
+      : base_(std::move(base)), scheduling_(std::move(scheduling)) {}
+
+  Result<std::vector<FileInfo>> Next() override {
+    auto permit = scheduling_.Acquire();
+    return base_->Next();
+  }
+
+ private:
+  std::unique_ptr<FileInfoIterator> base_;
+  const Scheduling scheduling_;
+};
+
+}  // namespace
+
+ScheduledFileIO::ScheduledFileIO(std::shared_ptr<FileIO> base,
+                                 std::shared_ptr<IOScheduler> scheduler, IOClass io_class)
+    : base_(std::move(base)), scheduler_(std::move(scheduler)), io_class_(io_class) {}
+
+ScheduledFileIO::~ScheduledFileIO() = default;
+
+bool ScheduledFileIO::Equals(const FileIO& other) const {
+  auto scheduled = dynamic_cast<const ScheduledFileIO*>(&other);
+  return scheduled != nullptr && scheduler_ == scheduled->scheduler_ &&
+         io_class_ == scheduled->io_class_ && base_->Equals(*scheduled->base_);
+}
+
+Result<std::shared_ptr<InputFile>> ScheduledFileIO::newInputFile(
+    const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newInputFile(path));
+  return std::make_shared<ScheduledInputFile>(std::move(base),
+                                              Scheduling{scheduler_, io_class_});
+}
+
+Result<std::shared_ptr<InputFile>> ScheduledFileIO::newInputFile(const std::string& path,
+                                                                 int64_t length) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newInputFile(path, length));
+  return std::make_shared<ScheduledInputFile>(std::move(base),
+                                              Scheduling{scheduler_, io_class_});
+}
+
+Result<std::shared_ptr<OutputFile>> ScheduledFileIO::newOutputFile(
+    const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->newOutputFile(path));
+  return std::make_shared<ScheduledOutputFile>(std::move(base),
+                                               Scheduling{scheduler_, io_class_});
+}
+
+Status ScheduledFileIO::DeleteFile(const std::string& path) {
+  auto permit = scheduler_->Acquire(io_class_);
+  return base_->DeleteFile(path);
+}
+
+Result<DeleteFilesResult> ScheduledFileIO::DeleteFiles(
+    const std::vector<std::string>& paths, const DeleteFilesOptions& options) {
+  auto permit = scheduler_->Acquire(io_class_);
+  return base_->DeleteFiles(paths, options);
+}
+
+Result<std::unique_ptr<FileInfoIterator>> ScheduledFileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  ICEBERG_ASSIGN_OR_RAISE(auto base, base_->ListPrefix(prefix, options));
+  return std::make_unique<ScheduledFileInfoIterator>(std::move(base),
+                                                     Scheduling{scheduler_, io_class_});
+}
+
+Status ScheduledFileIO::CopyFile(const std::string& src, const std::string& dst) {
+  auto permit = scheduler_->Acquire(io_class_);
+  return base_->CopyFile(src, dst);
+}
+
+std::shared_ptr<ScheduledFileIO> ScheduledFileIO::WithClass(IOClass io_class) const {
+  return std::make_shared<ScheduledFileIO>(base_, scheduler_, io_class);
+}
+
+}  // namespace io
+}  // namespace iceberg
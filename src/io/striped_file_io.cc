@@ -0,0 +1,457 @@
+#include "iceberg/io/striped_file_io.hh"
+
+#include <sys/statvfs.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <random>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include "iceberg/util/macros.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace internal {
+
+/// The volumes of a StripedFileIO and the mapping of its locations to them.
+class StripedVolumes {
+ public:
+  explicit StripedVolumes(StripedFileIOOptions options)
+      : options_(std::move(options)),
+        local_(std::make_shared<LocalFileIO>(options_.local)) {}
+
+  const StripedFileIOOptions& options() const { return options_; }
+
+  const std::shared_ptr<LocalFileIO>& local() const { return local_; }
+
+  int num_volumes() const { return static_cast<int>(options_.volumes.size()); }
+
+  // The location of `path` relative to the root, starting with '/'
+  Result<std::string> Relative(const std::string& path) const {
+    const std::string& root = options_.root;
+    if (path.compare(0, root.size(), root) != 0 ||
+        (path.size() > root.size() && path[root.size()] != '/')) {
+      return Status::Invalid("Location '", path, "' is not under the striped root '",
+                             root, "'");
+    }
+    return path.substr(root.size());
+  }
+
+  std::string PhysicalPath(int volume, const std::string& relative) const {
+    return options_.volumes[volume] + relative;
+  }
+
+  std::string LogicalPath(int volume, const std::string& physical) const {
+    return options_.root + physical.substr(options_.volumes[volume].size());
+  }
+
+  // The volume holding the file, looked up on the volumes if not mapped yet
+  std::optional<int> Locate(const std::string& path, const std::string& relative) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = locations_.find(path);
+      if (it != locations_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+        return it->second.volume;
+      }
+    }
+    const int first = PinnedVolume(relative).value_or(0);
+    for (int i = 0; i < num_volumes(); ++i) {
+      const int volume = (first + i) % num_volumes();
+      if (ExistsOn(volume, relative)) {
+        Remember(path, volume);
+        return volume;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // The path to read the file from. A missing file is looked for where it would be
+  // pinned, so that reading it fails the usual way.
+  Result<std::string> InputPath(const std::string& path) {
+    ICEBERG_ASSIGN_OR_RAISE(auto relative, Relative(path));
+    const int volume =
+        Locate(path, relative).value_or(PinnedVolume(relative).value_or(0));
+    return PhysicalPath(volume, relative);
+  }
+
+  // Whether another volume than `volume` holds the file
+  bool ExistsElsewhere(int volume, const std::string& relative) const {
+    for (int i = 0; i < num_volumes(); ++i) {
+      if (i != volume && ExistsOn(i, relative)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // The volume the metadata file is pinned to, if any
+  std::optional<int> PinnedVolume(const std::string& relative) const {
+    if (options_.metadata_volume.has_value() &&
+        relative.find("/metadata/") != std::string::npos) {
+      return options_.metadata_volume;
+    }
+    return std::nullopt;
+  }
+
+  // The volume a new file is placed on
+  int Place(const std::string& relative) {
+    auto pinned = PinnedVolume(relative);
+    if (pinned.has_value()) {
+      return *pinned;
+    }
+    if (options_.placement == VolumePlacement::FREE_SPACE) {
+      auto volume = PlaceByFreeSpace();
+      if (volume.has_value()) {
+        return *volume;
+      }
+    }
+    return static_cast<int>(next_volume_.fetch_add(1, std::memory_order_relaxed) %
+                            options_.volumes.size());
+  }
+
+  void Remember(const std::string& path, int volume) {
+    if (options_.max_remembered_locations == 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = locations_.find(path);
+    if (it != locations_.end()) {
+      it->second.volume = volume;
+      lru_.splice(lru_.begin(), lru_, it->second.lru);
+      return;
+    }
+    if (locations_.size() >= options_.max_remembered_locations) {
+      // The volumes still hold the forgotten location; Locate finds it there again
+      locations_.erase(lru_.back());
+      lru_.pop_back();
+    }
+    lru_.push_front(path);
+    locations_.emplace(path, Location{volume, lru_.begin()});
+  }
+
+  void Forget(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = locations_.find(path);
+    if (it != locations_.end()) {
+      lru_.erase(it->second.lru);
+      locations_.erase(it);
+    }
+  }
+
+ private:
+  bool ExistsOn(int volume, const std::string& relative) const {
+    std::error_code ec;
+    return std::filesystem::is_regular_file(PhysicalPath(volume, relative), ec);
+  }
+
+  // The available space of each volume, read again once older than the refresh interval
+  std::vector<uint64_t> AvailableSpace() {
+    std::lock_guard<std::mutex> lock(free_space_mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    if (available_.empty() || now - available_at_ >= options_.free_space_refresh) {
+      available_.assign(options_.volumes.size(), 0);
+      for (size_t i = 0; i < available_.size(); ++i) {
+        struct statvfs stats;
+        if (statvfs(options_.volumes[i].c_str(), &stats) == 0) {
+          available_[i] = static_cast<uint64_t>(stats.f_bavail) * stats.f_frsize;
+        }
+      }
+      available_at_ = now;
+    }
+    return available_;
+  }
+
+  // Fall back to round robin when no volume reports available space
+  std::optional<int> PlaceByFreeSpace() {
+    const std::vector<uint64_t> available = AvailableSpace();
+    uint64_t total = 0;
+    for (uint64_t bytes : available) {
+      total += bytes;
+    }
+    if (total == 0) {
+      return std::nullopt;
+    }
+    thread_local std::mt19937_64 rng{std::random_device{}()};
+    uint64_t point = std::uniform_int_distribution<uint64_t>(0, total - 1)(rng);
+    for (size_t i = 0; i < available.size(); ++i) {
+      if (point < available[i]) {
+        return static_cast<int>(i);
+      }
+      point -= available[i];
+    }
+    return std::nullopt;
+  }
+
+  const StripedFileIOOptions options_;
+  const std::shared_ptr<LocalFileIO> local_;
+  std::atomic<uint64_t> next_volume_{0};
+
+  std::mutex free_space_mutex_;
+  std::vector<uint64_t> available_;
+  std::chrono::steady_clock::time_point available_at_;
+
+  struct Location {
+    int volume;
+    std::list<std::string>::iterator lru;
+  };
+
+  std::mutex mutex_;
+  // Logical location to volume, bounded by max_remembered_locations
+  std::unordered_map<std::string, Location> locations_;
+  // Remembered locations, most recently used first
+  std::list<std::string> lru_;
+};
+
+}  // namespace internal
+
+namespace {
+
+using internal::StripedVolumes;
+
+// Trims trailing slashes, but keeps "/" itself
+std::string TrimDirectory(std::string path) {
+  while (path.size() > 1 && path.back() == '/') {
+    path.pop_back();
+  }
+  return path;
+}
+
+/// Reports the logical location of a file on a volume.
+class StripedInputFile : public InputFile {
+ public:
+  StripedInputFile(std::string location, std::shared_ptr<InputFile> base)
+      : InputFile(std::move(location)), base_(std::move(base)) {}
+
+  Result<int64_t> getLength() override { return base_->getLength(); }
+
+  Result<std::shared_ptr<SeekableInputStream>> newStream() override {
+    return base_->newStream();
+  }
+
+  bool exists() const override { return base_->exists(); }
+
+ private:
+  std::shared_ptr<InputFile> base_;
+};
+
+class StripedOutputFile : public OutputFile {
+ public:
+  StripedOutputFile(std::string location, std::string relative, int volume,
+                    std::shared_ptr<StripedVolumes> volumes)
+      : OutputFile(std::move(location)),
+        relative_(std::move(relative)),
+        volume_(volume),
+        volumes_(std::move(volumes)) {}
+
+  Result<std::shared_ptr<PositionOutputStream>> create() override {
+    ICEBERG_ASSIGN_OR_RAISE(auto file, PrepareFile());
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, file->create());
+    // A racing creator may have placed the file on another volume. Each creator checks
+    // only after creating its own, so at most one of them finds no other.
+    if (volumes_->ExistsElsewhere(volume_, relative_)) {
+      ICEBERG_UNUSED(stream->Close());
+      ICEBERG_UNUSED(volumes_->local()->DeleteFile(file->location()));
+      return Status::AlreadyExists("output file ", location(), " already exisits");
+    }
+    volumes_->Remember(location(), volume_);
+    return stream;
+  }
+
+  Result<std::shared_ptr<PositionOutputStream>> createOrOverwrite() override {
+    ICEBERG_ASSIGN_OR_RAISE(auto file, PrepareFile());
+    ICEBERG_ASSIGN_OR_RAISE(auto stream, file->createOrOverwrite());
+    volumes_->Remember(location(), volume_);
+    return stream;
+  }
+
+  Result<std::shared_ptr<InputFile>> toInputFile() const override {
+    ICEBERG_ASSIGN_OR_RAISE(
+        auto file,
+        volumes_->local()->newInputFile(volumes_->PhysicalPath(volume_, relative_)));
+    return std::make_shared<StripedInputFile>(location(), std::move(file));
+  }
+
+ private:
+  // Make the parent directory on the volume, which may not have the table's yet
+  Result<std::shared_ptr<OutputFile>> PrepareFile() {
+    const std::filesystem::path path = volumes_->PhysicalPath(volume_, relative_);
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (ec) {
+      return Status::IOError("Failed to create directory '", path.parent_path().string(),
+                             "': ", ec.message());
+    }
+    return volumes_->local()->newOutputFile(path.string());
+  }
+
+  const std::string relative_;
+  const int volume_;
+  std::shared_ptr<StripedVolumes> volumes_;
+};
+
+/// Lists the volumes one after the other. The listings all start up front, so that the
+/// volumes are walked in parallel.
+class StripedFileInfoIterator : public FileInfoIterator {
+ public:
+  StripedFileInfoIterator(std::vector<std::unique_ptr<FileInfoIterator>> listings,
+                          std::shared_ptr<StripedVolumes> volumes)
+      : listings_(std::move(listings)), volumes_(std::move(volumes)) {}
+
+  Result<std::vector<FileInfo>> Next() override {
+    for (; current_ < listings_.size(); ++current_) {
+      ICEBERG_ASSIGN_OR_RAISE(auto batch, listings_[current_]->Next());
+      if (batch.empty()) {
+        // Stop the finished listing early
+        listings_[current_].reset();
+        continue;
+      }
+      std::vector<FileInfo> infos;
+      infos.reserve(batch.size());
+      const int volume = static_cast<int>(current_);
+      for (const auto& info : batch) {
+        infos.emplace_back(volumes_->LogicalPath(volume, info.location()), info.size(),
+                           info.createdAtMillis());
+      }
+      return infos;
+    }
+    return std::vector<FileInfo>{};
+  }
+
+ private:
+  std::vector<std::unique_ptr<FileInfoIterator>> listings_;
+  size_t current_ = 0;
+  std::shared_ptr<StripedVolumes> volumes_;
+};
+
+}  // namespace
+
+Result<std::shared_ptr<StripedFileIO>> StripedFileIO::Make(StripedFileIOOptions options) {
+  if (options.volumes.empty()) {
+    return Status::Invalid("A striped FileIO needs at least one volume");
+  }
+  if (options.root.empty() || options.root[0] != '/') {
+    return Status::Invalid("Invalid striped root: '", options.root, "'");
+  }
+  const int num_volumes = static_cast<int>(options.volumes.size());
+  if (options.metadata_volume.has_value() &&
+      (*options.metadata_volume < 0 || *options.metadata_volume >= num_volumes)) {
+    return Status::Invalid("Invalid metadata volume: ", *options.metadata_volume);
+  }
+  options.root = TrimDirectory(std::move(options.root));
+  if (options.root == "/") {
+    options.root.clear();
+  }
+  for (auto& volume : options.volumes) {
+    volume = TrimDirectory(std::move(volume));
+    std::error_code ec;
+    if (!std::filesystem::is_directory(volume, ec)) {
+      return Status::Invalid("Volume '", volume, "' is not a directory");
+    }
+  }
+  return std::shared_ptr<StripedFileIO>(
+      new StripedFileIO(std::make_shared<StripedVolumes>(std::move(options))));
+}
+
+StripedFileIO::StripedFileIO(std::shared_ptr<internal::StripedVolumes> volumes)
+    : volumes_(std::move(volumes)) {}
+
+StripedFileIO::~StripedFileIO() = default;
+
+const StripedFileIOOptions& StripedFileIO::options() const {
+  return volumes_->options();
+}
+
+bool StripedFileIO::Equals(const FileIO& other) const {
+  auto striped = dynamic_cast<const StripedFileIO*>(&other);
+  return striped != nullptr && volumes_ == striped->volumes_;
+}
+
+Result<std::shared_ptr<InputFile>> StripedFileIO::newInputFile(const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto physical, volumes_->InputPath(path));
+  ICEBERG_ASSIGN_OR_RAISE(auto file, volumes_->local()->newInputFile(physical));
+  return std::make_shared<StripedInputFile>(path, std::move(file));
+}
+
+Result<std::shared_ptr<InputFile>> StripedFileIO::newInputFile(const std::string& path,
+                                                               int64_t length) {
+  ICEBERG_ASSIGN_OR_RAISE(auto physical, volumes_->InputPath(path));
+  ICEBERG_ASSIGN_OR_RAISE(auto file, volumes_->local()->newInputFile(physical, length));
+  return std::make_shared<StripedInputFile>(path, std::move(file));
+}
+
+Result<std::shared_ptr<OutputFile>> StripedFileIO::newOutputFile(
+    const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto relative, volumes_->Relative(path));
+  auto volume = volumes_->Locate(path, relative);
+  if (!volume.has_value()) {
+    volume = volumes_->Place(relative);
+  }
+  return std::make_shared<StripedOutputFile>(path, std::move(relative), *volume,
+                                             volumes_);
+}
+
+Status StripedFileIO::DeleteFile(const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto relative, volumes_->Relative(path));
+  auto volume = volumes_->Locate(path, relative);
+  if (!volume.has_value()) {
+    return Status::IOError("Delete file '", path, "' failed, no volume holds it");
+  }
+  volumes_->Forget(path);
+  return volumes_->local()->DeleteFile(volumes_->PhysicalPath(*volume, relative));
+}
+
+Result<std::unique_ptr<FileInfoIterator>> StripedFileIO::ListPrefix(
+    const std::string& prefix, const ListPrefixOptions& options) {
+  ICEBERG_ASSIGN_OR_RAISE(auto relative, volumes_->Relative(prefix));
+  if (relative.empty()) {
+    // The root itself is a partial name in its parent directory; list all of it
+    relative = "/";
+  }
+  std::vector<std::unique_ptr<FileInfoIterator>> listings;
+  for (int i = 0; i < volumes_->num_volumes(); ++i) {
+    ICEBERG_ASSIGN_OR_RAISE(
+        auto listing,
+        volumes_->local()->ListPrefix(volumes_->PhysicalPath(i, relative), options));
+    listings.push_back(std::move(listing));
+  }
+  return std::make_unique<StripedFileInfoIterator>(std::move(listings), volumes_);
+}
+
+Status StripedFileIO::CopyFile(const std::string& src, const std::string& dst) {
+  ICEBERG_ASSIGN_OR_RAISE(auto src_relative, volumes_->Relative(src));
+  ICEBERG_ASSIGN_OR_RAISE(auto dst_relative, volumes_->Relative(dst));
+  auto src_volume = volumes_->Locate(src, src_relative);
+  if (!src_volume.has_value()) {
+    return Status::Invalid("Input file not exists: ", src);
+  }
+  if (volumes_->Locate(dst, dst_relative).has_value()) {
+    return Status::AlreadyExists("output file ", dst, " already exisits");
+  }
+  const int dst_volume = volumes_->PinnedVolume(dst_relative).value_or(*src_volume);
+  const std::filesystem::path dst_path = volumes_->PhysicalPath(dst_volume, dst_relative);
+  std::error_code ec;
+  std::filesystem::create_directories(dst_path.parent_path(), ec);
+  if (ec) {
+    return Status::IOError("Failed to create directory '",
+                           dst_path.parent_path().string(), "': ", ec.message());
+  }
+  ICEBERG_RETURN_NOT_OK(volumes_->local()->CopyFile(
+      volumes_->PhysicalPath(*src_volume, src_relative), dst_path.string()));
+  volumes_->Remember(dst, dst_volume);
+  return Status::OK();
+}
+
+Result<std::optional<int>> StripedFileIO::VolumeOf(const std::string& path) {
+  ICEBERG_ASSIGN_OR_RAISE(auto relative, volumes_->Relative(path));
+  return volumes_->Locate(path, relative);
+}
+
+}  // namespace io
+}  // namespace iceberg
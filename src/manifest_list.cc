@@ -0,0 +1,455 @@
+#include "iceberg/manifest_list.hh"
+
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "iceberg/avro/file_reader.hh"
+#include "iceberg/avro/projection.hh"
+
+namespace iceberg {
+namespace table {
+
+namespace {
+
+// What to do with a field of the writer's manifest_file record
+enum class Target : int8_t {
+  SKIP,
+  MANIFEST_PATH,
+  MANIFEST_LENGTH,
+  PARTITION_SPEC_ID,
+  CONTENT,
+  SEQUENCE_NUMBER,
+  MIN_SEQUENCE_NUMBER,
+  ADDED_SNAPSHOT_ID,
+  ADDED_FILES_COUNT,
+  EXISTING_FILES_COUNT,
+  DELETED_FILES_COUNT,
+  ADDED_ROWS_COUNT,
+  EXISTING_ROWS_COUNT,
+  DELETED_ROWS_COUNT,
+  PARTITIONS,
+  NUM_TARGETS,
+};
+
+// What to do with a field of the writer's field_summary record
+enum class SummaryTarget : int8_t {
+  SKIP,
+  CONTAINS_NULL,
+  CONTAINS_NAN,
+  LOWER_BOUND,
+  UPPER_BOUND,
+};
+
+struct KnownField {
+  int32_t field_id;
+  const char* name;
+  // The name of the field in version 1, if different
+  const char* v1_name;
+  Target target;
+};
+
+// The fields of manifest_file, from the Iceberg spec
+constexpr KnownField kManifestFileFields[] = {
+    {500, "manifest_path", nullptr, Target::MANIFEST_PATH},
+    {501, "manifest_length", nullptr, Target::MANIFEST_LENGTH},
+    {502, "partition_spec_id", nullptr, Target::PARTITION_SPEC_ID},
+    {517, "content", nullptr, Target::CONTENT},
+    {515, "sequence_number", nullptr, Target::SEQUENCE_NUMBER},
+    {516, "min_sequence_number", nullptr, Target::MIN_SEQUENCE_NUMBER},
+    {503, "added_snapshot_id", nullptr, Target::ADDED_SNAPSHOT_ID},
+    {504, "added_files_count", "added_data_files_count", Target::ADDED_FILES_COUNT},
+    {505, "existing_files_count", "existing_data_files_count",
+     Target::EXISTING_FILES_COUNT},
+    {506, "deleted_files_count", "deleted_data_files_count", Target::DELETED_FILES_COUNT},
+    {512, "added_rows_count", nullptr, Target::ADDED_ROWS_COUNT},
+    {513, "existing_rows_count", nullptr, Target::EXISTING_ROWS_COUNT},
+    {514, "deleted_rows_count", nullptr, Target::DELETED_ROWS_COUNT},
+    {507, "partitions", nullptr, Target::PARTITIONS},
+};
+
+struct KnownSummaryField {
+  int32_t field_id;
+  const char* name;
+  SummaryTarget target;
+};
+
+constexpr KnownSummaryField kFieldSummaryFields[] = {
+    {509, "contains_null", SummaryTarget::CONTAINS_NULL},
+    {518, "contains_nan", SummaryTarget::CONTAINS_NAN},
+    {510, "lower_bound", SummaryTarget::LOWER_BOUND},
+    {511, "upper_bound", SummaryTarget::UPPER_BOUND},
+};
+
+bool IsProjected(Target target, const ManifestListProjection& projection) {
+  switch (target) {
+    case Target::MANIFEST_PATH:
+      return projection.manifest_path;
+    case Target::MANIFEST_LENGTH:
+      return projection.manifest_length;
+    case Target::PARTITION_SPEC_ID:
+      return projection.partition_spec_id;
+    case Target::CONTENT:
+      return projection.content;
+    case Target::SEQUENCE_NUMBER:
+    case Target::MIN_SEQUENCE_NUMBER:
+      return projection.sequence_numbers;
+    case Target::ADDED_SNAPSHOT_ID:
+      return projection.added_snapshot_id;
+    case Target::ADDED_FILES_COUNT:
+    case Target::EXISTING_FILES_COUNT:
+    case Target::DELETED_FILES_COUNT:
+    case Target::ADDED_ROWS_COUNT:
+    case Target::EXISTING_ROWS_COUNT:
+    case Target::DELETED_ROWS_COUNT:
+      return projection.counts;
+    case Target::PARTITIONS:
+      return projection.partitions;
+    default:
+      return false;
+  }
+}
+
+// Match a field of a writer's record to a known field by field id, or by name if it has
+// none
+template <typename Known, size_t N>
+const Known* MatchField(const ::avro::NodePtr& record, size_t index,
+                        const Known (&known)[N]) {
+  const std::optional<int32_t> field_id = avro::FieldId(record, index);
+  const std::string& name = record->nameAt(index);
+  for (const auto& candidate : known) {
+    if (field_id.has_value() ? *field_id == candidate.field_id
+                             : name == candidate.name) {
+      return &candidate;
+    }
+  }
+  if (!field_id.has_value()) {
+    if constexpr (std::is_same_v<Known, KnownField>) {
+      for (const auto& candidate : known) {
+        if (candidate.v1_name != nullptr && name == candidate.v1_name) {
+          return &candidate;
+        }
+      }
+    }
+  }
+  return nullptr;
+}
+
+Status CheckType(const avro::UnwrappedSchema& value, const std::string& name,
+                 std::initializer_list<::avro::Type> accepted) {
+  for (auto type : accepted) {
+    if (value.node->type() == type) {
+      return Status::OK();
+    }
+  }
+  return Status::Invalid("Unexpected Avro type ", ::avro::toString(value.node->type()),
+                         " of manifest list field ", name);
+}
+
+template <typename T>
+Status AppendInt(int64_t value, const char* name, std::vector<T>* column) {
+  if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+    return Status::Invalid("Manifest list field ", name, " out of range: ", value);
+  }
+  column->push_back(static_cast<T>(value));
+  return Status::OK();
+}
+
+}  // namespace
+
+struct ManifestListReader::Plan {
+  struct Step {
+    Target target;
+    ::avro::NodePtr writer;
+    avro::UnwrappedSchema value;
+  };
+
+  struct SummaryStep {
+    SummaryTarget target;
+    ::avro::NodePtr writer;
+    avro::UnwrappedSchema value;
+  };
+
+  std::vector<Step> steps;
+  std::vector<SummaryStep> summary_steps;
+  // Projected targets the writer's schema lacks, filled with their defaults
+  std::vector<Target> defaulted;
+  // Strings and bytes of the manifest being decoded
+  std::string bytes;
+  std::string lower;
+  std::string upper;
+
+  static Result<std::unique_ptr<Plan>> Make(const ::avro::ValidSchema& schema,
+                                            const ManifestListProjection& projection);
+
+  Status DecodeSummaries(::avro::Decoder* decoder, const Step& step,
+                         PartitionSummaryColumns* out);
+
+  Status Decode(::avro::Decoder* decoder, ManifestListColumns* out);
+};
+
+Result<std::unique_ptr<ManifestListReader::Plan>> ManifestListReader::Plan::Make(
+    const ::avro::ValidSchema& schema, const ManifestListProjection& projection) {
+  const ::avro::NodePtr record = avro::Resolve(schema.root());
+  if (record->type() != ::avro::AVRO_RECORD) {
+    return Status::Invalid("Manifest list schema is not a record");
+  }
+  auto plan = std::make_unique<Plan>();
+  bool present[static_cast<int>(Target::NUM_TARGETS)] = {};
+  for (size_t i = 0; i < record->leaves(); ++i) {
+    const std::string& name = record->nameAt(i);
+    Step step{Target::SKIP, record->leafAt(i), avro::UnwrapOptional(record->leafAt(i))};
+    const KnownField* known = MatchField(record, i, kManifestFileFields);
+    if (known != nullptr && IsProjected(known->target, projection)) {
+      step.target = known->target;
+      present[static_cast<int>(step.target)] = true;
+      if (step.target == Target::MANIFEST_PATH) {
+        ICEBERG_RETURN_NOT_OK(CheckType(step.value, name, {::avro::AVRO_STRING}));
+      } else if (step.target == Target::PARTITIONS) {
+        ICEBERG_RETURN_NOT_OK(CheckType(step.value, name, {::avro::AVRO_ARRAY}));
+        const ::avro::NodePtr summary = avro::Resolve(step.value.node->leafAt(0));
+        // Every summary takes at least a byte, which bounds the count of a corrupt block
+        if (summary->type() != ::avro::AVRO_RECORD || avro::IsZeroWidth(summary)) {
+          return Status::Invalid("Manifest list partition summaries are not records");
+        }
+        for (size_t j = 0; j < summary->leaves(); ++j) {
+          const std::string& summary_name = summary->nameAt(j);
+          SummaryStep summary_step{SummaryTarget::SKIP, summary->leafAt(j),
+                                   avro::UnwrapOptional(summary->leafAt(j))};
+          if (const auto* known_summary = MatchField(summary, j, kFieldSummaryFields)) {
+            summary_step.target = known_summary->target;
+            if (summary_step.target == SummaryTarget::CONTAINS_NULL ||
+                summary_step.target == SummaryTarget::CONTAINS_NAN) {
+              ICEBERG_RETURN_NOT_OK(
+                  CheckType(summary_step.value, summary_name, {::avro::AVRO_BOOL}));
+            } else {
+              ICEBERG_RETURN_NOT_OK(CheckType(summary_step.value, summary_name,
+                                              {::avro::AVRO_BYTES, ::avro::AVRO_FIXED}));
+            }
+          }
+          plan->summary_steps.push_back(summary_step);
+        }
+      } else {
+        ICEBERG_RETURN_NOT_OK(
+            CheckType(step.value, name, {::avro::AVRO_INT, ::avro::AVRO_LONG}));
+      }
+    }
+    plan->steps.push_back(step);
+  }
+  for (const auto& known : kManifestFileFields) {
+    if (!IsProjected(known.target, projection) ||
+        present[static_cast<int>(known.target)]) {
+      continue;
+    }
+    switch (known.target) {
+      case Target::MANIFEST_PATH:
+      case Target::MANIFEST_LENGTH:
+      case Target::PARTITION_SPEC_ID:
+      case Target::ADDED_SNAPSHOT_ID:
+        return Status::Invalid("Manifest list without required field ", known.name);
+      default:
+        plan->defaulted.push_back(known.target);
+    }
+  }
+  return plan;
+}
+
+Status ManifestListReader::Plan::DecodeSummaries(::avro::Decoder* decoder,
+                                                 const Step& step,
+                                                 PartitionSummaryColumns* out) {
+  bool present;
+  ICEBERG_RETURN_NOT_OK(avro::ReadPresence(decoder, step.value, &present));
+  for (size_t n = present ? decoder->arrayStart() : 0; n != 0; n = decoder->arrayNext()) {
+    for (size_t i = 0; i < n; ++i) {
+      // Unknown containment is recorded as containing nulls, which prunes nothing
+      int64_t contains_null = 1;
+      int64_t contains_nan = -1;
+      bool has_lower = false, has_upper = false;
+      for (const auto& summary_step : summary_steps) {
+        bool value_present;
+        switch (summary_step.target) {
+          case SummaryTarget::SKIP:
+            ICEBERG_RETURN_NOT_OK(avro::Skip(decoder, summary_step.writer));
+            break;
+          case SummaryTarget::CONTAINS_NULL:
+            ICEBERG_RETURN_NOT_OK(avro::ReadOptionalLong(decoder, summary_step.value,
+                                                         &value_present, &contains_null));
+            break;
+          case SummaryTarget::CONTAINS_NAN:
+            ICEBERG_RETURN_NOT_OK(avro::ReadOptionalLong(decoder, summary_step.value,
+                                                         &value_present, &contains_nan));
+            break;
+          case SummaryTarget::LOWER_BOUND:
+            ICEBERG_RETURN_NOT_OK(avro::ReadOptionalBytes(decoder, summary_step.value,
+                                                          &has_lower, &lower));
+            break;
+          case SummaryTarget::UPPER_BOUND:
+            ICEBERG_RETURN_NOT_OK(avro::ReadOptionalBytes(decoder, summary_step.value,
+                                                          &has_upper, &upper));
+            break;
+        }
+      }
+      out->contains_null.push_back(static_cast<uint8_t>(contains_null));
+      out->contains_nan.push_back(static_cast<int8_t>(contains_nan));
+      has_lower ? out->lower_bound.Append(lower) : out->lower_bound.AppendNull();
+      has_upper ? out->upper_bound.Append(upper) : out->upper_bound.AppendNull();
+    }
+  }
+  out->offsets.push_back(static_cast<int64_t>(out->contains_null.size()));
+  return Status::OK();
+}
+
+Status ManifestListReader::Plan::Decode(::avro::Decoder* decoder,
+                                        ManifestListColumns* out) {
+  for (const auto& step : steps) {
+    bool present;
+    int64_t value = -1;
+    switch (step.target) {
+      case Target::SKIP:
+        ICEBERG_RETURN_NOT_OK(avro::Skip(decoder, step.writer));
+        continue;
+      case Target::MANIFEST_PATH:
+        ICEBERG_RETURN_NOT_OK(
+            avro::ReadOptionalBytes(decoder, step.value, &present, &bytes));
+        present ? out->manifest_path.Append(bytes) : out->manifest_path.AppendNull();
+        continue;
+      case Target::PARTITIONS:
+        ICEBERG_RETURN_NOT_OK(DecodeSummaries(decoder, step, &out->partitions));
+        continue;
+      default:
+        break;
+    }
+    ICEBERG_RETURN_NOT_OK(avro::ReadOptionalLong(decoder, step.value, &present, &value));
+    switch (step.target) {
+      case Target::MANIFEST_LENGTH:
+        out->manifest_length.push_back(value);
+        break;
+      case Target::PARTITION_SPEC_ID:
+        ICEBERG_RETURN_NOT_OK(
+            AppendInt(value, "partition_spec_id", &out->partition_spec_id));
+        break;
+      case Target::CONTENT:
+        if (present && value != 0 && value != 1) {
+          return Status::Invalid("Invalid manifest content: ", value);
+        }
+        out->content.push_back(value == 1 ? ManifestContent::DELETES
+                                          : ManifestContent::DATA);
+        break;
+      case Target::SEQUENCE_NUMBER:
+        out->sequence_number.push_back(present ? value : 0);
+        break;
+      case Target::MIN_SEQUENCE_NUMBER:
+        out->min_sequence_number.push_back(present ? value : 0);
+        break;
+      case Target::ADDED_SNAPSHOT_ID:
+        out->added_snapshot_id.push_back(value);
+        break;
+      case Target::ADDED_FILES_COUNT:
+        ICEBERG_RETURN_NOT_OK(AppendInt(value, "added_files_count",
+                                        &out->added_files_count));
+        break;
+      case Target::EXISTING_FILES_COUNT:
+        ICEBERG_RETURN_NOT_OK(AppendInt(value, "existing_files_count",
+                                        &out->existing_files_count));
+        break;
+      case Target::DELETED_FILES_COUNT:
+        ICEBERG_RETURN_NOT_OK(AppendInt(value, "deleted_files_count",
+                                        &out->deleted_files_count));
+        break;
+      case Target::ADDED_ROWS_COUNT:
+        out->added_rows_count.push_back(value);
+        break;
+      case Target::EXISTING_ROWS_COUNT:
+        out->existing_rows_count.push_back(value);
+        break;
+      case Target::DELETED_ROWS_COUNT:
+        out->deleted_rows_count.push_back(value);
+        break;
+      default:
+        break;
+    }
+  }
+  for (Target target : defaulted) {
+    switch (target) {
+      case Target::CONTENT:
+        out->content.push_back(ManifestContent::DATA);
+        break;
+      case Target::SEQUENCE_NUMBER:
+        out->sequence_number.push_back(0);
+        break;
+      case Target::MIN_SEQUENCE_NUMBER:
+        out->min_sequence_number.push_back(0);
+        break;
+      case Target::ADDED_FILES_COUNT:
+        out->added_files_count.push_back(-1);
+        break;
+      case Target::EXISTING_FILES_COUNT:
+        out->existing_files_count.push_back(-1);
+        break;
+      case Target::DELETED_FILES_COUNT:
+        out->deleted_files_count.push_back(-1);
+        break;
+      case Target::ADDED_ROWS_COUNT:
+        out->added_rows_count.push_back(-1);
+        break;
+      case Target::EXISTING_ROWS_COUNT:
+        out->existing_rows_count.push_back(-1);
+        break;
+      case Target::DELETED_ROWS_COUNT:
+        out->deleted_rows_count.push_back(-1);
+        break;
+      case Target::PARTITIONS:
+        out->partitions.offsets.push_back(out->partitions.offsets.back());
+        break;
+      default:
+        break;
+    }
+  }
+  return Status::OK();
+}
+
+ManifestListReader::ManifestListReader(std::unique_ptr<avro::FileReader> file,
+                                       ManifestListProjection projection,
+                                       std::unique_ptr<Plan> plan)
+    : file_(std::move(file)), projection_(projection), plan_(std::move(plan)) {}
+
+ManifestListReader::~ManifestListReader() = default;
+
+Result<std::unique_ptr<ManifestListReader>> ManifestListReader::Open(
+    const std::shared_ptr<io::InputFile>& file, ManifestListProjection projection) {
+  ICEBERG_ASSIGN_OR_RAISE(auto reader, avro::FileReader::Open(file));
+  ICEBERG_ASSIGN_OR_RAISE(auto plan, Plan::Make(reader->schema(), projection));
+  return std::unique_ptr<ManifestListReader>(
+      new ManifestListReader(std::move(reader), projection, std::move(plan)));
+}
+
+Result<std::unique_ptr<ManifestListReader>> ManifestListReader::Open(
+    io::FileIO& file_io, const std::string& path, ManifestListProjection projection) {
+  ICEBERG_ASSIGN_OR_RAISE(auto file, file_io.newInputFile(path));
+  return Open(file, projection);
+}
+
+Result<int64_t> ManifestListReader::ReadBatch(ManifestListColumns* out) {
+  ICEBERG_ASSIGN_OR_RAISE(auto num_rows,
+                          file_->ReadBlock([this, out](::avro::Decoder* decoder) {
+                            return plan_->Decode(decoder, out);
+                          }));
+  out->num_rows += num_rows;
+  return num_rows;
+}
+
+Result<ManifestListColumns> ManifestListReader::ReadAll() {
+  ManifestListColumns columns;
+  while (true) {
+    ICEBERG_ASSIGN_OR_RAISE(auto num_rows, ReadBatch(&columns));
+    if (num_rows == 0) {
+      return columns;
+    }
+  }
+}
+
+}  // namespace table
+}  // namespace iceberg
@@ -0,0 +1,552 @@
+#include "iceberg/manifest_reader.hh"
+
+#include <algorithm>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "iceberg/avro/file_reader.hh"
+#include "iceberg/avro/projection.hh"
+
+namespace iceberg {
+namespace table {
+
+namespace {
+
+// What to do with a field of the writer's manifest_entry record
+enum class EntryTarget : int8_t {
+  SKIP,
+  STATUS,
+  SNAPSHOT_ID,
+  SEQUENCE_NUMBER,
+  FILE_SEQUENCE_NUMBER,
+  DATA_FILE,
+};
+
+// What to do with a field of the writer's data_file record. The metrics maps come last,
+// in the order of their Metric.
+enum class FileTarget : int8_t {
+  SKIP,
+  CONTENT,
+  FILE_PATH,
+  FILE_FORMAT,
+  PARTITION,
+  RECORD_COUNT,
+  FILE_SIZE_IN_BYTES,
+  COLUMN_SIZES,
+  VALUE_COUNTS,
+  NULL_VALUE_COUNTS,
+  NAN_VALUE_COUNTS,
+  LOWER_BOUNDS,
+  UPPER_BOUNDS,
+};
+
+// The metrics maps; the first kNumCountMetrics have long values, the others bounds
+enum Metric : int8_t {
+  COLUMN_SIZE = 0,
+  VALUE_COUNT,
+  NULL_VALUE_COUNT,
+  NAN_VALUE_COUNT,
+  LOWER_BOUND,
+  UPPER_BOUND,
+};
+
+constexpr int kNumCountMetrics = 4;
+
+template <typename Target>
+struct KnownField {
+  int32_t field_id;
+  const char* name;
+  Target target;
+};
+
+// The fields of manifest_entry and data_file, from the Iceberg spec
+constexpr KnownField<EntryTarget> kEntryFields[] = {
+    {0, "status", EntryTarget::STATUS},
+    {1, "snapshot_id", EntryTarget::SNAPSHOT_ID},
+    {3, "sequence_number", EntryTarget::SEQUENCE_NUMBER},
+    {4, "file_sequence_number", EntryTarget::FILE_SEQUENCE_NUMBER},
+    {2, "data_file", EntryTarget::DATA_FILE},
+};
+
+constexpr KnownField<FileTarget> kDataFileFields[] = {
+    {134, "content", FileTarget::CONTENT},
+    {100, "file_path", FileTarget::FILE_PATH},
+    {101, "file_format", FileTarget::FILE_FORMAT},
+    {102, "partition", FileTarget::PARTITION},
+    {103, "record_count", FileTarget::RECORD_COUNT},
+    {104, "file_size_in_bytes", FileTarget::FILE_SIZE_IN_BYTES},
+    {108, "column_sizes", FileTarget::COLUMN_SIZES},
+    {109, "value_counts", FileTarget::VALUE_COUNTS},
+    {110, "null_value_counts", FileTarget::NULL_VALUE_COUNTS},
+    {137, "nan_value_counts", FileTarget::NAN_VALUE_COUNTS},
+    {125, "lower_bounds", FileTarget::LOWER_BOUNDS},
+    {128, "upper_bounds", FileTarget::UPPER_BOUNDS},
+};
+
+// Match a field of a writer's record by field id, or by name if it has none
+template <typename Target, size_t N>
+Target MatchField(const ::avro::NodePtr& record, size_t index,
+                  const KnownField<Target> (&known)[N]) {
+  const std::optional<int32_t> field_id = avro::FieldId(record, index);
+  const std::string& name = record->nameAt(index);
+  for (const auto& candidate : known) {
+    if (field_id.has_value() ? *field_id == candidate.field_id
+                             : name == candidate.name) {
+      return candidate.target;
+    }
+  }
+  return Target::SKIP;
+}
+
+Status CheckType(const avro::UnwrappedSchema& value, const std::string& name,
+                 std::initializer_list<::avro::Type> accepted) {
+  for (auto type : accepted) {
+    if (value.node->type() == type) {
+      return Status::OK();
+    }
+  }
+  return Status::Invalid("Unexpected Avro type ", ::avro::toString(value.node->type()),
+                         " of manifest field ", name);
+}
+
+}  // namespace
+
+class ManifestReader::Plan {
+ public:
+  static Result<std::unique_ptr<Plan>> Make(const ::avro::ValidSchema& schema,
+                                            const ManifestReaderOptions& options);
+
+  Status Decode(::avro::Decoder* decoder, ManifestEntryColumns* out);
+
+  const ::avro::NodePtr& partition_schema() const { return partition_schema_; }
+
+ private:
+  struct Step {
+    Step(int8_t target, const ::avro::NodePtr& writer)
+        : target(target), writer(writer), value(avro::UnwrapOptional(writer)) {}
+
+    int8_t target;
+    ::avro::NodePtr writer;
+    avro::UnwrappedSchema value;
+    // For metrics maps, written as arrays of key-value records: whether to decode the
+    // map, and the schema of its values
+    bool decode = false;
+    avro::UnwrappedSchema map_value;
+    ::avro::NodePtr map_value_writer;
+    // Whether keys and values are a required int or long and bytes, which are skipped
+    // without walking their schema
+    bool fast_skip = false;
+  };
+
+  Status PlanMetrics(const std::string& name, Step* step) const;
+
+  Status DecodeDataFile(::avro::Decoder* decoder, ManifestEntryColumns* out);
+
+  Status DecodeMetrics(::avro::Decoder* decoder, const Step& step);
+
+  Status SkipMapValue(::avro::Decoder* decoder, const Step& step) {
+    if (step.fast_skip) {
+      if (step.map_value.node->type() == ::avro::AVRO_BYTES) {
+        decoder->skipBytes();
+      } else {
+        decoder->decodeLong();
+      }
+      return Status::OK();
+    }
+    return avro::Skip(decoder, step.map_value_writer);
+  }
+
+  int Slot(int64_t field_id) const {
+    return field_id >= 0 && field_id < static_cast<int64_t>(slot_by_field_id_.size())
+               ? slot_by_field_id_[field_id]
+               : -1;
+  }
+
+  ManifestReaderOptions options_;
+  std::vector<Step> entry_steps_;
+  std::vector<Step> file_steps_;
+  ::avro::NodePtr partition_schema_;
+  bool has_content_ = false;
+  bool has_sequence_number_ = false;
+  bool has_file_sequence_number_ = false;
+
+  // Index of each requested column in ManifestEntryColumns::metrics, by field id
+  std::vector<int> slot_by_field_id_;
+  // The metrics of the requested columns in the entry being decoded
+  std::vector<int64_t> counts_[kNumCountMetrics];
+  std::vector<std::string> bounds_[2];
+  std::vector<uint8_t> has_bound_[2];
+  // Strings and bytes of the entry being decoded
+  std::string bytes_;
+};
+
+Status ManifestReader::Plan::PlanMetrics(const std::string& name, Step* step) const {
+  const auto metric = static_cast<Metric>(
+      step->target - static_cast<int8_t>(FileTarget::COLUMN_SIZES));
+  step->decode = !options_.metrics_field_ids.empty() &&
+                 (metric != COLUMN_SIZE || options_.column_sizes);
+  // Iceberg writes maps with int keys as arrays of key-value records
+  const ::avro::NodePtr& map = step->value.node;
+  const ::avro::NodePtr items =
+      map->type() == ::avro::AVRO_ARRAY ? avro::Resolve(map->leafAt(0)) : nullptr;
+  if (items == nullptr || items->type() != ::avro::AVRO_RECORD || items->leaves() != 2) {
+    if (step->decode) {
+      return Status::Invalid("Manifest field ", name,
+                             " is not an array of key-value records");
+    }
+    step->target = static_cast<int8_t>(FileTarget::SKIP);
+    return Status::OK();
+  }
+  const auto unwrapped_key = avro::UnwrapOptional(items->leafAt(0));
+  step->map_value = avro::UnwrapOptional(items->leafAt(1));
+  step->map_value_writer = items->leafAt(1);
+  const bool long_key = unwrapped_key.null_index < 0 &&
+                        (unwrapped_key.node->type() == ::avro::AVRO_INT ||
+                         unwrapped_key.node->type() == ::avro::AVRO_LONG);
+  const auto value_type = step->map_value.node->type();
+  step->fast_skip = long_key && step->map_value.null_index < 0 &&
+                    (value_type == ::avro::AVRO_INT || value_type == ::avro::AVRO_LONG ||
+                     value_type == ::avro::AVRO_BYTES);
+  if (!step->decode) {
+    return Status::OK();
+  }
+  if (!long_key) {
+    return Status::Invalid("Keys of manifest field ", name, " are not required ints");
+  }
+  if (metric < kNumCountMetrics) {
+    return CheckType(step->map_value, name, {::avro::AVRO_INT, ::avro::AVRO_LONG});
+  }
+  return CheckType(step->map_value, name, {::avro::AVRO_BYTES, ::avro::AVRO_FIXED});
+}
+
+Result<std::unique_ptr<ManifestReader::Plan>> ManifestReader::Plan::Make(
+    const ::avro::ValidSchema& schema, const ManifestReaderOptions& options) {
+  const ::avro::NodePtr entry = avro::Resolve(schema.root());
+  if (entry->type() != ::avro::AVRO_RECORD) {
+    return Status::Invalid("Manifest schema is not a record");
+  }
+  auto plan = std::make_unique<Plan>();
+  plan->options_ = options;
+  const auto& field_ids = options.metrics_field_ids;
+  for (size_t i = 0; i < field_ids.size(); ++i) {
+    if (field_ids[i] < 0) {
+      return Status::Invalid("Invalid field id: ", field_ids[i]);
+    }
+    if (field_ids[i] >= static_cast<int32_t>(plan->slot_by_field_id_.size())) {
+      plan->slot_by_field_id_.resize(field_ids[i] + 1, -1);
+    }
+    if (plan->slot_by_field_id_[field_ids[i]] >= 0) {
+      return Status::Invalid("Field id requested twice: ", field_ids[i]);
+    }
+    plan->slot_by_field_id_[field_ids[i]] = static_cast<int>(i);
+  }
+  for (auto& counts : plan->counts_) {
+    counts.resize(field_ids.size());
+  }
+  for (int i = 0; i < 2; ++i) {
+    plan->bounds_[i].resize(field_ids.size());
+    plan->has_bound_[i].resize(field_ids.size());
+  }
+
+  ::avro::NodePtr data_file;
+  uint32_t seen = 0;
+  for (size_t i = 0; i < entry->leaves(); ++i) {
+    Step step(static_cast<int8_t>(MatchField(entry, i, kEntryFields)), entry->leafAt(i));
+    switch (static_cast<EntryTarget>(step.target)) {
+      case EntryTarget::SKIP:
+        break;
+      case EntryTarget::DATA_FILE:
+        if (step.value.node->type() != ::avro::AVRO_RECORD ||
+            step.value.null_index >= 0) {
+          return Status::Invalid("Manifest field data_file is not a record");
+        }
+        data_file = step.value.node;
+        break;
+      default:
+        ICEBERG_RETURN_NOT_OK(CheckType(step.value, entry->nameAt(i),
+                                        {::avro::AVRO_INT, ::avro::AVRO_LONG}));
+    }
+    seen |= 1u << step.target;
+    plan->entry_steps_.push_back(step);
+  }
+  for (const auto& known : kEntryFields) {
+    if ((seen & (1u << static_cast<int8_t>(known.target))) == 0 &&
+        known.target != EntryTarget::SEQUENCE_NUMBER &&
+        known.target != EntryTarget::FILE_SEQUENCE_NUMBER) {
+      return Status::Invalid("Manifest without required field ", known.name);
+    }
+  }
+  plan->has_sequence_number_ =
+      (seen & (1u << static_cast<int8_t>(EntryTarget::SEQUENCE_NUMBER))) != 0;
+  plan->has_file_sequence_number_ =
+      (seen & (1u << static_cast<int8_t>(EntryTarget::FILE_SEQUENCE_NUMBER))) != 0;
+
+  seen = 0;
+
+  for (size_t i = 0; i < data_file->leaves(); ++i) {
+    const std::string& name = data_file->nameAt(i);
+    Step step(static_cast<int8_t>(MatchField(data_file, i, kDataFileFields)),
+              data_file->leafAt(i));
+    const auto target = static_cast<FileTarget>(step.target);
+    switch (target) {
+      case FileTarget::SKIP:
+        break;
+      case FileTarget::FILE_PATH:
+      case FileTarget::FILE_FORMAT:
+        ICEBERG_RETURN_NOT_OK(CheckType(step.value, name, {::avro::AVRO_STRING}));
+        break;
+      case FileTarget::PARTITION:
+        ICEBERG_RETURN_NOT_OK(CheckType(step.value, name, {::avro::AVRO_RECORD}));
+        plan->partition_schema_ = step.value.node;
+        break;
+      case FileTarget::CONTENT:
+      case FileTarget::RECORD_COUNT:
+      case FileTarget::FILE_SIZE_IN_BYTES:
+        ICEBERG_RETURN_NOT_OK(
+            CheckType(step.value, name, {::avro::AVRO_INT, ::avro::AVRO_LONG}));
+        break;
+      default:
+        ICEBERG_RETURN_NOT_OK(plan->PlanMetrics(name, &step));
+    }
+    seen |= 1u << step.target;
+    plan->file_steps_.push_back(step);
+  }
+  for (const auto& known : kDataFileFields) {
+    if ((seen & (1u << static_cast<int8_t>(known.target))) == 0 &&
+        known.target < FileTarget::COLUMN_SIZES && known.target != FileTarget::CONTENT) {
+      return Status::Invalid("Manifest without required field data_file.", known.name);
+    }
+  }
+  plan->has_content_ = (seen & (1u << static_cast<int8_t>(FileTarget::CONTENT))) != 0;
+  return plan;
+}
+
+Status ManifestReader::Plan::DecodeMetrics(::avro::Decoder* decoder,
+                                           const Step& step) {
+  if (!step.decode && !step.fast_skip) {
+    return avro::Skip(decoder, step.writer);
+  }
+  bool present;
+  ICEBERG_RETURN_NOT_OK(avro::ReadPresence(decoder, step.value, &present));
+  if (!present) {
+    return Status::OK();
+  }
+  if (!step.decode) {
+    // skipArray() skips the blocks written with byte sizes and returns the count of the
+    // next block to walk, 0 after the last one
+    for (size_t n = decoder->skipArray(); n != 0; n = decoder->skipArray()) {
+      for (size_t i = 0; i < n; ++i) {
+        decoder->decodeLong();
+        ICEBERG_RETURN_NOT_OK(SkipMapValue(decoder, step));
+      }
+    }
+    return Status::OK();
+  }
+  const int metric = step.target - static_cast<int8_t>(FileTarget::COLUMN_SIZES);
+  for (size_t n = decoder->arrayStart(); n != 0; n = decoder->arrayNext()) {
+    for (size_t i = 0; i < n; ++i) {
+      const int slot = Slot(decoder->decodeLong());
+      if (slot < 0) {
+        ICEBERG_RETURN_NOT_OK(SkipMapValue(decoder, step));
+        continue;
+      }
+      bool value_present;
+      if (metric < kNumCountMetrics) {
+        ICEBERG_RETURN_NOT_OK(avro::ReadOptionalLong(decoder, step.map_value,
+                                                     &value_present,
+                                                     &counts_[metric][slot]));
+      } else {
+        const int bound = metric - LOWER_BOUND;
+        ICEBERG_RETURN_NOT_OK(avro::ReadOptionalBytes(decoder, step.map_value,
+                                                      &value_present,
+                                                      &bounds_[bound][slot]));
+        has_bound_[bound][slot] = value_present;
+      }
+    }
+  }
+  return Status::OK();
+}
+
+Status ManifestReader::Plan::DecodeDataFile(::avro::Decoder* decoder,
+                                            ManifestEntryColumns* out) {
+  for (const auto& file_step : file_steps_) {
+    const auto target = static_cast<FileTarget>(file_step.target);
+    bool present;
+    int64_t value = -1;
+    switch (target) {
+      case FileTarget::SKIP:
+        ICEBERG_RETURN_NOT_OK(avro::Skip(decoder, file_step.writer));
+        break;
+      case FileTarget::FILE_PATH:
+      case FileTarget::FILE_FORMAT: {
+        auto& column =
+            target == FileTarget::FILE_PATH ? out->file_path : out->file_format;
+        ICEBERG_RETURN_NOT_OK(
+            avro::ReadOptionalBytes(decoder, file_step.value, &present, &bytes_));
+        present ? column.Append(bytes_) : column.AppendNull();
+        break;
+      }
+      case FileTarget::PARTITION:
+        if (!options_.partition) {
+          ICEBERG_RETURN_NOT_OK(avro::Skip(decoder, file_step.writer));
+          break;
+        }
+        bytes_.clear();
+        ICEBERG_RETURN_NOT_OK(avro::CopyValue(decoder, file_step.writer, &bytes_));
+        out->partition.Append(bytes_);
+        break;
+      case FileTarget::CONTENT:
+        ICEBERG_RETURN_NOT_OK(
+            avro::ReadOptionalLong(decoder, file_step.value, &present, &value));
+        if (present && (value < 0 || value > 2)) {
+          return Status::Invalid("Invalid data file content: ", value);
+        }
+        out->content.push_back(present ? static_cast<DataFileContent>(value)
+                                       : DataFileContent::DATA);
+        break;
+      case FileTarget::RECORD_COUNT:
+        ICEBERG_RETURN_NOT_OK(
+            avro::ReadOptionalLong(decoder, file_step.value, &present, &value));
+        out->record_count.push_back(value);
+        break;
+      case FileTarget::FILE_SIZE_IN_BYTES:
+        ICEBERG_RETURN_NOT_OK(
+            avro::ReadOptionalLong(decoder, file_step.value, &present, &value));
+        out->file_size_in_bytes.push_back(value);
+        break;
+      default:
+        ICEBERG_RETURN_NOT_OK(DecodeMetrics(decoder, file_step));
+    }
+  }
+  if (!has_content_) {
+    out->content.push_back(DataFileContent::DATA);
+  }
+  return Status::OK();
+}
+
+Status ManifestReader::Plan::Decode(::avro::Decoder* decoder,
+                                    ManifestEntryColumns* out) {
+  for (auto& counts : counts_) {
+    std::fill(counts.begin(), counts.end(), -1);
+  }
+  for (auto& has_bound : has_bound_) {
+    std::fill(has_bound.begin(), has_bound.end(), 0);
+  }
+  for (const auto& step : entry_steps_) {
+    bool present;
+    int64_t value = -1;
+    switch (static_cast<EntryTarget>(step.target)) {
+      case EntryTarget::SKIP:
+        ICEBERG_RETURN_NOT_OK(avro::Skip(decoder, step.writer));
+        break;
+      case EntryTarget::STATUS:
+        ICEBERG_RETURN_NOT_OK(
+            avro::ReadOptionalLong(decoder, step.value, &present, &value));
+        if (value < 0 || value > 2) {
+          return Status::Invalid("Invalid manifest entry status: ", value);
+        }
+        out->status.push_back(static_cast<ManifestEntryStatus>(value));
+        break;
+      case EntryTarget::SNAPSHOT_ID:
+        ICEBERG_RETURN_NOT_OK(
+            avro::ReadOptionalLong(decoder, step.value, &present, &value));
+        out->snapshot_id.push_back(value);
+        break;
+      case EntryTarget::SEQUENCE_NUMBER:
+        ICEBERG_RETURN_NOT_OK(
+            avro::ReadOptionalLong(decoder, step.value, &present, &value));
+        out->sequence_number.push_back(value);
+        break;
+      case EntryTarget::FILE_SEQUENCE_NUMBER:
+        ICEBERG_RETURN_NOT_OK(
+            avro::ReadOptionalLong(decoder, step.value, &present, &value));
+        out->file_sequence_number.push_back(value);
+        break;
+      case EntryTarget::DATA_FILE:
+        ICEBERG_RETURN_NOT_OK(DecodeDataFile(decoder, out));
+        break;
+    }
+  }
+  // Version 1 manifests have no sequence numbers
+  if (!has_sequence_number_) {
+    out->sequence_number.push_back(0);
+  }
+  if (!has_file_sequence_number_) {
+    out->file_sequence_number.push_back(0);
+  }
+  for (size_t slot = 0; slot < out->metrics.size(); ++slot) {
+    auto& metrics = out->metrics[slot];
+    if (options_.column_sizes) {
+      metrics.column_size.push_back(counts_[COLUMN_SIZE][slot]);
+    }
+    metrics.value_count.push_back(counts_[VALUE_COUNT][slot]);
+    metrics.null_value_count.push_back(counts_[NULL_VALUE_COUNT][slot]);
+    metrics.nan_value_count.push_back(counts_[NAN_VALUE_COUNT][slot]);
+    has_bound_[0][slot] ? metrics.lower_bound.Append(bounds_[0][slot])
+                        : metrics.lower_bound.AppendNull();
+    has_bound_[1][slot] ? metrics.upper_bound.Append(bounds_[1][slot])
+                        : metrics.upper_bound.AppendNull();
+  }
+  return Status::OK();
+}
+
+ManifestReader::ManifestReader(std::unique_ptr<avro::FileReader> file,
+                               ManifestReaderOptions options, std::unique_ptr<Plan> plan)
+    : file_(std::move(file)), options_(std::move(options)), plan_(std::move(plan)) {}
+
+ManifestReader::~ManifestReader() = default;
+
+Result<std::unique_ptr<ManifestReader>> ManifestReader::Open(
+    const std::shared_ptr<io::InputFile>& file, ManifestReaderOptions options) {
+  ICEBERG_ASSIGN_OR_RAISE(auto reader, avro::FileReader::Open(file));
+  ICEBERG_ASSIGN_OR_RAISE(auto plan, Plan::Make(reader->schema(), options));
+  return std::unique_ptr<ManifestReader>(
+      new ManifestReader(std::move(reader), std::move(options), std::move(plan)));
+}
+
+Result<std::unique_ptr<ManifestReader>> ManifestReader::Open(
+    io::FileIO& file_io, const std::string& path, ManifestReaderOptions options) {
+  ICEBERG_ASSIGN_OR_RAISE(auto file, file_io.newInputFile(path));
+  return Open(file, std::move(options));
+}
+
+const ::avro::NodePtr& ManifestReader::partition_schema() const {
+  return plan_->partition_schema();
+}
+
+std::optional<std::string> ManifestReader::metadata(const std::string& key) const {
+  return file_->metadata(key);
+}
+
+Result<int64_t> ManifestReader::ReadBatch(ManifestEntryColumns* out) {
+  if (out->metrics.size() != options_.metrics_field_ids.size()) {
+    if (out->num_rows != 0 || !out->metrics.empty()) {
+      return Status::Invalid("Manifest entry columns with other metrics columns");
+    }
+    out->metrics.resize(options_.metrics_field_ids.size());
+    for (size_t i = 0; i < out->metrics.size(); ++i) {
+      out->metrics[i].field_id = options_.metrics_field_ids[i];
+    }
+  }
+  ICEBERG_ASSIGN_OR_RAISE(auto num_rows,
+                          file_->ReadBlock([this, out](::avro::Decoder* decoder) {
+                            return plan_->Decode(decoder, out);
+                          }));
+  out->num_rows += num_rows;
+  return num_rows;
+}
+
+Result<ManifestEntryColumns> ManifestReader::ReadAll() {
+  ManifestEntryColumns columns;
+  while (true) {
+    ICEBERG_ASSIGN_OR_RAISE(auto num_rows, ReadBatch(&columns));
+    if (num_rows == 0) {
+      return columns;
+    }
+  }
+}
+
+}  // namespace table
+}  // namespace iceberg
@@ -0,0 +1,231 @@
+#include "iceberg/util/crc32c.hh"
+
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define ICEBERG_CRC32C_SSE42 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define ICEBERG_CRC32C_ARMV8 1
+#endif
+
+namespace iceberg {
+namespace util {
+
+namespace {
+
+// The Castagnoli polynomial, bit-reflected
+constexpr uint32_t kPolynomial = 0x82f63b78;
+
+uint64_t LoadWord(const uint8_t* data) {
+  uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+/// Lookup tables of the portable implementation. Table k maps a byte to the CRC of
+/// that byte followed by k zero bytes, so that eight tables consume eight bytes at once.
+struct SlicingTables {
+  uint32_t table[8][256];
+
+  SlicingTables() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc >> 1) ^ ((crc & 1) ? kPolynomial : 0);
+      }
+      table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+      for (int k = 1; k < 8; ++k) {
+        const uint32_t prev = table[k - 1][i];
+        table[k][i] = (prev >> 8) ^ table[0][prev & 0xff];
+      }
+    }
+  }
+};
+
+const SlicingTables& GetSlicingTables() {
+  static const SlicingTables tables;
+  return tables;
+}
+
+#if defined(ICEBERG_CRC32C_SSE42)
+
+// The CRC instruction has a latency of three cycles but a throughput of one per cycle,
+// so the hardware path runs three independent CRCs over adjacent blocks, then shifts
+// and merges them. Shifting a CRC over n zero bytes is linear over GF(2), hence a
+// 32x32 bit matrix, applied below through four byte-indexed tables.
+constexpr size_t kLongBlock = 8192;
+constexpr size_t kShortBlock = 256;
+
+uint32_t MatrixTimes(const uint32_t* matrix, uint32_t vector) {
+  uint32_t sum = 0;
+  for (; vector != 0; vector >>= 1, ++matrix) {
+    if (vector & 1) {
+      sum ^= *matrix;
+    }
+  }
+  return sum;
+}
+
+void MatrixSquare(uint32_t* square, const uint32_t* matrix) {
+  for (int n = 0; n < 32; ++n) {
+    square[n] = MatrixTimes(matrix, matrix[n]);
+  }
+}
+
+/// Tables shifting a CRC over a fixed number of zero bytes.
+struct ShiftTables {
+  uint32_t table[4][256];
+
+  explicit ShiftTables(size_t length) {
+    // The operator for one zero bit, squared up to one for `length` zero bytes
+    uint32_t odd[32];
+    uint32_t even[32];
+    odd[0] = kPolynomial;
+    for (int n = 1; n < 32; ++n) {
+      odd[n] = 1u << (n - 1);
+    }
+    MatrixSquare(even, odd);  // two bits
+    MatrixSquare(odd, even);  // four bits
+    const uint32_t* op = odd;
+    for (;;) {
+      MatrixSquare(even, odd);  // doubles from a nibble: one byte first
+      length >>= 1;
+      if (length == 0) {
+        op = even;
+        break;
+      }
+      MatrixSquare(odd, even);
+      length >>= 1;
+      if (length == 0) {
+        op = odd;
+        break;
+      }
+    }
+    for (uint32_t n = 0; n < 256; ++n) {
+      table[0][n] = MatrixTimes(op, n);
+      table[1][n] = MatrixTimes(op, n << 8);
+      table[2][n] = MatrixTimes(op, n << 16);
+      table[3][n] = MatrixTimes(op, n << 24);
+    }
+  }
+
+  uint32_t Shift(uint32_t crc) const {
+    return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^
+           table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+  }
+};
+
+// Run three CRCs over three adjacent blocks of `block` bytes while `length` allows
+__attribute__((target("sse4.2"))) uint64_t Crc32cInterleaved(
+    uint64_t crc0, const uint8_t*& data, size_t& length, size_t block,
+    const ShiftTables& shift) {
+  while (length >= 3 * block) {
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const uint8_t* end = data + block;
+    do {
+      crc0 = _mm_crc32_u64(crc0, LoadWord(data));
+      crc1 = _mm_crc32_u64(crc1, LoadWord(data + block));
+      crc2 = _mm_crc32_u64(crc2, LoadWord(data + 2 * block));
+      data += 8;
+    } while (data < end);
+    crc0 = shift.Shift(static_cast<uint32_t>(crc0)) ^ crc1;
+    crc0 = shift.Shift(static_cast<uint32_t>(crc0)) ^ crc2;
+    data += 2 * block;
+    length -= 3 * block;
+  }
+  return crc0;
+}
+
+__attribute__((target("sse4.2"))) uint32_t Crc32cHardware(const void* data,
+                                                          size_t length, uint32_t crc) {
+  static const ShiftTables long_shift(kLongBlock);
+  static const ShiftTables short_shift(kShortBlock);
+  auto next = static_cast<const uint8_t*>(data);
+  uint64_t crc0 = ~crc;
+  while (length > 0 && (reinterpret_cast<uintptr_t>(next) & 7) != 0) {
+    crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *next++);
+    --length;
+  }
+  crc0 = Crc32cInterleaved(crc0, next, length, kLongBlock, long_shift);
+  crc0 = Crc32cInterleaved(crc0, next, length, kShortBlock, short_shift);
+  for (; length >= 8; length -= 8, next += 8) {
+    crc0 = _mm_crc32_u64(crc0, LoadWord(next));
+  }
+  for (; length > 0; --length) {
+    crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *next++);
+  }
+  return ~static_cast<uint32_t>(crc0);
+}
+
+#elif defined(ICEBERG_CRC32C_ARMV8)
+
+uint32_t Crc32cHardware(const void* data, size_t length, uint32_t crc) {
+  auto next = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  for (; length >= 8; length -= 8, next += 8) {
+    crc = __crc32cd(crc, LoadWord(next));
+  }
+  for (; length > 0; --length) {
+    crc = __crc32cb(crc, *next++);
+  }
+  return ~crc;
+}
+
+#endif
+
+using Crc32cFunction = uint32_t (*)(const void*, size_t, uint32_t);
+
+Crc32cFunction SelectCrc32c() {
+#if defined(ICEBERG_CRC32C_SSE42)
+  if (__builtin_cpu_supports("sse4.2")) {
+    return Crc32cHardware;
+  }
+#elif defined(ICEBERG_CRC32C_ARMV8)
+  return Crc32cHardware;
+#endif
+  return internal::Crc32cPortable;
+}
+
+Crc32cFunction GetCrc32c() {
+  static const Crc32cFunction function = SelectCrc32c();
+  return function;
+}
+
+}  // namespace
+
+uint32_t Crc32c(const void* data, size_t length, uint32_t crc) {
+  return GetCrc32c()(data, length, crc);
+}
+
+bool IsCrc32cAccelerated() { return GetCrc32c() != internal::Crc32cPortable; }
+
+namespace internal {
+
+uint32_t Crc32cPortable(const void* data, size_t length, uint32_t crc) {
+  const auto& table = GetSlicingTables().table;
+  auto next = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  for (; length >= 8; length -= 8, next += 8) {
+    const uint32_t low = crc ^ (static_cast<uint32_t>(next[0]) |
+                                static_cast<uint32_t>(next[1]) << 8 |
+                                static_cast<uint32_t>(next[2]) << 16 |
+                                static_cast<uint32_t>(next[3]) << 24);
+    crc = table[7][low & 0xff] ^ table[6][(low >> 8) & 0xff] ^
+          table[5][(low >> 16) & 0xff] ^ table[4][low >> 24] ^ table[3][next[4]] ^
+          table[2][next[5]] ^ table[1][next[6]] ^ table[0][next[7]];
+  }
+  for (; length > 0; --length) {
+    crc = (crc >> 8) ^ table[0][(crc ^ *next++) & 0xff];
+  }
+  return ~crc;
+}
+
+}  // namespace internal
+
+}  // namespace util
+}  // namespace iceberg
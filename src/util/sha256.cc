@@ -0,0 +1,158 @@
+#include "iceberg/util/sha256.hh"
+
+#include <algorithm>
+#include <cstring>
+
+namespace iceberg {
+namespace util {
+
+namespace {
+
+constexpr uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2};
+
+uint32_t Rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+uint32_t LoadBigEndian(const uint8_t* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | data[3];
+}
+
+}  // namespace
+
+Sha256::Sha256()
+    : state_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c,
+             0x1f83d9ab, 0x5be0cd19} {}
+
+void Sha256::Compress(const uint8_t* block) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; ++i) {
+    w[i] = LoadBigEndian(block + 4 * i);
+  }
+  for (int i = 16; i < 64; ++i) {
+    const uint32_t s0 = Rotr(w[i - 15], 7) ^ Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    const uint32_t s1 = Rotr(w[i - 2], 17) ^ Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+  uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+  uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+  for (int i = 0; i < 64; ++i) {
+    const uint32_t s1 = Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25);
+    const uint32_t ch = (e & f) ^ (~e & g);
+    const uint32_t t1 = h + s1 + ch + kRoundConstants[i] + w[i];
+    const uint32_t s0 = Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22);
+    const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+    const uint32_t t2 = s0 + maj;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  state_[0] += a;
+  state_[1] += b;
+  state_[2] += c;
+  state_[3] += d;
+  state_[4] += e;
+  state_[5] += f;
+  state_[6] += g;
+  state_[7] += h;
+}
+
+void Sha256::Update(const void* data, size_t length) {
+  auto next = static_cast<const uint8_t*>(data);
+  length_ += length;
+  if (block_size_ > 0) {
+    const size_t n = std::min(length, sizeof(block_) - block_size_);
+    std::memcpy(block_ + block_size_, next, n);
+    block_size_ += n;
+    next += n;
+    length -= n;
+    if (block_size_ < sizeof(block_)) {
+      return;
+    }
+    Compress(block_);
+    block_size_ = 0;
+  }
+  for (; length >= sizeof(block_); next += sizeof(block_), length -= sizeof(block_)) {
+    Compress(next);
+  }
+  std::memcpy(block_, next, length);
+  block_size_ = length;
+}
+
+Sha256Digest Sha256::Finish() {
+  const uint64_t bit_length = length_ * 8;
+  uint8_t padding[72] = {0x80};
+  // Pad to 56 bytes modulo 64, then append the length
+  const size_t padding_size =
+      block_size_ < 56 ? 56 - block_size_ : 64 + 56 - block_size_;
+  for (int i = 0; i < 8; ++i) {
+    padding[padding_size + i] = static_cast<uint8_t>(bit_length >> (56 - 8 * i));
+  }
+  Update(padding, padding_size + 8);
+  Sha256Digest digest;
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      digest[4 * i + j] = static_cast<uint8_t>(state_[i] >> (24 - 8 * j));
+    }
+  }
+  return digest;
+}
+
+Sha256Digest Sha256Hash(std::string_view data) {
+  Sha256 hasher;
+  hasher.Update(data);
+  return hasher.Finish();
+}
+
+Sha256Digest HmacSha256(std::string_view key, std::string_view data) {
+  uint8_t block[64] = {};
+  if (key.size() > sizeof(block)) {
+    const Sha256Digest hashed = Sha256Hash(key);
+    std::memcpy(block, hashed.data(), hashed.size());
+  } else {
+    std::memcpy(block, key.data(), key.size());
+  }
+  uint8_t pad[64];
+  for (size_t i = 0; i < sizeof(block); ++i) {
+    pad[i] = block[i] ^ 0x36;
+  }
+  Sha256 inner;
+  inner.Update(pad, sizeof(pad));
+  inner.Update(data);
+  const Sha256Digest inner_digest = inner.Finish();
+  for (size_t i = 0; i < sizeof(block); ++i) {
+    pad[i] = block[i] ^ 0x5c;
+  }
+  Sha256 outer;
+  outer.Update(pad, sizeof(pad));
+  outer.Update(inner_digest.data(), inner_digest.size());
+  return outer.Finish();
+}
+
+std::string ToHex(const Sha256Digest& digest) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(2 * digest.size());
+  for (uint8_t byte : digest) {
+    hex.push_back(kDigits[byte >> 4]);
+    hex.push_back(kDigits[byte & 0xf]);
+  }
+  return hex;
+}
+
+}  // namespace util
+}  // namespace iceberg
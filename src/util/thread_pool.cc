@@ -0,0 +1,67 @@
+#include "iceberg/util/thread_pool.hh"
+
+#include <cstdlib>
+
+namespace iceberg {
+namespace util {
+
+ThreadPool::ThreadPool(int num_threads) {
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  workers_.reserve(static_cast<size_t>(num_threads));
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this]() { WorkerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Spawn(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void ThreadPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return shutdown_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        // shutdown_ is set and all queued work is done
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+ThreadPool* GetIOThreadPool() {
+  // Intentionally leaked, so that tasks still running at exit never see a destroyed pool
+  static ThreadPool* pool = []() {
+    int num_threads = 8;
+    if (const char* env = std::getenv("ICEBERG_IO_THREADS")) {
+      num_threads = std::atoi(env);
+    }
+    return new ThreadPool(num_threads);
+  }();
+  return pool;
+}
+
+}  // namespace util
+}  // namespace iceberg
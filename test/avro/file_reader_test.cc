@@ -0,0 +1,274 @@
+#include "iceberg/avro/file_reader.hh"
+
+#include <avro/Compiler.hh>
+#include <avro/Exception.hh>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iceberg/avro/projection.hh"
+#include "iceberg/io/memory_file_io.hh"
+#include "test_util.hh"
+
+namespace iceberg {
+namespace avro {
+
+const char kSchema[] = R"({
+  "type": "record", "name": "entry", "namespace": "org.example",
+  "fields": [
+    {"name": "id", "type": "long", "field-id": 1},
+    {"name": "name", "type": ["null", "string"], "default": null, "field-id": 2},
+    {"name": "tags", "type": {"type": "array", "items": "string"}, "field-id": 3},
+    {"name": "point", "type": {"type": "record", "name": "point",
+      "fields": [{"name": "x", "type": "double"}, {"name": "y", "type": "float"}]}},
+    {"name": "other", "type": ["point", "null"]},
+    {"name": "attrs", "type": {"type": "map", "values": "int"}},
+    {"name": "hash", "type": {"type": "fixed", "name": "md5", "size": 16}},
+    {"name": "kind", "type": {"type": "enum", "name": "kind", "symbols": ["A", "B"]}},
+    {"name": "day", "type": {"type": "int", "logicalType": "date"}},
+    {"name": "note", "type": "string", "doc": "café \"quoted\""}
+  ]
+})";
+
+::avro::NodePtr Compile(const std::string& json) {
+  return ::avro::compileJsonSchemaFromString(json).root();
+}
+
+// An entry of kSchema, followed by the long 7
+std::string EncodeEntry() {
+  const double x = 1;
+  const float y = 2;
+  TestEncoder encoder;
+  encoder.Long(42).Long(1).Bytes("name");
+  // Tags written as one block with a byte size, then a block without
+  TestEncoder tags;
+  tags.Bytes("a").Bytes("bc");
+  encoder.Long(-2).Long(tags.str().size()).Raw(tags.str());
+  encoder.Long(1).Bytes("d").Long(0);
+  encoder.Raw(std::string_view(reinterpret_cast<const char*>(&x), sizeof(x)));
+  encoder.Raw(std::string_view(reinterpret_cast<const char*>(&y), sizeof(y)));
+  encoder.Long(1);
+  encoder.Long(2).Bytes("k1").Long(7).Bytes("k2").Long(-7).Long(0);
+  encoder.Raw("0123456789abcdef").Long(1).Long(19000).Bytes("note");
+  encoder.Long(7);
+  return encoder.str();
+}
+
+TEST(ProjectionTest, FieldIdsAndOptionals) {
+  auto schema = Compile(kSchema);
+  ASSERT_EQ(schema->type(), ::avro::AVRO_RECORD);
+  ASSERT_EQ(schema->leaves(), 10);
+  ASSERT_EQ(FieldId(schema, 0), 1);
+  ASSERT_EQ(FieldId(schema, 2), 3);
+  ASSERT_FALSE(FieldId(schema, 9).has_value());
+
+  const auto name = UnwrapOptional(schema->leafAt(1));
+  ASSERT_EQ(name.null_index, 0);
+  ASSERT_EQ(name.node->type(), ::avro::AVRO_STRING);
+  ASSERT_EQ(UnwrapOptional(schema->leafAt(0)).null_index, -1);
+  // A named type referenced by name is resolved to its definition
+  const auto other = UnwrapOptional(schema->leafAt(4));
+  ASSERT_EQ(other.null_index, 1);
+  ASSERT_EQ(other.node, Resolve(schema->leafAt(3)));
+  ASSERT_EQ(other.node->type(), ::avro::AVRO_RECORD);
+
+  ASSERT_TRUE(IsZeroWidth(Compile("\"null\"")));
+  ASSERT_TRUE(IsZeroWidth(Compile(
+      R"({"type": "record", "name": "r", "fields": [{"name": "a", "type": "null"}]})")));
+  ASSERT_FALSE(IsZeroWidth(schema));
+  ASSERT_FALSE(IsZeroWidth(Compile(R"({"type": "array", "items": "null"})")));
+}
+
+TEST(ProjectionTest, SkipValues) {
+  auto schema = Compile(kSchema);
+  const std::string data = EncodeEntry();
+  TestDecoder decoder(data);
+  ASSERT_TRUE(Skip(decoder.get(), schema).ok());
+  ASSERT_EQ(decoder.get()->decodeLong(), 7);
+
+  // Skipping only the record fields not needed
+  TestDecoder partial(data);
+  ASSERT_EQ(partial.get()->decodeLong(), 42);
+  for (size_t i = 1; i < schema->leaves() - 1; ++i) {
+    ASSERT_TRUE(Skip(partial.get(), schema->leafAt(i)).ok());
+  }
+  bool present;
+  std::string note;
+  ASSERT_TRUE(ReadOptionalBytes(partial.get(), UnwrapOptional(schema->leafAt(9)),
+                                &present, &note)
+                  .ok());
+  ASSERT_TRUE(present);
+  ASSERT_EQ(note, "note");
+
+  const std::string truncated_data = data.substr(0, data.size() - 4);
+  TestDecoder truncated(truncated_data);
+  ASSERT_THROW(Skip(truncated.get(), schema), ::avro::Exception);
+}
+
+TEST(ProjectionTest, SkipZeroWidthItems) {
+  // Huge counts of items encoded in no bytes are skipped without walking the items
+  TestEncoder encoder;
+  encoder.Long(int64_t{1} << 50).Long(0).Long(int64_t{1} << 50).Long(0).Long(7);
+  const std::string data = encoder.str();
+  TestDecoder decoder(data);
+  ASSERT_TRUE(Skip(decoder.get(), Compile(R"({"type": "array", "items": "null"})")).ok());
+  ASSERT_TRUE(Skip(decoder.get(),
+                   Compile(R"({"type": "array", "items": {"type": "record",
+                               "name": "empty", "fields": []}})"))
+                  .ok());
+  ASSERT_EQ(decoder.get()->decodeLong(), 7);
+}
+
+TEST(ProjectionTest, ReadOptional) {
+  auto optional = UnwrapOptional(Compile("[\"null\", \"long\"]"));
+  auto reversed = UnwrapOptional(Compile("[\"int\", \"null\"]"));
+  TestEncoder encoder;
+  encoder.Long(1).Long(-5).Long(0).Long(1).Long(0).Long(-2).Long(3);
+  const std::string data = encoder.str();
+  TestDecoder decoder(data);
+  bool present;
+  int64_t value = 0;
+  ASSERT_TRUE(ReadOptionalLong(decoder.get(), optional, &present, &value).ok());
+  ASSERT_TRUE(present);
+  ASSERT_EQ(value, -5);
+  ASSERT_TRUE(ReadOptionalLong(decoder.get(), optional, &present, &value).ok());
+  ASSERT_FALSE(present);
+  ASSERT_TRUE(ReadOptionalLong(decoder.get(), reversed, &present, &value).ok());
+  ASSERT_FALSE(present);
+  ASSERT_TRUE(ReadOptionalLong(decoder.get(), reversed, &present, &value).ok());
+  ASSERT_TRUE(present);
+  ASSERT_EQ(value, -2);
+  // Branch 3 is out of range
+  ASSERT_TRUE(ReadOptionalLong(decoder.get(), reversed, &present, &value).IsInvalid());
+}
+
+TEST(ProjectionTest, CopyValue) {
+  auto schema = Compile(kSchema);
+  const std::string data = EncodeEntry();
+  TestDecoder decoder(data);
+  std::string copy;
+  ASSERT_TRUE(CopyValue(decoder.get(), schema, &copy).ok());
+  ASSERT_EQ(decoder.get()->decodeLong(), 7);
+
+  // The copy decodes as the original, with the tags rewritten without a byte size
+  TestDecoder copied(copy);
+  ASSERT_EQ(copied.get()->decodeLong(), 42);
+  ASSERT_EQ(copied.get()->decodeUnionIndex(), 1);
+  ASSERT_EQ(copied.get()->decodeString(), "name");
+  ASSERT_EQ(copied.get()->arrayStart(), 2);
+  ASSERT_EQ(copied.get()->decodeString(), "a");
+  ASSERT_EQ(copied.get()->decodeString(), "bc");
+  ASSERT_EQ(copied.get()->arrayNext(), 1);
+  ASSERT_EQ(copied.get()->decodeString(), "d");
+  ASSERT_EQ(copied.get()->arrayNext(), 0);
+  for (size_t i = 3; i < schema->leaves(); ++i) {
+    ASSERT_TRUE(Skip(copied.get(), schema->leafAt(i)).ok());
+  }
+  ASSERT_EQ(copy.size(), data.size() - 2);
+}
+
+class FileReaderTest : public testing::Test {
+ protected:
+  void SetUp() override { fs = std::make_shared<io::MemoryFileIO>(); }
+
+  std::shared_ptr<io::InputFile> WriteFile(const std::string& content) {
+    auto out = fs->newOutputFile("mem://file.avro").ValueOrDie();
+    auto stream = out->createOrOverwrite().ValueOrDie();
+    EXPECT_TRUE(stream->Write(content).ok());
+    EXPECT_TRUE(stream->Close().ok());
+    return out->toInputFile().ValueOrDie();
+  }
+
+  static std::vector<TestBlock> Blocks() {
+    std::vector<TestBlock> blocks;
+    for (int64_t b = 0; b < 3; ++b) {
+      TestEncoder encoder;
+      for (int64_t i = 0; i < 100; ++i) {
+        encoder.Long(b * 100 + i);
+      }
+      blocks.emplace_back(100, encoder.str());
+    }
+    // An empty block is passed over
+    blocks.emplace(blocks.begin() + 1, 0, "");
+    return blocks;
+  }
+
+  void ReadBlocks(FileReader* reader) {
+    int64_t next = 0;
+    auto decode = [&next](::avro::Decoder* decoder) {
+      const int64_t value = decoder->decodeLong();
+      if (value != next++) {
+        return Status::Invalid("Unexpected value ", value);
+      }
+      return Status::OK();
+    };
+    for (int b = 0; b < 3; ++b) {
+      ASSERT_EQ(reader->ReadBlock(decode).ValueOrDie(), 100);
+    }
+    ASSERT_EQ(next, 300);
+    ASSERT_EQ(reader->ReadBlock(decode).ValueOrDie(), 0);
+  }
+
+  static Status SkipLong(::avro::Decoder* decoder) {
+    decoder->decodeLong();
+    return Status::OK();
+  }
+
+  std::shared_ptr<io::MemoryFileIO> fs;
+};
+
+TEST_F(FileReaderTest, ReadBlocks) {
+  auto file = WriteFile(MakeAvroFile("\"long\"", Blocks(), "null", {{"k", "v"}}));
+  // A small buffer makes blocks straddle buffer refills
+  auto reader = FileReader::Open(file, 64).ValueOrDie();
+  ASSERT_EQ(reader->schema().root()->type(), ::avro::AVRO_LONG);
+  ASSERT_EQ(reader->metadata("k"), "v");
+  ASSERT_EQ(reader->metadata("avro.codec"), "null");
+  ASSERT_FALSE(reader->metadata("missing").has_value());
+  ReadBlocks(reader.get());
+  ASSERT_TRUE(reader->Close().ok());
+}
+
+TEST_F(FileReaderTest, ReadDeflateBlocks) {
+  auto file = WriteFile(MakeAvroFile("\"long\"", Blocks(), "deflate"));
+  auto reader = FileReader::Open(file).ValueOrDie();
+  ASSERT_EQ(reader->metadata("avro.codec"), "deflate");
+  ReadBlocks(reader.get());
+}
+
+TEST_F(FileReaderTest, RejectsInvalidFiles) {
+  ASSERT_TRUE(FileReader::Open(WriteFile("PAR1")).status().IsInvalid());
+  ASSERT_TRUE(FileReader::Open(WriteFile(MakeAvroFile("\"long\"", {}, "unknown")))
+                  .status()
+                  .IsInvalid());
+
+  std::string content = MakeAvroFile("\"long\"", Blocks());
+  // Corrupt the sync marker after the last block
+  const size_t last_sync = content.find("0123456789abcdef", content.size() - 200);
+  content[last_sync] = 'x';
+  auto reader = FileReader::Open(WriteFile(content)).ValueOrDie();
+  ASSERT_EQ(reader->ReadBlock(SkipLong).ValueOrDie(), 100);
+  ASSERT_EQ(reader->ReadBlock(SkipLong).ValueOrDie(), 100);
+  ASSERT_TRUE(reader->ReadBlock(SkipLong).status().IsInvalid());
+
+  // Errors of the decode function are returned as is
+  reader = FileReader::Open(WriteFile(MakeAvroFile("\"long\"", Blocks()))).ValueOrDie();
+  ASSERT_TRUE(reader->ReadBlock([](::avro::Decoder*) { return Status::IOError("x"); })
+                  .status()
+                  .IsIOError());
+
+  content = MakeAvroFile("\"long\"", Blocks());
+  content.resize(content.size() - 20);
+  reader = FileReader::Open(WriteFile(content)).ValueOrDie();
+  ASSERT_EQ(reader->ReadBlock(SkipLong).ValueOrDie(), 100);
+  auto result = reader->ReadBlock(SkipLong);
+  while (result.ok() && *result > 0) {
+    result = reader->ReadBlock(SkipLong);
+  }
+  ASSERT_TRUE(result.status().IsInvalid());
+}
+
+}  // namespace avro
+}  // namespace iceberg
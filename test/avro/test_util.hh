@@ -0,0 +1,111 @@
+#pragma once
+
+#include <avro/Decoder.hh>
+#include <avro/Stream.hh>
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace iceberg {
+namespace avro {
+
+/// \brief Encodes Avro binary data, to write test files by hand
+class TestEncoder {
+ public:
+  TestEncoder& Long(int64_t value) {
+    uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ (value < 0 ? ~0ULL : 0);
+    do {
+      uint8_t byte = zigzag & 0x7F;
+      zigzag >>= 7;
+      if (zigzag != 0) {
+        byte |= 0x80;
+      }
+      out_.push_back(static_cast<char>(byte));
+    } while (zigzag != 0);
+    return *this;
+  }
+
+  TestEncoder& Bool(bool value) {
+    out_.push_back(value ? 1 : 0);
+    return *this;
+  }
+
+  TestEncoder& Bytes(std::string_view value) {
+    Long(static_cast<int64_t>(value.size()));
+    out_.append(value.data(), value.size());
+    return *this;
+  }
+
+  TestEncoder& Raw(std::string_view value) {
+    out_.append(value.data(), value.size());
+    return *this;
+  }
+
+  const std::string& str() const { return out_; }
+
+ private:
+  std::string out_;
+};
+
+/// \brief An avro-cpp decoder over `data`, which must outlive it
+struct TestDecoder {
+  explicit TestDecoder(const std::string& data)
+      : stream(::avro::memoryInputStream(reinterpret_cast<const uint8_t*>(data.data()),
+                                         data.size())),
+        decoder(::avro::binaryDecoder()) {
+    decoder->init(*stream);
+  }
+
+  ::avro::Decoder* get() { return decoder.get(); }
+
+  std::unique_ptr<::avro::InputStream> stream;
+  ::avro::DecoderPtr decoder;
+};
+
+/// \brief A block of an Avro data file: the number of objects and their encoding
+using TestBlock = std::pair<int64_t, std::string>;
+
+inline std::string RawDeflate(const std::string& data) {
+  z_stream stream{};
+  deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+               Z_DEFAULT_STRATEGY);
+  std::string out(deflateBound(&stream, data.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef*>(out.data());
+  stream.avail_out = static_cast<uInt>(out.size());
+  deflate(&stream, Z_FINISH);
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+  return out;
+}
+
+/// \brief Return an Avro object container file with the given schema and blocks
+inline std::string MakeAvroFile(
+    const std::string& schema, const std::vector<TestBlock>& blocks,
+    const std::string& codec = "null",
+    const std::vector<std::pair<std::string, std::string>>& metadata = {}) {
+  const std::string sync = "0123456789abcdef";
+  TestEncoder file;
+  file.Raw(std::string_view("Obj\x01", 4));
+  file.Long(2 + static_cast<int64_t>(metadata.size()));
+  file.Bytes("avro.schema").Bytes(schema).Bytes("avro.codec").Bytes(codec);
+  for (const auto& entry : metadata) {
+    file.Bytes(entry.first).Bytes(entry.second);
+  }
+  file.Long(0).Raw(sync);
+  for (const auto& block : blocks) {
+    const std::string data = codec == "deflate" ? RawDeflate(block.second) : block.second;
+    file.Long(block.first).Bytes(data).Raw(sync);
+  }
+  return file.str();
+}
+
+}  // namespace avro
+}  // namespace iceberg
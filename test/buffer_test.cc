@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "iceberg/buffer.hh"
+
+namespace iceberg {
+
+TEST(Buffer, AllocateAndSlice) {
+  auto buffer = AllocateBuffer(16).ValueOrDie();
+  ASSERT_TRUE(buffer->is_mutable());
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(buffer->data()) % 64, 0);
+  std::memcpy(buffer->mutable_data(), "0123456789abcdef", 16);
+
+  auto slice = SliceBuffer(buffer, 4, 6);
+  ASSERT_EQ(slice->ToStringView(), "456789");
+  ASSERT_EQ(slice->parent(), buffer);
+  ASSERT_FALSE(slice->is_mutable());
+
+  ASSERT_TRUE(SliceBufferSafe(buffer, 10, 6).ok());
+  ASSERT_TRUE(SliceBufferSafe(buffer, 10, 7).status().IsInvalid());
+  ASSERT_TRUE(SliceBufferSafe(buffer, -1, 2).status().IsInvalid());
+  ASSERT_TRUE(AllocateBuffer(-1).status().IsInvalid());
+  ASSERT_EQ(AllocateBuffer(0).ValueOrDie()->size(), 0);
+}
+
+TEST(Buffer, FromOwnedMemory) {
+  int released = 0;
+  auto data = new uint8_t[8]{'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'};
+  std::shared_ptr<Buffer> slice;
+  {
+    auto buffer = Buffer::FromOwnedMemory(data, 8, [&](const uint8_t* ptr, int64_t size) {
+      ASSERT_EQ(size, 8);
+      delete[] ptr;
+      ++released;
+    });
+    slice = SliceBuffer(buffer, 2, 3);
+  }
+  // The slice keeps its parent alive
+  ASSERT_EQ(released, 0);
+  ASSERT_EQ(slice->ToString(), "cde");
+  slice.reset();
+  ASSERT_EQ(released, 1);
+}
+
+TEST(Buffer, WrapAndFromString) {
+  auto owner = std::make_shared<std::string>("owned elsewhere");
+  auto wrapped = Buffer::Wrap(reinterpret_cast<const uint8_t*>(owner->data()),
+                              static_cast<int64_t>(owner->size()), owner);
+  ASSERT_EQ(owner.use_count(), 2);
+  ASSERT_EQ(wrapped->ToStringView(), "owned elsewhere");
+  wrapped.reset();
+  ASSERT_EQ(owner.use_count(), 1);
+
+  auto from_string = Buffer::FromString("owned elsewhere");
+  ASSERT_TRUE(from_string->Equals(*Buffer::CopyOf("owned elsewhere").ValueOrDie()));
+  ASSERT_FALSE(from_string->Equals(*Buffer::FromString("owned")));
+}
+
+}  // namespace iceberg
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "iceberg/io/buffered.hh"
+
+namespace iceberg {
+namespace io {
+
+// A seekable stream over a string that counts the calls made on it
+class StringInputStream : public SeekableInputStream {
+ public:
+  explicit StringInputStream(std::string data) : data_(std::move(data)) {}
+
+  Status Close() override {
+    closed_ = true;
+    return Status::OK();
+  }
+
+  Result<int64_t> Tell() const override { return position_; }
+
+  bool closed() const override { return closed_; }
+
+  Result<int64_t> Read(int64_t nbytes, void* out) override {
+    ++reads;
+    const int64_t available = static_cast<int64_t>(data_.size()) - position_;
+    const int64_t bytes_read = std::max<int64_t>(0, std::min(nbytes, available));
+    std::memcpy(out, data_.data() + position_, static_cast<size_t>(bytes_read));
+    position_ += bytes_read;
+    return bytes_read;
+  }
+
+  Status Seek(int64_t position) override {
+    ++seeks;
+    position_ = position;
+    return Status::OK();
+  }
+
+  int reads = 0;
+  int seeks = 0;
+
+ private:
+  std::string data_;
+  int64_t position_ = 0;
+  bool closed_ = false;
+};
+
+class BufferedInputStreamTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    for (int i = 0; i < 1000; ++i) {
+      content.push_back(static_cast<char>('a' + i % 26));
+    }
+    raw = std::make_shared<StringInputStream>(content);
+    stream = BufferedInputStream::Create(64, raw).ValueOrDie();
+  }
+
+  std::string content;
+  std::shared_ptr<StringInputStream> raw;
+  std::shared_ptr<BufferedInputStream> stream;
+};
+
+TEST_F(BufferedInputStreamTest, SmallReadsHitTheBuffer) {
+  char out[4];
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_EQ(stream->Read(4, out).ValueOrDie(), 4);
+    ASSERT_EQ(std::string(out, 4), content.substr(i * 4, 4));
+  }
+  ASSERT_EQ(raw->reads, 1);
+  ASSERT_EQ(stream->Tell().ValueOrDie(), 64);
+  ASSERT_EQ(stream->bytes_buffered(), 0);
+
+  // Reads at least as large as the buffer bypass it
+  std::string large(200, '\0');
+  ASSERT_EQ(stream->Read(200, large.data()).ValueOrDie(), 200);
+  ASSERT_EQ(large, content.substr(64, 200));
+  ASSERT_EQ(raw->reads, 2);
+  ASSERT_EQ(stream->bytes_buffered(), 0);
+}
+
+TEST_F(BufferedInputStreamTest, ReadBuffer) {
+  auto buffer = stream->Read(10).ValueOrDie();
+  ASSERT_EQ(buffer->ToStringView(), content.substr(0, 10));
+  ASSERT_TRUE(stream->Advance(985).ok());
+  buffer = stream->Read(10).ValueOrDie();
+  ASSERT_EQ(buffer->ToStringView(), content.substr(995));
+}
+
+TEST_F(BufferedInputStreamTest, Peek) {
+  auto view = stream->Peek(10).ValueOrDie();
+  ASSERT_EQ(view, content.substr(0, 10));
+  ASSERT_EQ(stream->Tell().ValueOrDie(), 0);
+
+  // Peeking past the buffer size grows the buffer
+  view = stream->Peek(100).ValueOrDie();
+  ASSERT_EQ(view, content.substr(0, 100));
+
+  char out[10];
+  ASSERT_EQ(stream->Read(10, out).ValueOrDie(), 10);
+  ASSERT_EQ(std::string(out, 10), content.substr(0, 10));
+  ASSERT_EQ(stream->Peek(5).ValueOrDie(), content.substr(10, 5));
+
+  ASSERT_TRUE(stream->Advance(980).ok());
+  ASSERT_EQ(stream->Peek(50).ValueOrDie(), content.substr(990));
+}
+
+TEST_F(BufferedInputStreamTest, AdvanceSeeksOnTheRawStream) {
+  char out[8];
+  ASSERT_EQ(stream->Read(8, out).ValueOrDie(), 8);
+  ASSERT_EQ(raw->reads, 1);
+
+  // Skipping within the buffer costs nothing
+  ASSERT_TRUE(stream->Advance(40).ok());
+  ASSERT_EQ(raw->reads, 1);
+  ASSERT_EQ(raw->seeks, 0);
+  ASSERT_EQ(stream->Tell().ValueOrDie(), 48);
+
+  // Skipping past it becomes a seek
+  ASSERT_TRUE(stream->Advance(500).ok());
+  ASSERT_EQ(raw->reads, 1);
+  ASSERT_EQ(raw->seeks, 1);
+  ASSERT_EQ(stream->Tell().ValueOrDie(), 548);
+  ASSERT_EQ(stream->Read(8, out).ValueOrDie(), 8);
+  ASSERT_EQ(std::string(out, 8), content.substr(548, 8));
+
+  ASSERT_TRUE(stream->Close().ok());
+  ASSERT_TRUE(raw->closed());
+  ASSERT_TRUE(stream->Read(1, out).status().IsInvalid());
+}
+
+// An output stream appending to a string that counts the calls made on it
+class StringOutputStream : public OutputStream {
+ public:
+  Status Close() override {
+    closed_ = true;
+    return Status::OK();
+  }
+
+  Result<int64_t> Tell() const override { return static_cast<int64_t>(data.size()); }
+
+  bool closed() const override { return closed_; }
+
+  Status Write(const void* bytes, int64_t nbytes) override {
+    if (full) {
+      return Status::IOError("No space left on device");
+    }
+    ++writes;
+    data.append(reinterpret_cast<const char*>(bytes), static_cast<size_t>(nbytes));
+    return Status::OK();
+  }
+
+  Status Flush() override {
+    ++flushes;
+    return Status::OK();
+  }
+
+  Status Sync() override {
+    ++syncs;
+    return Status::OK();
+  }
+
+  std::string data;
+  int writes = 0;
+  int flushes = 0;
+  int syncs = 0;
+  // Fail writes, as a full disk would
+  bool full = false;
+
+ private:
+  bool closed_ = false;
+};
+
+TEST(BufferedOutputStream, CoalescesSmallWrites) {
+  auto raw = std::make_shared<StringOutputStream>();
+  auto stream = BufferedOutputStream::Create(64, raw).ValueOrDie();
+  std::string expected;
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_TRUE(stream->Write("0123456789").ok());
+    expected += "0123456789";
+    ASSERT_EQ(stream->Tell().ValueOrDie(), static_cast<int64_t>(expected.size()));
+  }
+  ASSERT_EQ(raw->writes, 3);
+  ASSERT_EQ(stream->bytes_buffered(), 200 - 3 * 60);
+
+  ASSERT_TRUE(stream->Flush().ok());
+  ASSERT_EQ(raw->data, expected);
+  ASSERT_EQ(raw->flushes, 1);
+  ASSERT_EQ(raw->syncs, 0);
+
+  // Large writes go straight through
+  std::string large(100, 'x');
+  ASSERT_TRUE(stream->Write("abc").ok());
+  ASSERT_TRUE(stream->Write(large).ok());
+  ASSERT_EQ(raw->data, expected + "abc" + large);
+
+  // Large buffers are handed over without copying
+  auto buffer = Buffer::FromString(std::string(64, 'y'));
+  ASSERT_TRUE(stream->Write(buffer).ok());
+  ASSERT_TRUE(stream->Write(Buffer::FromString("z")).ok());
+  ASSERT_EQ(stream->bytes_buffered(), 1);
+  large += std::string(64, 'y') + "z";
+
+  ASSERT_TRUE(stream->Write("tail").ok());
+  ASSERT_TRUE(stream->Sync().ok());
+  ASSERT_EQ(raw->syncs, 1);
+  ASSERT_TRUE(stream->Write("end").ok());
+  ASSERT_TRUE(stream->Close().ok());
+  ASSERT_TRUE(raw->closed());
+  ASSERT_EQ(raw->data, expected + "abc" + large + "tailend");
+}
+
+TEST(BufferedOutputStream, DestructorSurvivesFailedFlush) {
+  auto raw = std::make_shared<StringOutputStream>();
+  {
+    auto stream = BufferedOutputStream::Create(64, raw).ValueOrDie();
+    ASSERT_TRUE(stream->Write("buffered").ok());
+    raw->full = true;
+  }
+  ASSERT_TRUE(raw->closed());
+  ASSERT_TRUE(raw->data.empty());
+
+  auto stream = BufferedOutputStream::Create(64, raw).ValueOrDie();
+  ASSERT_TRUE(stream->Write("buffered").ok());
+  ASSERT_TRUE(stream->Close().IsIOError());
+}
+
+}  // namespace io
+}  // namespace iceberg
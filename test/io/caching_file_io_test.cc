@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iceberg/io/caching_file_io.hh"
+#include "iceberg/io/local_file_io.hh"
+
+namespace iceberg {
+namespace io {
+
+class CachingFileIOTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    for (int i = 0; i < 10000; ++i) {
+      content.push_back(static_cast<char>('a' + i % 26));
+    }
+    auto local = std::make_shared<LocalFileIO>();
+    auto out = local->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+    ASSERT_TRUE(out->Write(content).ok());
+    ASSERT_TRUE(out->Close().ok());
+
+    BlockCacheOptions options;
+    options.block_size = 1024;
+    options.capacity = 64 * 1024;
+    options.num_shards = 4;
+    fs = std::make_shared<CachingFileIO>(local, options);
+  }
+
+  void TearDown() override { ASSERT_TRUE(fs->DeleteFile(path).ok()); }
+
+  const std::string path = "/tmp/iceberg_caching_file_io.txt";
+  std::string content;
+  std::shared_ptr<CachingFileIO> fs;
+};
+
+TEST_F(CachingFileIOTest, ServesRepeatedReadsFromCache) {
+  auto in = fs->newInputFile(path).ValueOrDie();
+  ASSERT_EQ(in->getLength().ValueOrDie(), 10000);
+  auto stream = in->newStream().ValueOrDie();
+
+  std::string out(3000, '\0');
+  ASSERT_EQ(stream->ReadAt(500, 3000, out.data()).ValueOrDie(), 3000);
+  ASSERT_EQ(out, content.substr(500, 3000));
+  auto stats = fs->cache()->stats();
+  ASSERT_EQ(stats.hits, 0);
+  ASSERT_EQ(stats.misses, 4);
+  ASSERT_EQ(fs->cache()->size(), 4 * 1024);
+
+  // A second stream of the same file hits the cache
+  auto other = fs->newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_EQ(other->ReadAt(1024, 100).ValueOrDie()->ToString(), content.substr(1024, 100));
+  ASSERT_EQ(fs->cache()->stats().hits, 1);
+
+  // Sequential reads through the end of the file
+  std::string tail(500, '\0');
+  ASSERT_TRUE(other->Seek(9800).ok());
+  ASSERT_EQ(other->Read(500, tail.data()).ValueOrDie(), 200);
+  ASSERT_EQ(tail.substr(0, 200), content.substr(9800));
+  ASSERT_EQ(other->Read(10, tail.data()).ValueOrDie(), 0);
+
+  // Blocks fetched together are cached separately, not as slices of one read
+  auto block = fs->cache()->Lookup(path, 2);
+  ASSERT_EQ(block->size(), 1024);
+  ASSERT_EQ(block->parent(), nullptr);
+}
+
+TEST_F(CachingFileIOTest, EvictsWithinBudget) {
+  BlockCacheOptions options;
+  options.block_size = 1024;
+  options.capacity = 4 * 1024;
+  options.num_shards = 1;
+  auto small = std::make_shared<CachingFileIO>(fs->base(), options);
+  auto stream = small->newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  std::string out(10000, '\0');
+  ASSERT_EQ(stream->ReadAt(0, 10000, out.data()).ValueOrDie(), 10000);
+  ASSERT_EQ(out, content);
+  ASSERT_LE(small->cache()->size(), 4 * 1024);
+  ASSERT_EQ(small->cache()->stats().evictions, 6);
+
+  ASSERT_TRUE(small->DeleteFile(path).ok());
+  ASSERT_EQ(small->cache()->size(), 0);
+  auto local = fs->base();
+  auto rewrite = local->newOutputFile(path).ValueOrDie()->create().ValueOrDie();
+  ASSERT_TRUE(rewrite->Write(content).ok());
+  ASSERT_TRUE(rewrite->Close().ok());
+}
+
+TEST(BlockCacheTest, ConcurrentMissesShareOneFetch) {
+  BlockCache cache;
+  auto owner = cache.Claim("/f", 3);
+  ASSERT_TRUE(owner.owner);
+  auto joined = cache.Claim("/f", 3);
+  ASSERT_FALSE(joined.owner);
+  ASSERT_EQ(joined.pending, owner.pending);
+
+  std::thread waiter([&]() {
+    auto block = joined.pending->Wait();
+    ASSERT_TRUE(block.ok());
+    ASSERT_EQ((*block)->ToString(), "block");
+  });
+  cache.Complete("/f", 3, owner.pending, Buffer::FromString("block"));
+  waiter.join();
+  ASSERT_EQ(cache.Claim("/f", 3).block->ToString(), "block");
+
+  // A failed fetch is reported to its waiters and not cached
+  auto failed = cache.Claim("/f", 4);
+  auto failed_joined = cache.Claim("/f", 4);
+  cache.Complete("/f", 4, failed.pending, Status::IOError("unreadable"));
+  ASSERT_TRUE(failed_joined.pending->Wait().status().IsIOError());
+  ASSERT_TRUE(cache.Claim("/f", 4).owner);
+
+  // A fetch racing an Erase does not cache what may be the old file's block
+  auto stale = cache.Claim("/f", 5);
+  cache.Erase("/f");
+  ASSERT_EQ(cache.Lookup("/f", 3), nullptr);
+  auto fresh = cache.Claim("/f", 5);
+  ASSERT_TRUE(fresh.owner);
+  cache.Complete("/f", 5, stale.pending, Buffer::FromString("old"));
+  ASSERT_EQ(cache.Lookup("/f", 5), nullptr);
+  cache.Complete("/f", 5, fresh.pending, Buffer::FromString("new"));
+  ASSERT_EQ(cache.Lookup("/f", 5)->ToString(), "new");
+  ASSERT_EQ(cache.size(), 3);
+}
+
+TEST_F(CachingFileIOTest, SharedAcrossThreads) {
+  auto stream = fs->newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  std::vector<std::thread> threads;
+  std::vector<int> matched(8, 0);
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t]() {
+      bool ok = true;
+      char buffer[300];
+      for (int64_t pos = t * 7; pos + 300 <= 10000; pos += 211) {
+        auto res = stream->ReadAt(pos, 300, buffer);
+        ok = ok && res.ok() && std::string(buffer, 300) == content.substr(pos, 300);
+      }
+      matched[t] = ok ? 1 : 0;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int ok : matched) {
+    ASSERT_TRUE(ok);
+  }
+  ASSERT_LE(fs->cache()->size(), 10 * 1024);
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,168 @@
+#include "iceberg/io/checksum.hh"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/memory_file_io.hh"
+#include "iceberg/util/crc32c.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+std::string MakeContent(int64_t size) {
+  std::string content;
+  for (int64_t i = 0; i < size; ++i) {
+    content.push_back(static_cast<char>(i * 7 + i / 251));
+  }
+  return content;
+}
+
+}  // namespace
+
+TEST(FileChecksumsTest, Serialize) {
+  const std::string content = MakeContent(1000);
+  auto checksums = ComputeChecksums(content.data(), content.size(), 300);
+  ASSERT_EQ(checksums.num_blocks(), 4);
+  ASSERT_EQ(checksums.crcs[3], util::Crc32c(content.data() + 900, 100));
+  auto data = checksums.Serialize();
+  auto parsed = FileChecksums::Deserialize(data).ValueOrDie();
+  ASSERT_EQ(parsed.length, 1000);
+  ASSERT_EQ(parsed.block_size, 300);
+  ASSERT_EQ(parsed.crcs, checksums.crcs);
+
+  auto whole = ComputeChecksums(content.data(), 0, 0);
+  ASSERT_EQ(FileChecksums::Deserialize(whole.Serialize()).ValueOrDie().crcs,
+            std::vector<uint32_t>{0});
+
+  data[10] ^= 1;
+  ASSERT_TRUE(FileChecksums::Deserialize(data).status().IsIOError());
+  ASSERT_TRUE(FileChecksums::Deserialize("ICRC").status().IsIOError());
+}
+
+class ChecksumFileIOTest : public ::testing::TestWithParam<int64_t> {
+ protected:
+  void SetUp() override {
+    base = std::make_shared<MemoryFileIO>();
+    ChecksumOptions options;
+    options.block_size = GetParam();
+    fs = std::make_shared<ChecksumFileIO>(base, options);
+  }
+
+  void WriteFile(FileIO* io, const std::string& path, const std::string& content,
+                 int64_t chunk = 333) {
+    auto out = io->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+    for (size_t i = 0; i < content.size(); i += chunk) {
+      ASSERT_TRUE(out->Write(std::string_view(content).substr(i, chunk)).ok());
+    }
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  std::shared_ptr<MemoryFileIO> base;
+  std::shared_ptr<ChecksumFileIO> fs;
+};
+
+TEST_P(ChecksumFileIOTest, ReadVerified) {
+  const std::string content = MakeContent(10000);
+  WriteFile(fs.get(), "mem://t/a", content);
+  ASSERT_TRUE(base->newInputFile("mem://t/a.crc").ValueOrDie()->exists());
+
+  auto stream = fs->newInputFile("mem://t/a").ValueOrDie()->newStream().ValueOrDie();
+  std::string read;
+  for (auto chunk = stream->Read(77).ValueOrDie(); chunk->size() > 0;
+       chunk = stream->Read(77).ValueOrDie()) {
+    read += chunk->ToString();
+  }
+  ASSERT_EQ(read, content);
+  ASSERT_EQ(stream->ReadAt(1234, 4000).ValueOrDie()->ToString(),
+            content.substr(1234, 4000));
+  ASSERT_EQ(stream->ReadAt(9990, 100).ValueOrDie()->ToString(), content.substr(9990));
+  ASSERT_EQ(stream->ReadAt(20000, 100).ValueOrDie()->size(), 0);
+  ASSERT_TRUE(stream->Seek(5000).ok());
+  ASSERT_EQ(stream->Read(10).ValueOrDie()->ToString(), content.substr(5000, 10));
+
+  auto ranges = stream->ReadRanges({{0, 100}, {4096, 5000}}).ValueOrDie();
+  ASSERT_EQ(ranges[1]->ToString(), content.substr(4096, 5000));
+
+  // Empty files are checksummed too
+  WriteFile(fs.get(), "mem://t/empty", "");
+  stream = fs->newInputFile("mem://t/empty").ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_EQ(stream->Read(10).ValueOrDie()->size(), 0);
+}
+
+TEST_P(ChecksumFileIOTest, DetectsCorruption) {
+  std::string content = MakeContent(10000);
+  WriteFile(fs.get(), "mem://t/a", content);
+  // Flip a bit behind the checksums' back
+  content[6000] ^= 0x10;
+  WriteFile(base.get(), "mem://t/a", content);
+
+  auto stream = fs->newInputFile("mem://t/a").ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_TRUE(stream->Read(content.size()).status().IsIOError());
+  if (GetParam() > 0 && GetParam() <= 4096) {
+    // Only the corrupted block fails
+    ASSERT_TRUE(stream->ReadAt(0, 4096).ok());
+    ASSERT_TRUE(stream->ReadAt(5999, 2).status().IsIOError());
+    ASSERT_TRUE(stream->ReadRanges({{5000, 2000}}).status().IsIOError());
+  }
+
+  // A truncated file is caught before reading
+  WriteFile(base.get(), "mem://t/a", content.substr(0, 9999));
+  auto file = fs->newInputFile("mem://t/a").ValueOrDie();
+  ASSERT_TRUE(file->newStream().status().IsIOError());
+}
+
+TEST_P(ChecksumFileIOTest, MissingChecksums) {
+  WriteFile(base.get(), "mem://t/plain", "plain");
+  auto stream = fs->newInputFile("mem://t/plain").ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_EQ(stream->Read(10).ValueOrDie()->ToString(), "plain");
+
+  ChecksumOptions options;
+  options.require_checksums = true;
+  ChecksumFileIO strict(base, options);
+  auto file = strict.newInputFile("mem://t/plain").ValueOrDie();
+  ASSERT_TRUE(file->newStream().status().IsIOError());
+}
+
+TEST_P(ChecksumFileIOTest, ListCopyAndDelete) {
+  WriteFile(fs.get(), "mem://t/a", MakeContent(5000));
+  WriteFile(fs.get(), "mem://t/b", MakeContent(10));
+  WriteFile(base.get(), "mem://t/c", "c");
+
+  auto list = [&]() {
+    auto it = fs->ListPrefix("mem://t/").ValueOrDie();
+    std::set<std::string> listed;
+    for (auto batch = it->Next().ValueOrDie(); !batch.empty();
+         batch = it->Next().ValueOrDie()) {
+      for (const auto& info : batch) {
+        listed.insert(info.location());
+      }
+    }
+    return listed;
+  };
+  ASSERT_EQ(list(), (std::set<std::string>{"mem://t/a", "mem://t/b", "mem://t/c"}));
+
+  ASSERT_TRUE(fs->CopyFile("mem://t/a", "mem://t/d").ok());
+  ASSERT_TRUE(base->newInputFile("mem://t/d.crc").ValueOrDie()->exists());
+  auto stream = fs->newInputFile("mem://t/d").ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_EQ(stream->Read(5000).ValueOrDie()->ToString(), MakeContent(5000));
+  ASSERT_TRUE(fs->CopyFile("mem://t/c", "mem://t/e").ok());
+  ASSERT_FALSE(base->newInputFile("mem://t/e.crc").ValueOrDie()->exists());
+
+  ASSERT_TRUE(fs->DeleteFile("mem://t/a").ok());
+  ASSERT_TRUE(fs->DeleteFile("mem://t/c").ok());
+  ASSERT_FALSE(base->newInputFile("mem://t/a.crc").ValueOrDie()->exists());
+  ASSERT_EQ(list(), (std::set<std::string>{"mem://t/b", "mem://t/d", "mem://t/e"}));
+  ASSERT_EQ(base->num_files(), 5);
+}
+
+INSTANTIATE_TEST_SUITE_P(BlockSizes, ChecksumFileIOTest,
+                         ::testing::Values(0, 1024, 4096, 64 * 1024));
+
+}  // namespace io
+}  // namespace iceberg
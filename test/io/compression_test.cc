@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <memory>
+#include <string>
+
+#include "iceberg/io/compression.hh"
+#include "iceberg/io/instrumented_file_io.hh"
+#include "iceberg/io/local_file_io.hh"
+#include "iceberg/io/memory.hh"
+#include "iceberg/io/memory_file_io.hh"
+
+namespace iceberg {
+namespace io {
+
+class CompressionTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    fs = std::make_shared<MemoryFileIO>();
+    // Compressible, but not trivially so
+    for (int i = 0; i < 20000; ++i) {
+      content += "{\"snapshot-id\": " + std::to_string(i * 7919 % 100003) + "},\n";
+    }
+  }
+
+  void WriteCompressed(const std::string& path, CompressionOptions options = {}) {
+    auto raw = fs->newOutputFile(path).ValueOrDie()->create().ValueOrDie();
+    auto out = MaybeCompress(CompressionCodecFromPath(path), raw, options).ValueOrDie();
+    for (size_t pos = 0; pos < content.size(); pos += 1000) {
+      ASSERT_TRUE(out->Write(content.substr(pos, 1000)).ok());
+    }
+    ASSERT_EQ(out->Tell().ValueOrDie(), content.size());
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  std::string ReadAll(const std::shared_ptr<InputStream>& stream, int64_t chunksize) {
+    std::string result;
+    while (true) {
+      auto chunk = stream->Read(chunksize).ValueOrDie();
+      if (chunk->size() == 0) {
+        break;
+      }
+      result += chunk->ToString();
+    }
+    return result;
+  }
+
+  std::shared_ptr<MemoryFileIO> fs;
+  std::string content;
+};
+
+TEST(CompressionCodecTest, Names) {
+  ASSERT_EQ(CompressionCodecFromName("GZIP").ValueOrDie(), CompressionCodec::GZIP);
+  ASSERT_EQ(CompressionCodecFromName("none").ValueOrDie(), CompressionCodec::NONE);
+  ASSERT_EQ(CompressionCodecFromName("zstd").ValueOrDie(), CompressionCodec::ZSTD);
+  ASSERT_TRUE(CompressionCodecFromName("lz4").status().IsInvalid());
+  ASSERT_STREQ(CompressionCodecName(CompressionCodec::GZIP), "gzip");
+
+  ASSERT_EQ(CompressionCodecFromPath("s3://b/t/metadata/00001-a.gz.metadata.json"),
+            CompressionCodec::GZIP);
+  ASSERT_EQ(CompressionCodecFromPath("/t/metadata/v3.metadata.json.gz"),
+            CompressionCodec::GZIP);
+  ASSERT_EQ(CompressionCodecFromPath("/t/metadata/v3.zst.metadata.json"),
+            CompressionCodec::ZSTD);
+  ASSERT_EQ(CompressionCodecFromPath("/t.gz.d/metadata/v3.metadata.json"),
+            CompressionCodec::NONE);
+  ASSERT_EQ(CompressionCodecFromPath("/t/metadata/v3.metadata.json"),
+            CompressionCodec::NONE);
+}
+
+TEST_F(CompressionTest, GzipRoundTrip) {
+  const std::string path = "/t/metadata/v1.gz.metadata.json";
+  WriteCompressed(path);
+  ASSERT_LT(fs->size(), content.size() / 4);
+
+  auto stream = OpenDecompressedStream(fs->newInputFile(path).ValueOrDie()).ValueOrDie();
+  ASSERT_EQ(ReadAll(stream, 4093), content);
+  ASSERT_EQ(stream->Tell().ValueOrDie(), content.size());
+  ASSERT_TRUE(stream->Close().ok());
+}
+
+TEST_F(CompressionTest, UncompressedPassThrough) {
+  const std::string path = "/t/metadata/v1.metadata.json";
+  WriteCompressed(path);
+  ASSERT_EQ(fs->size(), content.size());
+  auto stream = OpenDecompressedStream(fs->newInputFile(path).ValueOrDie()).ValueOrDie();
+  ASSERT_EQ(ReadAll(stream, 100000), content);
+}
+
+TEST_F(CompressionTest, DecompressesIncrementally) {
+  const std::string path = "/t/metadata/v1.gz.metadata.json";
+  WriteCompressed(path);
+  auto instrumented = std::make_shared<InstrumentedFileIO>(fs);
+  CompressionOptions options;
+  options.buffer_size = 1024;
+  auto stream =
+      OpenDecompressedStream(instrumented->newInputFile(path).ValueOrDie(), options)
+          .ValueOrDie();
+  ASSERT_EQ(stream->Read(100).ValueOrDie()->ToString(), content.substr(0, 100));
+  // Only the first compressed chunk was pulled from the file
+  ASSERT_EQ(instrumented->metrics()[IOOperation::READ].bytes, 1024);
+  ASSERT_EQ(ReadAll(stream, 1000), content.substr(100));
+}
+
+TEST_F(CompressionTest, FlushMakesDataReadable) {
+  const std::string path = "/tmp/iceberg_compression_flush.log.gz";
+  auto local = std::make_shared<LocalFileIO>();
+  auto raw = local->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  auto out = CompressingOutputStream::Create(CompressionCodec::GZIP, raw).ValueOrDie();
+  ASSERT_TRUE(out->Write(content.substr(0, 5000)).ok());
+  ASSERT_TRUE(out->Flush().ok());
+  ASSERT_TRUE(out->Flush().ok());
+
+  // Everything written before the flush can be decoded from the bytes so far
+  auto in = OpenDecompressedStream(local->newInputFile(path).ValueOrDie()).ValueOrDie();
+  std::string decoded(5000, '\0');
+  ASSERT_EQ(in->Read(5000, decoded.data()).ValueOrDie(), 5000);
+  ASSERT_EQ(decoded, content.substr(0, 5000));
+  ASSERT_TRUE(in->Read(10, decoded.data()).status().IsIOError());
+  ASSERT_TRUE(out->Close().ok());
+  ASSERT_TRUE(local->DeleteFile(path).ok());
+}
+
+TEST_F(CompressionTest, ReadsGzipFiles) {
+  // Two members, as written by concatenating gzip files
+  const std::string path = "/tmp/iceberg_compression_test.json.gz";
+  for (const char* mode : {"wb", "ab"}) {
+    gzFile file = gzopen(path.c_str(), mode);
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(gzwrite(file, content.data(), content.size()), content.size());
+    ASSERT_EQ(gzclose(file), Z_OK);
+  }
+  auto local = std::make_shared<LocalFileIO>();
+  auto file = local->newInputFile(path).ValueOrDie();
+  auto stream = OpenDecompressedStream(file).ValueOrDie();
+  ASSERT_EQ(ReadAll(stream, 65536), content + content);
+  ASSERT_TRUE(local->DeleteFile(path).ok());
+}
+
+TEST_F(CompressionTest, TruncatedStream) {
+  const std::string path = "/t/v1.gz.metadata.json";
+  WriteCompressed(path);
+  auto data = fs->newInputFile(path).ValueOrDie()->newStream().ValueOrDie()->Read(
+      fs->size() - 10);
+  auto stream =
+      DecompressingInputStream::Create(CompressionCodec::GZIP,
+                                       std::make_shared<BufferReader>(data.ValueOrDie()))
+          .ValueOrDie();
+  std::string out(content.size(), '\0');
+  ASSERT_TRUE(stream->Read(content.size(), out.data()).status().IsIOError());
+}
+
+TEST_F(CompressionTest, Zstd) {
+  const std::string path = "/t/v1.zst.metadata.json";
+  if (!IsCompressionCodecAvailable(CompressionCodec::ZSTD)) {
+    auto raw = fs->newOutputFile(path).ValueOrDie()->create().ValueOrDie();
+    ASSERT_TRUE(MaybeCompress(CompressionCodec::ZSTD, raw).status().IsNotImplemented());
+    return;
+  }
+  WriteCompressed(path);
+  auto stream = OpenDecompressedStream(fs->newInputFile(path).ValueOrDie()).ValueOrDie();
+  ASSERT_EQ(ReadAll(stream, 4093), content);
+}
+
+}  // namespace io
+}  // namespace iceberg
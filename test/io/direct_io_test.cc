@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+
+#include <memory>
+#include <string>
+
+#include "iceberg/io/direct_io.hh"
+#include "iceberg/io/local_file_io.hh"
+
+namespace iceberg {
+namespace io {
+
+class DirectIOTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    LocalFileIOOptions options;
+    options.use_direct_io = true;
+    options.direct_io.buffer_size = 16 * 1024;
+    fs = std::make_shared<LocalFileIO>(options);
+    // Not a multiple of the block size, so the file ends with an unaligned tail
+    for (int i = 0; i < 100003; ++i) {
+      content.push_back(static_cast<char>('a' + i % 29));
+    }
+  }
+
+  void TearDown() override { std::remove(path.c_str()); }
+
+  void WriteContent() {
+    auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+    ASSERT_NE(std::dynamic_pointer_cast<DirectFileOutputStream>(out), nullptr);
+    // Odd-sized writes straddle the aligned buffer boundaries
+    for (size_t pos = 0; pos < content.size(); pos += 777) {
+      ASSERT_TRUE(out->Write(content.substr(pos, 777)).ok());
+    }
+    ASSERT_EQ(out->Tell().ValueOrDie(), content.size());
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  const std::string path = "/tmp/iceberg_direct_io.bin";
+  std::shared_ptr<LocalFileIO> fs;
+  std::string content;
+};
+
+TEST_F(DirectIOTest, WritesUnalignedTail) {
+  WriteContent();
+  auto in = LocalFileIO().newInputFile(path).ValueOrDie();
+  ASSERT_EQ(in->getLength().ValueOrDie(), content.size());
+  auto stream = in->newStream().ValueOrDie();
+  ASSERT_EQ(stream->Read(content.size() + 10).ValueOrDie()->ToString(), content);
+}
+
+TEST_F(DirectIOTest, ReadsUnalignedRanges) {
+  WriteContent();
+  auto stream = fs->newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_NE(std::dynamic_pointer_cast<DirectFileInputStream>(stream), nullptr);
+
+  std::string out(50000, '\0');
+  ASSERT_EQ(stream->ReadAt(1234, 50000, out.data()).ValueOrDie(), 50000);
+  ASSERT_EQ(out, content.substr(1234, 50000));
+  ASSERT_EQ(stream->ReadAt(99990, 100).ValueOrDie()->ToString(), content.substr(99990));
+  ASSERT_EQ(stream->ReadAt(200000, 100).ValueOrDie()->size(), 0);
+
+  // Aligned reads into aligned memory go straight to the file
+  auto aligned = internal::AllocateAlignedBuffer(8192, 4096).ValueOrDie();
+  ASSERT_EQ(stream->ReadAt(4096, 8192, aligned->mutable_data()).ValueOrDie(), 8192);
+  ASSERT_EQ(aligned->ToString(), content.substr(4096, 8192));
+
+  ASSERT_TRUE(stream->Seek(98304).ok());
+  ASSERT_EQ(stream->Read(5000).ValueOrDie()->ToString(), content.substr(98304));
+}
+
+TEST_F(DirectIOTest, FlushWritesTail) {
+  auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write(content.substr(0, 5000)).ok());
+  ASSERT_TRUE(out->Flush().ok());
+  auto in = LocalFileIO().newInputFile(path).ValueOrDie();
+  ASSERT_EQ(in->getLength().ValueOrDie(), 5000);
+  // The partial block is rewritten once it fills up
+  ASSERT_TRUE(out->Write(content.substr(5000)).ok());
+  ASSERT_TRUE(out->Sync().ok());
+  ASSERT_TRUE(out->Close().ok());
+  auto stream = fs->newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_EQ(stream->Read(content.size()).ValueOrDie()->ToString(), content);
+}
+
+TEST_F(DirectIOTest, FallsBackWithoutDirectIOSupport) {
+  internal::SimulateDirectIOUnsupported(true);
+  auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_EQ(std::dynamic_pointer_cast<DirectFileOutputStream>(out), nullptr);
+  ASSERT_TRUE(out->Write(content).ok());
+  ASSERT_TRUE(out->Close().ok());
+  auto stream = fs->newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_EQ(std::dynamic_pointer_cast<DirectFileInputStream>(stream), nullptr);
+  ASSERT_EQ(stream->Read(content.size()).ValueOrDie()->ToString(), content);
+  internal::SimulateDirectIOUnsupported(false);
+}
+
+TEST(AlignedBufferTest, RecyclesMemory) {
+  const uint8_t* data;
+  {
+    auto buffer = internal::AllocateAlignedBuffer(12288, 4096).ValueOrDie();
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(buffer->data()) % 4096, 0);
+    ASSERT_TRUE(buffer->is_mutable());
+    data = buffer->data();
+  }
+  ASSERT_EQ(internal::AllocateAlignedBuffer(12288, 4096).ValueOrDie()->data(), data);
+  ASSERT_FALSE(internal::AllocateAlignedBuffer(100, 3000).ok());
+}
+
+TEST(DirectIOOptionsTest, Validation) {
+  DirectIOOptions options;
+  options.buffer_size = 1000;
+  ASSERT_TRUE(internal::ValidateDirectIOOptions(options).IsInvalid());
+  LocalFileIOOptions local;
+  local.use_direct_io = true;
+  local.direct_io = options;
+  auto out = LocalFileIO(local).newOutputFile("/tmp/iceberg_direct_io_invalid.bin");
+  ASSERT_TRUE(out.ValueOrDie()->createOrOverwrite().status().IsInvalid());
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,283 @@
+#include "iceberg/io/disk_cache.hh"
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iceberg/io/instrumented_file_io.hh"
+#include "iceberg/io/memory_file_io.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+std::string MakeContent(int64_t size, int seed = 0) {
+  std::string content;
+  for (int64_t i = 0; i < size; ++i) {
+    content.push_back(static_cast<char>(i * 7 + i / 251 + seed));
+  }
+  return content;
+}
+
+}  // namespace
+
+class DiskCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::filesystem::remove_all(kDir);
+    // Stands in for remote storage, counting the reads that reach it
+    remote = std::make_shared<InstrumentedFileIO>(std::make_shared<MemoryFileIO>());
+    options.directory = kDir;
+    options.block_size = 4096;
+    options.capacity = 64 * 4096;
+  }
+
+  void TearDown() override { std::filesystem::remove_all(kDir); }
+
+  void WriteFile(FileIO* fs, const std::string& path, const std::string& content) {
+    auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+    ASSERT_TRUE(out->Write(content).ok());
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  std::string ReadAt(FileIO* fs, const std::string& path, int64_t position,
+                     int64_t nbytes) {
+    auto file = fs->newInputFile(path).ValueOrDie();
+    auto stream = file->newStream().ValueOrDie();
+    return stream->ReadAt(position, nbytes).ValueOrDie()->ToString();
+  }
+
+  int64_t RemoteReads() const { return remote->metrics()[IOOperation::READ].count; }
+
+  const std::string kDir = "/tmp/iceberg_disk_cache";
+  std::shared_ptr<InstrumentedFileIO> remote;
+  DiskCacheOptions options;
+};
+
+TEST_F(DiskCacheTest, InvalidOptions) {
+  auto invalid = options;
+  invalid.directory.clear();
+  ASSERT_TRUE(DiskCache::Open(invalid).status().IsInvalid());
+  invalid = options;
+  invalid.capacity = options.block_size - 1;
+  ASSERT_TRUE(DiskCache::Open(invalid).status().IsInvalid());
+
+  auto cache = DiskCache::Open(options).ValueOrDie();
+  // The directory is locked while open
+  ASSERT_TRUE(DiskCache::Open(options).status().IsIOError());
+  cache.reset();
+  ASSERT_TRUE(DiskCache::Open(options).ok());
+}
+
+TEST_F(DiskCacheTest, HitsAvoidTheBase) {
+  const std::string content = MakeContent(10 * 4096 + 100);
+  WriteFile(remote.get(), "mem://bucket/a", content);
+  auto cache = DiskCache::Open(options).ValueOrDie();
+  DiskCachingFileIO fs(remote, cache);
+
+  ASSERT_EQ(ReadAt(&fs, "mem://bucket/a", 1000, 19000), content.substr(1000, 19000));
+  // The five missing blocks are fetched with one read
+  ASSERT_EQ(RemoteReads(), 1);
+  cache->WaitForPendingInserts();
+  ASSERT_EQ(cache->num_blocks(), 5);
+  ASSERT_EQ(cache->size(), 5 * 4096);
+
+  ASSERT_EQ(ReadAt(&fs, "mem://bucket/a", 4096, 12000), content.substr(4096, 12000));
+  ASSERT_EQ(RemoteReads(), 1);
+  ASSERT_EQ(ReadAt(&fs, "mem://bucket/a", 10 * 4096, 1000), content.substr(10 * 4096));
+  ASSERT_EQ(RemoteReads(), 2);
+  cache->WaitForPendingInserts();
+  ASSERT_EQ(cache->size(), 5 * 4096 + 100);
+
+  auto stats = cache->stats();
+  ASSERT_EQ(stats.hits, 3);
+  ASSERT_EQ(stats.insertions, 6);
+  ASSERT_EQ(stats.corruptions, 0);
+}
+
+TEST_F(DiskCacheTest, SurvivesRestart) {
+  const std::string content = MakeContent(8 * 4096);
+  WriteFile(remote.get(), "mem://bucket/a", content);
+  {
+    auto cache = DiskCache::Open(options).ValueOrDie();
+    DiskCachingFileIO fs(remote, cache);
+    ASSERT_EQ(ReadAt(&fs, "mem://bucket/a", 0, content.size()), content);
+    cache->WaitForPendingInserts();
+    ASSERT_TRUE(cache->Erase("mem://bucket/none").ok());
+  }
+  ASSERT_EQ(RemoteReads(), 1);
+
+  {
+    auto cache = DiskCache::Open(options).ValueOrDie();
+    ASSERT_EQ(cache->num_blocks(), 8);
+    DiskCachingFileIO fs(remote, cache);
+    ASSERT_EQ(ReadAt(&fs, "mem://bucket/a", 0, content.size()), content);
+    ASSERT_EQ(RemoteReads(), 1);
+  }
+
+  // Another configuration starts over
+  options.block_size = 8192;
+  ASSERT_EQ(DiskCache::Open(options).ValueOrDie()->num_blocks(), 0);
+}
+
+TEST_F(DiskCacheTest, TornIndexRecord) {
+  auto cache = DiskCache::Open(options).ValueOrDie();
+  ASSERT_TRUE(cache->Insert("mem://bucket/a", 0, *Buffer::FromString("first")).ok());
+  ASSERT_TRUE(cache->Insert("mem://bucket/a", 1, *Buffer::FromString("second")).ok());
+  cache.reset();
+
+  // Chop the last record short, as a crash while appending it would
+  const std::string index = kDir + "/index";
+  std::filesystem::resize_file(index, std::filesystem::file_size(index) - 3);
+  cache = DiskCache::Open(options).ValueOrDie();
+  ASSERT_EQ(cache->num_blocks(), 1);
+  ASSERT_EQ(cache->Lookup("mem://bucket/a", 0).ValueOrDie()->ToString(), "first");
+  ASSERT_EQ(cache->Lookup("mem://bucket/a", 1).ValueOrDie(), nullptr);
+}
+
+TEST_F(DiskCacheTest, DetectsCorruption) {
+  auto cache = DiskCache::Open(options).ValueOrDie();
+  ASSERT_TRUE(cache->Insert("mem://bucket/a", 0, *Buffer::FromString("block")).ok());
+
+  int fd = open((kDir + "/data").c_str(), O_WRONLY);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(pwrite(fd, "X", 1, 0), 1);
+  close(fd);
+
+  ASSERT_EQ(cache->Lookup("mem://bucket/a", 0).ValueOrDie(), nullptr);
+  auto stats = cache->stats();
+  ASSERT_EQ(stats.corruptions, 1);
+  ASSERT_EQ(stats.hits, 0);
+  ASSERT_EQ(stats.misses, 1);
+  ASSERT_EQ(cache->num_blocks(), 0);
+}
+
+TEST_F(DiskCacheTest, Eviction) {
+  for (auto eviction : {CacheEviction::LRU, CacheEviction::FIFO}) {
+    std::filesystem::remove_all(kDir);
+    options.capacity = 3 * 4096;
+    options.eviction = eviction;
+    auto cache = DiskCache::Open(options).ValueOrDie();
+    for (int64_t i = 0; i < 3; ++i) {
+      ASSERT_TRUE(cache->Insert("mem://bucket/a", i, *Buffer::FromString("b")).ok());
+    }
+    ASSERT_NE(cache->Lookup("mem://bucket/a", 0).ValueOrDie(), nullptr);
+    ASSERT_TRUE(cache->Insert("mem://bucket/a", 3, *Buffer::FromString("b")).ok());
+    ASSERT_EQ(cache->num_blocks(), 3);
+    ASSERT_EQ(cache->stats().evictions, 1);
+    // LRU keeps the block just read, FIFO drops the oldest stored
+    const int64_t evicted = eviction == CacheEviction::LRU ? 1 : 0;
+    ASSERT_EQ(cache->Lookup("mem://bucket/a", evicted).ValueOrDie(), nullptr);
+    ASSERT_NE(cache->Lookup("mem://bucket/a", 3).ValueOrDie(), nullptr);
+  }
+}
+
+TEST_F(DiskCacheTest, EvictionIsLoggedBeforeReuse) {
+  options.capacity = 2 * 4096;
+  options.verify_checksums = false;
+  auto cache = DiskCache::Open(options).ValueOrDie();
+  ASSERT_TRUE(cache->Insert("mem://bucket/a", 0, *Buffer::FromString("old0")).ok());
+  ASSERT_TRUE(cache->Insert("mem://bucket/a", 1, *Buffer::FromString("old1")).ok());
+  ASSERT_TRUE(cache->Insert("mem://bucket/b", 0, *Buffer::FromString("new0")).ok());
+  cache.reset();
+
+  // Drop the store record of the new block, as a crash right before appending it would
+  const std::string index = kDir + "/index";
+  const int64_t store_record = 33 + static_cast<int64_t>(strlen("mem://bucket/b"));
+  std::filesystem::resize_file(index, std::filesystem::file_size(index) - store_record);
+  cache = DiskCache::Open(options).ValueOrDie();
+  ASSERT_EQ(cache->num_blocks(), 1);
+  // The evicted block is not served from the slot now holding another's bytes
+  ASSERT_EQ(cache->Lookup("mem://bucket/a", 0).ValueOrDie(), nullptr);
+  ASSERT_EQ(cache->Lookup("mem://bucket/a", 1).ValueOrDie()->ToString(), "old1");
+  ASSERT_EQ(cache->Lookup("mem://bucket/b", 0).ValueOrDie(), nullptr);
+}
+
+TEST_F(DiskCacheTest, SecondAccessAdmission) {
+  options.admission = CacheAdmission::SECOND_ACCESS;
+  auto cache = DiskCache::Open(options).ValueOrDie();
+  auto block = Buffer::FromString("block");
+  ASSERT_TRUE(cache->Insert("mem://bucket/a", 0, *block).ok());
+  ASSERT_EQ(cache->num_blocks(), 0);
+  ASSERT_EQ(cache->stats().rejections, 1);
+  ASSERT_TRUE(cache->Insert("mem://bucket/b", 0, *block).ok());
+  ASSERT_TRUE(cache->Insert("mem://bucket/a", 0, *block).ok());
+  ASSERT_EQ(cache->num_blocks(), 1);
+  ASSERT_NE(cache->Lookup("mem://bucket/a", 0).ValueOrDie(), nullptr);
+}
+
+TEST_F(DiskCacheTest, WritesEraseCachedBlocks) {
+  {
+    auto cache = DiskCache::Open(options).ValueOrDie();
+    DiskCachingFileIO fs(remote, cache);
+    WriteFile(&fs, "mem://bucket/a", MakeContent(5000));
+    ASSERT_EQ(ReadAt(&fs, "mem://bucket/a", 0, 5000), MakeContent(5000));
+    cache->WaitForPendingInserts();
+    ASSERT_EQ(cache->num_blocks(), 2);
+
+    WriteFile(&fs, "mem://bucket/a", MakeContent(5000, 1));
+    ASSERT_EQ(cache->num_blocks(), 0);
+    ASSERT_EQ(ReadAt(&fs, "mem://bucket/a", 0, 5000), MakeContent(5000, 1));
+    cache->WaitForPendingInserts();
+
+    ASSERT_TRUE(fs.CopyFile("mem://bucket/a", "mem://bucket/b").ok());
+    ASSERT_EQ(ReadAt(&fs, "mem://bucket/b", 0, 5000), MakeContent(5000, 1));
+    cache->WaitForPendingInserts();
+    ASSERT_EQ(cache->num_blocks(), 4);
+    ASSERT_TRUE(fs.DeleteFile("mem://bucket/a").ok());
+    ASSERT_TRUE(fs.DeleteFiles({"mem://bucket/b"}).ok());
+    ASSERT_EQ(cache->num_blocks(), 0);
+    ASSERT_EQ(cache->size(), 0);
+  }
+  // Erased blocks stay erased across a restart
+  ASSERT_EQ(DiskCache::Open(options).ValueOrDie()->num_blocks(), 0);
+}
+
+TEST_F(DiskCacheTest, EraseKeepsInsertsOfOtherFiles) {
+  auto cache = DiskCache::Open(options).ValueOrDie();
+  ASSERT_TRUE(cache->Insert("mem://bucket/b", 0, *Buffer::FromString("b")).ok());
+  for (int i = 0; i < 16; ++i) {
+    cache->InsertAsync("mem://bucket/a", i, Buffer::FromString(std::to_string(i)));
+    ASSERT_TRUE(cache->Erase("mem://bucket/b").ok());
+  }
+  cache->WaitForPendingInserts();
+  ASSERT_EQ(cache->num_blocks(), 16);
+  ASSERT_EQ(cache->Lookup("mem://bucket/a", 7).ValueOrDie()->ToString(), "7");
+}
+
+TEST_F(DiskCacheTest, ConcurrentReaders) {
+  options.capacity = 8 * 4096;
+  const std::string content = MakeContent(32 * 4096);
+  WriteFile(remote.get(), "mem://bucket/a", content);
+  auto cache = DiskCache::Open(options).ValueOrDie();
+  auto fs = std::make_shared<DiskCachingFileIO>(remote, cache);
+  auto stream = fs->newInputFile("mem://bucket/a").ValueOrDie()->newStream().ValueOrDie();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 200; ++i) {
+        const int64_t position = ((i * 13 + t * 7) % 30) * 4096 + i;
+        auto data = stream->ReadAt(position, 6000).ValueOrDie();
+        ASSERT_EQ(data->ToString(), content.substr(position, 6000));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  cache->WaitForPendingInserts();
+  ASSERT_LE(cache->num_blocks(), 8);
+  ASSERT_EQ(cache->stats().corruptions, 0);
+}
+
+}  // namespace io
+}  // namespace iceberg
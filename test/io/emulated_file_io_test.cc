@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/emulated_file_io.hh"
+#include "iceberg/io/local_file_io.hh"
+
+namespace iceberg {
+namespace io {
+
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+class EmulatedFileIOTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    content = std::string(100 * 1024, 'x');
+    auto local = std::make_shared<LocalFileIO>();
+    auto out = local->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+    ASSERT_TRUE(out->Write(content).ok());
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  void TearDown() override {
+    ASSERT_TRUE(std::make_shared<LocalFileIO>()->DeleteFile(path).ok());
+  }
+
+  std::shared_ptr<EmulatedFileIO> MakeFileIO(EmulatedStorageOptions options) {
+    return std::make_shared<EmulatedFileIO>(std::make_shared<LocalFileIO>(), options);
+  }
+
+  const std::string path = "/tmp/iceberg_emulated_file_io.txt";
+  std::string content;
+};
+
+TEST_F(EmulatedFileIOTest, CountsRequests) {
+  auto fs = MakeFileIO({});
+  auto in = fs->newInputFile(path).ValueOrDie();
+  ASSERT_EQ(in->getLength().ValueOrDie(), 100 * 1024);
+  ASSERT_EQ(fs->stats().requests, 1);
+
+  // Sequential reads continue a single GET, a seek starts another
+  auto stream = in->newStream().ValueOrDie();
+  char buffer[1024];
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(stream->Read(1024, buffer).ValueOrDie(), 1024);
+  }
+  ASSERT_EQ(fs->stats().requests, 2);
+  ASSERT_TRUE(stream->Seek(50000).ok());
+  ASSERT_EQ(stream->Read(1024, buffer).ValueOrDie(), 1024);
+  ASSERT_EQ(fs->stats().requests, 3);
+
+  // Each positioned read is a GET of its own
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(stream->ReadAt(i * 2048, 1024, buffer).ValueOrDie(), 1024);
+  }
+  ASSERT_EQ(fs->stats().requests, 6);
+  ASSERT_EQ(fs->stats().bytes_read, 8 * 1024);
+
+  // A known length spares the HEAD request
+  ASSERT_EQ(fs->newInputFile(path, 100 * 1024).ValueOrDie()->getLength().ValueOrDie(),
+            100 * 1024);
+  ASSERT_EQ(fs->stats().requests, 6);
+}
+
+TEST_F(EmulatedFileIOTest, AddsFirstByteLatency) {
+  EmulatedStorageOptions options;
+  options.first_byte_latency = milliseconds(50);
+  auto fs = MakeFileIO(options);
+  auto stream = fs->newInputFile(path, 100 * 1024).ValueOrDie()->newStream().ValueOrDie();
+
+  auto start = steady_clock::now();
+  ASSERT_EQ(stream->ReadAt(0, 10).ValueOrDie()->size(), 10);
+  ASSERT_GE(steady_clock::now() - start, milliseconds(50));
+
+  // Ranges read concurrently overlap their latencies
+  std::vector<ReadRange> ranges;
+  for (int i = 0; i < 4; ++i) {
+    ranges.emplace_back(i * 20000, 100);
+  }
+  CoalesceOptions coalesce;
+  coalesce.hole_size_limit = 0;
+  ASSERT_EQ(fs->stats().max_overlapping_requests, 1);
+  auto buffers = stream->ReadRanges(ranges, coalesce).ValueOrDie();
+  ASSERT_EQ(buffers.size(), 4);
+  ASSERT_GT(fs->stats().max_overlapping_requests, 1);
+  ASSERT_EQ(fs->stats().requests, 5);
+}
+
+TEST_F(EmulatedFileIOTest, SamplesLatencyDistribution) {
+  EmulatedStorageOptions options;
+  options.first_byte_latency = milliseconds(2);
+  options.latency_distribution = LatencyDistribution::LOG_NORMAL;
+  auto fs = MakeFileIO(options);
+  auto stream = fs->newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  char buffer[16];
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(stream->ReadAt(i, 16, buffer).ValueOrDie(), 16);
+  }
+  ASSERT_EQ(fs->stats().requests, 10);
+}
+
+TEST_F(EmulatedFileIOTest, CapsBandwidth) {
+  EmulatedStorageOptions options;
+  options.read_bandwidth = 1024 * 1024;
+  auto fs = MakeFileIO(options);
+  auto stream = fs->newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  auto start = steady_clock::now();
+  ASSERT_EQ(stream->Read(100 * 1024).ValueOrDie()->size(), 100 * 1024);
+  // 100 KiB at 1 MiB/s
+  ASSERT_GE(steady_clock::now() - start, milliseconds(95));
+}
+
+TEST_F(EmulatedFileIOTest, LimitsRequestRate) {
+  EmulatedStorageOptions options;
+  options.max_requests_per_second = 100;
+  auto fs = MakeFileIO(options);
+  auto start = steady_clock::now();
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_TRUE(fs->newInputFile(path).ValueOrDie()->getLength().ok());
+  }
+  // The first request is admitted at once, the others 10ms apart
+  ASSERT_GE(steady_clock::now() - start, milliseconds(50));
+}
+
+TEST_F(EmulatedFileIOTest, WritesAndLists) {
+  auto fs = MakeFileIO({});
+  const std::string written = "/tmp/iceberg_emulated_file_io_written.txt";
+  auto out = fs->newOutputFile(written).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write("hello").ok());
+  ASSERT_EQ(fs->stats().requests, 0);
+  ASSERT_TRUE(out->Close().ok());
+  ASSERT_EQ(fs->stats().requests, 1);
+  ASSERT_EQ(fs->stats().bytes_written, 5);
+
+  auto it = fs->ListPrefix(written).ValueOrDie();
+  auto batch = it->Next().ValueOrDie();
+  ASSERT_EQ(batch.size(), 1);
+  ASSERT_EQ(batch[0].size(), 5);
+  ASSERT_TRUE(it->Next().ValueOrDie().empty());
+  ASSERT_EQ(fs->stats().requests, 3);
+
+  auto deleted = fs->DeleteFiles({written}).ValueOrDie();
+  ASSERT_EQ(deleted.num_deleted, 1);
+  ASSERT_EQ(fs->stats().requests, 4);
+}
+
+}  // namespace io
+}  // namespace iceberg
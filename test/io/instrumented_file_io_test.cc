@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iceberg/io/instrumented_file_io.hh"
+#include "iceberg/io/memory_file_io.hh"
+
+namespace iceberg {
+namespace io {
+
+class InstrumentedFileIOTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    base = std::make_shared<MemoryFileIO>();
+    fs = std::make_shared<InstrumentedFileIO>(
+        base, InstrumentedFileIOOptions{{"/table/", "/table/metadata/"}});
+  }
+
+  void WriteFile(const std::string& path, int64_t size) {
+    auto out = fs->newOutputFile(path).ValueOrDie()->create().ValueOrDie();
+    ASSERT_TRUE(out->Write(std::string(size, 'x')).ok());
+    ASSERT_TRUE(out->Flush().ok());
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  std::shared_ptr<MemoryFileIO> base;
+  std::shared_ptr<InstrumentedFileIO> fs;
+};
+
+TEST(Log2HistogramTest, Buckets) {
+  ASSERT_EQ(Log2Histogram::BucketOf(0), 0);
+  ASSERT_EQ(Log2Histogram::BucketOf(1), 1);
+  ASSERT_EQ(Log2Histogram::BucketOf(4095), 12);
+  ASSERT_EQ(Log2Histogram::BucketOf(4096), 13);
+  ASSERT_EQ(Log2Histogram::BucketOf(INT64_MAX), Log2Histogram::kNumBuckets - 1);
+  ASSERT_EQ(Log2Histogram::BucketUpperBound(12), 4095);
+
+  Log2Histogram histogram;
+  ASSERT_EQ(histogram.Quantile(0.5), 0);
+  histogram.buckets[Log2Histogram::BucketOf(100)] = 90;
+  histogram.buckets[Log2Histogram::BucketOf(100000)] = 10;
+  ASSERT_EQ(histogram.count(), 100);
+  ASSERT_EQ(histogram.Quantile(0.5), 127);
+  ASSERT_EQ(histogram.Quantile(0.9), 127);
+  ASSERT_EQ(histogram.Quantile(0.99), 131071);
+}
+
+TEST_F(InstrumentedFileIOTest, CountsOperations) {
+  WriteFile("/table/data/a.parquet", 10000);
+  auto stream =
+      fs->newInputFile("/table/data/a.parquet").ValueOrDie()->newStream().ValueOrDie();
+  char buffer[100];
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(stream->Read(100, buffer).ValueOrDie(), 100);
+  }
+  ASSERT_TRUE(stream->Seek(9000).ok());
+  ASSERT_EQ(stream->Read(5000).ValueOrDie()->size(), 1000);
+  ASSERT_EQ(stream->ReadAt(0, 10, buffer).ValueOrDie(), 10);
+  ASSERT_EQ(stream->ReadAtAsync(20, 10, buffer).get().ValueOrDie(), 10);
+  ASSERT_TRUE(stream->Seek(-1).IsInvalid());
+
+  auto metrics = fs->metrics();
+  ASSERT_EQ(metrics[IOOperation::OPEN].count, 2);
+  ASSERT_EQ(metrics[IOOperation::WRITE].count, 1);
+  ASSERT_EQ(metrics[IOOperation::WRITE].bytes, 10000);
+  ASSERT_EQ(metrics[IOOperation::FLUSH].count, 1);
+  ASSERT_EQ(metrics[IOOperation::SEEK].count, 2);
+  ASSERT_EQ(metrics[IOOperation::SEEK].errors, 1);
+  ASSERT_EQ(metrics[IOOperation::READ].count, 8);
+  ASSERT_EQ(metrics[IOOperation::READ].bytes, 1520);
+  ASSERT_EQ(metrics[IOOperation::READ].latency_nanos.count(), 8);
+  ASSERT_EQ(metrics.read_sizes().buckets[Log2Histogram::BucketOf(100)], 5);
+  ASSERT_EQ(metrics.read_sizes().buckets[Log2Histogram::BucketOf(10)], 2);
+  ASSERT_EQ(metrics.read_sizes().Quantile(1), 1023);
+  ASSERT_NE(metrics.ToString().find("read: count=8"), std::string::npos);
+}
+
+TEST_F(InstrumentedFileIOTest, BreaksDownByPrefix) {
+  WriteFile("/table/metadata/v1.json", 100);
+  WriteFile("/table/data/a.parquet", 200);
+  WriteFile("/other/b.parquet", 300);
+  ASSERT_TRUE(fs->DeleteFile("/table/metadata/v1.json").ok());
+  std::vector<std::string> paths = {"/table/data/a.parquet", "/table/data/missing",
+                                    "/other/b.parquet"};
+  auto result = fs->DeleteFiles(paths).ValueOrDie();
+  ASSERT_EQ(result.failures.size(), 1);
+
+  auto metadata = fs->metrics("/table/metadata/").ValueOrDie();
+  ASSERT_EQ(metadata[IOOperation::WRITE].bytes, 100);
+  ASSERT_EQ(metadata[IOOperation::DELETE].count, 1);
+  auto table = fs->metrics("/table/").ValueOrDie();
+  ASSERT_EQ(table[IOOperation::WRITE].bytes, 200);
+  ASSERT_EQ(table[IOOperation::DELETE].count, 2);
+  ASSERT_EQ(table[IOOperation::DELETE].errors, 1);
+  auto total = fs->metrics();
+  ASSERT_EQ(total[IOOperation::WRITE].bytes, 600);
+  ASSERT_EQ(total[IOOperation::DELETE].count, 4);
+  ASSERT_EQ(total[IOOperation::DELETE].errors, 1);
+  ASSERT_TRUE(fs->metrics("/elsewhere/").status().IsKeyError());
+
+  // A failed batch counts as failed deletes
+  DeleteFilesOptions invalid;
+  invalid.parallelism = 0;
+  ASSERT_TRUE(fs->DeleteFiles(paths, invalid).status().IsInvalid());
+  ASSERT_EQ(fs->metrics()[IOOperation::DELETE].count, 7);
+  ASSERT_EQ(fs->metrics()[IOOperation::DELETE].errors, 4);
+  ASSERT_EQ(fs->metrics("/table/").ValueOrDie()[IOOperation::DELETE].errors, 3);
+}
+
+TEST_F(InstrumentedFileIOTest, AsyncAndRangedReads) {
+  WriteFile("/table/data/a.parquet", 10000);
+  auto stream =
+      fs->newInputFile("/table/data/a.parquet").ValueOrDie()->newStream().ValueOrDie();
+  char buffer[100];
+  auto future = stream->ReadAtAsync(20, 100, buffer);
+  // Ready once the read completes, and recorded by then, before anyone calls get
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+  ASSERT_EQ(fs->metrics()[IOOperation::READ].count, 1);
+  ASSERT_EQ(future.get().ValueOrDie(), 100);
+
+  // The ranges are read by the base stream, as one operation
+  auto buffers = stream->ReadRanges({{0, 10}, {5000, 100}, {9990, 20}}).ValueOrDie();
+  ASSERT_EQ(buffers.size(), 3);
+  auto metrics = fs->metrics();
+  ASSERT_EQ(metrics[IOOperation::READ].count, 2);
+  ASSERT_EQ(metrics[IOOperation::READ].bytes, 100 + 10 + 100 + 10);
+}
+
+TEST_F(InstrumentedFileIOTest, ConcurrentReads) {
+  WriteFile("/table/data/a.parquet", 4096);
+  auto stream =
+      fs->newInputFile("/table/data/a.parquet").ValueOrDie()->newStream().ValueOrDie();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&stream]() {
+      char buffer[64];
+      for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(stream->ReadAt(i, 64, buffer).ValueOrDie(), 64);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto metrics = fs->metrics();
+  ASSERT_EQ(metrics[IOOperation::READ].count, 8000);
+  ASSERT_EQ(metrics[IOOperation::READ].bytes, 8000 * 64);
+  ASSERT_EQ(fs->metrics("/table/").ValueOrDie()[IOOperation::READ].count, 8000);
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iceberg/io/io_scheduler.hh"
+#include "iceberg/io/memory_file_io.hh"
+#include "iceberg/io/scheduled_file_io.hh"
+
+namespace iceberg {
+namespace io {
+
+namespace {
+
+// Wait until `predicate` holds, as queued requests are observed from other threads
+template <typename Predicate>
+void WaitFor(Predicate&& predicate) {
+  for (int i = 0; i < 10000 && !predicate(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(predicate());
+}
+
+}  // namespace
+
+TEST(IOSchedulerTest, InvalidOptions) {
+  IOSchedulerOptions options;
+  options.max_concurrency = 0;
+  ASSERT_TRUE(IOScheduler::Make(options).status().IsInvalid());
+  options = {};
+  options[IOClass::PREFETCH].max_concurrency = -1;
+  ASSERT_TRUE(IOScheduler::Make(options).status().IsInvalid());
+}
+
+TEST(IOSchedulerTest, AdmitsByPriority) {
+  IOSchedulerOptions options;
+  options.max_concurrency = 1;
+  auto scheduler = IOScheduler::Make(options).ValueOrDie();
+  auto permit = scheduler->Acquire(IOClass::DATA_SCAN);
+
+  std::mutex mutex;
+  std::vector<IOClass> admitted;
+  std::vector<std::thread> threads;
+  // Queued in order of increasing priority
+  for (auto io_class : {IOClass::BACKGROUND, IOClass::PREFETCH, IOClass::METADATA}) {
+    threads.emplace_back([&, io_class]() {
+      auto permit = scheduler->Acquire(io_class);
+      std::lock_guard<std::mutex> lock(mutex);
+      admitted.push_back(io_class);
+    });
+    WaitFor([&]() { return scheduler->stats(io_class).queued == 1; });
+  }
+  permit.Release();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(admitted, (std::vector<IOClass>{IOClass::METADATA, IOClass::PREFETCH,
+                                            IOClass::BACKGROUND}));
+  ASSERT_EQ(scheduler->stats(IOClass::BACKGROUND).admitted, 1);
+  ASSERT_EQ(scheduler->stats(IOClass::BACKGROUND).in_flight, 0);
+  ASSERT_GT(scheduler->stats(IOClass::BACKGROUND).wait_nanos, 0);
+}
+
+TEST(IOSchedulerTest, LimitsClassConcurrency) {
+  IOSchedulerOptions options;
+  options.max_concurrency = 4;
+  options[IOClass::BACKGROUND].max_concurrency = 2;
+  auto scheduler = IOScheduler::Make(options).ValueOrDie();
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 5; ++i) {
+    threads.emplace_back([&]() {
+      auto permit = scheduler->Acquire(IOClass::BACKGROUND);
+      while (!done) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+  }
+  WaitFor([&]() { return scheduler->stats(IOClass::BACKGROUND).queued == 3; });
+  ASSERT_EQ(scheduler->stats(IOClass::BACKGROUND).in_flight, 2);
+
+  // Background compaction leaves room for planning reads
+  {
+    auto first = scheduler->Acquire(IOClass::METADATA);
+    auto second = scheduler->Acquire(IOClass::METADATA);
+    ASSERT_EQ(scheduler->stats(IOClass::METADATA).in_flight, 2);
+  }
+  done = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(scheduler->stats(IOClass::BACKGROUND).admitted, 5);
+}
+
+TEST(IOSchedulerTest, Submit) {
+  IOSchedulerOptions options;
+  options.max_concurrency = 2;
+  auto scheduler = IOScheduler::Make(options).ValueOrDie();
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 20; ++i) {
+    futures.push_back(scheduler->Submit(IOClass::PREFETCH, [&, i]() {
+      int now = ++running;
+      int prev = max_running.load();
+      while (now > prev && !max_running.compare_exchange_weak(prev, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      --running;
+      return i;
+    }));
+  }
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_EQ(futures[i].get(), i);
+  }
+  ASSERT_LE(max_running.load(), 2);
+}
+
+TEST(IOSchedulerTest, NestedRequestsUseTheTaskSlot) {
+  IOSchedulerOptions options;
+  options.max_concurrency = 1;
+  auto scheduler = IOScheduler::Make(options).ValueOrDie();
+  // With its only slot taken by the task, a nested request waiting for another would
+  // never be admitted
+  auto future = scheduler->Submit(IOClass::BACKGROUND, [&]() {
+    auto permit = scheduler->Acquire(IOClass::METADATA);
+    return scheduler->stats(IOClass::METADATA).admitted;
+  });
+  ASSERT_EQ(future.get(), 0);
+  ASSERT_EQ(scheduler->stats(IOClass::BACKGROUND).admitted, 1);
+}
+
+TEST(IOSchedulerTest, BackgroundTasksLeaveRoomForMetadata) {
+  IOSchedulerOptions options;
+  options.max_concurrency = 12;
+  auto scheduler = IOScheduler::Make(options).ValueOrDie();
+  std::atomic<bool> done{false};
+  std::vector<std::future<void>> background;
+  for (int i = 0; i < 32; ++i) {
+    background.push_back(scheduler->Submit(IOClass::BACKGROUND, [&]() {
+      while (!done) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }));
+  }
+  WaitFor([&]() { return scheduler->stats(IOClass::BACKGROUND).in_flight == 8; });
+  // Admitted metadata tasks run at once, not behind the queued background ones
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(scheduler->Submit(IOClass::METADATA, [i]() { return i; }).get(), i);
+  }
+  done = true;
+  for (auto& future : background) {
+    future.get();
+  }
+}
+
+TEST(ScheduledFileIOTest, RoundTrip) {
+  auto scheduler = IOScheduler::Make().ValueOrDie();
+  auto base = std::make_shared<MemoryFileIO>();
+  auto background =
+      std::make_shared<ScheduledFileIO>(base, scheduler, IOClass::BACKGROUND);
+  auto out = background->newOutputFile("/t/data/a.parquet").ValueOrDie()->create();
+  ASSERT_TRUE(out.ValueOrDie()->Write(std::string(1000, 'x')).ok());
+  ASSERT_TRUE(out.ValueOrDie()->Close().ok());
+  // create, write and close
+  ASSERT_EQ(scheduler->stats(IOClass::BACKGROUND).admitted, 3);
+
+  auto scan = background->WithClass(IOClass::DATA_SCAN);
+  ASSERT_FALSE(scan->Equals(*background));
+  auto stream = scan->newInputFile("/t/data/a.parquet").ValueOrDie()->newStream();
+  ASSERT_EQ(stream.ValueOrDie()->ReadAt(10, 100).ValueOrDie()->size(), 100);
+  auto buffers =
+      stream.ValueOrDie()->ReadRanges({{0, 10}, {500, 10}}, {/*hole_size_limit=*/0})
+          .ValueOrDie();
+  ASSERT_EQ(buffers[1]->ToString(), std::string(10, 'x'));
+  // open, read and two ranges
+  ASSERT_EQ(scheduler->stats(IOClass::DATA_SCAN).admitted, 4);
+
+  ASSERT_TRUE(scan->WithClass(IOClass::BACKGROUND)->Equals(*background));
+  ASSERT_TRUE(background->DeleteFile("/t/data/a.parquet").ok());
+  ASSERT_EQ(scheduler->stats(IOClass::BACKGROUND).admitted, 4);
+
+  // A batch of deletions is admitted once
+  for (const char* name : {"/t/data/b", "/t/data/c"}) {
+    auto file = base->newOutputFile(name).ValueOrDie()->create().ValueOrDie();
+    ASSERT_TRUE(file->Close().ok());
+  }
+  auto deleted = background->DeleteFiles({"/t/data/b", "/t/data/c"}).ValueOrDie();
+  ASSERT_EQ(deleted.num_deleted, 2);
+  ASSERT_EQ(scheduler->stats(IOClass::BACKGROUND).admitted, 5);
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -1,8 +1,16 @@
 #include <gtest/gtest.h>
 
+#include "iceberg/io/group_commit.hh"
+#include "iceberg/io/io_uring.hh"
 #include "iceberg/io/local_file_io.hh"
 
+#include <filesystem>
+#include <future>
+#include <map>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace iceberg {
 namespace io {
@@ -37,6 +45,351 @@ TEST_F(LocalFSTest, newInputFile) {
   ASSERT_EQ(res1.ValueOrDie(), 12);
 }
 
+TEST_F(LocalFSTest, readAt) {
+  const std::string path = "/tmp/iceberg_read_at.txt";
+  std::string content;
+  for (int i = 0; i < 4096; ++i) {
+    content.push_back(static_cast<char>('a' + i % 26));
+  }
+  auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write(content).ok());
+  ASSERT_TRUE(out->Close().ok());
+
+  auto sis = fs->newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_TRUE(sis->Seek(100).ok());
+
+  std::vector<std::thread> threads;
+  std::vector<int> matched(8, 0);
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t]() {
+      char buffer[64];
+      bool ok = true;
+      for (int64_t pos = t; pos + 64 <= 4096; pos += 512) {
+        auto res = sis->ReadAt(pos, 64, buffer);
+        ok = ok && res.ok() && res.ValueOrDie() == 64 &&
+             std::string(buffer, 64) == content.substr(pos, 64);
+      }
+      matched[t] = ok ? 1 : 0;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int ok : matched) {
+    ASSERT_TRUE(ok);
+  }
+
+  // ReadAt neither uses nor moves the stream position
+  ASSERT_EQ(sis->Tell().ValueOrDie(), 100);
+  char tail[16];
+  auto res = sis->ReadAt(4090, 16, tail);
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.ValueOrDie(), 6);
+  ASSERT_TRUE(fs->DeleteFile(path).ok());
+}
+
+TEST_F(LocalFSTest, readAtAsync) {
+  const std::string path = "/tmp/iceberg_read_at_async.txt";
+  std::string content;
+  for (int i = 0; i < 128 * 1024; ++i) {
+    content.push_back(static_cast<char>('a' + i % 26));
+  }
+  auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write(content).ok());
+  ASSERT_TRUE(out->Close().ok());
+
+  for (bool use_io_uring : {true, false}) {
+    LocalFileIOOptions options;
+    options.use_io_uring = use_io_uring;
+    LocalFileIO local(options);
+    auto sis = local.newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+
+    // More reads in flight than fit in one ring, so some take the fallback path
+    const int num_reads = 2 * internal::kIoUringQueueDepth + 8;
+    std::vector<std::string> buffers(num_reads, std::string(1000, '\0'));
+    std::vector<std::future<Result<int64_t>>> futures;
+    for (int i = 0; i < num_reads; ++i) {
+      futures.push_back(sis->ReadAtAsync(i * 500, 1000, buffers[i].data()));
+    }
+    for (int i = 0; i < num_reads; ++i) {
+      auto res = futures[i].get();
+      ASSERT_TRUE(res.ok());
+      ASSERT_EQ(res.ValueOrDie(), 1000);
+      ASSERT_EQ(buffers[i], content.substr(i * 500, 1000));
+    }
+
+    char tail[100];
+    auto res = sis->ReadAtAsync(content.size() - 10, 100, tail).get();
+    ASSERT_TRUE(res.ok());
+    ASSERT_EQ(res.ValueOrDie(), 10);
+  }
+  ASSERT_TRUE(fs->DeleteFile(path).ok());
+}
+
+TEST_F(LocalFSTest, memoryMapped) {
+  const std::string path = "/tmp/iceberg_mmap.txt";
+  auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write("hello memory mapped world").ok());
+  ASSERT_TRUE(out->Close().ok());
+
+  LocalFileIOOptions options;
+  options.use_mmap = true;
+  options.access_pattern = AccessPattern::SEQUENTIAL;
+  auto mmap_fs = std::make_shared<LocalFileIO>(options);
+  auto sis = mmap_fs->newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  auto mapped = std::dynamic_pointer_cast<MemoryMappedInputStream>(sis);
+  ASSERT_NE(mapped, nullptr);
+  ASSERT_EQ(mapped->size(), 25);
+
+  auto first = mapped->Read(5).ValueOrDie();
+  ASSERT_EQ(first->ToStringView(), "hello");
+  ASSERT_EQ(mapped->Tell().ValueOrDie(), 5);
+  char copied[7];
+  ASSERT_EQ(mapped->Read(7, copied).ValueOrDie(), 7);
+  ASSERT_EQ(std::string(copied, 7), " memory");
+
+  auto tail = mapped->ReadAt(20, 100).ValueOrDie();
+  ASSERT_EQ(tail->ToStringView(), "world");
+  ASSERT_TRUE(mapped->Advise(AccessPattern::RANDOM, 3, 10).ok());
+
+  // Buffers keep the mapping alive after the stream is closed
+  ASSERT_TRUE(mapped->Close().ok());
+  ASSERT_TRUE(mapped->closed());
+  ASSERT_FALSE(mapped->Read(1).ok());
+  ASSERT_EQ(first->ToString() + tail->ToString(), "helloworld");
+  ASSERT_TRUE(fs->DeleteFile(path).ok());
+}
+
+TEST_F(LocalFSTest, flushAndSync) {
+  const std::string path = "/tmp/iceberg_flush_sync.txt";
+  auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write("hello").ok());
+  ASSERT_EQ(out->Tell().ValueOrDie(), 5);
+  // Buffered writes reach the file on Flush, without waiting for Sync
+  ASSERT_EQ(fs->newInputFile(path).ValueOrDie()->getLength().ValueOrDie(), 0);
+  ASSERT_TRUE(out->Flush().ok());
+  ASSERT_EQ(fs->newInputFile(path).ValueOrDie()->getLength().ValueOrDie(), 5);
+  ASSERT_TRUE(out->Write(" world").ok());
+  ASSERT_TRUE(out->Sync().ok());
+  ASSERT_EQ(fs->newInputFile(path).ValueOrDie()->getLength().ValueOrDie(), 11);
+  ASSERT_TRUE(out->Close().ok());
+  ASSERT_TRUE(fs->DeleteFile(path).ok());
+}
+
+TEST_F(LocalFSTest, groupCommit) {
+  GroupCommitter committer;
+  std::vector<std::shared_ptr<PositionOutputStream>> streams;
+  for (int i = 0; i < 4; ++i) {
+    auto path = "/tmp/iceberg_group_commit_" + std::to_string(i) + ".txt";
+    streams.push_back(
+        fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie());
+  }
+  std::vector<std::thread> threads;
+  std::vector<int> synced(16, 0);
+  for (int t = 0; t < 16; ++t) {
+    threads.emplace_back([&, t]() {
+      auto stream = streams[t % streams.size()];
+      synced[t] = committer.Sync(stream).ok() ? 1 : 0;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int ok : synced) {
+    ASSERT_TRUE(ok);
+  }
+  ASSERT_GE(committer.num_batches(), 1);
+  ASSERT_LE(committer.num_batches(), 16);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(streams[i]->Close().ok());
+    ASSERT_TRUE(fs->DeleteFile("/tmp/iceberg_group_commit_" + std::to_string(i) + ".txt")
+                    .ok());
+  }
+}
+
+TEST_F(LocalFSTest, knownLength) {
+  const std::string path = "/tmp/iceberg_known_length.txt";
+  auto cache = std::make_shared<StatCache>();
+  LocalFileIOOptions options;
+  options.stat_cache = cache;
+  auto local = std::make_shared<LocalFileIO>(options);
+  auto out = local->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write("hello world").ok());
+  ASSERT_TRUE(out->Close().ok());
+  auto created = local->newOutputFile(path).ValueOrDie()->create();
+  ASSERT_TRUE(created.status().IsAlreadyExists());
+
+  // The length learned by opening a stream is remembered
+  auto in = local->newInputFile(path).ValueOrDie();
+  ASSERT_TRUE(in->newStream().ok());
+  ASSERT_EQ(cache->GetLength(path), 11);
+  ASSERT_EQ(local->newInputFile(path).ValueOrDie()->getLength().ValueOrDie(), 11);
+
+  // A length from a listing is trusted as is
+  auto listed = local->newInputFile(FileInfo(path, 5, 0)).ValueOrDie();
+  ASSERT_EQ(listed->getLength().ValueOrDie(), 5);
+  auto sis = listed->newStream().ValueOrDie();
+  char buffer[11];
+  ASSERT_EQ(sis->Read(11, buffer).ValueOrDie(), 11);
+  ASSERT_FALSE(local->newInputFile(path, -1).ok());
+
+  // A mapping covers no more than the file, whatever the known length says
+  options.use_mmap = true;
+  LocalFileIO mapped(options);
+  auto stale = mapped.newInputFile(FileInfo(path, 8192, 0)).ValueOrDie();
+  auto mapped_stream = stale->newStream().ValueOrDie();
+  ASSERT_EQ(mapped_stream->ReadAt(4096, 10).ValueOrDie()->size(), 0);
+  ASSERT_EQ(mapped_stream->ReadAt(0, 8192).ValueOrDie()->ToString(), "hello world");
+
+  ASSERT_TRUE(local->DeleteFile(path).ok());
+  ASSERT_FALSE(cache->GetLength(path).has_value());
+  auto missing = local->newInputFile(path, 11).ValueOrDie()->newStream();
+  ASSERT_TRUE(missing.status().IsInvalid());
+}
+
+TEST_F(LocalFSTest, statCacheSkipsFilesOpenForWriting) {
+  const std::string path = "/tmp/iceberg_stat_cache_writer.txt";
+  auto cache = std::make_shared<StatCache>();
+  LocalFileIOOptions options;
+  options.stat_cache = cache;
+  auto local = std::make_shared<LocalFileIO>(options);
+  auto out = local->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write("hello").ok());
+  ASSERT_TRUE(out->Flush().ok());
+
+  // A reader racing the writer does not pin the partial length
+  auto in = local->newInputFile(path).ValueOrDie();
+  ASSERT_TRUE(in->exists());
+  ASSERT_EQ(in->getLength().ValueOrDie(), 5);
+  ASSERT_FALSE(cache->GetLength(path).has_value());
+
+  ASSERT_TRUE(out->Write(" world").ok());
+  ASSERT_TRUE(out->Close().ok());
+  auto reopened = local->newInputFile(path).ValueOrDie();
+  ASSERT_TRUE(reopened->exists());
+  ASSERT_EQ(cache->GetLength(path), 11);
+  ASSERT_EQ(reopened->getLength().ValueOrDie(), 11);
+
+  ASSERT_TRUE(local->DeleteFile(path).ok());
+  ASSERT_FALSE(local->newInputFile(path).ValueOrDie()->exists());
+
+  // A cache of no capacity holds nothing
+  StatCache empty(0);
+  empty.PutLength(path, 11);
+  ASSERT_EQ(empty.size(), 0);
+}
+
+TEST_F(LocalFSTest, deleteFiles) {
+  const std::string dir = "/tmp/iceberg_delete_files";
+  std::filesystem::create_directories(dir);
+  std::vector<std::string> paths;
+  for (int i = 0; i < 64; ++i) {
+    paths.push_back(dir + "/" + std::to_string(i) + ".txt");
+    auto out = fs->newOutputFile(paths.back()).ValueOrDie()->createOrOverwrite();
+    ASSERT_TRUE(out.ValueOrDie()->Close().ok());
+  }
+  paths.insert(paths.begin() + 10, dir + "/missing.txt");
+
+  DeleteFilesOptions options;
+  options.parallelism = 4;
+  int64_t last_completed = 0;
+  options.progress = [&](int64_t completed, int64_t total) {
+    ASSERT_EQ(completed, last_completed + 1);
+    ASSERT_EQ(total, 65);
+    last_completed = completed;
+  };
+  auto result = fs->DeleteFiles(paths, options).ValueOrDie();
+  ASSERT_EQ(result.num_deleted, 64);
+  ASSERT_EQ(result.failures.size(), 1);
+  ASSERT_EQ(result.failures[0].first, dir + "/missing.txt");
+  ASSERT_TRUE(result.failures[0].second.IsIOError());
+  ASSERT_EQ(last_completed, 65);
+  ASSERT_TRUE(std::filesystem::is_empty(dir));
+
+  options.parallelism = 0;
+  ASSERT_FALSE(fs->DeleteFiles(paths, options).ok());
+  std::filesystem::remove(dir);
+}
+
+TEST_F(LocalFSTest, listPrefix) {
+  const std::string root = "/tmp/iceberg_list_prefix";
+  std::filesystem::remove_all(root);
+  std::map<std::string, int64_t> expected;
+  for (const std::string dir : {"data/a", "data/b/c", "metadata"}) {
+    std::filesystem::create_directories(root + "/" + dir);
+    for (int i = 0; i < 20; ++i) {
+      const std::string path = root + "/" + dir + "/" + std::to_string(i);
+      auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+      ASSERT_TRUE(out->Write(std::string(i, 'x')).ok());
+      ASSERT_TRUE(out->Close().ok());
+      expected[path] = i;
+    }
+  }
+
+  auto list = [&](const std::string& prefix, int parallelism = 3) {
+    ListPrefixOptions options;
+    options.parallelism = parallelism;
+    options.batch_size = 7;
+    auto it = fs->ListPrefix(prefix, options).ValueOrDie();
+    std::map<std::string, int64_t> listed;
+    for (auto batch = it->Next().ValueOrDie(); !batch.empty();
+         batch = it->Next().ValueOrDie()) {
+      EXPECT_LE(batch.size(), 7);
+      for (const auto& info : batch) {
+        listed[info.location()] = info.size();
+        EXPECT_GT(info.createdAtMillis(), 0);
+      }
+    }
+    return listed;
+  };
+  ASSERT_EQ(list(root + "/"), expected);
+  auto data = list(root + "/da");
+  ASSERT_EQ(data.size(), 40);
+  ASSERT_EQ(data[root + "/data/b/c/13"], 13);
+  ASSERT_TRUE(list(root + "/missing/").empty());
+
+  // More directories than fit in the bounded task queue of a single worker
+  for (int i = 0; i < 30; ++i) {
+    const std::string dir = root + "/many/" + std::to_string(i);
+    std::filesystem::create_directories(dir);
+    auto out = fs->newOutputFile(dir + "/f").ValueOrDie()->createOrOverwrite();
+    ASSERT_TRUE(out.ValueOrDie()->Close().ok());
+    expected[dir + "/f"] = 0;
+  }
+  ASSERT_EQ(list(root + "/", 1), expected);
+
+  // Abandoning a listing midway stops it
+  ASSERT_FALSE(fs->ListPrefix(root + "/").ValueOrDie()->Next().ValueOrDie().empty());
+  std::filesystem::remove_all(root);
+}
+
+TEST_F(LocalFSTest, copyFile) {
+  const std::string src = "/tmp/iceberg_copy_src.bin";
+  const std::string dst = "/tmp/iceberg_copy_dst.bin";
+  std::filesystem::remove(dst);
+  std::string content;
+  for (int i = 0; i < 3 * 1024 * 1024 + 17; ++i) {
+    content.push_back(static_cast<char>(i * 31));
+  }
+  auto out = fs->newOutputFile(src).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write(content).ok());
+  ASSERT_TRUE(out->Close().ok());
+
+  ASSERT_TRUE(fs->CopyFile(src, dst).ok());
+  auto in = fs->newInputFile(dst).ValueOrDie();
+  ASSERT_EQ(in->getLength().ValueOrDie(), content.size());
+  ASSERT_EQ(in->newStream().ValueOrDie()->Read(content.size()).ValueOrDie()->ToString(),
+            content);
+
+  // The destination is never overwritten, and a failed copy leaves nothing behind
+  ASSERT_TRUE(fs->CopyFile(src, dst).IsAlreadyExists());
+  ASSERT_TRUE(fs->CopyFile("/tmp/iceberg_copy_missing.bin", dst + ".2").IsInvalid());
+  ASSERT_FALSE(std::filesystem::exists(dst + ".2"));
+  ASSERT_TRUE(fs->CopyFile(src, "/tmp/iceberg_copy_missing_dir/dst.bin").IsIOError());
+  std::filesystem::remove(src);
+  std::filesystem::remove(dst);
+}
+
 TEST_F(LocalFSTest, deleteFile) {
   auto res = fs->DeleteFile("/tmp/123.txt");
   ASSERT_TRUE(res.ok());
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iceberg/io/memory.hh"
+#include "iceberg/io/memory_file_io.hh"
+
+namespace iceberg {
+namespace io {
+
+class MemoryFileIOTest : public testing::Test {
+ protected:
+  void SetUp() override { fs = std::make_shared<MemoryFileIO>(); }
+
+  void WriteFile(const std::string& path, const std::string& content) {
+    auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+    ASSERT_TRUE(out->Write(content).ok());
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  std::shared_ptr<MemoryFileIO> fs;
+};
+
+TEST_F(MemoryFileIOTest, WriteAndRead) {
+  auto out_file = fs->newOutputFile("mem://a").ValueOrDie();
+  auto out = out_file->create().ValueOrDie();
+  ASSERT_TRUE(out_file->create().status().IsAlreadyExists());
+  ASSERT_TRUE(out->Write("hello ").ok());
+  ASSERT_TRUE(out->Write("world").ok());
+  ASSERT_EQ(out->Tell().ValueOrDie(), 11);
+  // Contents become visible on close
+  ASSERT_EQ(fs->newInputFile("mem://a").ValueOrDie()->getLength().ValueOrDie(), 0);
+  ASSERT_TRUE(out->Close().ok());
+  ASSERT_TRUE(out->Write("more").IsInvalid());
+
+  auto in = out_file->toInputFile().ValueOrDie();
+  ASSERT_TRUE(in->exists());
+  ASSERT_EQ(in->getLength().ValueOrDie(), 11);
+  auto stream = in->newStream().ValueOrDie();
+  ASSERT_EQ(stream->Read(5).ValueOrDie()->ToString(), "hello");
+  ASSERT_EQ(stream->ReadAt(6, 100).ValueOrDie()->ToString(), "world");
+  ASSERT_EQ(fs->num_files(), 1);
+  ASSERT_EQ(fs->size(), 11);
+}
+
+TEST_F(MemoryFileIOTest, ReadsWithoutCopying) {
+  WriteFile("mem://b", "0123456789");
+  auto stream = fs->newInputFile("mem://b").ValueOrDie()->newStream().ValueOrDie();
+  auto first = stream->ReadAt(0, 4).ValueOrDie();
+  auto second = stream->ReadAt(4, 4).ValueOrDie();
+  ASSERT_EQ(first->data() + 4, second->data());
+
+  auto buffers = stream->ReadRanges({ReadRange(2, 3), ReadRange(8, 5)}).ValueOrDie();
+  ASSERT_EQ(buffers[0]->ToString(), "234");
+  ASSERT_EQ(buffers[1]->ToString(), "89");
+  ASSERT_EQ(buffers[0]->data(), first->data() + 2);
+
+  // Readers keep the contents they opened
+  WriteFile("mem://b", "new");
+  ASSERT_TRUE(fs->DeleteFile("mem://b").ok());
+  ASSERT_EQ(stream->ReadAt(0, 10).ValueOrDie()->ToString(), "0123456789");
+  ASSERT_TRUE(stream->Close().ok());
+  ASSERT_EQ(first->ToString(), "0123");
+}
+
+TEST_F(MemoryFileIOTest, MissingFiles) {
+  auto in = fs->newInputFile("mem://missing").ValueOrDie();
+  ASSERT_FALSE(in->exists());
+  ASSERT_TRUE(in->newStream().status().IsInvalid());
+  ASSERT_TRUE(in->getLength().status().IsInvalid());
+  ASSERT_TRUE(fs->DeleteFile("mem://missing").IsIOError());
+}
+
+TEST_F(MemoryFileIOTest, ListAndDelete) {
+  for (int i = 0; i < 5; ++i) {
+    WriteFile("mem://t/data/" + std::to_string(i), std::string(i, 'x'));
+  }
+  WriteFile("mem://t/metadata/v1.json", "{}");
+
+  ListPrefixOptions options;
+  options.batch_size = 2;
+  auto it = fs->ListPrefix("mem://t/data/", options).ValueOrDie();
+  std::vector<std::string> paths;
+  for (auto batch = it->Next().ValueOrDie(); !batch.empty();
+       batch = it->Next().ValueOrDie()) {
+    ASSERT_LE(batch.size(), 2);
+    for (const auto& info : batch) {
+      paths.push_back(info.location());
+    }
+  }
+  ASSERT_EQ(paths.size(), 5);
+
+  auto result = fs->DeleteFiles(paths).ValueOrDie();
+  ASSERT_EQ(result.num_deleted, 5);
+  ASSERT_EQ(fs->num_files(), 1);
+}
+
+TEST_F(MemoryFileIOTest, CopyFile) {
+  WriteFile("mem://t/a", "0123456789");
+  ASSERT_TRUE(fs->CopyFile("mem://t/a", "mem://t/b").ok());
+  auto a = fs->newInputFile("mem://t/a").ValueOrDie()->newStream().ValueOrDie();
+  auto b = fs->newInputFile("mem://t/b").ValueOrDie()->newStream().ValueOrDie();
+  // The copy shares the contents of the source
+  ASSERT_EQ(a->ReadAt(0, 10).ValueOrDie()->data(), b->ReadAt(0, 10).ValueOrDie()->data());
+  ASSERT_TRUE(fs->CopyFile("mem://t/a", "mem://t/b").IsAlreadyExists());
+  ASSERT_TRUE(fs->CopyFile("mem://t/missing", "mem://t/c").IsInvalid());
+
+  // The default implementation streams through newInputFile and newOutputFile
+  ASSERT_TRUE(fs->FileIO::CopyFile("mem://t/a", "mem://t/c").ok());
+  auto c = fs->newInputFile("mem://t/c").ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_EQ(c->ReadAt(0, 100).ValueOrDie()->ToString(), "0123456789");
+  ASSERT_TRUE(fs->FileIO::CopyFile("mem://t/a", "mem://t/c").IsAlreadyExists());
+  ASSERT_TRUE(fs->FileIO::CopyFile("mem://t/missing", "mem://t/d").IsInvalid());
+  ASSERT_EQ(fs->num_files(), 3);
+}
+
+TEST(BufferOutputStreamTest, Finish) {
+  BufferOutputStream out;
+  ASSERT_TRUE(out.Write("abc").ok());
+  ASSERT_TRUE(out.Write(Buffer::FromString("def")).ok());
+  auto buffer = out.Finish().ValueOrDie();
+  ASSERT_EQ(buffer->ToString(), "abcdef");
+  ASSERT_TRUE(out.closed());
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "iceberg/io/io_util.hh"
+#include "iceberg/io/local_file_io.hh"
+
+namespace iceberg {
+namespace io {
+
+TEST(CoalesceReadRanges, MergesNearbyRanges) {
+  CoalesceOptions options;
+  options.hole_size_limit = 10;
+  options.range_size_limit = 100;
+
+  auto res = internal::CoalesceReadRanges(
+      {{50, 10}, {0, 10}, {15, 5}, {200, 0}, {65, 10}, {90, 5}}, options);
+  ASSERT_TRUE(res.ok());
+  std::vector<ReadRange> expected = {{0, 20}, {50, 25}, {90, 5}};
+  ASSERT_EQ(res.ValueOrDie(), expected);
+}
+
+TEST(CoalesceReadRanges, RespectsSizeLimitExceptForOverlaps) {
+  CoalesceOptions options;
+  options.hole_size_limit = 10;
+  options.range_size_limit = 30;
+
+  auto res = internal::CoalesceReadRanges({{0, 20}, {25, 20}, {30, 100}}, options);
+  ASSERT_TRUE(res.ok());
+  std::vector<ReadRange> expected = {{0, 20}, {25, 105}};
+  ASSERT_EQ(res.ValueOrDie(), expected);
+
+  ASSERT_TRUE(internal::CoalesceReadRanges({{-1, 10}}, options).status().IsInvalid());
+}
+
+TEST(ReadRanges, LocalFile) {
+  const std::string path = "/tmp/iceberg_read_ranges.txt";
+  std::string content;
+  for (int i = 0; i < 10000; ++i) {
+    content.push_back(static_cast<char>('a' + i % 26));
+  }
+  LocalFileIO fs;
+  auto out = fs.newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write(content).ok());
+  ASSERT_TRUE(out->Close().ok());
+
+  std::vector<ReadRange> ranges = {{9990, 10}, {0, 4}, {10, 100}, {50, 20},
+                                   {5000, 0},  {9995, 20}, {3000, 1000}};
+  LocalFileIOOptions mmap_options;
+  mmap_options.use_mmap = true;
+  LocalFileIO mmap_fs(mmap_options);
+  for (FileIO* io : std::vector<FileIO*>{&fs, &mmap_fs}) {
+    auto res = io->newInputFile(path).ValueOrDie()->ReadRanges(ranges);
+    ASSERT_TRUE(res.ok());
+    const auto& buffers = res.ValueOrDie();
+    ASSERT_EQ(buffers.size(), ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      ASSERT_EQ(buffers[i]->ToString(),
+                content.substr(ranges[i].offset, ranges[i].length));
+    }
+  }
+  ASSERT_TRUE(fs.DeleteFile(path).ok());
+}
+
+}  // namespace io
+}  // namespace iceberg
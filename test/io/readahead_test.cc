@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "iceberg/io/local_file_io.hh"
+#include "iceberg/io/memory.hh"
+#include "iceberg/io/readahead.hh"
+
+namespace iceberg {
+namespace io {
+
+/// A BufferReader recording the positioned reads issued against it
+class RecordingReader : public BufferReader {
+ public:
+  explicit RecordingReader(std::shared_ptr<Buffer> buffer)
+      : BufferReader(std::move(buffer)) {}
+
+  using BufferReader::ReadAt;
+  Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void* out) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      reads_.emplace_back(position, nbytes);
+    }
+    return BufferReader::ReadAt(position, nbytes, out);
+  }
+
+  std::vector<ReadRange> reads() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reads_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<ReadRange> reads_;
+};
+
+class ReadaheadTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    for (int i = 0; i < 1000000; ++i) {
+      content.push_back(static_cast<char>('a' + i % 23));
+    }
+    raw = std::make_shared<RecordingReader>(Buffer::FromString(content));
+    options.initial_window = 4096;
+    options.max_window = 32768;
+    options.depth = 2;
+  }
+
+  std::string content;
+  std::shared_ptr<RecordingReader> raw;
+  ReadaheadOptions options;
+};
+
+TEST_F(ReadaheadTest, ReadsSequentiallyWithGrowingWindows) {
+  auto stream = ReadaheadInputStream::Create(raw, options).ValueOrDie();
+  // Two windows are in flight before the first read
+  ASSERT_EQ(raw->reads().size(), 2);
+
+  std::string out(content.size() + 100, '\0');
+  int64_t total = 0;
+  while (true) {
+    auto n = stream->Read(1000, out.data() + total).ValueOrDie();
+    if (n == 0) {
+      break;
+    }
+    total += n;
+  }
+  ASSERT_EQ(total, content.size());
+  out.resize(total);
+  ASSERT_EQ(out, content);
+  ASSERT_EQ(stream->window_size(), 32768);
+
+  // Windows are contiguous and never shrink
+  auto reads = raw->reads();
+  for (size_t i = 1; i < reads.size(); ++i) {
+    ASSERT_EQ(reads[i].offset, reads[i - 1].offset + reads[i - 1].length);
+    ASSERT_GE(reads[i].length, reads[i - 1].length);
+  }
+  ASSERT_TRUE(stream->Close().ok());
+}
+
+TEST_F(ReadaheadTest, ReturnsSlicesOfWindows) {
+  auto stream = ReadaheadInputStream::Create(raw, options).ValueOrDie();
+  auto first = stream->Read(100).ValueOrDie();
+  auto second = stream->Read(100).ValueOrDie();
+  ASSERT_EQ(first->ToString(), content.substr(0, 100));
+  ASSERT_EQ(first->data() + 100, second->data());
+  // Spanning two windows falls back to a copy
+  ASSERT_TRUE(stream->Seek(4000).ok());
+  ASSERT_EQ(stream->Read(200).ValueOrDie()->ToString(), content.substr(4000, 200));
+}
+
+TEST_F(ReadaheadTest, SeeksWithinWindows) {
+  auto stream = ReadaheadInputStream::Create(raw, options).ValueOrDie();
+  ASSERT_TRUE(stream->Seek(6000).ok());
+  char buffer[100];
+  ASSERT_EQ(stream->Read(100, buffer).ValueOrDie(), 100);
+  ASSERT_EQ(std::string(buffer, 100), content.substr(6000, 100));
+  ASSERT_FALSE(stream->suspended());
+  // Skipping past the first window retired it and scheduled one more
+  auto reads = raw->reads();
+  ASSERT_EQ(reads.size(), 3);
+  ASSERT_EQ(reads[2].offset, 8192);
+}
+
+TEST_F(ReadaheadTest, SuspendsOnRandomAccess) {
+  auto stream = ReadaheadInputStream::Create(raw, options).ValueOrDie();
+  char buffer[100];
+  ASSERT_TRUE(stream->Seek(500000).ok());
+  ASSERT_FALSE(stream->suspended());
+  ASSERT_TRUE(stream->Seek(100000).ok());
+  ASSERT_TRUE(stream->suspended());
+
+  // Reads go straight to the raw stream
+  const size_t before = raw->reads().size();
+  ASSERT_EQ(stream->Read(100, buffer).ValueOrDie(), 100);
+  ASSERT_EQ(std::string(buffer, 100), content.substr(100000, 100));
+  auto reads = raw->reads();
+  ASSERT_EQ(reads.size(), before + 1);
+  ASSERT_EQ(reads.back(), ReadRange(100000, 100));
+
+  // Sequential reads resume readahead
+  ASSERT_EQ(stream->Read(100, buffer).ValueOrDie(), 100);
+  ASSERT_FALSE(stream->suspended());
+  ASSERT_EQ(stream->Read(100, buffer).ValueOrDie(), 100);
+  ASSERT_EQ(std::string(buffer, 100), content.substr(100200, 100));
+  ASSERT_EQ(raw->reads().back(), ReadRange(100200 + 4096, 4096));
+}
+
+TEST_F(ReadaheadTest, StopsAtEndOfStream) {
+  ASSERT_TRUE(raw->Seek(999950).ok());
+  auto stream = ReadaheadInputStream::Create(raw, options).ValueOrDie();
+  char buffer[100];
+  ASSERT_EQ(stream->Read(100, buffer).ValueOrDie(), 50);
+  ASSERT_EQ(stream->Read(100, buffer).ValueOrDie(), 0);
+  ASSERT_EQ(stream->Tell().ValueOrDie(), 1000000);
+}
+
+TEST_F(ReadaheadTest, InvalidOptions) {
+  options.max_window = 1024;
+  ASSERT_TRUE(ReadaheadInputStream::Create(raw, options).status().IsInvalid());
+}
+
+TEST(LocalReadaheadTest, LocalFileIOOption) {
+  const std::string path = "/tmp/iceberg_readahead.txt";
+  std::string content(300000, 'r');
+  LocalFileIOOptions options;
+  options.access_pattern = AccessPattern::SEQUENTIAL;
+  options.readahead = ReadaheadOptions();
+  LocalFileIO fs(options);
+  auto out = fs.newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write(content).ok());
+  ASSERT_TRUE(out->Close().ok());
+
+  auto stream = fs.newInputFile(path).ValueOrDie()->newStream().ValueOrDie();
+  ASSERT_NE(std::dynamic_pointer_cast<ReadaheadInputStream>(stream), nullptr);
+  ASSERT_EQ(stream->Read(400000).ValueOrDie()->ToString(), content);
+  ASSERT_TRUE(stream->Close().ok());
+  ASSERT_TRUE(fs.DeleteFile(path).ok());
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,240 @@
+#include "iceberg/io/striped_file_io.hh"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace iceberg {
+namespace io {
+
+class StripedFileIOTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::filesystem::remove_all(kDir);
+    for (int i = 0; i < 3; ++i) {
+      volumes.push_back(kDir + "/volume" + std::to_string(i));
+      std::filesystem::create_directories(volumes.back());
+    }
+    options.root = "/warehouse/";
+    options.volumes = volumes;
+  }
+
+  void TearDown() override { std::filesystem::remove_all(kDir); }
+
+  void WriteFile(FileIO* fs, const std::string& path, const std::string& content) {
+    auto out = fs->newOutputFile(path).ValueOrDie()->create().ValueOrDie();
+    ASSERT_TRUE(out->Write(content).ok());
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  std::string ReadFile(FileIO* fs, const std::string& path) {
+    auto file = fs->newInputFile(path).ValueOrDie();
+    auto length = file->getLength().ValueOrDie();
+    return file->newStream().ValueOrDie()->Read(length).ValueOrDie()->ToString();
+  }
+
+  const std::string kDir = "/tmp/iceberg_striped_file_io";
+  std::vector<std::string> volumes;
+  StripedFileIOOptions options;
+};
+
+TEST_F(StripedFileIOTest, InvalidOptions) {
+  auto invalid = options;
+  invalid.volumes.clear();
+  ASSERT_TRUE(StripedFileIO::Make(invalid).status().IsInvalid());
+  invalid = options;
+  invalid.root = "warehouse";
+  ASSERT_TRUE(StripedFileIO::Make(invalid).status().IsInvalid());
+  invalid = options;
+  invalid.metadata_volume = 3;
+  ASSERT_TRUE(StripedFileIO::Make(invalid).status().IsInvalid());
+  invalid = options;
+  invalid.volumes.push_back(kDir + "/missing");
+  ASSERT_TRUE(StripedFileIO::Make(invalid).status().IsInvalid());
+
+  auto fs = StripedFileIO::Make(options).ValueOrDie();
+  ASSERT_TRUE(fs->newInputFile("/elsewhere/a").status().IsInvalid());
+  ASSERT_TRUE(fs->newOutputFile("/warehouse2/a").status().IsInvalid());
+}
+
+TEST_F(StripedFileIOTest, RoundRobin) {
+  auto fs = StripedFileIO::Make(options).ValueOrDie();
+  for (int i = 0; i < 9; ++i) {
+    WriteFile(fs.get(), "/warehouse/t/data/" + std::to_string(i), std::to_string(i));
+  }
+  for (int i = 0; i < 9; ++i) {
+    const std::string path = "/warehouse/t/data/" + std::to_string(i);
+    ASSERT_EQ(fs->VolumeOf(path).ValueOrDie(), i % 3);
+    ASSERT_TRUE(
+        std::filesystem::exists(volumes[i % 3] + "/t/data/" + std::to_string(i)));
+    ASSERT_EQ(ReadFile(fs.get(), path), std::to_string(i));
+    ASSERT_EQ(fs->newInputFile(path).ValueOrDie()->location(), path);
+  }
+
+  // Another instance over the same volumes finds the files where they are
+  auto other = StripedFileIO::Make(options).ValueOrDie();
+  for (int i = 0; i < 9; ++i) {
+    const std::string path = "/warehouse/t/data/" + std::to_string(i);
+    ASSERT_EQ(ReadFile(other.get(), path), std::to_string(i));
+    ASSERT_EQ(other->VolumeOf(path).ValueOrDie(), i % 3);
+  }
+  ASSERT_FALSE(other->VolumeOf("/warehouse/t/data/9").ValueOrDie().has_value());
+  ASSERT_FALSE(other->newInputFile("/warehouse/t/data/9").ValueOrDie()->exists());
+}
+
+TEST_F(StripedFileIOTest, PinsMetadata) {
+  options.metadata_volume = 2;
+  options.placement = VolumePlacement::FREE_SPACE;
+  auto fs = StripedFileIO::Make(options).ValueOrDie();
+  std::set<int> data_volumes;
+  for (int i = 0; i < 30; ++i) {
+    const std::string suffix = "/" + std::to_string(i);
+    WriteFile(fs.get(), "/warehouse/t/metadata" + suffix, "m");
+    WriteFile(fs.get(), "/warehouse/t/data" + suffix, "d");
+    ASSERT_EQ(fs->VolumeOf("/warehouse/t/metadata" + suffix).ValueOrDie(), 2);
+    data_volumes.insert(*fs->VolumeOf("/warehouse/t/data" + suffix).ValueOrDie());
+  }
+  // The volumes share a file system here, so they are picked about evenly
+  ASSERT_EQ(data_volumes.size(), 3);
+}
+
+TEST_F(StripedFileIOTest, Overwrite) {
+  auto fs = StripedFileIO::Make(options).ValueOrDie();
+  WriteFile(fs.get(), "/warehouse/t/a", "first");
+  WriteFile(fs.get(), "/warehouse/t/b", "b");
+  ASSERT_TRUE(fs->newOutputFile("/warehouse/t/a").ValueOrDie()->create().status()
+                  .IsAlreadyExists());
+
+  // Overwriting keeps the file on its volume, also for a fresh instance
+  auto other = StripedFileIO::Make(options).ValueOrDie();
+  auto file = other->newOutputFile("/warehouse/t/a").ValueOrDie();
+  auto out = file->createOrOverwrite().ValueOrDie();
+  ASSERT_TRUE(out->Write(std::string("second")).ok());
+  ASSERT_TRUE(out->Close().ok());
+  ASSERT_EQ(ReadFile(fs.get(), "/warehouse/t/a"), "second");
+  ASSERT_FALSE(std::filesystem::exists(volumes[1] + "/t/a"));
+
+  // Creating a file written by another instance fails too
+  ASSERT_TRUE(other->newOutputFile("/warehouse/t/b").ValueOrDie()->create().status()
+                  .IsAlreadyExists());
+}
+
+TEST_F(StripedFileIOTest, ExclusiveCreate) {
+  // Instances unaware of each other race to create the same files on different volumes
+  std::vector<std::shared_ptr<StripedFileIO>> instances;
+  for (int i = 0; i < 3; ++i) {
+    instances.push_back(StripedFileIO::Make(options).ValueOrDie());
+  }
+  for (int round = 0; round < 20; ++round) {
+    const std::string path = "/warehouse/t/metadata/v" + std::to_string(round);
+    std::vector<std::shared_ptr<OutputFile>> files;
+    for (int i = 0; i < 3; ++i) {
+      // Offsets the placement of each instance
+      for (int j = 0; j < i; ++j) {
+        ASSERT_TRUE(instances[i]->newOutputFile(path).ok());
+      }
+      files.push_back(instances[i]->newOutputFile(path).ValueOrDie());
+    }
+    std::atomic<int> created{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i) {
+      threads.emplace_back([&, i]() {
+        auto stream = files[i]->create();
+        if (stream.ok()) {
+          ++created;
+          ASSERT_TRUE((*stream)->Close().ok());
+        } else {
+          ASSERT_TRUE(stream.status().IsAlreadyExists());
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    ASSERT_LE(created.load(), 1);
+  }
+}
+
+TEST_F(StripedFileIOTest, ListAndDelete) {
+  auto fs = StripedFileIO::Make(options).ValueOrDie();
+  std::map<std::string, int64_t> expected;
+  for (int i = 0; i < 20; ++i) {
+    const std::string path = "/warehouse/t/data/" + std::to_string(i);
+    WriteFile(fs.get(), path, std::string(i, 'x'));
+    expected[path] = i;
+  }
+  WriteFile(fs.get(), "/warehouse/u/data/0", "u");
+
+  auto list = [&](const std::string& prefix) {
+    ListPrefixOptions list_options;
+    list_options.batch_size = 3;
+    auto it = fs->ListPrefix(prefix, list_options).ValueOrDie();
+    std::map<std::string, int64_t> listed;
+    for (auto batch = it->Next().ValueOrDie(); !batch.empty();
+         batch = it->Next().ValueOrDie()) {
+      for (const auto& info : batch) {
+        listed[info.location()] = info.size();
+      }
+    }
+    return listed;
+  };
+  ASSERT_EQ(list("/warehouse/t/"), expected);
+  ASSERT_EQ(list("/warehouse").size(), 21);
+  ASSERT_TRUE(list("/warehouse/v/").empty());
+
+  ASSERT_TRUE(fs->DeleteFile("/warehouse/t/data/4").ok());
+  ASSERT_TRUE(fs->DeleteFile("/warehouse/t/data/4").IsIOError());
+  auto result = fs->DeleteFiles({"/warehouse/t/data/5", "/warehouse/t/data/6"});
+  ASSERT_TRUE(result.ok());
+  ASSERT_EQ(list("/warehouse/t/").size(), 17);
+  ASSERT_FALSE(fs->newInputFile("/warehouse/t/data/5").ValueOrDie()->exists());
+}
+
+TEST_F(StripedFileIOTest, ForgottenLocationsAreFoundAgain) {
+  options.max_remembered_locations = 2;
+  options.placement = VolumePlacement::FREE_SPACE;
+  auto fs = StripedFileIO::Make(options).ValueOrDie();
+  std::map<std::string, int> placed;
+  for (int i = 0; i < 10; ++i) {
+    const std::string path = "/warehouse/t/data/" + std::to_string(i);
+    WriteFile(fs.get(), path, std::to_string(i));
+    placed[path] = *fs->VolumeOf(path).ValueOrDie();
+  }
+  for (const auto& [path, volume] : placed) {
+    ASSERT_EQ(fs->VolumeOf(path).ValueOrDie(), volume);
+    ASSERT_EQ(ReadFile(fs.get(), path), path.substr(path.rfind('/') + 1));
+  }
+  auto result = fs->DeleteFiles({"/warehouse/t/data/0", "/warehouse/t/data/9"});
+  ASSERT_TRUE(result.ok());
+  ASSERT_FALSE(fs->VolumeOf("/warehouse/t/data/0").ValueOrDie().has_value());
+  ASSERT_FALSE(fs->VolumeOf("/warehouse/t/data/9").ValueOrDie().has_value());
+}
+
+TEST_F(StripedFileIOTest, CopyFile) {
+  options.metadata_volume = 0;
+  auto fs = StripedFileIO::Make(options).ValueOrDie();
+  WriteFile(fs.get(), "/warehouse/t/data/a", "aaa");
+  WriteFile(fs.get(), "/warehouse/t/data/b", "bbb");
+  ASSERT_EQ(fs->VolumeOf("/warehouse/t/data/b").ValueOrDie(), 1);
+
+  // Copies stay on the volume of the source, unless pinned elsewhere
+  ASSERT_TRUE(fs->CopyFile("/warehouse/t/data/b", "/warehouse/u/data/b").ok());
+  ASSERT_EQ(fs->VolumeOf("/warehouse/u/data/b").ValueOrDie(), 1);
+  ASSERT_TRUE(fs->CopyFile("/warehouse/t/data/b", "/warehouse/u/metadata/b").ok());
+  ASSERT_EQ(fs->VolumeOf("/warehouse/u/metadata/b").ValueOrDie(), 0);
+  ASSERT_EQ(ReadFile(fs.get(), "/warehouse/u/metadata/b"), "bbb");
+
+  ASSERT_TRUE(
+      fs->CopyFile("/warehouse/t/data/a", "/warehouse/u/data/b").IsAlreadyExists());
+  ASSERT_TRUE(fs->CopyFile("/warehouse/t/data/c", "/warehouse/u/data/c").IsInvalid());
+}
+
+}  // namespace io
+}  // namespace iceberg
@@ -0,0 +1,285 @@
+#include "iceberg/manifest_list.hh"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "avro/test_util.hh"
+#include "iceberg/io/memory_file_io.hh"
+
+namespace iceberg {
+namespace table {
+
+using avro::MakeAvroFile;
+using avro::TestBlock;
+using avro::TestEncoder;
+
+const char kManifestListV2Schema[] = R"({
+  "type": "record", "name": "manifest_file", "fields": [
+    {"name": "manifest_path", "type": "string", "field-id": 500},
+    {"name": "manifest_length", "type": "long", "field-id": 501},
+    {"name": "partition_spec_id", "type": "int", "field-id": 502},
+    {"name": "content", "type": "int", "field-id": 517},
+    {"name": "sequence_number", "type": "long", "field-id": 515},
+    {"name": "min_sequence_number", "type": "long", "field-id": 516},
+    {"name": "added_snapshot_id", "type": "long", "field-id": 503},
+    {"name": "added_files_count", "type": "int", "field-id": 504},
+    {"name": "existing_files_count", "type": "int", "field-id": 505},
+    {"name": "deleted_files_count", "type": "int", "field-id": 506},
+    {"name": "added_rows_count", "type": "long", "field-id": 512},
+    {"name": "existing_rows_count", "type": "long", "field-id": 513},
+    {"name": "deleted_rows_count", "type": "long", "field-id": 514},
+    {"name": "partitions", "type": ["null", {"type": "array", "items": {
+      "type": "record", "name": "r508", "fields": [
+        {"name": "contains_null", "type": "boolean", "field-id": 509},
+        {"name": "contains_nan", "type": ["null", "boolean"], "field-id": 518},
+        {"name": "lower_bound", "type": ["null", "bytes"], "field-id": 510},
+        {"name": "upper_bound", "type": ["null", "bytes"], "field-id": 511}]},
+      "element-id": 508}], "default": null, "field-id": 507},
+    {"name": "key_metadata", "type": ["null", "bytes"], "field-id": 519}
+  ]
+})";
+
+const char kManifestListV1Schema[] = R"({
+  "type": "record", "name": "manifest_file", "fields": [
+    {"name": "manifest_path", "type": "string", "field-id": 500},
+    {"name": "manifest_length", "type": "long", "field-id": 501},
+    {"name": "partition_spec_id", "type": "int", "field-id": 502},
+    {"name": "added_snapshot_id", "type": ["null", "long"], "field-id": 503},
+    {"name": "added_data_files_count", "type": ["null", "int"], "field-id": 504},
+    {"name": "existing_data_files_count", "type": ["null", "int"], "field-id": 505},
+    {"name": "deleted_data_files_count", "type": ["null", "int"], "field-id": 506},
+    {"name": "partitions", "type": ["null", {"type": "array", "items": {
+      "type": "record", "name": "r508", "fields": [
+        {"name": "contains_null", "type": "boolean", "field-id": 509},
+        {"name": "lower_bound", "type": ["null", "bytes"], "field-id": 510},
+        {"name": "upper_bound", "type": ["null", "bytes"], "field-id": 511}]}}],
+      "field-id": 507},
+    {"name": "added_rows_count", "type": ["null", "long"], "field-id": 512},
+    {"name": "existing_rows_count", "type": ["null", "long"], "field-id": 513},
+    {"name": "deleted_rows_count", "type": ["null", "long"], "field-id": 514}
+  ]
+})";
+
+class ManifestListTest : public testing::Test {
+ protected:
+  void SetUp() override { fs = std::make_shared<io::MemoryFileIO>(); }
+
+  void WriteFile(const std::string& path, const std::string& content) {
+    auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+    ASSERT_TRUE(out->Write(content).ok());
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  static std::string Path(int64_t i) {
+    return "s3://bucket/metadata/manifest-" + std::to_string(i) + ".avro";
+  }
+
+  // Manifest i has i % 3 partition summaries, or none at all if i % 3 is 0
+  static void EncodeV2(int64_t i, TestEncoder* encoder) {
+    encoder->Bytes(Path(i)).Long(1000 + i).Long(i % 2).Long(i % 4 == 3 ? 1 : 0);
+    encoder->Long(10 + i).Long(5 + i).Long(9000 + i);
+    encoder->Long(i).Long(2 * i).Long(3 * i).Long(100 * i).Long(200 * i).Long(300 * i);
+    if (i % 3 == 0) {
+      encoder->Long(0);
+    } else {
+      encoder->Long(1).Long(i % 3);
+      for (int64_t j = 0; j < i % 3; ++j) {
+        encoder->Bool(j == 1).Long(1).Bool(false);
+        encoder->Long(1).Bytes("lo" + std::to_string(i));
+        encoder->Long(j == 0 ? 1 : 0);
+        if (j == 0) {
+          encoder->Bytes("hi" + std::to_string(i));
+        }
+      }
+      encoder->Long(0);
+    }
+    encoder->Long(1).Bytes("secret-key-metadata");
+  }
+
+  std::string WriteV2(int64_t num_blocks, int64_t per_block,
+                      const std::string& codec = "null") {
+    std::vector<TestBlock> blocks;
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      TestEncoder encoder;
+      for (int64_t i = b * per_block; i < (b + 1) * per_block; ++i) {
+        EncodeV2(i, &encoder);
+      }
+      blocks.emplace_back(per_block, encoder.str());
+    }
+    WriteFile("mem://snap-1.avro", MakeAvroFile(kManifestListV2Schema, blocks, codec));
+    return "mem://snap-1.avro";
+  }
+
+  static void CheckV2(const ManifestListColumns& columns, int64_t n) {
+    ASSERT_EQ(columns.num_rows, n);
+    ASSERT_EQ(columns.manifest_path.size(), n);
+    ASSERT_EQ(columns.partitions.offsets.size(), n + 1);
+    for (int64_t i = 0; i < n; ++i) {
+      ASSERT_EQ(columns.manifest_path[i], Path(i));
+      ASSERT_EQ(columns.manifest_length[i], 1000 + i);
+      ASSERT_EQ(columns.partition_spec_id[i], i % 2);
+      ASSERT_EQ(columns.content[i],
+                i % 4 == 3 ? ManifestContent::DELETES : ManifestContent::DATA);
+      ASSERT_EQ(columns.sequence_number[i], 10 + i);
+      ASSERT_EQ(columns.min_sequence_number[i], 5 + i);
+      ASSERT_EQ(columns.added_snapshot_id[i], 9000 + i);
+      ASSERT_EQ(columns.added_files_count[i], i);
+      ASSERT_EQ(columns.existing_files_count[i], 2 * i);
+      ASSERT_EQ(columns.deleted_files_count[i], 3 * i);
+      ASSERT_EQ(columns.added_rows_count[i], 100 * i);
+      ASSERT_EQ(columns.existing_rows_count[i], 200 * i);
+      ASSERT_EQ(columns.deleted_rows_count[i], 300 * i);
+
+      const auto& partitions = columns.partitions;
+      const int64_t begin = partitions.offsets[i];
+      ASSERT_EQ(partitions.offsets[i + 1] - begin, i % 3);
+      for (int64_t j = 0; j < i % 3; ++j) {
+        ASSERT_EQ(partitions.contains_null[begin + j], j == 1 ? 1 : 0);
+        ASSERT_EQ(partitions.contains_nan[begin + j], 0);
+        ASSERT_EQ(partitions.lower_bound[begin + j], "lo" + std::to_string(i));
+        ASSERT_EQ(partitions.upper_bound.IsNull(begin + j), j != 0);
+        if (j == 0) {
+          ASSERT_EQ(partitions.upper_bound[begin + j], "hi" + std::to_string(i));
+        }
+      }
+    }
+  }
+
+  std::shared_ptr<io::MemoryFileIO> fs;
+};
+
+TEST_F(ManifestListTest, ReadAll) {
+  const auto path = WriteV2(3, 50);
+  auto reader = ManifestListReader::Open(*fs, path).ValueOrDie();
+  CheckV2(reader->ReadAll().ValueOrDie(), 150);
+}
+
+TEST_F(ManifestListTest, ReadDeflateFile) {
+  const auto path = WriteV2(2, 40, "deflate");
+  auto reader = ManifestListReader::Open(*fs, path).ValueOrDie();
+  CheckV2(reader->ReadAll().ValueOrDie(), 80);
+}
+
+TEST_F(ManifestListTest, ReadBatchStreamsBlocks) {
+  const auto path = WriteV2(3, 20);
+  auto reader = ManifestListReader::Open(*fs, path).ValueOrDie();
+  ManifestListColumns columns;
+  for (int b = 0; b < 3; ++b) {
+    ASSERT_EQ(reader->ReadBatch(&columns).ValueOrDie(), 20);
+    ASSERT_EQ(columns.num_rows, 20 * (b + 1));
+  }
+  ASSERT_EQ(reader->ReadBatch(&columns).ValueOrDie(), 0);
+  CheckV2(columns, 60);
+}
+
+TEST_F(ManifestListTest, Projection) {
+  const auto path = WriteV2(2, 10);
+  ManifestListProjection projection;
+  projection.partition_spec_id = false;
+  projection.content = false;
+  projection.sequence_numbers = false;
+  projection.added_snapshot_id = false;
+  projection.partitions = false;
+  auto reader = ManifestListReader::Open(*fs, path, projection).ValueOrDie();
+  auto columns = reader->ReadAll().ValueOrDie();
+  ASSERT_EQ(columns.num_rows, 20);
+  ASSERT_EQ(columns.manifest_path.size(), 20);
+  ASSERT_EQ(columns.manifest_path[7], Path(7));
+  ASSERT_EQ(columns.manifest_length[7], 1007);
+  ASSERT_EQ(columns.deleted_rows_count[7], 2100);
+  ASSERT_TRUE(columns.partition_spec_id.empty());
+  ASSERT_TRUE(columns.content.empty());
+  ASSERT_TRUE(columns.sequence_number.empty());
+  ASSERT_TRUE(columns.added_snapshot_id.empty());
+  ASSERT_EQ(columns.partitions.offsets.size(), 1);
+  ASSERT_TRUE(columns.partitions.contains_null.empty());
+
+  projection = ManifestListProjection{};
+  projection.manifest_path = false;
+  projection.counts = false;
+  reader = ManifestListReader::Open(*fs, path, projection).ValueOrDie();
+  columns = reader->ReadAll().ValueOrDie();
+  ASSERT_TRUE(columns.manifest_path.empty());
+  ASSERT_TRUE(columns.added_files_count.empty());
+  ASSERT_EQ(columns.partitions.offsets.size(), 21);
+  ASSERT_EQ(columns.partitions.lower_bound[0], "lo1");
+}
+
+TEST_F(ManifestListTest, ReadV1) {
+  TestEncoder encoder;
+  // A manifest with counts and partitions, and one without
+  encoder.Bytes("m0.avro").Long(10).Long(0).Long(1).Long(77);
+  encoder.Long(1).Long(3).Long(1).Long(4).Long(1).Long(5);
+  encoder.Long(1).Long(1).Bool(true).Long(0).Long(0).Long(0);
+  encoder.Long(1).Long(30).Long(1).Long(40).Long(1).Long(50);
+  encoder.Bytes("m1.avro").Long(20).Long(1).Long(1).Long(78);
+  encoder.Long(0).Long(0).Long(0).Long(0).Long(0).Long(0).Long(0);
+  WriteFile("mem://v1.avro", MakeAvroFile(kManifestListV1Schema, {{2, encoder.str()}}));
+
+  auto reader = ManifestListReader::Open(*fs, "mem://v1.avro").ValueOrDie();
+  auto columns = reader->ReadAll().ValueOrDie();
+  ASSERT_EQ(columns.num_rows, 2);
+  ASSERT_EQ(columns.manifest_path[1], "m1.avro");
+  ASSERT_EQ(columns.added_snapshot_id[1], 78);
+  // Fields added in version 2 take their defaults
+  ASSERT_EQ(columns.content,
+            std::vector<ManifestContent>(2, ManifestContent::DATA));
+  ASSERT_EQ(columns.sequence_number, std::vector<int64_t>(2, 0));
+  ASSERT_EQ(columns.min_sequence_number, std::vector<int64_t>(2, 0));
+  ASSERT_EQ(columns.added_files_count, (std::vector<int32_t>{3, -1}));
+  ASSERT_EQ(columns.deleted_files_count, (std::vector<int32_t>{5, -1}));
+  ASSERT_EQ(columns.existing_rows_count, (std::vector<int64_t>{40, -1}));
+  ASSERT_EQ(columns.partitions.offsets, (std::vector<int64_t>{0, 1, 1}));
+  ASSERT_EQ(columns.partitions.contains_null[0], 1);
+  ASSERT_EQ(columns.partitions.contains_nan[0], -1);
+  ASSERT_TRUE(columns.partitions.lower_bound.IsNull(0));
+}
+
+TEST_F(ManifestListTest, MatchesFieldsByNameWithoutIds) {
+  const char schema[] = R"({"type": "record", "name": "manifest_file", "fields": [
+    {"name": "extra", "type": {"type": "map", "values": "string"}},
+    {"name": "partition_spec_id", "type": "int"},
+    {"name": "manifest_length", "type": "long"},
+    {"name": "added_snapshot_id", "type": "long"},
+    {"name": "manifest_path", "type": "string"}]})";
+  TestEncoder encoder;
+  encoder.Long(1).Bytes("k").Bytes("v").Long(0).Long(3).Long(55).Long(66).Bytes("m.avro");
+  WriteFile("mem://names.avro", MakeAvroFile(schema, {{1, encoder.str()}}));
+  auto reader = ManifestListReader::Open(*fs, "mem://names.avro").ValueOrDie();
+  auto columns = reader->ReadAll().ValueOrDie();
+  ASSERT_EQ(columns.num_rows, 1);
+  ASSERT_EQ(columns.manifest_path[0], "m.avro");
+  ASSERT_EQ(columns.manifest_length[0], 55);
+  ASSERT_EQ(columns.partition_spec_id[0], 3);
+  ASSERT_EQ(columns.added_snapshot_id[0], 66);
+}
+
+TEST_F(ManifestListTest, RejectsInvalidFiles) {
+  const char missing_path[] = R"({"type": "record", "name": "manifest_file",
+    "fields": [{"name": "manifest_length", "type": "long", "field-id": 501}]})";
+  WriteFile("mem://a.avro", MakeAvroFile(missing_path, {}));
+  ASSERT_TRUE(ManifestListReader::Open(*fs, "mem://a.avro").status().IsInvalid());
+  ManifestListProjection projection;
+  projection.manifest_path = false;
+  projection.partition_spec_id = false;
+  projection.added_snapshot_id = false;
+  ASSERT_TRUE(ManifestListReader::Open(*fs, "mem://a.avro", projection).ok());
+
+  const char wrong_type[] = R"({"type": "record", "name": "manifest_file",
+    "fields": [{"name": "manifest_path", "type": "long", "field-id": 500}]})";
+  WriteFile("mem://b.avro", MakeAvroFile(wrong_type, {}));
+  ASSERT_TRUE(ManifestListReader::Open(*fs, "mem://b.avro").status().IsInvalid());
+
+  // A block claiming more manifests than it holds
+  TestEncoder encoder;
+  EncodeV2(0, &encoder);
+  WriteFile("mem://c.avro", MakeAvroFile(kManifestListV2Schema, {{2, encoder.str()}}));
+  auto reader = ManifestListReader::Open(*fs, "mem://c.avro").ValueOrDie();
+  ASSERT_TRUE(reader->ReadAll().status().IsInvalid());
+}
+
+}  // namespace table
+}  // namespace iceberg
@@ -0,0 +1,336 @@
+#include "iceberg/manifest_reader.hh"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "avro/test_util.hh"
+#include "iceberg/avro/projection.hh"
+#include "iceberg/io/memory_file_io.hh"
+
+namespace iceberg {
+namespace table {
+
+using avro::MakeAvroFile;
+using avro::TestBlock;
+using avro::TestDecoder;
+using avro::TestEncoder;
+
+// A metrics map, written by Iceberg as an optional array of key-value records
+std::string MetricsField(const std::string& name, int field_id, int key_id,
+                         const std::string& value_type) {
+  const std::string record = "k" + std::to_string(key_id) + "_v" +
+                             std::to_string(key_id + 1);
+  return R"({"name": ")" + name + R"(", "type": ["null", {"type": "array", "items": {
+      "type": "record", "name": ")" + record + R"(", "fields": [
+        {"name": "key", "type": "int", "field-id": )" + std::to_string(key_id) + R"(},
+        {"name": "value", "type": ")" + value_type + R"(", "field-id": )" +
+         std::to_string(key_id + 1) + R"(}]},
+      "logicalType": "map"}], "default": null, "field-id": )" +
+         std::to_string(field_id) + "}";
+}
+
+std::string ManifestV2Schema() {
+  return R"({"type": "record", "name": "manifest_entry", "fields": [
+    {"name": "status", "type": "int", "field-id": 0},
+    {"name": "snapshot_id", "type": ["null", "long"], "field-id": 1},
+    {"name": "sequence_number", "type": ["null", "long"], "field-id": 3},
+    {"name": "file_sequence_number", "type": ["null", "long"], "field-id": 4},
+    {"name": "data_file", "type": {"type": "record", "name": "r2", "fields": [
+      {"name": "content", "type": "int", "field-id": 134},
+      {"name": "file_path", "type": "string", "field-id": 100},
+      {"name": "file_format", "type": "string", "field-id": 101},
+      {"name": "partition", "type": {"type": "record", "name": "r102", "fields": [
+        {"name": "day", "type": ["null", "int"], "field-id": 1000},
+        {"name": "bucket", "type": ["null", "int"], "field-id": 1001}]},
+       "field-id": 102},
+      {"name": "record_count", "type": "long", "field-id": 103},
+      {"name": "file_size_in_bytes", "type": "long", "field-id": 104},
+      )" + MetricsField("column_sizes", 108, 117, "long") + ",\n" +
+         MetricsField("value_counts", 109, 119, "long") + ",\n" +
+         MetricsField("null_value_counts", 110, 121, "long") + ",\n" +
+         MetricsField("nan_value_counts", 137, 138, "long") + ",\n" +
+         MetricsField("lower_bounds", 125, 126, "bytes") + ",\n" +
+         MetricsField("upper_bounds", 128, 129, "bytes") + R"(,
+      {"name": "key_metadata", "type": ["null", "bytes"], "field-id": 131},
+      {"name": "split_offsets", "type": ["null", {"type": "array", "items": "long",
+        "element-id": 133}], "field-id": 132},
+      {"name": "equality_ids", "type": ["null", {"type": "array", "items": "int",
+        "element-id": 136}], "field-id": 135},
+      {"name": "sort_order_id", "type": ["null", "int"], "field-id": 140}]},
+     "field-id": 2}]})";
+}
+
+class ManifestReaderTest : public testing::Test {
+ protected:
+  static constexpr int kNumColumns = 40;
+
+  void SetUp() override { fs = std::make_shared<io::MemoryFileIO>(); }
+
+  void WriteFile(const std::string& path, const std::string& content) {
+    auto out = fs->newOutputFile(path).ValueOrDie()->createOrOverwrite().ValueOrDie();
+    ASSERT_TRUE(out->Write(content).ok());
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  static std::string Path(int64_t i) {
+    return "s3://bucket/data/file-" + std::to_string(i) + ".parquet";
+  }
+
+  // Write a map with an entry per column for which `value` writes a value. With
+  // `sized`, the block carries its byte size, as some writers do.
+  static void EncodeMap(bool sized, TestEncoder* encoder,
+                        const std::function<bool(int, TestEncoder*)>& value) {
+    TestEncoder entries;
+    int64_t count = 0;
+    for (int id = 1; id <= kNumColumns; ++id) {
+      TestEncoder entry;
+      entry.Long(id);
+      if (value(id, &entry)) {
+        entries.Raw(entry.str());
+        ++count;
+      }
+    }
+    encoder->Long(1);
+    if (sized) {
+      encoder->Long(-count).Long(entries.str().size());
+    } else {
+      encoder->Long(count);
+    }
+    encoder->Raw(entries.str()).Long(0);
+  }
+
+  static void EncodeEntry(int64_t i, bool sized, TestEncoder* encoder) {
+    encoder->Long(1);
+    if (i % 2 == 0) {
+      encoder->Long(1).Long(500 + i);
+    } else {
+      encoder->Long(0);
+    }
+    encoder->Long(1).Long(10 + i).Long(1).Long(20 + i);
+    encoder->Long(i % 3 == 2 ? 2 : 0).Bytes(Path(i)).Bytes("PARQUET");
+    encoder->Long(1).Long(19000 + i).Long(0);
+    encoder->Long(1000 + i).Long(5000 + i);
+    EncodeMap(sized, encoder, [&](int id, TestEncoder* e) {
+      e->Long(id * 100 + i);
+      return true;
+    });
+    EncodeMap(sized, encoder, [&](int, TestEncoder* e) {
+      e->Long(1000 + i);
+      return true;
+    });
+    EncodeMap(sized, encoder, [&](int id, TestEncoder* e) {
+      e->Long(id);
+      return true;
+    });
+    EncodeMap(sized, encoder, [&](int id, TestEncoder* e) {
+      e->Long(0);
+      return id % 2 == 0;
+    });
+    EncodeMap(sized, encoder, [&](int id, TestEncoder* e) {
+      e->Bytes("l" + std::to_string(id) + "-" + std::to_string(i));
+      return true;
+    });
+    EncodeMap(sized, encoder, [&](int id, TestEncoder* e) {
+      e->Bytes("u" + std::to_string(id) + "-" + std::to_string(i));
+      return id != 5;
+    });
+    encoder->Long(0).Long(1).Long(2).Long(4).Long(100).Long(0).Long(0).Long(1).Long(0);
+  }
+
+  std::string WriteManifest(int64_t num_blocks, int64_t per_block, bool sized = false) {
+    std::vector<TestBlock> blocks;
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      TestEncoder encoder;
+      for (int64_t i = b * per_block; i < (b + 1) * per_block; ++i) {
+        EncodeEntry(i, sized, &encoder);
+      }
+      blocks.emplace_back(per_block, encoder.str());
+    }
+    WriteFile("mem://manifest.avro",
+              MakeAvroFile(ManifestV2Schema(), blocks, "deflate",
+                           {{"format-version", "2"}, {"partition-spec-id", "3"}}));
+    return "mem://manifest.avro";
+  }
+
+  static void CheckEntries(const ManifestEntryColumns& columns, int64_t n) {
+    ASSERT_EQ(columns.num_rows, n);
+    for (int64_t i = 0; i < n; ++i) {
+      ASSERT_EQ(columns.status[i], ManifestEntryStatus::ADDED);
+      ASSERT_EQ(columns.snapshot_id[i], i % 2 == 0 ? 500 + i : -1);
+      ASSERT_EQ(columns.sequence_number[i], 10 + i);
+      ASSERT_EQ(columns.file_sequence_number[i], 20 + i);
+      ASSERT_EQ(columns.content[i], i % 3 == 2 ? DataFileContent::EQUALITY_DELETES
+                                               : DataFileContent::DATA);
+      ASSERT_EQ(columns.file_path[i], Path(i));
+      ASSERT_EQ(columns.file_format[i], "PARQUET");
+      ASSERT_EQ(columns.record_count[i], 1000 + i);
+      ASSERT_EQ(columns.file_size_in_bytes[i], 5000 + i);
+    }
+  }
+
+  std::shared_ptr<io::MemoryFileIO> fs;
+};
+
+TEST_F(ManifestReaderTest, DecodesMetricsOfRequestedColumns) {
+  const auto path = WriteManifest(2, 25);
+  ManifestReaderOptions options;
+  options.metrics_field_ids = {7, 4, 5, 99};
+  auto reader = ManifestReader::Open(*fs, path, options).ValueOrDie();
+  ASSERT_EQ(reader->metadata("partition-spec-id"), "3");
+  auto columns = reader->ReadAll().ValueOrDie();
+  CheckEntries(columns, 50);
+
+  ASSERT_EQ(columns.metrics.size(), 4);
+  for (size_t c = 0; c < 3; ++c) {
+    const auto& metrics = columns.metrics[c];
+    const int id = metrics.field_id;
+    ASSERT_EQ(id, options.metrics_field_ids[c]);
+    ASSERT_TRUE(metrics.column_size.empty());
+    for (int64_t i = 0; i < 50; ++i) {
+      ASSERT_EQ(metrics.value_count[i], 1000 + i);
+      ASSERT_EQ(metrics.null_value_count[i], id);
+      ASSERT_EQ(metrics.nan_value_count[i], id % 2 == 0 ? 0 : -1);
+      ASSERT_EQ(metrics.lower_bound[i],
+                "l" + std::to_string(id) + "-" + std::to_string(i));
+      if (id == 5) {
+        ASSERT_TRUE(metrics.upper_bound.IsNull(i));
+      } else {
+        ASSERT_EQ(metrics.upper_bound[i],
+                  "u" + std::to_string(id) + "-" + std::to_string(i));
+      }
+    }
+  }
+  // A column without metrics in any file
+  const auto& missing = columns.metrics[3];
+  ASSERT_EQ(missing.value_count, std::vector<int64_t>(50, -1));
+  ASSERT_EQ(missing.lower_bound.size(), 50);
+  ASSERT_TRUE(missing.lower_bound.IsNull(49));
+}
+
+TEST_F(ManifestReaderTest, DecodesColumnSizesOnRequest) {
+  const auto path = WriteManifest(1, 10);
+  ManifestReaderOptions options;
+  options.metrics_field_ids = {12};
+  options.column_sizes = true;
+  auto reader = ManifestReader::Open(*fs, path, options).ValueOrDie();
+  auto columns = reader->ReadAll().ValueOrDie();
+  ASSERT_EQ(columns.metrics[0].column_size[3], 1203);
+}
+
+TEST_F(ManifestReaderTest, SkipsAllMetrics) {
+  for (bool sized : {false, true}) {
+    const auto path = WriteManifest(3, 10, sized);
+    auto reader = ManifestReader::Open(*fs, path).ValueOrDie();
+    auto columns = reader->ReadAll().ValueOrDie();
+    CheckEntries(columns, 30);
+    ASSERT_TRUE(columns.metrics.empty());
+  }
+  // Maps written with byte sizes are also decoded
+  const auto path = WriteManifest(1, 10, true);
+  ManifestReaderOptions options;
+  options.metrics_field_ids = {40};
+  auto reader = ManifestReader::Open(*fs, path, options).ValueOrDie();
+  auto columns = reader->ReadAll().ValueOrDie();
+  ASSERT_EQ(columns.metrics[0].null_value_count[9], 40);
+}
+
+TEST_F(ManifestReaderTest, KeepsPartitionEncoding) {
+  const auto path = WriteManifest(1, 5);
+  auto reader = ManifestReader::Open(*fs, path).ValueOrDie();
+  auto columns = reader->ReadAll().ValueOrDie();
+  const ::avro::NodePtr& partition_schema = reader->partition_schema();
+  ASSERT_EQ(partition_schema->leaves(), 2);
+  ASSERT_EQ(columns.partition.size(), 5);
+
+  const std::string encoded = std::string(columns.partition[4]) + "x";
+  TestDecoder decoder(encoded);
+  const auto day_schema = avro::UnwrapOptional(partition_schema->leafAt(0));
+  const auto bucket_schema = avro::UnwrapOptional(partition_schema->leafAt(1));
+  bool present;
+  int64_t value;
+  ASSERT_TRUE(avro::ReadOptionalLong(decoder.get(), day_schema, &present, &value).ok());
+  ASSERT_EQ(value, 19004);
+  ASSERT_TRUE(
+      avro::ReadOptionalLong(decoder.get(), bucket_schema, &present, &value).ok());
+  ASSERT_FALSE(present);
+  // The tuple ends where the marker appended after it starts
+  std::vector<uint8_t> marker;
+  decoder.get()->decodeFixed(1, marker);
+  ASSERT_EQ(marker[0], 'x');
+
+  ManifestReaderOptions options;
+  options.partition = false;
+  reader = ManifestReader::Open(*fs, path, options).ValueOrDie();
+  columns = reader->ReadAll().ValueOrDie();
+  ASSERT_TRUE(columns.partition.empty());
+  CheckEntries(columns, 5);
+}
+
+TEST_F(ManifestReaderTest, ReadV1) {
+  const char schema[] = R"({"type": "record", "name": "manifest_entry", "fields": [
+    {"name": "status", "type": "int", "field-id": 0},
+    {"name": "snapshot_id", "type": "long", "field-id": 1},
+    {"name": "data_file", "type": {"type": "record", "name": "r2", "fields": [
+      {"name": "file_path", "type": "string", "field-id": 100},
+      {"name": "file_format", "type": "string", "field-id": 101},
+      {"name": "partition", "type": {"type": "record", "name": "r102", "fields": []},
+       "field-id": 102},
+      {"name": "record_count", "type": "long", "field-id": 103},
+      {"name": "file_size_in_bytes", "type": "long", "field-id": 104},
+      {"name": "block_size_in_bytes", "type": "long", "field-id": 105},
+      {"name": "value_counts", "type": ["null", {"type": "array", "items": {
+        "type": "record", "name": "k119_v120", "fields": [
+          {"name": "key", "type": "int", "field-id": 119},
+          {"name": "value", "type": "long", "field-id": 120}]}}], "field-id": 109}]},
+     "field-id": 2}]})";
+  TestEncoder encoder;
+  encoder.Long(2).Long(77).Bytes("a.avro").Bytes("AVRO").Long(5).Long(100).Long(64);
+  encoder.Long(1).Long(2).Long(1).Long(11).Long(2).Long(22).Long(0);
+  WriteFile("mem://v1.avro", MakeAvroFile(schema, {{1, encoder.str()}}));
+
+  ManifestReaderOptions options;
+  options.metrics_field_ids = {2};
+  auto reader = ManifestReader::Open(*fs, "mem://v1.avro", options).ValueOrDie();
+  auto columns = reader->ReadAll().ValueOrDie();
+  ASSERT_EQ(columns.num_rows, 1);
+  ASSERT_EQ(columns.status[0], ManifestEntryStatus::DELETED);
+  ASSERT_EQ(columns.snapshot_id[0], 77);
+  ASSERT_EQ(columns.sequence_number[0], 0);
+  ASSERT_EQ(columns.file_sequence_number[0], 0);
+  ASSERT_EQ(columns.content[0], DataFileContent::DATA);
+  ASSERT_EQ(columns.file_path[0], "a.avro");
+  ASSERT_EQ(columns.partition[0], "");
+  ASSERT_EQ(columns.file_size_in_bytes[0], 100);
+  ASSERT_EQ(columns.metrics[0].value_count[0], 22);
+  ASSERT_EQ(columns.metrics[0].null_value_count[0], -1);
+}
+
+TEST_F(ManifestReaderTest, RejectsInvalidInput) {
+  const auto path = WriteManifest(1, 2);
+  ManifestReaderOptions options;
+  options.metrics_field_ids = {3, 3};
+  ASSERT_TRUE(ManifestReader::Open(*fs, path, options).status().IsInvalid());
+  options.metrics_field_ids = {-1};
+  ASSERT_TRUE(ManifestReader::Open(*fs, path, options).status().IsInvalid());
+
+  const char no_data_file[] = R"({"type": "record", "name": "manifest_entry",
+    "fields": [{"name": "status", "type": "int", "field-id": 0},
+               {"name": "snapshot_id", "type": "long", "field-id": 1}]})";
+  WriteFile("mem://bad.avro", MakeAvroFile(no_data_file, {}));
+  ASSERT_TRUE(ManifestReader::Open(*fs, "mem://bad.avro").status().IsInvalid());
+
+  // Columns filled by a reader of other metrics
+  auto reader = ManifestReader::Open(*fs, path).ValueOrDie();
+  ManifestEntryColumns columns;
+  ASSERT_EQ(reader->ReadBatch(&columns).ValueOrDie(), 2);
+  options.metrics_field_ids = {1};
+  reader = ManifestReader::Open(*fs, path, options).ValueOrDie();
+  ASSERT_TRUE(reader->ReadBatch(&columns).status().IsInvalid());
+}
+
+}  // namespace table
+}  // namespace iceberg
@@ -0,0 +1,59 @@
+#include "iceberg/util/crc32c.hh"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace iceberg {
+namespace util {
+
+TEST(Crc32cTest, KnownValues) {
+  ASSERT_EQ(Crc32c("", 0), 0);
+  ASSERT_EQ(Crc32c("123456789", 9), 0xe3069283);
+  ASSERT_EQ(internal::Crc32cPortable("123456789", 9, 0), 0xe3069283);
+  // From RFC 3720, appendix B.4
+  std::vector<uint8_t> data(32, 0);
+  ASSERT_EQ(Crc32c(data.data(), data.size()), 0x8a9136aa);
+  std::fill(data.begin(), data.end(), 0xff);
+  ASSERT_EQ(Crc32c(data.data(), data.size()), 0x62a8ab43);
+  for (int i = 0; i < 32; ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  ASSERT_EQ(Crc32c(data.data(), data.size()), 0x46dd794e);
+}
+
+TEST(Crc32cTest, MatchesPortable) {
+  std::mt19937 rng(42);
+  std::vector<uint8_t> data(3 * 8192 * 2 + 3 * 256 + 100);
+  for (auto& byte : data) {
+    byte = static_cast<uint8_t>(rng());
+  }
+  // Lengths and alignments around the interleaved block sizes
+  for (size_t length : {0, 1, 7, 8, 9, 255, 768, 769, 3 * 8192 - 1, 3 * 8192,
+                        3 * 8192 + 3 * 256 + 13, 6 * 8192 + 3 * 256 + 99}) {
+    for (size_t offset : {0, 1, 3}) {
+      ASSERT_EQ(Crc32c(data.data() + offset, length),
+                internal::Crc32cPortable(data.data() + offset, length, 0))
+          << "length " << length << ", offset " << offset;
+    }
+  }
+}
+
+TEST(Crc32cTest, Extend) {
+  std::string data(100000, 0);
+  std::mt19937 rng(7);
+  for (auto& c : data) {
+    c = static_cast<char>(rng());
+  }
+  const uint32_t whole = Crc32c(data.data(), data.size());
+  for (size_t split : {0, 1, 1000, 50001, 100000}) {
+    uint32_t crc = Crc32c(data.data(), split);
+    crc = Crc32c(data.data() + split, data.size() - split, crc);
+    ASSERT_EQ(crc, whole);
+  }
+}
+
+}  // namespace util
+}  // namespace iceberg
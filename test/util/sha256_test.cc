@@ -0,0 +1,42 @@
+#include "iceberg/util/sha256.hh"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace iceberg {
+namespace util {
+
+TEST(Sha256Test, KnownValues) {
+  ASSERT_EQ(ToHex(Sha256Hash("")),
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  ASSERT_EQ(ToHex(Sha256Hash("abc")),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  // From FIPS 180-4, one million times 'a', fed in uneven pieces
+  const std::string data(1000000, 'a');
+  Sha256 hasher;
+  for (size_t i = 0; i < data.size(); i += 999) {
+    hasher.Update(data.data() + i, std::min<size_t>(999, data.size() - i));
+  }
+  ASSERT_EQ(ToHex(hasher.Finish()),
+            "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+  // Lengths around the padding boundary
+  for (size_t length : {55, 56, 63, 64, 65}) {
+    Sha256 split;
+    split.Update(data.data(), length / 2);
+    split.Update(data.data() + length / 2, length - length / 2);
+    ASSERT_EQ(split.Finish(), Sha256Hash(std::string_view(data).substr(0, length)));
+  }
+}
+
+TEST(Sha256Test, Hmac) {
+  // From RFC 4231, test cases 2 and 6
+  ASSERT_EQ(ToHex(HmacSha256("Jefe", "what do ya want for nothing?")),
+            "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+  ASSERT_EQ(ToHex(HmacSha256(std::string(131, '\xaa'),
+                             "Test Using Larger Than Block-Size Key - Hash Key First")),
+            "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+}
+
+}  // namespace util
+}  // namespace iceberg
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <vector>
+
+#include "iceberg/util/thread_pool.hh"
+
+namespace iceberg {
+namespace util {
+
+TEST(ThreadPool, Submit) {
+  ThreadPool pool(4);
+  ASSERT_EQ(pool.num_threads(), 4);
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 100; ++i) {
+    futures.push_back(pool.Submit([i]() { return i * i; }));
+  }
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(futures[i].get(), i * i);
+  }
+}
+
+TEST(ThreadPool, DrainsOnDestruction) {
+  std::atomic<int> counter{0};
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < 1000; ++i) {
+      pool.Spawn([&counter]() { counter.fetch_add(1); });
+    }
+  }
+  ASSERT_EQ(counter.load(), 1000);
+}
+
+}  // namespace util
+}  // namespace iceberg